@@ -107,17 +107,12 @@ int main(int argc, char *argv[])
       exit(1);
    }
 
-   for (i = 0; i < NbrTet; i++)
-   {
-      GmlSetDataLine(GmlIdx, SolTetIdx, i, Zero);
-      GmlSetDataLine(GmlIdx, GrdTetIdx, i, Zero);
-      GmlSetDataLine(GmlIdx, RhsIdx, i, Zero);
-   }
-   for (i = 0; i < NbrTri; i++)
-   {
-      GmlSetDataLine(GmlIdx, SolExtIdx, i, Zero);
-      GmlSetDataLine(GmlIdx, GrdExtIdx, i, Zero);
-   }
+   /* Fields initialization: a null stride sets every line to Zero. */
+   GmlSetSolutionBlock(GmlIdx, SolTetIdx, 0, NbrTet-1, GmlFlt, Zero, Zero);
+   GmlSetSolutionBlock(GmlIdx, GrdTetIdx, 0, NbrTet-1, GmlFlt, Zero, Zero);
+   GmlSetSolutionBlock(GmlIdx, RhsIdx,    0, NbrTet-1, GmlFlt, Zero, Zero);
+   GmlSetSolutionBlock(GmlIdx, SolExtIdx, 0, NbrTri-1, GmlFlt, Zero, Zero);
+   GmlSetSolutionBlock(GmlIdx, GrdExtIdx, 0, NbrTri-1, GmlFlt, Zero, Zero);
 
    /* Kernels compilation. */
    IniTetKrn = GmlCompileKernel(GmlIdx, ini_tet, "ini_tet", GmlTetrahedra, 2,
@@ -108,7 +108,9 @@ int main(int ArgCnt, char **ArgVec)
       return(1);
 
    // Create a raw datatype to store the element middles.
-   if(!(OptIdx = GmlNewSolutionData(GmlIdx, GmlTetrahedra, 4, GmlFlt4, "OptCrd")))
+   // It is only used by the kernels so it needs no host memory.
+   if(!(OptIdx = GmlNewSolutionData(GmlIdx, GmlTetrahedra, 4,
+                                    GmlFlt4 | GmlDeviceOnly, "OptCrd")))
       return(1);
 
    // A residual vector to store the nodes' displacement
@@ -32,6 +32,26 @@ __kernel void AddVec(__global fpn4 *U,
    Y[l] = U[l] + V[l] + W[l];
 }
 
+#elif defined(PACKED)
+
+// Unpadded vectors are added four scalars at a time regardless of the blocks
+__kernel void AddVec(__global fpn *U,
+                     __global fpn *V,
+                     __global fpn *W,
+                     __global fpn *Y,
+                     __global void *par,
+                     const int2 N)
+{
+   int l;
+
+   l = get_global_id(0);
+
+   if(l >= N.s0)
+      return;
+
+   vstore4(vload4(l, U) + vload4(l, V) + vload4(l, W), l, Y);
+}
+
 #else
 
 __kernel void AddVec(__global fpn8 *U,
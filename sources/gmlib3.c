@@ -26,6 +26,7 @@
 #include <limits.h>
 #include <math.h>
 #include <stdarg.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -43,6 +44,10 @@
 #include <unistd.h>
 #endif
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include "gmlib3.h"
 #include "reduce.h"
 #include "toolkit.h"
@@ -51,6 +56,7 @@
 #include "scalevec.h"
 #include "multdiagmatvec.h"
 #include "normvec.h"
+#include "topology.h"
 
 
 /*----------------------------------------------------------------------------*/
@@ -63,10 +69,27 @@
 #define DEFEVTBLK    100
 #define STRSIZ       1024
 #define MAXSLC       5
+#define HSTPAG       4096
+#define HSTALN       64
+#define MINPARLIN    100000
+#define POLCHKSIZ    (64 * MB)
+#define POLMAXSIZ    (16 * MB)
+#define MAXPRT       64
+#define HSHMINSIZ    1024
+#define CSRMINOCC    60
+#define MAXTIE       4
+#define TIEMINLIN    1024
+#define TPOPARSIZ    128
+#define MAXFACELE    16
+#define MAXCAVLST    1024
+#define MAXLNKCOL    (3 * GmlMaxEleTyp)
+#define STAVER       1
+#define MAXSTATAB    32
 
 enum data_type       {GmlArgDat, GmlRawDat, GmlLnkDat, GmlEleDat,
                       GmlRefDat, GmlMatDat, GmlVecDat};
 enum memory_type     {GmlInternal, GmlInput, GmlOutput, GmlInout};
+enum topology_kernel {TpoCntKrn, TpoSctKrn, TpoSplKrn, TpoSchKrn, MaxTpoKrn};
 
 
 /*----------------------------------------------------------------------------*/
@@ -75,20 +98,28 @@ enum memory_type     {GmlInternal, GmlInput, GmlOutput, GmlInout};
 
 typedef struct
 {
-   int            EleTyp, EleIdx, ItmIdx, NxtDat, nod[4];
+   int            nod[4], EleIdx;
+   char           EleTyp, ItmIdx, use;
 }BucSct;
 
 typedef struct
 {
-   int            HshTyp, DatLen, KeyLen, *HshTab;
-   int            NmbMis, NmbHit, TabSiz, NmbDat, NxtDat;
+   size_t         NmbDat, MaxDat, NmbPrb, MaxPrb;
    BucSct         *DatTab;
+}HshPrtSct;
+
+typedef struct
+{
+   int            HshTyp, DatLen, NmbPrt;
+   size_t         NmbDat, NmbPrb, MaxPrb, TabSiz;
+   HshPrtSct      prt[ MAXPRT ];
 }HshTabSct;
 
 typedef struct
 {
    int            ArgIdx, MshTyp, DatIdx, LnkTyp, LnkIdx, LnkDir, CntIdx;
-   int            LnkDeg, MaxDeg, NmbItm, ItmLen, ItmTyp, FlgTab;
+   int            LnkDeg, MaxDeg, NmbItm, ItmLen, ItmTyp, FlgTab, CsrFlg, TieFlg;
+   int            TagIdx;
    const char     *nam, *VoyNam;
 }ArgSct;
 
@@ -96,18 +127,28 @@ typedef struct
 {
    int            AloTyp, MemAcs, MshTyp, LnkTyp, ItmTyp, RedIdx;
    int            NmbItm, ItmLen, ItmSiz, NmbLin, LinSiz;
-   char           *src, use;
+   int            DrtBeg, DrtEnd, HstBeg, HstEnd, PolIdx, VoyIdx;
+   char           *src, use, ZerCpy, NamBuf[16];
    const char     *nam, *VoyNam;
-   size_t         MemSiz;
+   size_t         MemSiz, PolOff, PolSiz;
    cl_mem         GpuMem;
    void           *CpuMem;
 }DatSct;
 
+typedef struct
+{
+   int            idx, AloTyp, MemAcs, MshTyp, LnkTyp, ItmTyp, NmbItm, ItmLen;
+   int            ItmSiz, NmbLin, LinSiz, VoyIdx;
+   char           nam[16];
+   size_t         MemSiz, FilOff;
+}StaSct;
+
 typedef struct
 {
    int            NmbSlc, NmbLin, BlkSiz, FltTyp, MatSlc[ MAXSLC+1 ][5];
    int            KrnIdx[ MAXSLC ], ValIdx[ MAXSLC ], ColIdx[ MAXSLC ];
    int            DegIdx[ MAXSLC ], NmbValTyp, VecValSiz, MatValSiz[10];
+   int            PckFlg;
    float          FltOpp, MemAcc;
    char           use;
 }MatSct;
@@ -116,6 +157,7 @@ typedef struct
 {
    int            NmbLin, BlkSiz, FltTyp, idx, NmbValTyp, VecValSiz;
    int            AddKrnIdx, SclKrnIdx, MulDiaKrnIdx, NrmKrnIdx, FltSiz;
+   int            PckFlg;
    float          FltOpp, MemAcc;
    char           use;
 }VecSct;
@@ -125,6 +167,7 @@ typedef struct
    int            idx, HghIdx, NmbLin[2], NmbDat, DatTab[ GmlMaxDat ];
    int            NmbEvt, EvtBlk, IniFlg, TstDat;
    double         TstTim[20];
+   char           *PrgSrc, PrgOpt[ STRSIZ ], use;
    cl_event       *EvtTab;
    size_t         NmbGrp, GrpSiz, OptSiz, NxtSiz, MaxSiz;
    cl_kernel      kernel;
@@ -133,23 +176,39 @@ typedef struct
 
 typedef struct
 {
-   int            NmbKrn, ParIdx, CurDev, DbgFlg, DblExt;
+   int            NmbFre, MaxFre;
+   size_t         siz, *FreOff, *FreSiz;
+   cl_mem         mem;
+}PolSct;
+
+typedef struct
+{
+   int            ParIdx, CurDev, DbgFlg, DblExt, VecLay, UniMem, CrdTyp, TpoBld;
+   int            MaxDat, MaxMat, MaxVec, MaxKrn, NmbPol, MaxPol;
+   int            HybBal, HybDeg, HybTyp;
    int            TypIdx[ GmlMaxEleTyp ];
    int            RefIdx[ GmlMaxEleTyp ];
+   int            NgbTag[ GmlMaxEleTyp ];
    int            NmbEle[ GmlMaxEleTyp ];
-   int            LnkMat[ GmlMaxEleTyp ][ GmlMaxEleTyp ];
-   int            LnkHgh[ GmlMaxEleTyp ][ GmlMaxEleTyp ];
-   int            CntMat[ GmlMaxEleTyp ][ GmlMaxEleTyp ];
-   int            SizMatHgh[ GmlMaxEleTyp ][ GmlMaxEleTyp ];
+   int            LnkMat[ GmlMaxEleTyp ][ MAXLNKCOL ];
+   int            CntMat[ GmlMaxEleTyp ][ MAXLNKCOL ];
+   int            CsrMat[ GmlMaxEleTyp ][ MAXLNKCOL ];
+   int            NmbTie[ GmlMaxEleTyp ][ MAXLNKCOL ];
+   int            TieMat[ GmlMaxEleTyp ][ MAXLNKCOL ][ MAXTIE ];
+   int            TieLin[ GmlMaxEleTyp ][ MAXLNKCOL ][ MAXTIE+1 ];
+   int            PrmMat[ GmlMaxEleTyp ][ MAXLNKCOL ];
+   int            InvMat[ GmlMaxEleTyp ][ MAXLNKCOL ];
    int            RedKrn[ GmlMaxRed ];
+   int            TpoKrn[ MaxTpoKrn ];
    char           *UsrTlk, cflags[100];
    cl_uint        NmbDev;
-   size_t         MemSiz, MovSiz;
+   size_t         MemSiz, MovSiz, PolAln, PolChk;
    float          MemAcc, FltOpp;
-   DatSct         dat[ GmlMaxDat + 1 ];
-   MatSct         mat[ GmlMaxMat + 1 ];
-   VecSct         vec[ GmlMaxVec + 1 ];
-   KrnSct         krn[ GmlMaxKrn + 1 ];
+   PolSct         *pol;
+   DatSct         **dat;
+   MatSct         **mat;
+   VecSct         **vec;
+   KrnSct         **krn;
    cl_device_id   device_id[ MaxGpu ];
    cl_context     context;
    cl_command_queue queue;
@@ -163,10 +222,13 @@ typedef struct
 #define MIN(a,b)        ((a) < (b) ? (a) : (b))
 #define MAX(a,b)        ((a) > (b) ? (a) : (b))
 #define POW(a)          ((a)*(a))
-#define CHKDATIDX(p, i) if( ((i) < 1) || ((i) > GmlMaxDat) || !p->dat[(i)].use) return(0);
+#define CHKDATIDX(p, i) if( ((i) < 1) || ((i) > p->MaxDat) || !p->dat[(i)]->use) return(0);
 #define CHKELETYP(t)    if( ((t) < 0) || ((t) >= GmlMaxEleTyp)) return(0)
 #define CHKOCLTYP(t)    if( ((t) < GmlInt) || ((t) >= GmlMaxOclTyp)) return(0)
 #define GETGMLPTR(p,i)  GmlSct *p = (GmlSct *)(i)
+#define ISHLF(t)        ( ((t) >= GmlHlf) && ((t) <= GmlHlf16) )
+#define HSHPRT(l,k)     (int)(((k) >> 40) % (size_t)(l)->NmbPrt)
+#define CAVCOL(t,c)     ((1 + (c)) * GmlMaxEleTyp + (t))
 
 
 /*----------------------------------------------------------------------------*/
@@ -174,28 +236,85 @@ typedef struct
 /*----------------------------------------------------------------------------*/
 
 static int     NewData                 (GmlSct *, DatSct *);
+static void   *NewHstMem               (size_t);
+static void    FreeHstMem              (void *);
+static cl_mem  NewPolBuf               (GmlSct *, DatSct *, cl_mem_flags, size_t);
+static void    FreePolBuf              (GmlSct *, DatSct *);
 static int     NewBallData             (GmlSct *, int, int, char *, char *, char *);
+static int     NewChrTab               (GmlSct *, int, const char *);
+static char   *NewVoyData              (GmlSct *, int);
+static int     GetDegBuc               (int, int, int);
+static int     GetTieLay               (int, int *, int, int, int *, int *, int *, size_t *, size_t *);
+static int     NewDwnLnk               (GmlSct *, int, int, char *);
+static void    FreeLnkDat              (GmlSct *, int, int);
+static int     NewFacShl               (GmlSct *, int, int);
+static int     ExtFacTyp               (GmlSct *, int);
+static int     GetHostBall             (GmlSct *, int, int);
+static void    AddCavLst               (int *, int *, int);
+static int     GetCavLst               (GmlSct *, int, int, int, int, int *);
+static int     NewCavTab               (GmlSct *, int, int, int, int, const char *);
+static int     GetLnkCol               (GmlSct *, int, int, int);
+static int    *GetBalRow               (GmlSct *, int, int, int, int *, char **, int *, int *);
+static void    SetDirtyRow             (GmlSct *, int, int);
+static int     SchBal                  (GmlSct *, int, int *, int, int, int);
+static void    DelBalEnt               (GmlSct *, int, int, int, int, int);
+static int     AddBalEnt               (GmlSct *, int, int, int, int, int, int *);
+static int     SwpBalLin               (GmlSct *, int, int, int, int *);
+static void    SetCsrBal               (GmlSct *, int, int);
+static int     GetMemKnd               (GmlSct *, int, int *, int *, int *);
+static int     IsStaDat                (GmlSct *, int);
+static int     GetStaTab               (GmlSct *, void **, size_t *);
+static int     ReadState               (GmlSct *, FILE *, int, StaSct *);
+static int     GetTpoKey               (GmlSct *, int, int, int, int *);
+static int     NewTpoDat               (GmlSct *, int, int, int);
+static int     NewTpoPar               (GmlSct *, int *);
+static int     RunTpoKrn               (GmlSct *, int, int, int, int *, int);
 static int     UploadData              (GmlSct *, int);
 static int     DownloadData            (GmlSct *, int);
-static int     NewOclKrn               (GmlSct *, char *, char *);
+static int     UploadLines             (GmlSct *, int, int, int);
+static int     DownloadLines           (GmlSct *, int, int, int);
+static int     MapData                 (GmlSct *, DatSct *, cl_map_flags, size_t, size_t);
+static void    SetDirtyLines           (GmlSct *, int, int, int);
+static void    GetLinesExtent          (DatSct *, int, int, size_t *, size_t *);
+static void    CopyScalars             (char *, int, char *, int, int);
+static double  GetScalar               (char *, int, int);
+static void    SetScalar               (char *, int, int, double);
+static float   HlfToFlt                (cl_half);
+static cl_half FltToHlf                (float);
+static int     StageLine               (GmlSct *, int, int, void *, int);
+static int     GetHostLines            (GmlSct *, int, int, int);
+static int     NewOclKrn               (GmlSct *, char *, char *, int);
+static void    FreeOclKrn              (GmlSct *, int);
+static int     GrowDatTab              (GmlSct *);
+static int     GrowMatTab              (GmlSct *);
+static int     GrowVecTab              (GmlSct *);
+static int     GrowKrnTab              (GmlSct *);
 static int     GetNewDatIdx            (GmlSct *);
 static int     GetNewMatIdx            (GmlSct *);
 static int     GetNewVecIdx            (GmlSct *);
+static int     GetNewKrnIdx            (GmlSct *);
 static int     RunOclKrn               (GmlSct *, KrnSct *);
 static void    WriteToolkitSource      (char *, char *);
 static void    WriteUserToolkitSource  (char *, char *);
 static void    WriteUserTypedef        (char *, char *);
 static void    WriteProcedureHeader    (char *, char *, int, int, ArgSct *);
 static void    WriteKernelVariables    (char *, int, int, ArgSct *);
-static void    WriteKernelCounters     (char *, int);
+static void    WriteKernelCounters     (char *, int, const char *);
 static void    WriteKernelMemoryReads  (char *, int, int, ArgSct *);
 static void    WriteKernelMemoryWrites (char *, int, int, ArgSct *);
 static void    WriteUserKernel         (char *, char *);
 static void    GetCntVec               (int , int *, int *, int *);
 static void    GetItmNod               (int *, int, int, int, int *);
-static int     CalHshKey               (HshTabSct *, int *);
-static void    AddHsh                  (HshTabSct *, int, int, int, int, int *);
-static int     GetHsh                  (HshTabSct *, int, int, int, int *, int *, int *);
+static void    GetNgbFac               (int *, int, int, int, int *);
+static int     NewHsh                  (HshTabSct *, int, size_t);
+static void    SumHsh                  (HshTabSct *);
+static void    FreeHsh                 (HshTabSct *);
+static size_t  CalHshKey               (HshTabSct *, int *);
+static int     AddHsh                  (HshTabSct *, size_t, int, int, int, int *);
+static int     GetHsh                  (HshTabSct *, size_t, int, int, int *,
+                                        int *, char *, int *);
+static BucSct *GetHshBuc               (HshTabSct *, size_t, int *);
+static int     FilHsh                  (HshTabSct *, size_t, size_t *, BucSct *, int);
 
 
 /*----------------------------------------------------------------------------*/
@@ -225,7 +344,17 @@ static const int  OclTypSiz[ GmlMaxOclTyp ] = {
    sizeof(cl_char2),
    sizeof(cl_char4),
    sizeof(cl_char8),
-   sizeof(cl_char16) };
+   sizeof(cl_char16),
+   sizeof(cl_half),
+   sizeof(cl_half) * 2,
+   sizeof(cl_half) * 4,
+   sizeof(cl_half) * 8,
+   sizeof(cl_half) * 16,
+   sizeof(cl_short),
+   sizeof(cl_short2),
+   sizeof(cl_short4),
+   sizeof(cl_short8),
+   sizeof(cl_short16) };
 
 static const char *OclTypStr[ GmlMaxOclTyp ]  = {
    "int      ",
@@ -247,7 +376,17 @@ static const char *OclTypStr[ GmlMaxOclTyp ]  = {
    "char2    ",
    "char4    ",
    "char8    ",
-   "char16   " };
+   "char16   ",
+   "float    ",
+   "float2   ",
+   "float4   ",
+   "float8   ",
+   "float16  ",
+   "short    ",
+   "short2   ",
+   "short4   ",
+   "short8   ",
+   "short16  " };
 
 static const char *OclNulVec[ GmlMaxOclTyp ]  = {
    "(int){0}",
@@ -269,10 +408,24 @@ static const char *OclNulVec[ GmlMaxOclTyp ]  = {
    "(char2){0,0}",
    "(char4){0,0,0,0}",
    "(char8){0,0,0,0,0,0,0,0}",
-   "(char16){0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}" };
+   "(char16){0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}",
+   "(float){0.}",
+   "(float2){0.,0.}",
+   "(float4){0.,0.,0.,0.}",
+   "(float8){0.,0.,0.,0.,0.,0.,0.,0.}",
+   "(float16){0.,0.,0.,0.,0.,0.,0.,0.,0.,0.,0.,0.,0.,0.,0.,0.}",
+   "(short){0}",
+   "(short2){0,0}",
+   "(short4){0,0,0,0}",
+   "(short8){0,0,0,0,0,0,0,0}",
+   "(short16){0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}" };
 
 static const int  TypVecSiz[ GmlMaxOclTyp ]  = {
-   1,2,4,8,16,1,2,4,8,16,1,2,4,8,16,1,2,4,8,16 };
+   1,2,4,8,16,1,2,4,8,16,1,2,4,8,16,1,2,4,8,16,1,2,4,8,16,1,2,4,8,16 };
+
+static const char *HlfVecSfx[ GmlMaxOclTyp ]  = {
+   "","","","","", "","","","","", "","","","","", "","","","","",
+   "","2","4","8","16", "","","","","" };
 
 static const int  OclVecPow[ VECPOWOCL +1 ]  = {
    GmlInt, GmlInt2, GmlInt4, GmlInt8, GmlInt16};
@@ -294,6 +447,11 @@ static const char *MshRefStr[ GmlMaxEleTyp ]  = {
    "VerRef", "EdgRef", "TriRef", "QadRef",
    "TetRef", "PyrRef", "PriRef", "HexRef" };
 
+static const char *MemKndStr[ GmlMaxMemKnd ]  = {
+   "parameters", "mesh", "references", "solution", "link", "ball",
+   "high_ball", "degree", "voyeurs", "matrix", "vector", "reduction",
+   "packed_ball", "offsets", "permutation" };
+
 static const int LenMatBas[ GmlMaxEleTyp ][ GmlMaxEleTyp ] = {
    {0,16, 8, 4,32,16,16, 8},
    {2, 0, 2, 2, 8, 8, 8, 4},
@@ -325,7 +483,10 @@ static const int NmbTpoLnk[ GmlMaxEleTyp ][ GmlMaxEleTyp ] = {
    {8,12, 0, 6, 0, 6, 6, 6} };
 
 static const int NgbTyp[8]    = {-1,0,1,1,2,3,3,3};
-static const int HshLenTab[5] = {0,1,2,3,2};
+
+static const int SclTypSiz[6] = {
+   sizeof(cl_int), sizeof(cl_float), sizeof(cl_double),
+   sizeof(cl_char), sizeof(cl_half), sizeof(cl_short) };
 static const int ItmNmbVer[8] = {1,2,3,4,4,5,6,8};
 static const int ItmNmbEdg[8] = {0,1,3,4,6,8,9,12};
 
@@ -340,8 +501,6 @@ static const int ItmEdgNod[8][12][2] = {
 { {0,1}, {3,2}, {7,6}, {4,5}, {0,3}, {4,7}, {5,6}, {1,2}, {0,4}, {1,5}, {2,6}, {3,7} } };
 
 static const int ItmNmbFac[8] = {0,0,1,1,4,5,5,6};
-static const int ItmNmbTri[8] = {0,0,1,0,4,4,2,0};
-static const int ItmNmbQad[8] = {0,0,0,1,0,1,3,6};
 
 static const int ItmFacDeg[8][6] = { 
 {0,0,0,0,0,0}, {0,0,0,0,0,0}, {3,0,0,0,0,0}, {4,0,0,0,0,0},
@@ -388,6 +547,9 @@ size_t GmlInit(int DevIdx)
    int            err, res;
    cl_platform_id PlfTab[ GmlMaxOclTyp ];
    cl_uint        NmbPlf;
+   cl_bool        UniMem;
+   cl_uint        AdrAln;
+   cl_ulong       MaxAlo;
    GmlSct         *gml;
    size_t         GmlIdx, retSiz;
 
@@ -396,6 +558,15 @@ size_t GmlInit(int DevIdx)
    assert(gml);
    GmlIdx = (size_t)gml;
    gml->CurDev = DevIdx;
+   gml->CrdTyp = GmlFlt4;
+
+   // Allocate the initial data, matrix, vector and kernel tables
+   // that will be doubled each time one of them gets full
+   if(!GrowDatTab(gml) || !GrowMatTab(gml) || !GrowVecTab(gml) || !GrowKrnTab(gml))
+   {
+      puts("Could not allocate the GMlib internal tables.");
+      return(0);
+   }
 
    // Init the OpenCL software platform
    res = clGetPlatformIDs(10, PlfTab, &NmbPlf);
@@ -449,6 +620,34 @@ size_t GmlInit(int DevIdx)
    if(strstr(str, "cl_khr_fp64"))
       gml->DblExt = 1;
 
+   // CPU runtimes and integrated GPUs share the host memory:
+   // buffers will be allocated once and accessed through mapping
+   if( (clGetDeviceInfo(gml->device_id[ gml->CurDev ],
+                        CL_DEVICE_HOST_UNIFIED_MEMORY, sizeof(cl_bool),
+                        &UniMem, NULL) == CL_SUCCESS) && UniMem )
+   {
+      gml->UniMem = 1;
+   }
+
+   // Small buffers are carved out of larger chunks whose sub-buffer
+   // offsets must be aligned on the device's base address alignment
+   gml->PolAln = 128;
+   gml->PolChk = POLCHKSIZ;
+
+   if( (clGetDeviceInfo(gml->device_id[ gml->CurDev ],
+                        CL_DEVICE_MEM_BASE_ADDR_ALIGN, sizeof(cl_uint),
+                        &AdrAln, NULL) == CL_SUCCESS) && (AdrAln / 8 > 128) )
+   {
+      gml->PolAln = AdrAln / 8;
+   }
+
+   if( (clGetDeviceInfo(gml->device_id[ gml->CurDev ],
+                        CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(cl_ulong),
+                        &MaxAlo, NULL) == CL_SUCCESS) && (MaxAlo < POLCHKSIZ) )
+   {
+      gml->PolChk = (size_t)MaxAlo;
+   }
+
    // Return a pointer on the allocated and initialize GMlib structure
    return(GmlIdx);
 }
@@ -464,18 +663,51 @@ void GmlStop(size_t GmlIdx)
    GETGMLPTR(gml, GmlIdx);
 
    // Free GPU memories, kernels and queue
-   for(i=1;i<=GmlMaxDat;i++)
-      if(gml->dat[i].GpuMem)
-         clReleaseMemObject(gml->dat[i].GpuMem);
+   for(i=1;i<=gml->MaxDat;i++)
+      if(gml->dat[i]->GpuMem)
+         clReleaseMemObject(gml->dat[i]->GpuMem);
 
-   for(i=1;i<=gml->NmbKrn;i++)
+   for(i=1;i<=gml->MaxKrn;i++)
+      if(gml->krn[i]->use)
+         FreeOclKrn(gml, i);
+
+   // Release the memory pool chunks once all their sub-buffers are gone
+   for(i=0;i<gml->NmbPol;i++)
    {
-      clReleaseKernel(gml->krn[i].kernel);
-      clReleaseProgram(gml->krn[i].program);
+      clReleaseMemObject(gml->pol[i].mem);
+      free(gml->pol[i].FreOff);
+      free(gml->pol[i].FreSiz);
    }
 
+   if(gml->pol)
+      free(gml->pol);
+
    clReleaseCommandQueue(gml->queue); 
    clReleaseContext(gml->context);
+
+   // Free the host side tables
+   for(i=0;i<=gml->MaxDat;i++)
+   {
+      if(gml->dat[i]->CpuMem)
+         FreeHstMem(gml->dat[i]->CpuMem);
+
+      free(gml->dat[i]);
+   }
+
+   for(i=0;i<=gml->MaxMat;i++)
+      free(gml->mat[i]);
+
+   for(i=0;i<=gml->MaxVec;i++)
+      free(gml->vec[i]);
+
+   for(i=0;i<=gml->MaxKrn;i++)
+      free(gml->krn[i]);
+
+   free(gml->dat);
+   free(gml->mat);
+   free(gml->vec);
+   free(gml->krn);
+   free(gml);
 }
 
 
@@ -531,7 +763,7 @@ void *GmlNewParameters(size_t GmlIdx, int siz, char *src)
    if(!(idx = GetNewDatIdx(gml)))
       return(NULL);
 
-   dat = &gml->dat[ idx ];
+   dat = gml->dat[ idx ];
 
    dat->AloTyp = GmlArgDat;
    dat->MshTyp = 0;
@@ -579,13 +811,13 @@ int GmlNewMeshData(size_t GmlIdx, int MshTyp, int NmbLin)
    if(!(EleIdx = GetNewDatIdx(gml)))
       return(0);
 
-   EleDat = &gml->dat[ EleIdx ];
+   EleDat = gml->dat[ EleIdx ];
 
    EleDat->AloTyp = GmlEleDat;
    EleDat->MshTyp = MshTyp;
    EleDat->LnkTyp = 0;
    EleDat->MemAcs = GmlInout;
-   EleDat->ItmTyp = MshItmTyp[ MshTyp ];
+   EleDat->ItmTyp = (MshTyp == GmlVertices) ? gml->CrdTyp : MshItmTyp[ MshTyp ];
    EleDat->NmbItm = 1;
    EleDat->ItmSiz = OclTypSiz[ EleDat->ItmTyp ];
    EleDat->ItmLen = TypVecSiz[ EleDat->ItmTyp ];
@@ -601,7 +833,7 @@ int GmlNewMeshData(size_t GmlIdx, int MshTyp, int NmbLin)
    if(!(RefIdx = GetNewDatIdx(gml)))
       return(0);
 
-   RefDat = &gml->dat[ RefIdx ];
+   RefDat = gml->dat[ RefIdx ];
 
    RefDat->AloTyp = GmlRefDat;
    RefDat->MshTyp = MshTyp;
@@ -646,22 +878,30 @@ int GmlNewMeshData(size_t GmlIdx, int MshTyp, int NmbLin)
 int GmlNewSolutionData( size_t GmlIdx, int MshTyp, int NmbDat,
                                        int ItmTyp, char *nam )
 {
-   int      idx;
+   int      idx, MemAcs = GmlInout;
    DatSct   *dat;
 
    GETGMLPTR(gml, GmlIdx);
    CHKELETYP(MshTyp);
+
+   // Scratch fields may be allocated on the device only, without host mirror
+   if(ItmTyp & GmlDeviceOnly)
+   {
+      ItmTyp &= ~GmlDeviceOnly;
+      MemAcs = GmlInternal;
+   }
+
    CHKOCLTYP(ItmTyp);
 
    if(!(idx = GetNewDatIdx(gml)))
       return(0);
 
-   dat = &gml->dat[ idx ];
+   dat = gml->dat[ idx ];
 
    dat->AloTyp = GmlRawDat;
    dat->MshTyp = MshTyp;
    dat->LnkTyp = 0;
-   dat->MemAcs = GmlInout;
+   dat->MemAcs = MemAcs;
    dat->ItmTyp = ItmTyp;
    dat->NmbItm = NmbDat;
    dat->ItmSiz = OclTypSiz[ ItmTyp ];
@@ -692,11 +932,18 @@ int GmlNewSolutionData( size_t GmlIdx, int MshTyp, int NmbDat,
 
 int GmlNewLinkData(size_t GmlIdx, int MshTyp, int LnkTyp, int NmbDat, char *nam)
 {
-   int      LnkIdx, VecCnt, VecSiz, ItmTyp;
+   int      LnkIdx, VecCnt, VecSiz, ItmTyp, MemAcs = GmlInout;
    DatSct   *dat;
 
    GETGMLPTR(gml, GmlIdx);
    CHKELETYP(MshTyp);
+
+   if(LnkTyp & GmlDeviceOnly)
+   {
+      LnkTyp &= ~GmlDeviceOnly;
+      MemAcs = GmlInternal;
+   }
+
    CHKELETYP(LnkTyp);
 
    if(!(LnkIdx = GetNewDatIdx(gml)))
@@ -704,12 +951,12 @@ int GmlNewLinkData(size_t GmlIdx, int MshTyp, int LnkTyp, int NmbDat, char *nam)
 
    GetCntVec(NmbDat, &VecCnt, &VecSiz, &ItmTyp);
 
-   dat = &gml->dat[ LnkIdx ];
+   dat = gml->dat[ LnkIdx ];
 
    dat->AloTyp = GmlLnkDat;
    dat->MshTyp = MshTyp;
    dat->LnkTyp = LnkTyp;
-   dat->MemAcs = GmlInout;
+   dat->MemAcs = MemAcs;
    dat->ItmTyp = ItmTyp;
    dat->NmbItm = VecCnt;
    dat->ItmSiz = VecCnt * OclTypSiz[ ItmTyp ];
@@ -737,29 +984,36 @@ int GmlNewLinkData(size_t GmlIdx, int MshTyp, int LnkTyp, int NmbDat, char *nam)
 
 
 /*----------------------------------------------------------------------------*/
-/* Build an arbitray element kind and dimension link table                    */
+/* Build an arbitray element kind and dimension link table and return the     */
+/* index of its first table, or 0 if any table could not be built or filled   */
 /*----------------------------------------------------------------------------*/
 
 static int NewBallData( GmlSct *gml, int SrcTyp, int DstTyp,
                         char *BalNam, char *DegNam, char *VoyNam )
 {
-   int         i, j, idx, cod[4], cpt, dir, HshKey, ItmTab[4];
-   int         BalIdx, HghIdx, DegIdx;
-   int         VecSiz, BalSiz, MaxSiz, HghSiz = 0;
-   int         *EleTab, *BalTab, *DegTab, *HghTab, *PtrInt;
-   int         MaxDeg = 0, MaxPos = 0, DegTot = 0, VecCnt, ItmTyp, NmbDat;
+   int         i, j, p, t, n, cod[4], cpt, dir, ItmTab[4], HshTyp, res;
+   int         BalIdx = 0, DegIdx = 0, VecSiz, BalSiz, MaxSiz, MaxDeg = 0;
+   int         BucPos[ MAXTIE ], LstIdx[ MAXTIE+5 ];
+   int         PrmIdx = 0, InvIdx = 0, *PrmTab = NULL, *InvTab = NULL;
+   int         *BalTab, *DegTab = NULL, VecCnt, ItmTyp, NmbDat;
+   int         NmbTie = 0, TieLin[ MAXTIE+1 ], TieWid[ MAXTIE ], TieIdx[ MAXTIE ] = {0};
+   int         *TieTab[ MAXTIE ];
+   int         OclFlg = 0, KeyIdx = 0, TpoIdx, TpoPar[ TPOPARSIZ ], IdtNod[8];
+   int         OffIdx = 0, CurIdx, TupIdx, DatTab[10], *OffTab = NULL, CsrFlg = 0;
    int         SrcNmbItm, SrcLen, DstNmbItm, DstLen, *SrcNod, *DstNod, *EleNod;
+   char        VoyTab[4], *TieVoy[ MAXTIE ] = {NULL};
    const char  *SrcNam, *DstNam;
-   DatSct      *src, *dst, *bal, *hgh, *deg, *BalDat, *HghDat, *DegDat;
+   size_t      idx, HshKey, DegTot = 0, PadTot = 0, NmbKey, *KeyTab;
+   BucSct      *KeyBuc;
+   DatSct      *src, *dst, *bal, *deg, *BalDat, *DegDat = NULL, *key, *OffDat = NULL;
    HshTabSct   lnk;
 
    // Get and check the source and destination mesh datatypes
    CHKELETYP(SrcTyp);
    CHKELETYP(DstTyp);
-   memset(&lnk, 0, sizeof(HshTabSct));
 
-   src = &gml->dat[ gml->TypIdx[ SrcTyp ] ];
-   dst = &gml->dat[ gml->TypIdx[ DstTyp ] ];
+   src = gml->dat[ gml->TypIdx[ SrcTyp ] ];
+   dst = gml->dat[ gml->TypIdx[ DstTyp ] ];
 
    if(gml->DbgFlg)
    {
@@ -784,8 +1038,7 @@ static int NewBallData( GmlSct *gml, int SrcTyp, int DstTyp,
    if(SrcTyp < DstTyp)
    {
       dir = 1;
-      lnk.HshTyp = SrcTyp;
-      lnk.TabSiz = src->NmbLin;
+      HshTyp = SrcTyp;
 
       if(gml->DbgFlg)
          printf("Building up link %s -> %s\n", SrcNam, DstNam);
@@ -793,8 +1046,7 @@ static int NewBallData( GmlSct *gml, int SrcTyp, int DstTyp,
    else if(SrcTyp > DstTyp)
    {
       dir = -1;
-      lnk.HshTyp = DstTyp;
-      lnk.TabSiz = dst->NmbLin;
+      HshTyp = DstTyp;
 
       if(gml->DbgFlg)
          printf("Building down link %s -> %s\n", SrcNam, DstNam);
@@ -802,70 +1054,105 @@ static int NewBallData( GmlSct *gml, int SrcTyp, int DstTyp,
    else
    {
       dir = 0;
-      lnk.HshTyp = NgbTyp[ SrcTyp ];
-      lnk.TabSiz = src->NmbLin * NmbTpoLnk[ SrcTyp ][ SrcTyp ] / 2;
+      HshTyp = NgbTyp[ SrcTyp ];
 
       if(gml->DbgFlg)
          printf(  "Building %s neighbours between %s\n",
                   SrcNam, BalTypStr[ NgbTyp[ SrcTyp ] ] );
    }
 
-   // Setup a hash table
-   lnk.DatLen = ItmNmbVer[ lnk.HshTyp ];
-   lnk.KeyLen = HshLenTab[ lnk.DatLen ];
-   lnk.NmbDat = lnk.TabSiz;
-   lnk.NxtDat = 1;
-   lnk.HshTab = calloc(lnk.TabSiz, sizeof(int));
-   lnk.DatTab = malloc(lnk.NmbDat * sizeof(BucSct));
-
-   if(!lnk.HshTab || !lnk.DatTab)
-      return(0);
-
-   if(gml->DbgFlg)
-      printf(  "Hash table: lines=%d, stored items=%d, hash keys=%d\n",
-               (int)lnk.TabSiz, lnk.DatLen, lnk.KeyLen);
-
    // Workaround to avoid reading the number of neighbours
    // in case a type is pointing to itself
-   if(SrcTyp != lnk.HshTyp)
-      SrcNmbItm = NmbTpoLnk[ SrcTyp ][ lnk.HshTyp ];
+   if(SrcTyp != HshTyp)
+      SrcNmbItm = NmbTpoLnk[ SrcTyp ][ HshTyp ];
    else
       SrcNmbItm = 1;
 
-   if(DstTyp != lnk.HshTyp)
-      DstNmbItm = NmbTpoLnk[ DstTyp ][ lnk.HshTyp ];
+   if(DstTyp != HshTyp)
+      DstNmbItm = NmbTpoLnk[ DstTyp ][ HshTyp ];
    else
       DstNmbItm = 1;
 
    SrcLen = src->ItmLen;
    DstLen = dst->ItmLen;
 
-   // Add destination entities to the hash table
-   for(i=0;i<dst->NmbLin;i++)
+   // The device builder sorts the items by key on the GPU instead of hashing
+   // them on the host, provided that the key or ball tables can be built
+   if(gml->TpoBld == GmlDeviceTopology)
+      OclFlg = GetTpoKey(gml, SrcTyp, DstTyp, dir, &KeyIdx);
+
+   if(!OclFlg)
    {
-      EleNod = &DstNod[ i * DstLen ];
+      // Setup a hash table sized for all the destination items
+      if(!NewHsh(&lnk, HshTyp, (size_t)dst->NmbLin * DstNmbItm))
+         goto FreBal;
 
-      for(j=0;j<DstNmbItm;j++)
+      if(gml->DbgFlg)
+         printf(  "Hash table: buckets=%d, stored items=%d, partitions=%d\n",
+                  (int)lnk.TabSiz, lnk.DatLen, lnk.NmbPrt);
+
+      // Compute the keys of all destination entities once and in parallel,
+      // then each thread stores the keys of its own partition in the serial
+      // order, so the chains and the resulting links do not depend on the
+      // thread count
+      NmbKey = (size_t)dst->NmbLin * DstNmbItm;
+      KeyTab = malloc(MAX(NmbKey, 1) * sizeof(size_t));
+      KeyBuc = malloc(MAX(NmbKey, 1) * sizeof(BucSct));
+
+      if(!KeyTab || !KeyBuc)
       {
-         GetItmNod(EleNod, DstTyp, lnk.HshTyp, j, ItmTab);
-         HshKey = CalHshKey(&lnk, ItmTab);
-         AddHsh(&lnk, HshKey, DstTyp, i, j, ItmTab);
+         if(KeyTab)
+            free(KeyTab);
+
+         if(KeyBuc)
+            free(KeyBuc);
+
+         goto FreBal;
       }
-   }
 
-   if(gml->DbgFlg)
-      printf(  "Hashed %d entities: occupency=%d%%, collisions=%g\n",
-               (int)lnk.NmbDat, (int)((100 * lnk.NmbHit) / lnk.TabSiz),
-               (double)lnk.NmbMis / (double)lnk.TabSiz );
+#ifdef _OPENMP
+#pragma omp parallel for private(j, idx, EleNod) if(dst->NmbLin >= MINPARLIN)
+#endif
+      for(i=0;i<dst->NmbLin;i++)
+      {
+         EleNod = &DstNod[ (size_t)i * DstLen ];
+
+         for(j=0;j<DstNmbItm;j++)
+         {
+            idx = (size_t)i * DstNmbItm + j;
+            GetItmNod(EleNod, DstTyp, HshTyp, j, KeyBuc[ idx ].nod);
+            KeyBuc[ idx ].EleTyp = (char)DstTyp;
+            KeyBuc[ idx ].ItmIdx = (char)j;
+            KeyBuc[ idx ].EleIdx = i;
+            KeyTab[ idx ] = CalHshKey(&lnk, KeyBuc[ idx ].nod);
+         }
+      }
+
+      res = FilHsh(&lnk, NmbKey, KeyTab, KeyBuc, 0);
+      free(KeyTab);
+      free(KeyBuc);
+
+      if(!res)
+         goto FreBal;
+
+      SumHsh(&lnk);
+
+      if(gml->DbgFlg)
+         printf(  "Hashed %d entities: occupency=%d%%, mean probes=%g, max probes=%d\n",
+                  (int)lnk.NmbDat, (int)((100 * lnk.NmbDat) / lnk.TabSiz),
+                  (double)lnk.NmbPrb / (double)lnk.NmbDat, (int)lnk.MaxPrb );
+   }
+   else if(gml->DbgFlg)
+      printf("Sorting the links on the device with key table %d\n", KeyIdx);
 
    // Allocate and fill a GPU data type to store the degrees in case uf uplink
    if(dir == 1)
    {
       // First allocate the GPU datatype
       if(!(DegIdx = GetNewDatIdx(gml)))
-         return(0);
+         goto FreBal;
 
-      DegDat = &gml->dat[ DegIdx ];
+      DegDat = gml->dat[ DegIdx ];
 
       DegDat->AloTyp = GmlLnkDat;
       DegDat->MshTyp = SrcTyp;
@@ -879,88 +1166,156 @@ static int NewBallData( GmlSct *gml, int SrcTyp, int DstTyp,
       DegDat->LinSiz = DegDat->NmbItm * DegDat->ItmSiz;
       DegDat->MemSiz = (size_t)DegDat->NmbLin * (size_t)DegDat->LinSiz;
       DegDat->GpuMem = DegDat->CpuMem = NULL;
-      DegDat->nam    = DegNam;
+
+      // Names are copied into the slots as the caller's strings are local
+      DegDat->nam    = strncpy(DegDat->NamBuf, DegNam, 15);
 
       if(!NewData(gml, DegDat))
-         return(0);
+         goto FreBal;
 
       if(gml->DbgFlg)
          printf("Allocate a degree table with %d lines\n", DegDat->NmbLin);
 
       // Then fetch the degrees from the hash table
       gml->CntMat[ SrcTyp ][ DstTyp ] = DegIdx;
-      deg = &gml->dat[ gml->CntMat[ src->MshTyp ][ dst->MshTyp ] ];
+      deg = gml->dat[ gml->CntMat[ src->MshTyp ][ dst->MshTyp ] ];
       DegTab = deg->CpuMem;
 
-      for(i=0;i<src->NmbLin;i++)
+      if(OclFlg)
       {
-         if(SrcTyp == GmlVertices)
-            EleNod = &i;
-         else
-            EleNod = &SrcNod[ i * SrcLen ];
+         // Count the keys' occurrences with atomics on the device
+         // and only download the degrees, needed to size the balls
+         memset(TpoPar, 0, TPOPARSIZ * sizeof(int));
+         TpoPar[0] = DstNmbItm;
+         TpoPar[1] = gml->dat[ KeyIdx ]->ItmLen;
+
+         if(!(TpoIdx = NewTpoPar(gml, TpoPar)))
+            goto FreBal;
+
+         DatTab[0] = KeyIdx;
+         DatTab[1] = DegIdx;
+         DatTab[2] = TpoIdx;
+         i = 0;
+
+         if( !GmlFillData((size_t)gml, DegIdx, &i)
+         ||  (RunTpoKrn(gml, TpoCntKrn, dst->NmbLin, 3, DatTab, 5) != 1)
+         ||  !DownloadData(gml, DegIdx) )
+         {
+            GmlFreeData((size_t)gml, TpoIdx);
+            goto FreBal;
+         }
 
-         for(j=0;j<SrcNmbItm;j++)
+         GmlFreeData((size_t)gml, TpoIdx);
+      }
+      else
+      {
+         // Once built, the hash table is only read and entities can be
+         // looked up concurrently, each one writing to its own lines
+#ifdef _OPENMP
+#pragma omp parallel for private(j, idx, EleNod, ItmTab, HshKey) if(src->NmbLin >= MINPARLIN)
+#endif
+         for(i=0;i<src->NmbLin;i++)
          {
-            idx = i * SrcNmbItm + j;
-            GetItmNod(EleNod, SrcTyp, lnk.HshTyp, j, ItmTab);
-            HshKey = CalHshKey(&lnk, ItmTab);
-            DegTab[ idx ] = GetHsh(&lnk, HshKey, i, j, ItmTab, NULL, NULL);
+            if(SrcTyp == GmlVertices)
+               EleNod = &i;
+            else
+               EleNod = &SrcNod[ (size_t)i * SrcLen ];
+
+            for(j=0;j<SrcNmbItm;j++)
+            {
+               idx = (size_t)i * SrcNmbItm + j;
+               GetItmNod(EleNod, SrcTyp, HshTyp, j, ItmTab);
+               HshKey = CalHshKey(&lnk, ItmTab);
+               DegTab[ idx ] = GetHsh(&lnk, HshKey, i, j, ItmTab, NULL, NULL, NULL);
+            }
          }
       }
 
-      EleTab = dst->CpuMem;
       BalSiz = LenMatBas[ src->MshTyp ][ dst->MshTyp ];
       MaxSiz = LenMatMax[ src->MshTyp ][ dst->MshTyp ];
 
-      if(BalSiz == MaxSiz)
-      {
-         for(i=0;i<src->NmbLin;i++)
-            DegTot += DegTab[i];
+      // Split the lines into power of two width degree tiers
+      NmbTie = GetTieLay(  src->NmbLin, DegTab, BalSiz, MaxSiz,
+                           TieLin, TieWid, BucPos, &DegTot, &PadTot );
+      MaxDeg = TieWid[ NmbTie-1 ];
 
-         MaxDeg = BalSiz;
-         HghSiz = 0;
-         MaxPos = src->NmbLin;
-         gml->SizMatHgh[ src->MshTyp ][ dst->MshTyp ] = 0;
+      if(gml->DbgFlg)
+         for(t=0;t<NmbTie;t++)
+            printf(  "Width for lines %d..%d: %d\n",
+                     TieLin[t] + 1, TieLin[ t+1 ], TieWid[t] );
+
+      // Measure the padding of the tiers and store the uplink as
+      // packed entries with offsets if too many slots are empty
+      if(100 * DegTot < CSRMINOCC * PadTot)
+      {
+         CsrFlg = 1;
+         NmbTie = 1;
+         TieLin[1] = src->NmbLin;
 
          if(gml->DbgFlg)
-            printf("Constant width uplink: %d\n", BalSiz);
+            printf(  "Padded occupency = %g%%, switching to a packed uplink\n",
+                     (100. * DegTot) / (double)PadTot );
       }
-      else
+
+      // Several tiers need the permutation giving the line stored at each
+      // position, and its inverse giving each line's position, so the tiers
+      // stay tight without renumbering the mesh and lines may later be
+      // swapped between tiers when their degree changes: it is built even
+      // if the numbering is already sorted by tier, since kernels compiled
+      // now would otherwise miss it once GmlUpdateLinks() swaps lines
+      if(!CsrFlg && (NmbTie > 1))
       {
-         for(i=0;i<src->NmbLin;i++)
+         for(j=0;j<2;j++)
          {
-            if(!MaxPos && (DegTab[i] > BalSiz))
-               MaxPos = i;
+            if(!(n = GetNewDatIdx(gml)))
+               goto FreBal;
+
+            OffDat = gml->dat[n];
+
+            OffDat->AloTyp = GmlLnkDat;
+            OffDat->MshTyp = SrcTyp;
+            OffDat->LnkTyp = DstTyp;
+            OffDat->MemAcs = GmlInout;
+            OffDat->ItmTyp = GmlInt;
+            OffDat->NmbItm = 1;
+            OffDat->ItmSiz = OclTypSiz[ GmlInt ];
+            OffDat->ItmLen = 0;
+            OffDat->NmbLin = src->NmbLin;
+            OffDat->LinSiz = OffDat->NmbItm * OffDat->ItmSiz;
+            OffDat->MemSiz = (size_t)OffDat->NmbLin * (size_t)OffDat->LinSiz;
+            OffDat->GpuMem = OffDat->CpuMem = NULL;
+            sprintf( OffDat->NamBuf, "%s%s%s", BalTypStr[ SrcTyp ],
+                     BalTypStr[ DstTyp ], j ? "Inv" : "Prm" );
+            OffDat->nam    = OffDat->NamBuf;
+
+            if(j)
+               InvIdx = n;
+            else
+               PrmIdx = n;
 
-            DegTot += DegTab[i];
-            MaxDeg = MAX(MaxDeg, DegTab[i]);
+            if(!NewData(gml, OffDat))
+               goto FreBal;
          }
 
-         MaxDeg = (int)pow(2., ceil(log2(MaxDeg)));
-
-         // If the max degree is greater than de base size,
-         // create an extension ball table for high degree entities
-         if(MaxDeg > BalSiz)
-         {
-            HghSiz = MIN(MaxDeg, LenMatMax[ src->MshTyp ][ dst->MshTyp ]);
-            gml->SizMatHgh[ src->MshTyp ][ dst->MshTyp ] = HghSiz;
+         PrmTab = gml->dat[ PrmIdx ]->CpuMem;
+         InvTab = gml->dat[ InvIdx ]->CpuMem;
 
-            if(gml->DbgFlg)
-               printf(  "Width for lines 1..%d: %d, for lines %d..%d:%d\n",
-                        MaxPos, BalSiz, MaxPos+1, src->NmbLin, MaxDeg);
-         }
-         else
+         // Stable counting sort of the lines by width bucket
+         for(i=0;i<src->NmbLin;i++)
          {
-            // If the max degree fits in the base size vector,
-            // fall back to a regular contant width table
-            MaxDeg = BalSiz;
-            HghSiz = 0;
-            MaxPos = src->NmbLin;
-            gml->SizMatHgh[ src->MshTyp ][ dst->MshTyp ] = 0;
-
-            if(gml->DbgFlg)
-               printf("Constant width uplink: %d\n", BalSiz);
+            p = BucPos[ GetDegBuc(DegTab[i], BalSiz, MaxSiz) ]++;
+            PrmTab[p] = i;
+            InvTab[i] = p;
          }
+
+         UploadData(gml, PrmIdx);
+         UploadData(gml, InvIdx);
+         gml->PrmMat[ SrcTyp ][ DstTyp ] = PrmIdx;
+         gml->InvMat[ SrcTyp ][ DstTyp ] = InvIdx;
+
+         if(gml->DbgFlg)
+            printf(  "Lines sorted by degree tier through permutation %d\n",
+                     PrmIdx );
       }
    }
 
@@ -968,3302 +1323,8345 @@ static int NewBallData( GmlSct *gml, int SrcTyp, int DstTyp,
    if(dir == -1 || dir == 0)
    {
       // Allocate the downlink table
-      if(!(BalIdx = GetNewDatIdx(gml)))
-         return(0);
-
-      NmbDat = LenMatBas[ SrcTyp ][ DstTyp ];
-      GetCntVec(NmbDat, &VecCnt, &VecSiz, &ItmTyp);
-
-      BalDat = &gml->dat[ BalIdx ];
-
-      BalDat->AloTyp = GmlLnkDat;
-      BalDat->MshTyp = SrcTyp;
-      BalDat->LnkTyp = DstTyp;
-      BalDat->MemAcs = GmlInout;
-      BalDat->ItmTyp = ItmTyp;
-      BalDat->NmbItm = VecCnt;
-      BalDat->ItmSiz = VecCnt * OclTypSiz[ ItmTyp ];
-      BalDat->ItmLen = NmbDat;
-      BalDat->NmbLin = src->NmbLin;
-      BalDat->LinSiz = BalDat->NmbItm * BalDat->ItmSiz;
-      BalDat->MemSiz = (size_t)BalDat->NmbLin * (size_t)BalDat->LinSiz;
-      BalDat->GpuMem = BalDat->CpuMem = NULL;
-      BalDat->nam    = BalNam;
+      if(!(BalIdx = NewDwnLnk(gml, SrcTyp, DstTyp, BalNam)))
+         goto FreBal;
 
-      if(!NewData(gml, BalDat))
-         return(0);
+      BalDat = gml->dat[ BalIdx ];
 
       // fetch the pointed items from the hash table and store them as downlinks
-      gml->LnkMat[ SrcTyp ][ DstTyp ] = BalIdx;
-      bal = &gml->dat[ gml->LnkMat[ src->MshTyp ][ dst->MshTyp ] ];
+      bal = gml->dat[ gml->LnkMat[ src->MshTyp ][ dst->MshTyp ] ];
       BalTab = bal->CpuMem;
 
-      for(i=0;i<src->NmbLin;i++)
+      if(OclFlg)
       {
-         EleNod = &SrcNod[ i * SrcLen ];
+         // Look for the items in the ball of their first vertex, the key
+         // being this vertex ball, and get the items' local nodes from an
+         // element whose vertices are numbered from 0 to 7
+         key = gml->dat[ KeyIdx ];
+
+         memset(TpoPar, 0, TPOPARSIZ * sizeof(int));
+         TpoPar[0] = SrcNmbItm;
+         TpoPar[1] = SrcLen;
+         TpoPar[3] = gml->NmbTie[ GmlVertices ][ key->LnkTyp ];
+         TpoPar[6] = dir;
+         TpoPar[7] = gml->dat[ gml->TypIdx[ key->LnkTyp ] ]->ItmLen;
+         TpoPar[8] = EleNmbNod[ key->LnkTyp ];
+         TpoPar[9] = ItmNmbVer[ HshTyp ];
+         TpoPar[10] = BalDat->ItmLen;
+         TpoPar[11] = gml->CsrMat[ GmlVertices ][ key->LnkTyp ] ? 1 : 0;
+         TpoPar[12] = gml->InvMat[ GmlVertices ][ key->LnkTyp ] ? 1 : 0;
+
+         for(t=0;t<TpoPar[3];t++)
+         {
+            TpoPar[ 64 + t ] = gml->dat[ gml->TieMat[ GmlVertices ][ key->LnkTyp ][t] ]->ItmLen;
+            TpoPar[ 72 + t ] = gml->TieLin[ GmlVertices ][ key->LnkTyp ][t];
+         }
+
+         for(i=0;i<8;i++)
+            IdtNod[i] = i;
 
          for(j=0;j<SrcNmbItm;j++)
-         {
-            idx = i * SrcNmbItm + j;
+            GetItmNod(IdtNod, SrcTyp, HshTyp, j, &TpoPar[ 16 + j*4 ]);
 
-            ItmTab[0]=ItmTab[1]=ItmTab[2]=ItmTab[3]=0;
-            GetItmNod(EleNod, SrcTyp, lnk.HshTyp, j, ItmTab);
-            HshKey = CalHshKey(&lnk, ItmTab);
-            PtrInt = &BalTab[ i * BalDat->ItmLen + j ];
+         if(!(TpoIdx = NewTpoPar(gml, TpoPar)))
+            goto FreBal;
+
+         DatTab[0] = gml->TypIdx[ SrcTyp ];
+         DatTab[1] = gml->TypIdx[ key->LnkTyp ];
+         DatTab[6] = gml->CntMat[ GmlVertices ][ key->LnkTyp ];
+         DatTab[7] = DatTab[6];
+         DatTab[8] = BalIdx;
+         DatTab[9] = TpoIdx;
+
+         // The key comes with its degree tiers or its packed offsets,
+         // the unused tier arguments pointing to the first one,
+         // and with the inverse permutation of its lines if any
+         for(t=0;t<MAXTIE;t++)
+            DatTab[ 2+t ] = (t < TpoPar[3]) ? gml->TieMat[ GmlVertices ][ key->LnkTyp ][t] : KeyIdx;
+
+         if(TpoPar[11])
+            DatTab[3] = gml->CsrMat[ GmlVertices ][ key->LnkTyp ];
+
+         if(TpoPar[12])
+            DatTab[7] = gml->InvMat[ GmlVertices ][ key->LnkTyp ];
+
+         res = RunTpoKrn(gml, TpoSchKrn, src->NmbLin, 10, DatTab, 767);
+         GmlFreeData((size_t)gml, TpoIdx);
+
+         // The downlinks or neighbours are left unfilled by a failed search
+         if(res != 1)
+            goto FreBal;
+      }
+      else
+      {
+#ifdef _OPENMP
+#pragma omp parallel for private(j, idx, EleNod, ItmTab, HshKey, cpt, cod, VoyTab) if(src->NmbLin >= MINPARLIN)
+#endif
+         for(i=0;i<src->NmbLin;i++)
+         {
+            EleNod = &SrcNod[ (size_t)i * SrcLen ];
 
-            if((cpt = GetHsh(&lnk, HshKey, i, j, ItmTab, cod, NULL)))
+            for(j=0;j<SrcNmbItm;j++)
             {
-               if(dir == -1)
-                  BalTab[ i * BalDat->ItmLen + j ] = cod[0] >> 4;
-               else
+               idx = (size_t)i * BalDat->ItmLen + j;
+
+               ItmTab[0]=ItmTab[1]=ItmTab[2]=ItmTab[3]=0;
+               GetItmNod(EleNod, SrcTyp, HshTyp, j, ItmTab);
+               HshKey = CalHshKey(&lnk, ItmTab);
+
+               if((cpt = GetHsh(&lnk, HshKey, i, j, ItmTab, cod, VoyTab, NULL)))
                {
-                  if(cpt != 2)
-                     BalTab[ i * BalDat->ItmLen + j ] = 0;
-                  else if( ((cod[0] >> 4) != i) || ((cod[0] & 15) != j) )
-                     BalTab[ i * BalDat->ItmLen + j ] = cod[0];
+                  if(dir == -1)
+                     BalTab[ idx ] = cod[0];
+                  else if(cpt != 2)
+                     BalTab[ idx ] = 0;
+                  else if( (cod[0] != i) || (VoyTab[0] != j) )
+                     BalTab[ idx ] = cod[0];
+                  else
+                     BalTab[ idx ] = cod[1];
                }
             }
          }
-      }
 
-      // Upload the ball data to th GPU memory
-      gml->MovSiz += UploadData(gml, BalIdx);
+         // Upload the ball data to th GPU memory
+         UploadData(gml, BalIdx);
+      }
    }
    else if(dir == 1) // More complex case: balls and shells
    {
-      // Allocate the base vector ball table
-      if(!(BalIdx = GetNewDatIdx(gml)))
-         return(0);
+      // Allocate a vector ball table for each degree tier, or the
+      // packed entries table whose width is the maximum degree read
+      for(t=0;t<NmbTie;t++)
+      {
+         if(!(BalIdx = GetNewDatIdx(gml)))
+            goto FreBal;
+
+         if(CsrFlg)
+         {
+            NmbDat = MaxDeg;
+            VecCnt = 1;
+            ItmTyp = GmlInt;
+         }
+         else
+         {
+            NmbDat = TieWid[t];
+            GetCntVec(NmbDat, &VecCnt, &VecSiz, &ItmTyp);
+         }
 
-      NmbDat = LenMatBas[ SrcTyp ][ DstTyp ];
-      GetCntVec(NmbDat, &VecCnt, &VecSiz, &ItmTyp);
+         BalDat = gml->dat[ BalIdx ];
+
+         BalDat->AloTyp = GmlLnkDat;
+         BalDat->MshTyp = SrcTyp;
+         BalDat->LnkTyp = DstTyp;
+         BalDat->MemAcs = GmlInout;
+         BalDat->ItmTyp = ItmTyp;
+         BalDat->NmbItm = VecCnt;
+         BalDat->ItmSiz = VecCnt * OclTypSiz[ ItmTyp ];
+         BalDat->ItmLen = NmbDat;
+         BalDat->NmbLin = CsrFlg ? (int)MAX(DegTot, 1) : MAX(TieLin[ t+1 ] - TieLin[t], 1);
+         BalDat->LinSiz = BalDat->NmbItm * BalDat->ItmSiz;
+         BalDat->MemSiz = (size_t)BalDat->NmbLin * (size_t)BalDat->LinSiz;
+         BalDat->GpuMem = BalDat->CpuMem = NULL;
+         BalDat->nam    = strncpy(BalDat->NamBuf, BalNam, 15);
+         BalDat->VoyNam = VoyNam;
+
+         if(!NewData(gml, BalDat))
+            goto FreBal;
+
+         if(VoyNam && !(TieVoy[t] = NewVoyData(gml, BalIdx)))
+            goto FreBal;
 
-      BalDat = &gml->dat[ BalIdx ];
+         if(gml->DbgFlg)
+         {
+            if(CsrFlg)
+               printf(  "Allocate a packed table with %d entries\n", BalDat->NmbLin);
+            else
+               printf(  "Allocate tier %d with %d lines of %d width vectors\n",
+                        t, BalDat->NmbLin, NmbDat);
+         }
 
-      BalDat->AloTyp = GmlLnkDat;
-      BalDat->MshTyp = SrcTyp;
-      BalDat->LnkTyp = DstTyp;
-      BalDat->MemAcs = GmlInout;
-      BalDat->ItmTyp = ItmTyp;
-      BalDat->NmbItm = VecCnt;
-      BalDat->ItmSiz = VecCnt * OclTypSiz[ ItmTyp ];
-      BalDat->ItmLen = NmbDat;
-      BalDat->NmbLin = MaxPos+1;
-      BalDat->LinSiz = BalDat->NmbItm * BalDat->ItmSiz;
-      BalDat->MemSiz = (size_t)BalDat->NmbLin * (size_t)BalDat->LinSiz;
-      BalDat->GpuMem = BalDat->CpuMem = NULL;
-      BalDat->nam    = BalNam;
-      BalDat->VoyNam = VoyNam;
+         TieIdx[t] = BalIdx;
+         TieTab[t] = BalDat->CpuMem;
+         gml->TieMat[ SrcTyp ][ DstTyp ][t] = BalIdx;
+         gml->TieLin[ SrcTyp ][ DstTyp ][t] = TieLin[t];
+      }
 
-      if(!NewData(gml, BalDat))
-         return(0);
+      // The first tier is the link itself
+      gml->TieLin[ SrcTyp ][ DstTyp ][ NmbTie ] = src->NmbLin;
+      gml->NmbTie[ SrcTyp ][ DstTyp ] = NmbTie;
+      gml->LnkMat[ SrcTyp ][ DstTyp ] = BalIdx = TieIdx[0];
 
-      if(gml->DbgFlg)
-         printf(  "Allocate a base table with %d lines of %d width vectors\n",
-                  BalDat->NmbLin, NmbDat);
+      // Packed entries come with the offsets of each source line's segment
+      if(CsrFlg)
+      {
+         if(!(OffIdx = GetNewDatIdx(gml)))
+            goto FreBal;
+
+         OffDat = gml->dat[ OffIdx ];
+
+         OffDat->AloTyp = GmlLnkDat;
+         OffDat->MshTyp = SrcTyp;
+         OffDat->LnkTyp = DstTyp;
+         OffDat->MemAcs = GmlInout;
+         OffDat->ItmTyp = GmlInt;
+         OffDat->NmbItm = 1;
+         OffDat->ItmSiz = OclTypSiz[ GmlInt ];
+         OffDat->ItmLen = 0;
+         OffDat->NmbLin = src->NmbLin + 1;
+         OffDat->LinSiz = OffDat->NmbItm * OffDat->ItmSiz;
+         OffDat->MemSiz = (size_t)OffDat->NmbLin * (size_t)OffDat->LinSiz;
+         OffDat->GpuMem = OffDat->CpuMem = NULL;
+         sprintf(OffDat->NamBuf, "%s%sOff", BalTypStr[ SrcTyp ], BalTypStr[ DstTyp ]);
+         OffDat->nam    = OffDat->NamBuf;
+
+         if(!NewData(gml, OffDat))
+            goto FreBal;
+
+         OffTab = OffDat->CpuMem;
+         OffTab[0] = 0;
+
+         for(i=0;i<src->NmbLin;i++)
+            OffTab[ i+1 ] = OffTab[i] + DegTab[i];
 
-      gml->LnkMat[ SrcTyp ][ DstTyp ] = BalIdx;
-      bal = &gml->dat[ gml->LnkMat[ src->MshTyp ][ dst->MshTyp ] ];
+         gml->CsrMat[ SrcTyp ][ DstTyp ] = OffIdx;
+      }
 
-      // Allocate the high vector ball table
-      if(HghSiz)
+      if(OclFlg)
       {
-         if(!(HghIdx = GetNewDatIdx(gml)))
-            return(0);
+         // Device counting sort: the offsets are the prefix sum of the
+         // degrees, each key's segment is filled through an atomic cursor
+         // and sorted and stored in its tier's line by its own thread,
+         // packed uplinks keeping the sorted segments and their offsets as is
+         if(!CsrFlg)
+         {
+            if(!(OffIdx = NewTpoDat(gml, src->NmbLin + 1, GmlInt, GmlInout)))
+               goto FreBal;
 
-         NmbDat = gml->SizMatHgh[ SrcTyp ][ DstTyp ];
-         GetCntVec(NmbDat, &VecCnt, &VecSiz, &ItmTyp);
-
-         HghDat = &gml->dat[ HghIdx ];
-
-         HghDat->AloTyp = GmlLnkDat;
-         HghDat->MshTyp = SrcTyp;
-         HghDat->LnkTyp = DstTyp;
-         HghDat->MemAcs = GmlInout;
-         HghDat->ItmTyp = ItmTyp;
-         HghDat->NmbItm = VecCnt;
-         HghDat->ItmSiz = VecCnt * OclTypSiz[ ItmTyp ];
-         HghDat->ItmLen = NmbDat;
-         HghDat->NmbLin = gml->NmbEle[ SrcTyp ] - MaxPos;
-         HghDat->LinSiz = HghDat->NmbItm * HghDat->ItmSiz;
-         HghDat->MemSiz = (size_t)HghDat->NmbLin * (size_t)HghDat->LinSiz;
-         HghDat->GpuMem = HghDat->CpuMem = NULL;
-         HghDat->nam    = BalNam;
-         HghDat->VoyNam = VoyNam;
-
-         if(!NewData(gml, HghDat))
-            return(0);
+            OffTab = gml->dat[ OffIdx ]->CpuMem;
+            OffTab[0] = 0;
 
-         if(gml->DbgFlg)
-            printf(  "Allocate a hash table with %d lines of %d width vectors\n",
-                     HghDat->NmbLin, NmbDat);
+            for(i=0;i<src->NmbLin;i++)
+               OffTab[ i+1 ] = OffTab[i] + DegTab[i];
+         }
 
-         gml->LnkHgh[ SrcTyp ][ DstTyp ] = HghIdx;
-         hgh = &gml->dat[ gml->LnkHgh[ src->MshTyp ][ dst->MshTyp ] ];
-      }
+         UploadData(gml, OffIdx);
 
-      // Fill both ball tables at the same time
-      BalTab = bal->CpuMem;
+         memset(TpoPar, 0, TPOPARSIZ * sizeof(int));
+         TpoPar[0] = DstNmbItm;
+         TpoPar[1] = gml->dat[ KeyIdx ]->ItmLen;
+         TpoPar[5] = VoyNam ? 1 : 0;
+         TpoPar[11] = CsrFlg;
+         TpoPar[12] = PrmIdx ? 1 : 0;
 
-      if(HghSiz)
-         HghTab = hgh->CpuMem;
-      else
-         HghTab = NULL;
+         CurIdx = NewTpoDat(gml, src->NmbLin + 1, GmlInt, GmlInternal);
+         TupIdx = NewTpoDat(gml, (int)MAX(DegTot, 1), GmlInt2, GmlInternal);
+         TpoIdx = NewTpoPar(gml, TpoPar);
+         res = 0;
 
-      if(gml->DbgFlg)
-         puts("Fetching balls from the hash table and filling both low and high degree tables");
+         if(CurIdx && TupIdx && TpoIdx && GmlCopyData((size_t)gml, CurIdx, OffIdx))
+         {
+            DatTab[0] = KeyIdx;
+            DatTab[1] = CurIdx;
+            DatTab[2] = TupIdx;
+            DatTab[3] = TpoIdx;
 
-      for(i=0;i<src->NmbLin;i++)
-      {
-         if(SrcTyp == GmlVertices)
-            EleNod = &i;
-         else
-            EleNod = &SrcNod[ i * SrcLen ];
+            res = RunTpoKrn(gml, TpoSctKrn, dst->NmbLin, 4, DatTab, 9);
+         }
 
-         GetItmNod(EleNod, SrcTyp, lnk.HshTyp, 0, ItmTab);
-         HshKey = CalHshKey(&lnk, ItmTab);
+         GmlFreeData((size_t)gml, TpoIdx);
 
-         if(!HghTab || (i <= MaxPos))
-            GetHsh(&lnk, HshKey, i, 0, ItmTab, &BalTab[ i * BalSiz ], NULL);
-         else
-            GetHsh(&lnk, HshKey, i, 0, ItmTab, &HghTab[ (i - MaxPos) * HghSiz ], NULL);
+         // Each tier is sorted and stored by its own launch
+         for(t=0; (res == 1) && (t < NmbTie); t++)
+         {
+            TpoPar[2] = TieWid[t];
+            TpoPar[4] = TieLin[t];
+
+            if(!(TpoIdx = NewTpoPar(gml, TpoPar)))
+            {
+               res = 0;
+               break;
+            }
+
+            DatTab[0] = OffIdx;
+            DatTab[1] = TupIdx;
+            DatTab[2] = TieIdx[t];
+            DatTab[3] = TieVoy[t] ? gml->dat[ TieIdx[t] ]->VoyIdx : TieIdx[t];
+            DatTab[4] = PrmIdx ? PrmIdx : OffIdx;
+            DatTab[5] = TpoIdx;
+
+            res = RunTpoKrn(gml, TpoSplKrn, TieLin[ t+1 ] - TieLin[t], 6, DatTab, 49);
+            GmlFreeData((size_t)gml, TpoIdx);
+         }
+
+         if(!CsrFlg)
+         {
+            GmlFreeData((size_t)gml, OffIdx);
+            OffIdx = 0;
+         }
+
+         GmlFreeData((size_t)gml, CurIdx);
+         GmlFreeData((size_t)gml, TupIdx);
+
+         if(res != 1)
+            goto FreBal;
       }
+      else
+      {
+         if(gml->DbgFlg)
+            puts("Fetching balls from the hash table and filling all degree tiers");
 
-      if(gml->DbgFlg)
-         puts("Uploading the three tables");
+#ifdef _OPENMP
+#pragma omp parallel for private(p, t, idx, EleNod, ItmTab, HshKey) if(src->NmbLin >= MINPARLIN)
+#endif
+         for(i=0;i<src->NmbLin;i++)
+         {
+            if(SrcTyp == GmlVertices)
+               EleNod = &i;
+            else
+               EleNod = &SrcNod[ (size_t)i * SrcLen ];
+
+            GetItmNod(EleNod, SrcTyp, HshTyp, 0, ItmTab);
+            HshKey = CalHshKey(&lnk, ItmTab);
+
+            // Entity indices and voyeurs are stored in two separate tables
+            // so that the whole 32-bit range is available to the indices
+            if(CsrFlg)
+            {
+               t = 0;
+               idx = (size_t)OffTab[i];
+            }
+            else
+            {
+               p = InvTab ? InvTab[i] : i;
+               for(t=0; p >= TieLin[ t+1 ]; t++);
+               idx = (size_t)(p - TieLin[t]) * TieWid[t];
+            }
 
-      // Upload the ball data to th GPU memory
-      gml->MovSiz += UploadData(gml, BalIdx);
-      gml->MovSiz += UploadData(gml, DegIdx);
+            GetHsh(  &lnk, HshKey, i, 0, ItmTab, &TieTab[t][ idx ],
+                     TieVoy[t] ? &TieVoy[t][ idx ] : NULL, NULL );
+         }
+
+         if(gml->DbgFlg)
+            puts("Uploading the ball, degree and voyeur tables");
+
+         // Upload the ball data to th GPU memory
+         UploadData(gml, DegIdx);
 
-      if(HghSiz)
-         gml->MovSiz += UploadData(gml, HghIdx);
+         if(CsrFlg)
+            UploadData(gml, OffIdx);
+
+         for(t=0;t<NmbTie;t++)
+         {
+            UploadData(gml, TieIdx[t]);
+
+            if(TieVoy[t])
+               UploadData(gml, gml->dat[ TieIdx[t] ]->VoyIdx);
+         }
+      }
 
       if(gml->DbgFlg)
       {
          puts(sep);
          printf(  "Ball generation: type %s -> %s\n",
                   BalTypStr[ SrcTyp ], BalTypStr[ DstTyp ] );
-         printf(  "low degree ranging from 1 to %d, occupency = %g%%\n",
-                  MaxPos, (float)(100 * DegTot) / (float)(MaxPos * BalSiz) );
 
-         if(HghSiz)
-            printf(  "high degree entities = %d\n", src->NmbLin - MaxPos);
+         if(CsrFlg)
+            printf(  "packed entries = %zu, maximum degree read = %d\n",
+                     DegTot, MaxDeg );
+         else
+            printf(  "%d degree tiers, occupency = %g%%\n",
+                     NmbTie, (100. * DegTot) / (double)MAX(PadTot, 1) );
 
          printf(  "Allocated degree     data: index=%2d, size=%zu bytes\n",
                   DegIdx, DegDat->MemSiz );
-         printf(  "Allocated short ball data: index=%2d, size=%zu bytes\n",
-                  BalIdx, BalDat->MemSiz );
 
-         if(HghSiz)
-            printf(  "Allocated long ball  data: index=%2d, size=%zu bytes\n",
-                     HghIdx, HghDat->MemSiz );
+         for(t=0;t<NmbTie;t++)
+            printf(  "Allocated ball tier %d data: index=%2d, size=%zu bytes\n",
+                     t, TieIdx[t], gml->dat[ TieIdx[t] ]->MemSiz );
+
+         if(CsrFlg)
+            printf(  "Allocated offsets    data: index=%2d, size=%zu bytes\n",
+                     OffIdx, OffDat->MemSiz );
       }
    }
 
-   free(lnk.HshTab);
-   free(lnk.DatTab);
+   if(!OclFlg)
+      FreeHsh(&lnk);
+
+   return(BalIdx);
+
+   // Release the hash table and the tables built so far, which clears them
+   // from the link matrices, along with any slot whose allocation failed
+FreBal:
+   if(!OclFlg)
+      FreeHsh(&lnk);
+
+   LstIdx[0] = DegIdx;
+   LstIdx[1] = PrmIdx;
+   LstIdx[2] = InvIdx;
+   LstIdx[3] = OffIdx;
+   LstIdx[4] = BalIdx;
+
+   for(t=0;t<MAXTIE;t++)
+      LstIdx[ 5+t ] = TieIdx[t];
+
+   for(t=0;t<MAXTIE+5;t++)
+   {
+      if(!LstIdx[t])
+         continue;
+
+      if(gml->dat[ LstIdx[t] ]->GpuMem)
+         GmlFreeData((size_t)gml, LstIdx[t]);
+      else
+         memset(gml->dat[ LstIdx[t] ], 0, sizeof(DatSct));
+   }
 
    return(0);
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Allocate and fill a vectorized sparse matrix from a CSR input              */
+/* Get the power of two width bucket of a ball or shell line from its degree  */
 /*----------------------------------------------------------------------------*/
 
-int GmlNewMatrix( size_t GmlIdx, int NmbLin, int NmbBlk, int BlkSiz,
-                  void *val, int *col, int *lin, int FltTyp )
+static int GetDegBuc(int deg, int BalSiz, int MaxSiz)
 {
-   char     *PtrCol, *PtrVal, src[ GmlMaxSrcSiz ] = "\0";
-   char     PrcNam[100], OptStr[100] = "\0";
-   int      i, j, k, deg, vec;
-   int      VecNmbLin[9] = {-1,-1,-1,-1,-1,-1,-1,-1,-1};
-   int      *VecCol[9], PowTab[256], LenTab[9], MatIdx, FltSiz, SlcSiz, *IntPtr;
-   float    *FltVal = (float *)val;
-   double   *DblVal = (double *)val;
-   size_t   ValSiz, ColSiz, VecNnz = 0;
-   DatSct   *dat;
-   MatSct   *mat;
+   int b, wid;
 
-   GETGMLPTR(gml, GmlIdx);
+   for(  b=0, wid = MAX(BalSiz / 2, 1);
+         (wid < deg) && (wid < MaxSiz) && (b < MAXTIE-1);
+         b++, wid *= 2 );
 
-   if(NmbLin < 1 || NmbBlk < 1 || BlkSiz < 1 || BlkSiz > 10)
-      return(0);
+   return(b);
+}
 
-   if(!(MatIdx = GetNewMatIdx(gml)))
-      return(0);
 
-   mat = &gml->mat[ MatIdx ];
-   memset(mat, 0, sizeof(MatSct));
+/*----------------------------------------------------------------------------*/
+/* Split the lines of a ball or shell into power of two width degree tiers    */
+/* and return their number, along with each bucket's first sorted position,   */
+/* the total degree and the padded size                                       */
+/*----------------------------------------------------------------------------*/
 
-   mat->use = 1;
-   mat->NmbLin = NmbLin;
-   mat->BlkSiz = BlkSiz;
-   mat->FltTyp = FltTyp;
-   FltSiz = FltTyp == GmlFlt ? sizeof(float) : sizeof(double);
+static int GetTieLay(int NmbLin, int *DegTab, int BalSiz, int MaxSiz, int *TieLin,
+                     int *TieWid, int *BucPos, size_t *DegTot, size_t *PadTot)
+{
+   int i, b, p, t, n, beg, NmbTie = 0, BucLin[ MAXTIE ] = {0};
+
+   *DegTot = *PadTot = 0;
 
-   if(BlkSiz == 4)
+   // Bin the lines into power of two degree buckets,
+   // from half the base width up to the maximum one
+   for(i=0;i<NmbLin;i++)
    {
-      mat->NmbValTyp = 1;
-      mat->MatValSiz[0] = 16;
-      mat->VecValSiz = 4;
+      b = GetDegBuc(DegTab[i], BalSiz, MaxSiz);
+      BucLin[b]++;
+      *DegTot += DegTab[i];
    }
-   else if(BlkSiz == 5)
+
+   // Each non empty bucket makes a tier: the lines are stored in
+   // increasing width order through an internal permutation
+   for(b=p=0;b<MAXTIE;b++)
    {
-      mat->NmbValTyp = 3;
-      mat->MatValSiz[0] = 16;
-      mat->MatValSiz[1] = 8;
-      mat->MatValSiz[2] = 1;
-      mat->VecValSiz = 8;
+      BucPos[b] = p;
+
+      if(BucLin[b])
+      {
+         TieLin[ NmbTie ] = p;
+         TieWid[ NmbTie ] = MAX(BalSiz / 2, 1) << b;
+         NmbTie++;
+      }
+
+      p += BucLin[b];
    }
-   else if(BlkSiz == 7)
+
+   if(!NmbTie)
    {
-      mat->NmbValTyp = 4;
-      mat->MatValSiz[0] = 16;
-      mat->MatValSiz[1] = 16;
-      mat->MatValSiz[2] = 16;
-      mat->MatValSiz[3] = 1;
-      mat->VecValSiz = 8;
+      TieLin[0] = 0;
+      TieWid[0] = BalSiz;
+      NmbTie = 1;
    }
-   else
-      return(0);
 
-   for(i=0;i<=16;i++)
-      PowTab[i] = 4;
+   TieLin[ NmbTie ] = NmbLin;
 
-   for(i=17;i<=32;i++)
-      PowTab[i] = 5;
+   // A tier too short to be worth a kernel launch is merged into the next one
+   for(t=n=beg=0;t<NmbTie;t++)
+   {
+      if( (t < NmbTie-1) && (TieLin[ t+1 ] - beg < TIEMINLIN) )
+         continue;
 
-   for(i=33;i<=64;i++)
-      PowTab[i] = 6;
+      TieWid[n] = TieWid[t];
+      TieLin[n] = beg;
+      beg = TieLin[ t+1 ];
+      n++;
+   }
 
-   for(i=65;i<=128;i++)
-      PowTab[i] = 7;
+   NmbTie = n;
+   TieLin[ NmbTie ] = NmbLin;
 
-   for(i=128;i<256;i++)
-      PowTab[i] = 8;
+   for(t=0;t<NmbTie;t++)
+      *PadTot += (size_t)(TieLin[ t+1 ] - TieLin[t]) * TieWid[t];
 
-   for(i=0;i<mat->NmbLin;i++)
-   {
-      deg = lin[i+1] - lin[i];
+   return(NmbTie);
+}
 
-      if(deg > 256)
-         return(0);
 
-      if(VecNmbLin[ PowTab[ deg ] ] == -1)
-         VecNmbLin[ PowTab[ deg ] ] = i;
+/*----------------------------------------------------------------------------*/
+/* Allocate a downlink or neighbours table: one vector line per source item   */
+/*----------------------------------------------------------------------------*/
+
+static int NewDwnLnk(GmlSct *gml, int SrcTyp, int DstTyp, char *BalNam)
+{
+   int      BalIdx, NmbDat, VecCnt, VecSiz, ItmTyp;
+   DatSct   *BalDat;
+
+   if(!(BalIdx = GetNewDatIdx(gml)))
+      return(0);
+
+   NmbDat = LenMatBas[ SrcTyp ][ DstTyp ];
+   GetCntVec(NmbDat, &VecCnt, &VecSiz, &ItmTyp);
+
+   BalDat = gml->dat[ BalIdx ];
+
+   BalDat->AloTyp = GmlLnkDat;
+   BalDat->MshTyp = SrcTyp;
+   BalDat->LnkTyp = DstTyp;
+   BalDat->MemAcs = GmlInout;
+   BalDat->ItmTyp = ItmTyp;
+   BalDat->NmbItm = VecCnt;
+   BalDat->ItmSiz = VecCnt * OclTypSiz[ ItmTyp ];
+   BalDat->ItmLen = NmbDat;
+   BalDat->NmbLin = gml->dat[ gml->TypIdx[ SrcTyp ] ]->NmbLin;
+   BalDat->LinSiz = BalDat->NmbItm * BalDat->ItmSiz;
+   BalDat->MemSiz = (size_t)BalDat->NmbLin * (size_t)BalDat->LinSiz;
+   BalDat->GpuMem = BalDat->CpuMem = NULL;
+   BalDat->nam    = strncpy(BalDat->NamBuf, BalNam, 15);
+
+   if(!NewData(gml, BalDat))
+   {
+      memset(BalDat, 0, sizeof(DatSct));
+      return(0);
    }
 
-   for(i=0;i<=8;i++)
-      if(VecNmbLin[i] != -1)
-      {
-         mat->MatSlc[ mat->NmbSlc ][0] = 1 << i;
-         mat->MatSlc[ mat->NmbSlc ][1] = VecNmbLin[i];
+   gml->LnkMat[ SrcTyp ][ DstTyp ] = BalIdx;
 
-         if(i <= 4)
-         {
-            mat->MatSlc[ mat->NmbSlc ][2] = 1 << i;
-            mat->MatSlc[ mat->NmbSlc ][3] = 1;
-            mat->MatSlc[ mat->NmbSlc ][4] = OclVecPow[i];
-         }
-         else
-         {
-            mat->MatSlc[ mat->NmbSlc ][2] = 16;
-            mat->MatSlc[ mat->NmbSlc ][3] = 1 << (i-4);
-            mat->MatSlc[ mat->NmbSlc ][4] = OclVecPow[4];
-         }
+   return(BalIdx);
+}
 
-         mat->NmbSlc++;
-      }
 
-   mat->MatSlc[ mat->NmbSlc ][1] = mat->NmbLin;
+/*----------------------------------------------------------------------------*/
+/* Release all the tables of a link: tiers, degrees, offsets and permutation  */
+/*----------------------------------------------------------------------------*/
 
-   printf(" Matrix slices = %d\n", mat->NmbSlc);
+static void FreeLnkDat(GmlSct *gml, int SrcTyp, int DstTyp)
+{
+   int i, NmbTab = 0, TabIdx[ MAXTIE + 5 ];
 
-   // Set the variable size column and values
-   for(i=0;i<mat->NmbSlc;i++)
-   {
-      SlcSiz = mat->MatSlc[ i+1 ][1] - mat->MatSlc[i][1];
-      ValSiz = SlcSiz * mat->MatSlc[i][0] * mat->BlkSiz * mat->BlkSiz * FltSiz;
-      ColSiz = SlcSiz * mat->MatSlc[i][0] * sizeof(int);
-      VecNnz += SlcSiz * mat->MatSlc[i][0];
-      printf("  slice %d, width = %3d, length = %9d\n",i+1, mat->MatSlc[i][0], SlcSiz);
+   // Collect them first as freeing a tier clears the number of tiers
+   for(i=0;i<gml->NmbTie[ SrcTyp ][ DstTyp ];i++)
+      TabIdx[ NmbTab++ ] = gml->TieMat[ SrcTyp ][ DstTyp ][i];
 
-      // Set degree data
-      if(!(mat->DegIdx[i] = GetNewDatIdx(gml)))
-         return(0);
+   if(!gml->NmbTie[ SrcTyp ][ DstTyp ])
+      TabIdx[ NmbTab++ ] = gml->LnkMat[ SrcTyp ][ DstTyp ];
 
-      dat = &gml->dat[ mat->DegIdx[i] ];
+   TabIdx[ NmbTab++ ] = gml->CntMat[ SrcTyp ][ DstTyp ];
+   TabIdx[ NmbTab++ ] = gml->CsrMat[ SrcTyp ][ DstTyp ];
+   TabIdx[ NmbTab++ ] = gml->PrmMat[ SrcTyp ][ DstTyp ];
+   TabIdx[ NmbTab++ ] = gml->InvMat[ SrcTyp ][ DstTyp ];
 
-      memset(dat, 0, sizeof(DatSct));
+   for(i=0;i<NmbTab;i++)
+      if(TabIdx[i])
+         GmlFreeData((size_t)gml, TabIdx[i]);
+}
 
-      dat->AloTyp = GmlRawDat;
-      dat->MshTyp = GmlMatDat;
-      dat->MemAcs = GmlInput;
-      dat->ItmTyp = GmlInt;
-      dat->NmbItm = 1;
-      dat->ItmSiz = OclTypSiz[ GmlInt ];
-      dat->ItmLen = 1;
-      dat->NmbLin = SlcSiz;
-      dat->LinSiz = dat->NmbItm * dat->ItmSiz;
-      dat->MemSiz = (size_t)dat->NmbLin * (size_t)dat->LinSiz;
-      dat->GpuMem = dat->CpuMem = NULL;
-      dat->use    = 1;
 
-      if(!NewData(gml, dat))
-         return(0);
+/*----------------------------------------------------------------------------*/
+/* Allocate a face shell made of a single tier with voyeurs, and its degrees  */
+/*----------------------------------------------------------------------------*/
 
-      IntPtr = (int *)dat->CpuMem;
+static int NewFacShl(GmlSct *gml, int FacTyp, int EleTyp)
+{
+   int      BalIdx, DegIdx, NmbDat, VecCnt, VecSiz, ItmTyp;
+   char     VoyNam[ GmlMaxStrSiz ];
+   DatSct   *BalDat, *DegDat;
 
-      for(j=0;j<SlcSiz;j++)
-         IntPtr[j] = lin[ mat->MatSlc[i][1] + j + 1 ] - lin[ mat->MatSlc[i][1] + j ];
+   if(!(DegIdx = GetNewDatIdx(gml)))
+      return(0);
 
-      gml->MovSiz += UploadData(gml, mat->DegIdx[i]);
+   DegDat = gml->dat[ DegIdx ];
+
+   DegDat->AloTyp = GmlLnkDat;
+   DegDat->MshTyp = FacTyp;
+   DegDat->LnkTyp = EleTyp;
+   DegDat->MemAcs = GmlInout;
+   DegDat->ItmTyp = GmlInt;
+   DegDat->NmbItm = 1;
+   DegDat->ItmSiz = OclTypSiz[ GmlInt ];
+   DegDat->ItmLen = 0;
+   DegDat->NmbLin = gml->NmbEle[ FacTyp ];
+   DegDat->LinSiz = DegDat->NmbItm * DegDat->ItmSiz;
+   DegDat->MemSiz = (size_t)DegDat->NmbLin * (size_t)DegDat->LinSiz;
+   DegDat->GpuMem = DegDat->CpuMem = NULL;
+   sprintf(DegDat->NamBuf, "%s%sDeg", BalTypStr[ FacTyp ], BalTypStr[ EleTyp ]);
+   DegDat->nam    = DegDat->NamBuf;
+
+   if(!NewData(gml, DegDat))
+      return(0);
 
-      // Set column data
-      if(!(mat->ColIdx[i] = GetNewDatIdx(gml)))
-         return(0);
+   gml->CntMat[ FacTyp ][ EleTyp ] = DegIdx;
 
-      dat = &gml->dat[ mat->ColIdx[i] ];
-      memset(dat, 0, sizeof(DatSct));
+   if(!(BalIdx = GetNewDatIdx(gml)))
+      return(0);
 
-      dat->AloTyp = GmlRawDat;
-      dat->MshTyp = GmlMatDat;
-      dat->MemAcs = GmlInput;
-      dat->ItmTyp = mat->MatSlc[i][4];
-      dat->NmbItm = mat->MatSlc[i][3];
-      dat->ItmSiz = OclTypSiz[ dat->ItmTyp ];
-      dat->ItmLen = TypVecSiz[ dat->ItmTyp ];
-      dat->NmbLin = SlcSiz;
-      dat->LinSiz = dat->NmbItm * dat->ItmSiz;
-      dat->MemSiz = (size_t)dat->NmbLin * (size_t)dat->LinSiz;
-      dat->GpuMem = dat->CpuMem = NULL;
-      dat->use    = 1;
+   NmbDat = LenMatBas[ FacTyp ][ EleTyp ];
+   GetCntVec(NmbDat, &VecCnt, &VecSiz, &ItmTyp);
 
-       if(!NewData(gml, dat))
-         return(0);
+   BalDat = gml->dat[ BalIdx ];
+
+   BalDat->AloTyp = GmlLnkDat;
+   BalDat->MshTyp = FacTyp;
+   BalDat->LnkTyp = EleTyp;
+   BalDat->MemAcs = GmlInout;
+   BalDat->ItmTyp = ItmTyp;
+   BalDat->NmbItm = VecCnt;
+   BalDat->ItmSiz = VecCnt * OclTypSiz[ ItmTyp ];
+   BalDat->ItmLen = NmbDat;
+   BalDat->NmbLin = gml->NmbEle[ FacTyp ];
+   BalDat->LinSiz = BalDat->NmbItm * BalDat->ItmSiz;
+   BalDat->MemSiz = (size_t)BalDat->NmbLin * (size_t)BalDat->LinSiz;
+   BalDat->GpuMem = BalDat->CpuMem = NULL;
+   sprintf(BalDat->NamBuf, "%s%sBal", BalTypStr[ FacTyp ], BalTypStr[ EleTyp ]);
+   BalDat->nam    = BalDat->NamBuf;
+   sprintf(VoyNam, "%s%sVoy", BalTypStr[ FacTyp ], BalTypStr[ EleTyp ]);
+   BalDat->VoyNam = VoyNam;
+
+   if(!NewData(gml, BalDat) || !NewVoyData(gml, BalIdx))
+      return(0);
 
-      PtrCol = (char *)dat->CpuMem;
+   gml->TieMat[ FacTyp ][ EleTyp ][0] = BalIdx;
+   gml->TieLin[ FacTyp ][ EleTyp ][0] = 0;
+   gml->TieLin[ FacTyp ][ EleTyp ][1] = BalDat->NmbLin;
+   gml->NmbTie[ FacTyp ][ EleTyp ] = 1;
+   gml->LnkMat[ FacTyp ][ EleTyp ] = BalIdx;
 
-      for(j=mat->MatSlc[i][1]; j<mat->MatSlc[ i+1 ][1]; j++)
-      {
-         memcpy(PtrCol, &col[ lin[j] ], (lin[j+1] - lin[j]) * sizeof(int) );
-         PtrCol += dat->LinSiz;
-      }
+   return(BalIdx);
+}
 
-      gml->MovSiz += UploadData(gml, mat->ColIdx[i]);
 
-      // Set the matrix values
-      if(!(mat->ValIdx[i] = GetNewDatIdx(gml)))
-         return(0);
+/*----------------------------------------------------------------------------*/
+/* Make sure the host mirrors of all the tables of a ball or shell are valid  */
+/*----------------------------------------------------------------------------*/
 
-      dat = &gml->dat[ mat->ValIdx[i] ];
-      memset(dat, 0, sizeof(DatSct));
+static int GetHostBall(GmlSct *gml, int SrcTyp, int DstTyp)
+{
+   int i, t, idx, TabIdx[8], NmbTab = 0;
 
-      dat->AloTyp = GmlRawDat;
-      dat->MshTyp = GmlMatDat;
-      dat->MemAcs = GmlInput;
-      dat->ItmTyp = mat->FltTyp;
-      dat->NmbItm = mat->MatSlc[i][0] * BlkSiz * BlkSiz;
-      dat->ItmSiz = OclTypSiz[ dat->ItmTyp ];
-      dat->ItmLen = TypVecSiz[ dat->ItmTyp ];
-      dat->NmbLin = SlcSiz;
-      dat->LinSiz = dat->NmbItm * dat->ItmSiz;
-      dat->MemSiz = (size_t)dat->NmbLin * (size_t)dat->LinSiz;
-      dat->GpuMem = dat->CpuMem = NULL;
-      dat->use    = 1;
+   if(!gml->CntMat[ SrcTyp ][ DstTyp ] || !gml->LnkMat[ SrcTyp ][ DstTyp ])
+      return(0);
 
-      if(!NewData(gml, dat))
-         return(0);
+   TabIdx[ NmbTab++ ] = gml->CntMat[ SrcTyp ][ DstTyp ];
+   TabIdx[ NmbTab++ ] = gml->CsrMat[ SrcTyp ][ DstTyp ];
+   TabIdx[ NmbTab++ ] = gml->PrmMat[ SrcTyp ][ DstTyp ];
+   TabIdx[ NmbTab++ ] = gml->InvMat[ SrcTyp ][ DstTyp ];
 
-      PtrVal = (char *)dat->CpuMem;
+   for(t=0;t<gml->NmbTie[ SrcTyp ][ DstTyp ];t++)
+      TabIdx[ NmbTab++ ] = gml->TieMat[ SrcTyp ][ DstTyp ][t];
 
-      if(FltTyp == GmlFlt)
-      {
-         for(j=mat->MatSlc[i][1]; j<mat->MatSlc[ i+1 ][1]; j++)
-         {
-            memcpy(  PtrVal, &FltVal[ lin[j] * BlkSiz * BlkSiz ],
-                     (lin[j+1] - lin[j]) * BlkSiz * BlkSiz * FltSiz );
+   for(i=0;i<NmbTab;i++)
+   {
+      if(!(idx = TabIdx[i]))
+         continue;
 
-            PtrVal += dat->LinSiz;
-         }
-      }
-      else
-      {
-         for(j=mat->MatSlc[i][1]; j<mat->MatSlc[ i+1 ][1]; j++)
-         {
-            memcpy(  PtrVal, &DblVal[ lin[j] * BlkSiz * BlkSiz ],
-                     (lin[j+1] - lin[j]) * BlkSiz * BlkSiz * FltSiz );
+      if(!GetHostLines(gml, idx, 0, gml->dat[ idx ]->NmbLin - 1))
+         return(0);
 
-            PtrVal += dat->LinSiz;
-         }
+      if( gml->dat[ idx ]->VoyIdx
+      && !GetHostLines(gml, gml->dat[ idx ]->VoyIdx, 0, gml->dat[ idx ]->NmbLin - 1) )
+      {
+         return(0);
       }
+   }
 
-      // Upload this matrix slice to the GPU memory
-      gml->MovSiz += UploadData(gml, mat->ValIdx[i]);
+   return(1);
+}
 
-      sprintf(PrcNam, "MulMatVecSlc%d", mat->MatSlc[i][0]);
 
-      if(FltTyp == GmlFlt)
-         sprintf(OptStr, " -DBLKSIZ=%d -DREAL32 ", BlkSiz);
-      else
-         sprintf(OptStr, " -DBLKSIZ=%d ", BlkSiz);
+/*----------------------------------------------------------------------------*/
+/* Get the host row of a ball or shell line along with its width and          */
+/* voyeurs, the table storing it and its row in this table                    */
+/*----------------------------------------------------------------------------*/
 
-      GmlSetCompilerOptions(GmlIdx, OptStr);
-      mat->KrnIdx[i] = NewOclKrn(gml, multmatvec, PrcNam);
+static int *GetBalRow(  GmlSct *gml, int SrcTyp, int DstTyp, int lin,
+                        int *wid, char **voy, int *BalIdx, int *RowIdx )
+{
+   int      t, pos, NmbTie, *OffTab, *InvTab;
+   size_t   idx;
+   DatSct   *bal;
+
+   if(gml->CsrMat[ SrcTyp ][ DstTyp ])
+   {
+      // Packed entries are located through their offsets
+      OffTab   = (int *)gml->dat[ gml->CsrMat[ SrcTyp ][ DstTyp ] ]->CpuMem;
+      *BalIdx  = gml->LnkMat[ SrcTyp ][ DstTyp ];
+      *RowIdx  = OffTab[ lin ];
+      *wid     = OffTab[ lin+1 ] - OffTab[ lin ];
+      idx      = (size_t)OffTab[ lin ];
    }
+   else
+   {
+      // Other lines are stored at their permuted position in their tier
+      InvTab   = gml->InvMat[ SrcTyp ][ DstTyp ]
+               ? (int *)gml->dat[ gml->InvMat[ SrcTyp ][ DstTyp ] ]->CpuMem : NULL;
+      pos      = InvTab ? InvTab[ lin ] : lin;
+      NmbTie   = gml->NmbTie[ SrcTyp ][ DstTyp ];
 
-   mat->MemAcc += ((float)(NmbLin * BlkSiz)
-               +   (float)(NmbBlk * BlkSiz * (BlkSiz + 1))) * FltSiz;
+      for(t=0; (t < NmbTie-1) && (pos >= gml->TieLin[ SrcTyp ][ DstTyp ][ t+1 ]); t++);
 
-   mat->FltOpp = (float)NmbBlk * BlkSiz * BlkSiz * 2;
+      *BalIdx  = gml->TieMat[ SrcTyp ][ DstTyp ][t];
+      *RowIdx  = pos - gml->TieLin[ SrcTyp ][ DstTyp ][t];
+      *wid     = gml->dat[ *BalIdx ]->ItmLen;
+      idx      = (size_t)*RowIdx * *wid;
+   }
 
-   printf("  sparse nnz = %d, vectorized nnz = %zu, occupency = %.1f%%\n",
-            NmbBlk, VecNnz, (100. * NmbBlk) / VecNnz);
-   printf("  swipe = %.2f GB, %.2f GFlops\n", mat->MemAcc / 1.E9, mat->FltOpp / 1.E9);
+   bal = gml->dat[ *BalIdx ];
 
-   return(MatIdx);
+   if(voy)
+      *voy = bal->VoyIdx ? (char *)gml->dat[ bal->VoyIdx ]->CpuMem + idx : NULL;
+
+   return((int *)bal->CpuMem + idx);
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Allocate and fill a block vector                                           */
+/* Flag a modified row of a vector link table and of its voyeurs: tables      */
+/* made of several vectors are sized per vector, so a row lies within the     */
+/* line whose rank is the row's one divided by the number of vectors          */
 /*----------------------------------------------------------------------------*/
 
-int GmlNewVector(size_t GmlIdx, int NmbLin, int BlkSiz, void *val, int FltTyp)
+static void SetDirtyRow(GmlSct *gml, int idx, int row)
 {
-   char     *PtrVal, src[ GmlMaxSrcSiz ] = "\0";
-   char     PrcNam[100], OptStr[100] = "\0";
-   int      i, j;
-   int      VecIdx, *IntPtr;
-   float    *FltVal = (float *)val;
-   double   *DblVal = (double *)val;
-   DatSct   *dat;
-   VecSct   *vec;
+   DatSct *dat = gml->dat[ idx ];
 
-   GETGMLPTR(gml, GmlIdx);
+   SetDirtyLines(gml, idx, row / dat->NmbItm, row / dat->NmbItm);
 
-   if(NmbLin < 1 || BlkSiz < 1 || BlkSiz > 64)
-      return(0);
+   if(dat->VoyIdx)
+      SetDirtyLines(gml, dat->VoyIdx, row / dat->NmbItm, row / dat->NmbItm);
+}
 
-   if(!(VecIdx = GetNewVecIdx(gml)))
-      return(0);
 
-   vec = &gml->vec[ VecIdx ];
-   memset(vec, 0, sizeof(VecSct));
+/*----------------------------------------------------------------------------*/
+/* Host version of the device search: look for the entities sharing an item   */
+/* in the ball of one of its vertices and return the first one for downlinks, */
+/* and for neighbours the other element sharing it if there is only one,      */
+/* or -1 if there is none                                                     */
+/*----------------------------------------------------------------------------*/
 
-   vec->use = 1;
-   vec->NmbLin = NmbLin;
-   vec->BlkSiz = BlkSiz;
-   vec->FltTyp = FltTyp;
-   vec->FltSiz = (FltTyp == GmlFlt) ? sizeof(float) : sizeof(double);
+static int SchBal(GmlSct *gml, int KeyTyp, int *ItmNod, int NmbNod, int EleIdx, int dir)
+{
+   int      i, k, m, d, n, v, wid, hit, cpt = 0, res = -1, BalIdx, RowIdx;
+   int      *row = NULL, *DegTab, *KeyNod;
+   DatSct   *key = gml->dat[ gml->TypIdx[ KeyTyp ] ];
 
-   if(BlkSiz == 1)
-   {
-      vec->NmbValTyp = 1;
-      vec->VecValSiz = 1;
-   }
-   else if(BlkSiz == 2)
-   {
-      vec->NmbValTyp = 1;
-      vec->VecValSiz = 2;
-   }
-   else if(BlkSiz <= 4)
-   {
-      vec->NmbValTyp = 1;
-      vec->VecValSiz = 4;
-   }
-   else if(BlkSiz <= 8)
-   {
-      vec->NmbValTyp = 1;
-      vec->VecValSiz = 8;
-   }
-   else if(BlkSiz <= 16)
-   {
-      vec->NmbValTyp = 1;
-      vec->VecValSiz = 16;
-   }
-   else if(BlkSiz <= 32)
-   {
-      vec->NmbValTyp = 2;
-      vec->VecValSiz = 16;
-   }
-   else if(BlkSiz <= 48)
+   DegTab = (int *)gml->dat[ gml->CntMat[ GmlVertices ][ KeyTyp ] ]->CpuMem;
+   KeyNod = (int *)key->CpuMem;
+
+   // Ball lines are truncated to the widest tier: use the first vertex
+   // whose line is complete or scan the whole key table if there is none
+   for(v=0;v<NmbNod;v++)
    {
-      vec->NmbValTyp = 3;
-      vec->VecValSiz = 16;
+      row = GetBalRow(gml, GmlVertices, KeyTyp, ItmNod[v], &wid, NULL, &BalIdx, &RowIdx);
+
+      if(DegTab[ ItmNod[v] ] <= wid)
+         break;
    }
+
+   if(v < NmbNod)
+      n = DegTab[ ItmNod[v] ];
    else
    {
-      vec->NmbValTyp = 4;
-      vec->VecValSiz = 16;
+      row = NULL;
+      n = key->NmbLin;
    }
 
-   // Set the vector values
-   if(!(vec->idx = GetNewDatIdx(gml)))
-      return(0);
+   for(i=0;i<n;i++)
+   {
+      d = row ? row[i] : i;
+      hit = 1;
 
-   dat = &gml->dat[ vec->idx ];
-   memset(dat, 0, sizeof(DatSct));
+      for(k=0;k<NmbNod;k++)
+      {
+         hit = 0;
 
-   dat->AloTyp = GmlRawDat;
-   dat->MshTyp = GmlVecDat;
-   dat->MemAcs = GmlInput;
-   dat->ItmTyp = vec->FltTyp;
-   dat->NmbItm = vec->NmbValTyp * vec->VecValSiz;
-   dat->ItmSiz = OclTypSiz[ dat->ItmTyp ];
-   dat->ItmLen = TypVecSiz[ dat->ItmTyp ];
-   dat->NmbLin = vec->NmbLin;
-   dat->LinSiz = dat->NmbItm * dat->ItmSiz;
-   dat->MemSiz = (size_t)dat->NmbLin * (size_t)dat->LinSiz;
-   dat->GpuMem = dat->CpuMem = NULL;
-   dat->use    = 1;
+         for(m=0;m<EleNmbNod[ KeyTyp ];m++)
+            if(KeyNod[ (size_t)d * key->ItmLen + m ] == ItmNod[k])
+               hit = 1;
 
-   if(!NewData(gml, dat))
-      return(0);
+         if(!hit)
+            break;
+      }
 
-   PtrVal = (char *)dat->CpuMem;
+      if(!hit)
+         continue;
 
-   if(FltTyp == GmlFlt)
-   {
-      for(i=0;i<NmbLin;i++)
-      {
-         memcpy(PtrVal, &FltVal[ i * BlkSiz ], BlkSiz * vec->FltSiz);
-         PtrVal += dat->LinSiz;
-      }
-   }
-   else
-   {
-      for(i=0;i<NmbLin;i++)
+      cpt++;
+
+      if(dir == -1)
       {
-         memcpy(PtrVal, &DblVal[ i * BlkSiz ], BlkSiz * vec->FltSiz);
-         PtrVal += dat->LinSiz;
+         if(cpt == 1)
+            res = d;
       }
+      else if(d != EleIdx)
+         res = d;
    }
 
-   // Upload this vector to the GPU memory
-   gml->MovSiz += UploadData(gml, vec->idx);
-
-   if(FltTyp == GmlFlt)
-      sprintf(OptStr, " -DBLKSIZ=%d -DREAL32 ", BlkSiz);
-   else
-      sprintf(OptStr, " -DBLKSIZ=%d ", BlkSiz);
-
-   GmlSetCompilerOptions(GmlIdx, OptStr);
-   vec->AddKrnIdx = NewOclKrn(gml, addvec, "AddVec");
-   vec->SclKrnIdx = NewOclKrn(gml, scalevec, "ScaleVec");
-   vec->MulDiaKrnIdx = NewOclKrn(gml, multdiagmatvec, "MultDiaglMatVec");
-   vec->NrmKrnIdx = NewOclKrn(gml, normvec, "L2Norm");
+   if( (dir == 0) && (cpt != 2) )
+      res = -1;
 
-   return(VecIdx);
+   return(res);
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Extract an element's entity node table                                     */
+/* Remove an element's entry from a ball or shell line                        */
 /*----------------------------------------------------------------------------*/
 
-static void GetItmNod(  int *EleNod, int EleTyp,
-                        int ItmTyp, int ItmIdx, int *ItmTab )
+static void DelBalEnt(  GmlSct *gml, int SrcTyp, int DstTyp,
+                        int lin, int EleIdx, int ItmIdx )
 {
-   int i, j, tmp;
+   int      k, n, wid, BalIdx, RowIdx, *row, *DegTab;
+   char     *voy;
 
-   // Copy the hashed entity's vertices to the return table
-   switch(ItmTyp)
-   {
-      case GmlVertices :
-      {
-         ItmTab[0] = EleNod[ ItmIdx ];
-      }return;
+   row = GetBalRow(gml, SrcTyp, DstTyp, lin, &wid, &voy, &BalIdx, &RowIdx);
+   DegTab = (int *)gml->dat[ gml->CntMat[ SrcTyp ][ DstTyp ] ]->CpuMem;
+   n = MIN(DegTab[ lin ], wid);
 
-      case GmlEdges :
-      {
-         i = EleNod[ ItmEdgNod[ EleTyp ][ ItmIdx ][0] ];
-         j = EleNod[ ItmEdgNod[ EleTyp ][ ItmIdx ][1] ];
-         ItmTab[0] = MIN(i,j);
-         ItmTab[1] = MAX(i,j);
-      }return;
+   for(k=0;k<n;k++)
+      if( (row[k] == EleIdx) && (!voy || (voy[k] == ItmIdx)) )
+         break;
 
-      case GmlTriangles :
+   // Shift the following entries and clear the freed slot
+   if(k < n)
+   {
+      for(;k<n-1;k++)
       {
-         for(i=0;i<3;i++)
-            ItmTab[i] = EleNod[ ItmFacNod[ EleTyp ][ ItmIdx ][i] ];
+         row[k] = row[ k+1 ];
 
-         // Sort the vertices to speed-up further comparison
-         for(i=0;i<3;i++)
-            for(j=i+1;j<3;j++)
-               if(ItmTab[i] > ItmTab[j])
-               {
-                  tmp       = ItmTab[i];
-                  ItmTab[i] = ItmTab[j];
-                  ItmTab[j] = tmp;
-               }
-      }return;
+         if(voy)
+            voy[k] = voy[ k+1 ];
+      }
 
-      case GmlQuadrilaterals :
-      {
-         for(i=0;i<4;i++)
-            ItmTab[i] = EleNod[ ItmFacNod[ EleTyp ][ ItmIdx ][i] ];
+      row[ n-1 ] = 0;
 
-         // Sort the vertices to speed-up further comparison
-         for(i=0;i<4;i++)
-            for(j=i+1;j<4;j++)
-               if(ItmTab[i] > ItmTab[j])
-               {
-                  tmp       = ItmTab[i];
-                  ItmTab[i] = ItmTab[j];
-                  ItmTab[j] = tmp;
-               }
-      }return;
+      if(voy)
+         voy[ n-1 ] = 0;
+
+      SetDirtyRow(gml, BalIdx, RowIdx);
    }
+
+   DegTab[ lin ]--;
+   SetDirtyLines(gml, gml->CntMat[ SrcTyp ][ DstTyp ], lin, lin);
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Compute a hash key based on a node table and a hash table size             */
+/* Insert an element's entry in a ball or shell line, in increasing element   */
+/* and item order, and move the line to a wider tier if it gets too long:     */
+/* return 0 if it could not and the entry was dropped                         */
 /*----------------------------------------------------------------------------*/
 
-static int CalHshKey(HshTabSct *lnk, int *ItmTab)
+static int AddBalEnt(   GmlSct *gml, int SrcTyp, int DstTyp, int lin,
+                        int EleIdx, int ItmIdx, int *CurTab )
 {
-   int i, k = 0, wei[4] = {3,5,7,11};
+   int      k, n, wid, res = 1, BalIdx, RowIdx, *row, *DegTab;
+   char     *voy;
 
-   if(lnk->DatLen == 1)
-      return(ItmTab[0]);
-
-   for(i=0;i<lnk->DatLen;i++)
-      k += wei[i] * ItmTab[i];
-
-   return(k % lnk->TabSiz);
-}
+   DegTab = (int *)gml->dat[ gml->CntMat[ SrcTyp ][ DstTyp ] ]->CpuMem;
+   row = GetBalRow(gml, SrcTyp, DstTyp, lin, &wid, &voy, &BalIdx, &RowIdx);
+   DegTab[ lin ]++;
+   SetDirtyLines(gml, gml->CntMat[ SrcTyp ][ DstTyp ], lin, lin);
 
+   if(DegTab[ lin ] > wid)
+   {
+      res = SwpBalLin(gml, SrcTyp, DstTyp, lin, CurTab);
+      row = GetBalRow(gml, SrcTyp, DstTyp, lin, &wid, &voy, &BalIdx, &RowIdx);
+   }
 
-/*----------------------------------------------------------------------------*/
-/* Add a pair element/entity to the hash table and handle any collision       */
-/*----------------------------------------------------------------------------*/
+   n = DegTab[ lin ] - 1;
 
-static void AddHsh(  HshTabSct *lnk, int HshKey, int EleTyp,
-                     int EleIdx, int ItmIdx, int *ItmTab )
-{
-   int i, nxt;
-   BucSct *buc;
+   // Lines longer than the widest tier are truncated, as when building them
+   if(n >= wid)
+      return(res);
 
-   if(lnk->NxtDat == lnk->NmbDat)
+   for(k=n; (k > 0) && ( (row[ k-1 ] > EleIdx)
+   || (voy && (row[ k-1 ] == EleIdx) && (voy[ k-1 ] > ItmIdx)) ); k--)
    {
-      lnk->NmbDat *= 2;
-      lnk->DatTab = realloc(lnk->DatTab, lnk->NmbDat * sizeof(BucSct));
+      row[k] = row[ k-1 ];
+
+      if(voy)
+         voy[k] = voy[ k-1 ];
    }
 
-   nxt = lnk->HshTab[ HshKey ];
-   lnk->HshTab[ HshKey ] = lnk->NxtDat;
-   buc = &lnk->DatTab[ lnk->NxtDat ];
-   buc->EleTyp = EleTyp;
-   buc->EleIdx = EleIdx;
-   buc->ItmIdx = ItmIdx;
-   buc->NxtDat = nxt;
+   row[k] = EleIdx;
 
-   for(i=0;i<lnk->DatLen;i++)
-      buc->nod[i] = ItmTab[i];
+   if(voy)
+      voy[k] = (char)ItmIdx;
 
-   lnk->NxtDat++;
+   SetDirtyRow(gml, BalIdx, RowIdx);
 
-   if(nxt)
-      lnk->NmbMis++;
-   else
-      lnk->NmbHit++;
+   return(res);
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Fetch an element/entity pair from the hash table                           */
+/* Promote a line whose degree outgrew its tier by swapping its position with */
+/* a line of a wider tier whose degree fits in the narrower one, which gets   */
+/* demoted, CurTab giving where to resume the search in each tier             */
 /*----------------------------------------------------------------------------*/
 
-static int GetHsh(   HshTabSct *lnk, int HshKey, int EleIdx,
-                     int ItmIdx, int *ItmTab, int *UsrTab, int *TypTab )
+static int SwpBalLin(GmlSct *gml, int SrcTyp, int DstTyp, int lin, int *CurTab)
 {
-   int i, flg, deg = 0;
-   BucSct *buc;
+   int      i, k, t, u, pos, oth, NmbTie, *TieLin, *DegTab, *PrmTab, *InvTab;
+   int      wid[2], BalIdx[2], RowIdx[2], *row[2], n[2], TmpRow[ 1 << VECPOWMAX ];
+   char     *voy[2], TmpVoy[ 1 << VECPOWMAX ];
 
-   if(!lnk->HshTab[ HshKey ])
+   if(!gml->PrmMat[ SrcTyp ][ DstTyp ])
       return(0);
 
-   buc = &lnk->DatTab[ lnk->HshTab[ HshKey ] ];
+   NmbTie = gml->NmbTie[ SrcTyp ][ DstTyp ];
+   TieLin = gml->TieLin[ SrcTyp ][ DstTyp ];
+   DegTab = (int *)gml->dat[ gml->CntMat[ SrcTyp ][ DstTyp ] ]->CpuMem;
+   PrmTab = (int *)gml->dat[ gml->PrmMat[ SrcTyp ][ DstTyp ] ]->CpuMem;
+   InvTab = (int *)gml->dat[ gml->InvMat[ SrcTyp ][ DstTyp ] ]->CpuMem;
+   pos = InvTab[ lin ];
 
-   while(buc)
-   {
-      flg = 1;
+   for(t=0; (t < NmbTie-1) && (pos >= TieLin[ t+1 ]); t++);
 
-      for(i=0;i<lnk->DatLen;i++)
-         if(buc->nod[i] != ItmTab[i])
-         {
-            flg = 0;
-            break;
-         }
+   if(t == NmbTie-1)
+      return(1);
 
-      if(flg)
-      {
-         if(UsrTab)
-            UsrTab[ deg ] = (buc->EleIdx << 4) | buc->ItmIdx;
+   wid[0] = gml->dat[ gml->TieMat[ SrcTyp ][ DstTyp ][t] ]->ItmLen;
 
-         if(TypTab)
-            TypTab[ deg ] = buc->EleTyp;
+   // Pick the narrowest wider tier able to store the new degree
+   for(u=t+1; (u < NmbTie-1)
+   && (gml->dat[ gml->TieMat[ SrcTyp ][ DstTyp ][u] ]->ItmLen < DegTab[ lin ]); u++);
 
-         deg++;
-      }
+   // And look for a line of this tier that fits in the narrower one
+   for(k=MAX(CurTab[u], TieLin[u]); k < TieLin[ u+1 ]; k++)
+      if( (PrmTab[k] != lin) && (DegTab[ PrmTab[k] ] <= wid[0]) )
+         break;
+
+   CurTab[u] = k + 1;
+
+   if(k >= TieLin[ u+1 ])
+      return(0);
 
-      if(!buc->NxtDat)
-         return(deg);
+   oth = PrmTab[k];
+   row[0] = GetBalRow(gml, SrcTyp, DstTyp, lin, &wid[0], &voy[0], &BalIdx[0], &RowIdx[0]);
+   row[1] = GetBalRow(gml, SrcTyp, DstTyp, oth, &wid[1], &voy[1], &BalIdx[1], &RowIdx[1]);
+   n[0] = MIN(DegTab[ lin ] - 1, wid[0]);
+   n[1] = MIN(DegTab[ oth ], wid[1]);
 
-      buc = &lnk->DatTab[ buc->NxtDat ];
+   // Swap both rows and voyeurs, clearing the slots left unused
+   memcpy(TmpRow, row[0], n[0] * sizeof(int));
+
+   if(voy[0])
+      memcpy(TmpVoy, voy[0], n[0]);
+
+   for(i=0;i<wid[0];i++)
+   {
+      row[0][i] = (i < n[1]) ? row[1][i] : 0;
+
+      if(voy[0])
+         voy[0][i] = (i < n[1]) ? voy[1][i] : 0;
    }
 
-   return(0);
+   for(i=0;i<wid[1];i++)
+   {
+      row[1][i] = (i < n[0]) ? TmpRow[i] : 0;
+
+      if(voy[1])
+         voy[1][i] = (i < n[0]) ? TmpVoy[i] : 0;
+   }
+
+   SetDirtyRow(gml, BalIdx[0], RowIdx[0]);
+   SetDirtyRow(gml, BalIdx[1], RowIdx[1]);
+
+   // Then exchange their positions
+   PrmTab[ pos ] = oth;
+   PrmTab[k] = lin;
+   InvTab[ lin ] = k;
+   InvTab[ oth ] = pos;
+   SetDirtyLines(gml, gml->PrmMat[ SrcTyp ][ DstTyp ], MIN(pos, k), MAX(pos, k));
+   SetDirtyLines(gml, gml->InvMat[ SrcTyp ][ DstTyp ], MIN(lin, oth), MAX(lin, oth));
+
+   return(1);
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Find and return a free data slot in the GML structure                      */
+/* Refill a packed uplink as a whole since changing any degree shifts all the */
+/* following offsets: the number of entries does not change                   */
 /*----------------------------------------------------------------------------*/
 
-static int GetNewDatIdx(GmlSct *gml)
+static void SetCsrBal(GmlSct *gml, int SrcTyp, int DstTyp)
 {
-   for(int i=1;i<=GmlMaxDat;i++)
-      if(!gml->dat[i].use)
+   int      i, j, k, NmbKey, *KeyTab, *DegTab, *OffTab, *BalTab;
+   char     *VoyTab;
+   DatSct   *dst, *key, *deg, *off, *bal;
+
+   dst = gml->dat[ gml->TypIdx[ DstTyp ] ];
+   deg = gml->dat[ gml->CntMat[ SrcTyp ][ DstTyp ] ];
+   off = gml->dat[ gml->CsrMat[ SrcTyp ][ DstTyp ] ];
+   bal = gml->dat[ gml->LnkMat[ SrcTyp ][ DstTyp ] ];
+   DegTab = (int *)deg->CpuMem;
+   OffTab = (int *)off->CpuMem;
+   BalTab = (int *)bal->CpuMem;
+   VoyTab = bal->VoyIdx ? (char *)gml->dat[ bal->VoyIdx ]->CpuMem : NULL;
+
+   // Vertex balls are keyed by the elements' nodes
+   // and shells by the elements' downlinks
+   if(SrcTyp == GmlVertices)
+   {
+      key = dst;
+      NmbKey = EleNmbNod[ DstTyp ];
+   }
+   else
+   {
+      key = gml->dat[ gml->LnkMat[ DstTyp ][ SrcTyp ] ];
+      NmbKey = NmbTpoLnk[ DstTyp ][ SrcTyp ];
+   }
+
+   memset(DegTab, 0, deg->MemSiz);
+
+   for(i=0;i<dst->NmbLin;i++)
+   {
+      KeyTab = (int *)((char *)key->CpuMem + (size_t)i * (key->LinSiz / key->NmbItm));
+
+      for(j=0;j<NmbKey;j++)
+         DegTab[ KeyTab[j] ]++;
+   }
+
+   OffTab[0] = 0;
+
+   for(i=0;i<deg->NmbLin;i++)
+      OffTab[ i+1 ] = OffTab[i] + DegTab[i];
+
+   // Scanning the elements in order stores them sorted in each line
+   for(i=0;i<dst->NmbLin;i++)
+   {
+      KeyTab = (int *)((char *)key->CpuMem + (size_t)i * (key->LinSiz / key->NmbItm));
+
+      for(j=0;j<NmbKey;j++)
       {
-         gml->dat[i].use = 1;
-         return(i);
+         k = OffTab[ KeyTab[j] ]++;
+         BalTab[k] = i;
+
+         if(VoyTab)
+            VoyTab[k] = (char)j;
       }
+   }
 
-   return(0);
+   for(i=deg->NmbLin;i>0;i--)
+      OffTab[i] = OffTab[ i-1 ];
+
+   OffTab[0] = 0;
+
+   SetDirtyLines(gml, gml->CntMat[ SrcTyp ][ DstTyp ], 0, deg->NmbLin - 1);
+   SetDirtyLines(gml, gml->CsrMat[ SrcTyp ][ DstTyp ], 0, off->NmbLin - 1);
+   SetDirtyLines(gml, gml->LnkMat[ SrcTyp ][ DstTyp ], 0, bal->NmbLin - 1);
+
+   if(bal->VoyIdx)
+      SetDirtyLines(gml, bal->VoyIdx, 0, bal->NmbLin - 1);
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Find and return a free matrix slot in the GML structure                    */
+/* Allocate a char table with the same vector layout as a ball or shell       */
 /*----------------------------------------------------------------------------*/
 
-static int GetNewMatIdx(GmlSct *gml)
+static int NewChrTab(GmlSct *gml, int BalIdx, const char *nam)
 {
-   for(int i=1;i<=GmlMaxMat;i++)
-      if(!gml->mat[i].use)
-      {
-         gml->mat[i].use = 1;
-         return(i);
-      }
+   int      ChrIdx;
+   DatSct   *bal = gml->dat[ BalIdx ], *chr;
 
-   return(0);
+   if(!(ChrIdx = GetNewDatIdx(gml)))
+      return(0);
+
+   // Same vector layout as the ball table, with char instead of int items
+   chr = gml->dat[ ChrIdx ];
+   chr->AloTyp = GmlLnkDat;
+   chr->MshTyp = bal->MshTyp;
+   chr->LnkTyp = bal->LnkTyp;
+   chr->MemAcs = GmlInout;
+   chr->ItmTyp = GmlByt + bal->ItmTyp - GmlInt;
+   chr->NmbItm = bal->NmbItm;
+   chr->ItmSiz = bal->NmbItm * OclTypSiz[ chr->ItmTyp ];
+   chr->ItmLen = bal->ItmLen;
+   chr->NmbLin = bal->NmbLin;
+   chr->LinSiz = chr->NmbItm * chr->ItmSiz;
+   chr->MemSiz = (size_t)chr->NmbLin * (size_t)chr->LinSiz;
+   chr->GpuMem = chr->CpuMem = NULL;
+   chr->nam    = strncpy(chr->NamBuf, nam, 15);
+
+   if(!NewData(gml, chr))
+   {
+      memset(chr, 0, sizeof(DatSct));
+      return(0);
+   }
+
+   return(ChrIdx);
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Find and return a free vector slot in the GML structure                    */
+/* Allocate the char table that stores a ball or shell voyeurs                */
 /*----------------------------------------------------------------------------*/
 
-static int GetNewVecIdx(GmlSct *gml)
+static char *NewVoyData(GmlSct *gml, int BalIdx)
 {
-   for(int i=1;i<=GmlMaxVec;i++)
-      if(!gml->vec[i].use)
-      {
-         gml->vec[i].use = 1;
-         return(i);
-      }
+   int      VoyIdx;
+   DatSct   *bal = gml->dat[ BalIdx ], *voy;
 
-   return(0);
+   if(!(VoyIdx = NewChrTab(gml, BalIdx, bal->VoyNam)))
+      return(NULL);
+
+   // Point the ball to its voyeurs table and name
+   voy = gml->dat[ VoyIdx ];
+   bal->VoyIdx = VoyIdx;
+   bal->VoyNam = voy->nam;
+
+   return(voy->CpuMem);
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Allocate an OpenCL buffer                                                  */
+/* Get the table giving the device builder's keys, build it if need be        */
 /*----------------------------------------------------------------------------*/
 
-static int NewData(GmlSct *gml, DatSct *dat)
+static int GetTpoKey(GmlSct *gml, int SrcTyp, int DstTyp, int dir, int *KeyIdx)
 {
-   int MemAcs[4] = {0, CL_MEM_READ_ONLY, CL_MEM_WRITE_ONLY, CL_MEM_READ_WRITE};
+   int  KeyTyp;
+   char BalNam[ GmlMaxStrSiz ], DegNam[ GmlMaxStrSiz ];
 
-   // Allocate the requested memory size on the GPU
-   dat->GpuMem = clCreateBuffer( gml->context, MemAcs[ dat->MemAcs ],
-                                 dat->MemSiz, NULL, NULL );
+   *KeyIdx = 0;
 
-   if(!dat->GpuMem)
+   // Vertex balls are sorted by the destination elements' vertices
+   if( (dir == 1) && (SrcTyp == GmlVertices) )
    {
-      printf(  "Cannot allocate %zd MB on the GPU (%zd MB already used)\n",
-               dat->MemSiz / MB, GmlGetMemoryUsage((size_t)gml) / MB);
-      return(0);
+      *KeyIdx = gml->TypIdx[ DstTyp ];
+      return(*KeyIdx ? 1 : 0);
    }
 
-   // Allocate the requested memory size on the CPU side
-   if( (dat->MemAcs != GmlInternal) && !(dat->CpuMem = calloc(1, dat->MemSiz)) )
+   // Shells are sorted by the destination elements' downlinks and
+   // downlinks or neighbours are searched in the vertex balls
+   if(dir == 1)
    {
-      printf("Cannot allocate %zd MB on the CPU\n", dat->MemSiz/MB);
+      if(!gml->LnkMat[ DstTyp ][ SrcTyp ])
+      {
+         sprintf(BalNam, "%s%sLnk", BalTypStr[ DstTyp ], BalTypStr[ SrcTyp ]);
+         sprintf(DegNam, "%s%sDeg", BalTypStr[ DstTyp ], BalTypStr[ SrcTyp ]);
+         NewBallData(gml, DstTyp, SrcTyp, BalNam, DegNam, NULL);
+      }
+
+      *KeyIdx = gml->LnkMat[ DstTyp ][ SrcTyp ];
+      return(*KeyIdx ? 1 : 0);
+   }
+
+   KeyTyp = (dir == -1) ? DstTyp : SrcTyp;
+
+   if( (KeyTyp == GmlVertices) || (NgbTyp[ SrcTyp ] < 0) || !gml->TypIdx[ KeyTyp ] )
       return(0);
+
+   if(!gml->LnkMat[ GmlVertices ][ KeyTyp ])
+   {
+      sprintf(BalNam, "%s%sBal", BalTypStr[ GmlVertices ], BalTypStr[ KeyTyp ]);
+      sprintf(DegNam, "%s%sDeg", BalTypStr[ GmlVertices ], BalTypStr[ KeyTyp ]);
+      NewBallData(gml, GmlVertices, KeyTyp, BalNam, DegNam, NULL);
    }
 
-   // Keep track of allocated memory
-   gml->MemSiz += dat->MemSiz;
+   *KeyIdx = gml->LnkMat[ GmlVertices ][ KeyTyp ];
 
-   return(1);
+   return( (*KeyIdx && gml->CntMat[ GmlVertices ][ KeyTyp ]) ? 1 : 0 );
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Release an OpenCL buffer                                                   */
+/* Allocate a scratch table used by the device topology builder               */
 /*----------------------------------------------------------------------------*/
 
-int GmlFreeData(size_t GmlIdx, int idx)
+static int NewTpoDat(GmlSct *gml, int NmbLin, int ItmTyp, int MemAcs)
 {
-   GETGMLPTR(gml, GmlIdx);
-   DatSct *dat = &gml->dat[ idx ];
-
-   // Free both GPU and CPU memory buffers
-   if( (idx >= 1) && (idx <= GmlMaxDat) && dat->GpuMem )
-   {
-      if(clReleaseMemObject(dat->GpuMem) != CL_SUCCESS)
-         return(0);
+   int      idx;
+   DatSct   *dat;
 
-      dat->GpuMem = NULL;
-      dat->use = 0;
-      gml->MemSiz -= dat->MemSiz;
+   if(!(idx = GetNewDatIdx(gml)))
+      return(0);
 
-      if(dat->CpuMem)
-         free(dat->CpuMem);
+   dat = gml->dat[ idx ];
+   dat->AloTyp = GmlRawDat;
+   dat->MshTyp = GmlVertices;
+   dat->LnkTyp = 0;
+   dat->MemAcs = MemAcs;
+   dat->ItmTyp = ItmTyp;
+   dat->NmbItm = 1;
+   dat->ItmSiz = OclTypSiz[ ItmTyp ];
+   dat->ItmLen = TypVecSiz[ ItmTyp ];
+   dat->NmbLin = NmbLin;
+   dat->LinSiz = dat->NmbItm * dat->ItmSiz;
+   dat->MemSiz = (size_t)dat->NmbLin * (size_t)dat->LinSiz;
+   dat->GpuMem = dat->CpuMem = NULL;
+   dat->nam    = "topology";
 
-      return(1);
-   }
-   else
+   if(!NewData(gml, dat))
+   {
+      memset(dat, 0, sizeof(DatSct));
       return(0);
+   }
+
+   return(idx);
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Set a line of mesh, link or solution data                                  */
+/* Upload the 64 integer parameters of a topology kernel                      */
 /*----------------------------------------------------------------------------*/
 
-int GmlSetDataLine(size_t GmlIdx, int idx, int lin, ...)
+static int NewTpoPar(GmlSct *gml, int *TpoPar)
 {
-   GETGMLPTR(gml, GmlIdx);
-   CHKDATIDX(gml, idx);
-   DatSct   *dat = &gml->dat[ idx ], *RefDat;
-   char     *adr = (void *)dat->CpuMem;
-   int      i, *EleTab, siz, *RefTab, *tab, RefIdx = 0;
-   float    *CrdTab;
-   va_list  VarArg;
-
-   va_start(VarArg, lin);
-
-   if(dat->AloTyp == GmlRawDat)
-   {
-      memcpy(&adr[ lin * dat->LinSiz ], va_arg(VarArg, void *), dat->LinSiz);
-   }
-   else if(dat->AloTyp == GmlLnkDat)
-   {
-      tab = (int *)dat->CpuMem;
-
-      for(i=0;i<dat->NmbItm;i++)
-         tab[ lin * dat->NmbItm + i ] = va_arg(VarArg, int);
-   }
-   else if( (dat->AloTyp == GmlEleDat) && (dat->MshTyp == GmlVertices) )
-   {
-      CrdTab = (float *)dat->CpuMem;
-      RefIdx = gml->RefIdx[ dat->MshTyp ];
-      RefDat = &gml->dat[ RefIdx ];
-      RefTab = (int *)RefDat->CpuMem;
-      siz = 4;
-
-      for(i=0;i<3;i++)
-         CrdTab[ lin * siz + i ] = (float)va_arg(VarArg, double);
-
-      CrdTab[ lin * siz + 3 ] = 0.;
-      RefTab[ lin ] = va_arg(VarArg, int);
-   }
-   else if( (dat->AloTyp == GmlEleDat) && (dat->MshTyp > GmlVertices) )
-   {
-      EleTab = (int *)dat->CpuMem;
-      siz = TypVecSiz[ MshItmTyp[ dat->MshTyp ] ];
-      RefIdx = gml->RefIdx[ dat->MshTyp ];
-      RefDat = &gml->dat[ RefIdx ];
-      RefTab = (int *)RefDat->CpuMem;
-
-      for(i=0;i<EleNmbNod[ dat->MshTyp ];i++)
-         EleTab[ lin * siz + i ] = va_arg(VarArg, int);
+   int idx;
 
-      RefTab[ lin ] = va_arg(VarArg, int);
-   }
-
-   va_end(VarArg);
-
-   if(lin == dat->NmbLin - 1)
-   {
-      gml->MovSiz += UploadData(gml, idx);
+   if(!(idx = NewTpoDat(gml, TPOPARSIZ, GmlInt, GmlInput)))
+      return(0);
 
-      if(RefIdx)
-         gml->MovSiz += UploadData(gml, RefIdx);
-   }
+   memcpy(gml->dat[ idx ]->CpuMem, TpoPar, TPOPARSIZ * sizeof(int));
+   UploadData(gml, idx);
 
-   return(1);
+   return(idx);
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Get a line of solution or vertex coordinates from the librarie's buffers   */
+/* Set the arguments of a topology kernel and run it                          */
 /*----------------------------------------------------------------------------*/
 
-int GmlGetDataLine(size_t GmlIdx, int idx, int lin, ...)
+static int RunTpoKrn(GmlSct *gml, int KrnTyp, int NmbLin,
+                     int NmbDat, int *DatTab, int RedMsk )
 {
-   GETGMLPTR(gml, GmlIdx);
-   CHKDATIDX(gml, idx);
-   DatSct   *dat = &gml->dat[ idx ], *RefDat;
-   char     *adr = (void *)dat->CpuMem;
-   int      i, *EleTab, siz, *RefTab, RefIdx = 0, *UsrDat;
-   float    *GpuCrd;
-   double   *UsrCrd;
-   va_list  VarArg;
-
-   if(lin == 0)
-      gml->MovSiz += DownloadData(gml, idx);
+   int      i, res, HstBeg[16], HstEnd[16];
+   char     *TpoNam[ MaxTpoKrn ] = {"tpo_count", "tpo_scatter", "tpo_split", "tpo_search"};
+   KrnSct   *krn;
 
-   va_start(VarArg, lin);
+   // The four kernels share the same program, compiled on first use
+   if(!gml->TpoKrn[ KrnTyp ])
+      gml->TpoKrn[ KrnTyp ] = NewOclKrn(gml, topology, TpoNam[ KrnTyp ], 1);
 
-   if(dat->AloTyp == GmlRawDat)
+   if(!gml->TpoKrn[ KrnTyp ])
    {
-      memcpy(va_arg(VarArg, void *), &adr[ lin * dat->LinSiz ], dat->LinSiz);
+      printf("Failed to compile the %s topology kernel\n", TpoNam[ KrnTyp ]);
+      return(-5);
    }
-   else if( (dat->AloTyp == GmlEleDat) && (dat->MshTyp == GmlVertices) )
-   {
-      GpuCrd = (float *)dat->CpuMem;
 
-      for(i=0;i<3;i++)
-      {
-         UsrCrd = va_arg(VarArg, double *);
-         *UsrCrd = (double)GpuCrd[ lin*dat->LinSiz + i ];
-      }
-   }
-   else if( (dat->AloTyp == GmlEleDat) && (dat->MshTyp > GmlVertices) )
+   // The same kernel is run on different tables: reset its arguments
+   krn = gml->krn[ gml->TpoKrn[ KrnTyp ] ];
+   krn->NmbDat = NmbDat;
+   krn->NmbLin[0] = NmbLin;
+   krn->IniFlg = 0;
+
+   for(i=0;i<NmbDat;i++)
    {
-      EleTab = (int *)dat->CpuMem;
-      siz = TypVecSiz[ MshItmTyp[ dat->MshTyp ] ];
-      RefIdx = gml->RefIdx[ dat->MshTyp ];
-      RefDat = &gml->dat[ RefIdx ];
-      RefTab = (int *)RefDat->CpuMem;
+      krn->DatTab[i] = DatTab[i];
+      HstBeg[i] = gml->dat[ DatTab[i] ]->HstBeg;
+      HstEnd[i] = gml->dat[ DatTab[i] ]->HstEnd;
+   }
 
-      for(i=0;i<EleNmbNod[ dat->MshTyp ];i++)
+   res = RunOclKrn(gml, krn);
+
+   // Tables that are only read keep their valid host copy
+   for(i=0;i<NmbDat;i++)
+      if(RedMsk & (1 << i))
       {
-         UsrDat = va_arg(VarArg, int *);
-         *UsrDat = EleTab[ lin * siz + i ];
+         gml->dat[ DatTab[i] ]->HstBeg = HstBeg[i];
+         gml->dat[ DatTab[i] ]->HstEnd = HstEnd[i];
       }
 
-      UsrDat = va_arg(VarArg, int *);
-      *UsrDat = RefTab[ lin ];
-   }
-
-   va_end(VarArg);
-
-   return(1);
+   return(res);
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Set a range of mesh data lines in a row                                    */
+/* Allocate and fill a vectorized sparse matrix from a CSR input              */
 /*----------------------------------------------------------------------------*/
 
-int GmlSetDataBlock( size_t GmlIdx, int   TypIdx,
-                     int    BegIdx, int   EndIdx,
-                     void  *DatBeg, void *DatEnd,
-                     int   *RefBeg, int  *RefEnd )
+int GmlNewMatrix( size_t GmlIdx, int NmbLin, int NmbBlk, int BlkSiz,
+                  void *val, int *col, int *lin, int FltTyp )
 {
+   char     *PtrCol, *PtrVal, src[ GmlMaxSrcSiz ] = "\0";
+   char     PrcNam[100], OptStr[100] = "\0";
+   int      i, j, k, deg, vec;
+   int      VecNmbLin[9] = {-1,-1,-1,-1,-1,-1,-1,-1,-1};
+   int      *VecCol[9], PowTab[256], LenTab[9], MatIdx, FltSiz, SlcSiz, *IntPtr;
+   float    *FltVal = (float *)val;
+   double   *DblVal = (double *)val;
+   size_t   ValSiz, ColSiz, VecNnz = 0;
+   DatSct   *dat;
+   MatSct   *mat;
+
    GETGMLPTR(gml, GmlIdx);
-   CHKELETYP(TypIdx);
-   int      DatIdx = gml->TypIdx[ TypIdx ], RefIdx = gml->RefIdx[ TypIdx ];
-   DatSct   *dat = &gml->dat[ DatIdx ], *RefDat;
-   int      i, j, *EleTab, siz, *RefTab, *UsrRef, *UsrEle;
-   float    *CrdTab, *UsrCrd;
-   size_t   DatLen, RefLen;
 
-   if( (EndIdx <= BegIdx) || (dat->AloTyp != GmlEleDat) )
+   if(NmbLin < 1 || NmbBlk < 1 || BlkSiz < 1 || BlkSiz > 10)
       return(0);
 
-   if(dat->MshTyp == GmlVertices)
-   {
-      CrdTab = (float *)dat->CpuMem;
-      RefIdx = gml->RefIdx[ TypIdx ];
-      RefDat = &gml->dat[ RefIdx ];
-      RefTab = (int *)RefDat->CpuMem;
-      UsrCrd = (float *)DatBeg;
-      UsrRef = (int *)RefBeg;
-      DatLen = ((float *)DatEnd - (float *)DatBeg) / (EndIdx - BegIdx);
-      RefLen = (RefEnd - RefBeg) / (EndIdx - BegIdx);
+   if(!(MatIdx = GetNewMatIdx(gml)))
+      return(0);
 
-      for(i=BegIdx;i<=EndIdx;i++)
-      {
-         for(j=0;j<3;j++)
-            CrdTab[ i * 4 + j ] = UsrCrd[ (i - BegIdx) * DatLen + j ];
+   mat = gml->mat[ MatIdx ];
+   memset(mat, 0, sizeof(MatSct));
 
-         CrdTab[ i * 4 + 3 ] = 0.;
+   mat->use = 1;
+   mat->NmbLin = NmbLin;
+   mat->BlkSiz = BlkSiz;
+   mat->FltTyp = FltTyp;
+   FltSiz = FltTyp == GmlFlt ? sizeof(float) : sizeof(double);
 
-         if(UsrRef)
-            RefTab[i] = UsrRef[ (i - BegIdx) * RefLen ];
-      }
+   // Odd block sizes may be stored without padding and accessed with vloadn
+   if( (gml->VecLay == GmlPacked) && (BlkSiz == 5 || BlkSiz == 7) )
+   {
+      mat->PckFlg = 1;
+      mat->NmbValTyp = 1;
+      mat->MatValSiz[0] = BlkSiz * BlkSiz;
+      mat->VecValSiz = BlkSiz;
    }
-   else
+   else if(BlkSiz == 4)
    {
-      EleTab = (int *)dat->CpuMem;
-      RefIdx = gml->RefIdx[ TypIdx ];
-      siz    = TypVecSiz[ MshItmTyp[ dat->MshTyp ] ];
-      RefDat = &gml->dat[ gml->RefIdx[ dat->MshTyp ] ];
-      RefTab = (int *)RefDat->CpuMem;
-      UsrEle = (int *)DatBeg;
-      UsrRef = (int *)RefBeg;
-      DatLen = ((int *)DatEnd - (int *)DatBeg) / (EndIdx - BegIdx);
-      RefLen = (RefEnd - RefBeg) / (EndIdx - BegIdx);
-
-      for(i=BegIdx;i<=EndIdx;i++)
-      {
-         for(j=0; j<EleNmbNod[ dat->MshTyp ]; j++)
-            EleTab[ i * siz + j ] =  UsrEle[ (i - BegIdx) * DatLen + j ];
-
-         if(UsrRef)
-            RefTab[i] = UsrRef[ (i - BegIdx) * RefLen ];
-      }
+      mat->NmbValTyp = 1;
+      mat->MatValSiz[0] = 16;
+      mat->VecValSiz = 4;
    }
-
-   if(EndIdx == dat->NmbLin - 1)
+   else if(BlkSiz == 5)
+   {
+      mat->NmbValTyp = 3;
+      mat->MatValSiz[0] = 16;
+      mat->MatValSiz[1] = 8;
+      mat->MatValSiz[2] = 1;
+      mat->VecValSiz = 8;
+   }
+   else if(BlkSiz == 7)
    {
-      gml->MovSiz += UploadData(gml, DatIdx);
-      gml->MovSiz += UploadData(gml, RefIdx);
+      mat->NmbValTyp = 4;
+      mat->MatValSiz[0] = 16;
+      mat->MatValSiz[1] = 16;
+      mat->MatValSiz[2] = 16;
+      mat->MatValSiz[3] = 1;
+      mat->VecValSiz = 8;
    }
+   else
+      return(0);
 
-   return(1);
-}
+   for(i=0;i<=16;i++)
+      PowTab[i] = 4;
 
+   for(i=17;i<=32;i++)
+      PowTab[i] = 5;
 
-/*----------------------------------------------------------------------------*/
-/* Get a range mesh data lines in a row                                       */
-/*----------------------------------------------------------------------------*/
+   for(i=33;i<=64;i++)
+      PowTab[i] = 6;
 
-int GmlGetDataBlock( size_t GmlIdx, int   TypIdx,
-                     int    BegIdx, int   EndIdx,
-                     void  *DatBeg, void *DatEnd,
-                     int   *RefBeg, int  *RefEnd )
-{
-   GETGMLPTR(gml, GmlIdx);
-   CHKELETYP(TypIdx);
-   int      DatIdx = gml->TypIdx[ TypIdx ], RefIdx = gml->RefIdx[ TypIdx ];
-   DatSct   *dat = &gml->dat[ DatIdx ], *RefDat;
-   int      i, j, *EleTab, siz, *RefTab, *UsrRef, *UsrEle;
-   float    *CrdTab, *UsrCrd;
-   size_t   DatLen, RefLen;
+   for(i=65;i<=128;i++)
+      PowTab[i] = 7;
 
-   if( (EndIdx <= BegIdx) || (dat->AloTyp != GmlEleDat) )
-      return(0);
+   for(i=128;i<256;i++)
+      PowTab[i] = 8;
 
-   if(BegIdx == 0)
+   for(i=0;i<mat->NmbLin;i++)
    {
-      gml->MovSiz += DownloadData(gml, DatIdx);
-      gml->MovSiz += DownloadData(gml, RefIdx);
-   }
+      deg = lin[i+1] - lin[i];
 
-   if(dat->MshTyp == GmlVertices)
-   {
-      CrdTab = (float *)dat->CpuMem;
-      RefDat = &gml->dat[ RefIdx ];
-      RefTab = (int *)RefDat->CpuMem;
-      UsrCrd = (float *)DatBeg;
-      UsrRef = (int *)RefBeg;
-      DatLen = ((float *)DatEnd - (float *)DatBeg) / (EndIdx - BegIdx);
-      RefLen = (RefEnd - RefBeg) / (EndIdx - BegIdx);
+      if(deg > 256)
+         return(0);
 
-      for(i=BegIdx;i<=EndIdx;i++)
+      if(VecNmbLin[ PowTab[ deg ] ] == -1)
+         VecNmbLin[ PowTab[ deg ] ] = i;
+   }
+
+   for(i=0;i<=8;i++)
+      if(VecNmbLin[i] != -1)
       {
-         for(j=0;j<4;j++)
-            UsrCrd[ (i - BegIdx) * DatLen + j ] = CrdTab[ i * 4 + j ];
+         mat->MatSlc[ mat->NmbSlc ][0] = 1 << i;
+         mat->MatSlc[ mat->NmbSlc ][1] = VecNmbLin[i];
 
-         if(UsrRef)
-            UsrRef[ (i - BegIdx) * RefLen ] = RefTab[i];
-      }
-   }
-   else
-   {
-      EleTab = (int *)dat->CpuMem;
+         if(i <= 4)
+         {
+            mat->MatSlc[ mat->NmbSlc ][2] = 1 << i;
+            mat->MatSlc[ mat->NmbSlc ][3] = 1;
+            mat->MatSlc[ mat->NmbSlc ][4] = OclVecPow[i];
+         }
+         else
+         {
+            mat->MatSlc[ mat->NmbSlc ][2] = 16;
+            mat->MatSlc[ mat->NmbSlc ][3] = 1 << (i-4);
+            mat->MatSlc[ mat->NmbSlc ][4] = OclVecPow[4];
+         }
+
+         mat->NmbSlc++;
+      }
+
+   mat->MatSlc[ mat->NmbSlc ][1] = mat->NmbLin;
+
+   printf(" Matrix slices = %d\n", mat->NmbSlc);
+
+   // Set the variable size column and values
+   for(i=0;i<mat->NmbSlc;i++)
+   {
+      SlcSiz = mat->MatSlc[ i+1 ][1] - mat->MatSlc[i][1];
+      ValSiz = SlcSiz * mat->MatSlc[i][0] * mat->BlkSiz * mat->BlkSiz * FltSiz;
+      ColSiz = SlcSiz * mat->MatSlc[i][0] * sizeof(int);
+      VecNnz += SlcSiz * mat->MatSlc[i][0];
+      printf("  slice %d, width = %3d, length = %9d\n",i+1, mat->MatSlc[i][0], SlcSiz);
+
+      // Set degree data
+      if(!(mat->DegIdx[i] = GetNewDatIdx(gml)))
+         return(0);
+
+      dat = gml->dat[ mat->DegIdx[i] ];
+
+      memset(dat, 0, sizeof(DatSct));
+
+      dat->AloTyp = GmlRawDat;
+      dat->MshTyp = GmlMatDat;
+      dat->MemAcs = GmlInput;
+      dat->ItmTyp = GmlInt;
+      dat->NmbItm = 1;
+      dat->ItmSiz = OclTypSiz[ GmlInt ];
+      dat->ItmLen = 1;
+      dat->NmbLin = SlcSiz;
+      dat->LinSiz = dat->NmbItm * dat->ItmSiz;
+      dat->MemSiz = (size_t)dat->NmbLin * (size_t)dat->LinSiz;
+      dat->GpuMem = dat->CpuMem = NULL;
+      dat->use    = 1;
+
+      if(!NewData(gml, dat))
+         return(0);
+
+      IntPtr = (int *)dat->CpuMem;
+
+      for(j=0;j<SlcSiz;j++)
+         IntPtr[j] = lin[ mat->MatSlc[i][1] + j + 1 ] - lin[ mat->MatSlc[i][1] + j ];
+
+      UploadData(gml, mat->DegIdx[i]);
+
+      // Set column data
+      if(!(mat->ColIdx[i] = GetNewDatIdx(gml)))
+         return(0);
+
+      dat = gml->dat[ mat->ColIdx[i] ];
+      memset(dat, 0, sizeof(DatSct));
+
+      dat->AloTyp = GmlRawDat;
+      dat->MshTyp = GmlMatDat;
+      dat->MemAcs = GmlInput;
+      dat->ItmTyp = mat->MatSlc[i][4];
+      dat->NmbItm = mat->MatSlc[i][3];
+      dat->ItmSiz = OclTypSiz[ dat->ItmTyp ];
+      dat->ItmLen = TypVecSiz[ dat->ItmTyp ];
+      dat->NmbLin = SlcSiz;
+      dat->LinSiz = dat->NmbItm * dat->ItmSiz;
+      dat->MemSiz = (size_t)dat->NmbLin * (size_t)dat->LinSiz;
+      dat->GpuMem = dat->CpuMem = NULL;
+      dat->use    = 1;
+
+       if(!NewData(gml, dat))
+         return(0);
+
+      PtrCol = (char *)dat->CpuMem;
+
+      for(j=mat->MatSlc[i][1]; j<mat->MatSlc[ i+1 ][1]; j++)
+      {
+         memcpy(PtrCol, &col[ lin[j] ], (lin[j+1] - lin[j]) * sizeof(int) );
+         PtrCol += dat->LinSiz;
+      }
+
+      UploadData(gml, mat->ColIdx[i]);
+
+      // Set the matrix values
+      if(!(mat->ValIdx[i] = GetNewDatIdx(gml)))
+         return(0);
+
+      dat = gml->dat[ mat->ValIdx[i] ];
+      memset(dat, 0, sizeof(DatSct));
+
+      dat->AloTyp = GmlRawDat;
+      dat->MshTyp = GmlMatDat;
+      dat->MemAcs = GmlInput;
+      dat->ItmTyp = mat->FltTyp;
+      dat->NmbItm = mat->MatSlc[i][0] * BlkSiz * BlkSiz;
+      dat->ItmSiz = OclTypSiz[ dat->ItmTyp ];
+      dat->ItmLen = TypVecSiz[ dat->ItmTyp ];
+      dat->NmbLin = SlcSiz;
+      dat->LinSiz = dat->NmbItm * dat->ItmSiz;
+      dat->MemSiz = (size_t)dat->NmbLin * (size_t)dat->LinSiz;
+      dat->GpuMem = dat->CpuMem = NULL;
+      dat->use    = 1;
+
+      if(!NewData(gml, dat))
+         return(0);
+
+      PtrVal = (char *)dat->CpuMem;
+
+      if(FltTyp == GmlFlt)
+      {
+         for(j=mat->MatSlc[i][1]; j<mat->MatSlc[ i+1 ][1]; j++)
+         {
+            memcpy(  PtrVal, &FltVal[ lin[j] * BlkSiz * BlkSiz ],
+                     (lin[j+1] - lin[j]) * BlkSiz * BlkSiz * FltSiz );
+
+            PtrVal += dat->LinSiz;
+         }
+      }
+      else
+      {
+         for(j=mat->MatSlc[i][1]; j<mat->MatSlc[ i+1 ][1]; j++)
+         {
+            memcpy(  PtrVal, &DblVal[ lin[j] * BlkSiz * BlkSiz ],
+                     (lin[j+1] - lin[j]) * BlkSiz * BlkSiz * FltSiz );
+
+            PtrVal += dat->LinSiz;
+         }
+      }
+
+      // Upload this matrix slice to the GPU memory
+      UploadData(gml, mat->ValIdx[i]);
+
+      sprintf(PrcNam, "MulMatVecSlc%d", mat->MatSlc[i][0]);
+
+      if(FltTyp == GmlFlt)
+         sprintf(OptStr, " -DBLKSIZ=%d -DREAL32 ", BlkSiz);
+      else
+         sprintf(OptStr, " -DBLKSIZ=%d ", BlkSiz);
+
+      if(mat->PckFlg)
+         strcat(OptStr, "-DPACKED ");
+
+      GmlSetCompilerOptions(GmlIdx, OptStr);
+      mat->KrnIdx[i] = NewOclKrn(gml, multmatvec, PrcNam, 1);
+   }
+
+   mat->MemAcc += ((float)(NmbLin * BlkSiz)
+               +   (float)(NmbBlk * BlkSiz * (BlkSiz + 1))) * FltSiz;
+
+   mat->FltOpp = (float)NmbBlk * BlkSiz * BlkSiz * 2;
+
+   printf("  sparse nnz = %d, vectorized nnz = %zu, occupency = %.1f%%\n",
+            NmbBlk, VecNnz, (100. * NmbBlk) / VecNnz);
+   printf("  swipe = %.2f GB, %.2f GFlops\n", mat->MemAcc / 1.E9, mat->FltOpp / 1.E9);
+
+   return(MatIdx);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Allocate and fill a block vector                                           */
+/*----------------------------------------------------------------------------*/
+
+int GmlNewVector(size_t GmlIdx, int NmbLin, int BlkSiz, void *val, int FltTyp)
+{
+   char     *PtrVal, src[ GmlMaxSrcSiz ] = "\0";
+   char     PrcNam[100], OptStr[100] = "\0";
+   int      i, j;
+   int      VecIdx, *IntPtr;
+   float    *FltVal = (float *)val;
+   double   *DblVal = (double *)val;
+   DatSct   *dat;
+   VecSct   *vec;
+
+   GETGMLPTR(gml, GmlIdx);
+
+   if(NmbLin < 1 || BlkSiz < 1 || BlkSiz > 64)
+      return(0);
+
+   if(!(VecIdx = GetNewVecIdx(gml)))
+      return(0);
+
+   vec = gml->vec[ VecIdx ];
+   memset(vec, 0, sizeof(VecSct));
+
+   vec->use = 1;
+   vec->NmbLin = NmbLin;
+   vec->BlkSiz = BlkSiz;
+   vec->FltTyp = FltTyp;
+   vec->FltSiz = (FltTyp == GmlFlt) ? sizeof(float) : sizeof(double);
+
+   if(BlkSiz == 1)
+   {
+      vec->NmbValTyp = 1;
+      vec->VecValSiz = 1;
+   }
+   else if(BlkSiz == 2)
+   {
+      vec->NmbValTyp = 1;
+      vec->VecValSiz = 2;
+   }
+   else if(BlkSiz <= 4)
+   {
+      vec->NmbValTyp = 1;
+      vec->VecValSiz = 4;
+   }
+   else if(BlkSiz <= 8)
+   {
+      vec->NmbValTyp = 1;
+      vec->VecValSiz = 8;
+   }
+   else if(BlkSiz <= 16)
+   {
+      vec->NmbValTyp = 1;
+      vec->VecValSiz = 16;
+   }
+   else if(BlkSiz <= 32)
+   {
+      vec->NmbValTyp = 2;
+      vec->VecValSiz = 16;
+   }
+   else if(BlkSiz <= 48)
+   {
+      vec->NmbValTyp = 3;
+      vec->VecValSiz = 16;
+   }
+   else
+   {
+      vec->NmbValTyp = 4;
+      vec->VecValSiz = 16;
+   }
+
+   // Drop the padding of non power of two blocks if the user asked for it
+   if( (gml->VecLay == GmlPacked) && (BlkSiz >= 5)
+   &&  (vec->NmbValTyp * vec->VecValSiz != BlkSiz) )
+   {
+      vec->PckFlg = 1;
+      vec->NmbValTyp = 1;
+      vec->VecValSiz = BlkSiz;
+   }
+
+   // Set the vector values
+   if(!(vec->idx = GetNewDatIdx(gml)))
+      return(0);
+
+   dat = gml->dat[ vec->idx ];
+   memset(dat, 0, sizeof(DatSct));
+
+   dat->AloTyp = GmlRawDat;
+   dat->MshTyp = GmlVecDat;
+   dat->MemAcs = GmlInput;
+   dat->ItmTyp = vec->FltTyp;
+   dat->NmbItm = vec->NmbValTyp * vec->VecValSiz;
+   dat->ItmSiz = OclTypSiz[ dat->ItmTyp ];
+   dat->ItmLen = TypVecSiz[ dat->ItmTyp ];
+   dat->NmbLin = vec->NmbLin;
+   dat->LinSiz = dat->NmbItm * dat->ItmSiz;
+   dat->MemSiz = (size_t)dat->NmbLin * (size_t)dat->LinSiz;
+   dat->GpuMem = dat->CpuMem = NULL;
+   dat->use    = 1;
+
+   // Packed vectors are processed four scalars at a time by the
+   // term by term kernels, so round the buffer size up accordingly
+   if(vec->PckFlg)
+      dat->MemSiz = (((size_t)NmbLin * BlkSiz + 3) / 4) * 4 * vec->FltSiz;
+
+   if(!NewData(gml, dat))
+      return(0);
+
+   PtrVal = (char *)dat->CpuMem;
+
+   if(FltTyp == GmlFlt)
+   {
+      for(i=0;i<NmbLin;i++)
+      {
+         memcpy(PtrVal, &FltVal[ i * BlkSiz ], BlkSiz * vec->FltSiz);
+         PtrVal += dat->LinSiz;
+      }
+   }
+   else
+   {
+      for(i=0;i<NmbLin;i++)
+      {
+         memcpy(PtrVal, &DblVal[ i * BlkSiz ], BlkSiz * vec->FltSiz);
+         PtrVal += dat->LinSiz;
+      }
+   }
+
+   // Upload this vector to the GPU memory
+   UploadData(gml, vec->idx);
+
+   if(FltTyp == GmlFlt)
+      sprintf(OptStr, " -DBLKSIZ=%d -DREAL32 ", BlkSiz);
+   else
+      sprintf(OptStr, " -DBLKSIZ=%d ", BlkSiz);
+
+   if(vec->PckFlg)
+      strcat(OptStr, "-DPACKED ");
+
+   GmlSetCompilerOptions(GmlIdx, OptStr);
+   vec->AddKrnIdx = NewOclKrn(gml, addvec, "AddVec", 1);
+   vec->SclKrnIdx = NewOclKrn(gml, scalevec, "ScaleVec", 1);
+   vec->MulDiaKrnIdx = NewOclKrn(gml, multdiagmatvec, "MultDiaglMatVec", 1);
+   vec->NrmKrnIdx = NewOclKrn(gml, normvec, "L2Norm", 1);
+
+   return(VecIdx);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Release a matrix slices data and kernels                                   */
+/*----------------------------------------------------------------------------*/
+
+int GmlFreeMatrix(size_t GmlIdx, int MatIdx)
+{
+   GETGMLPTR(gml, GmlIdx);
+   int      i;
+   MatSct   *mat;
+
+   if( (MatIdx < 1) || (MatIdx > gml->MaxMat) || !gml->mat[ MatIdx ]->use )
+      return(0);
+
+   mat = gml->mat[ MatIdx ];
+
+   for(i=0;i<mat->NmbSlc;i++)
+   {
+      GmlFreeData(GmlIdx, mat->DegIdx[i]);
+      GmlFreeData(GmlIdx, mat->ColIdx[i]);
+      GmlFreeData(GmlIdx, mat->ValIdx[i]);
+
+      if(mat->KrnIdx[i])
+         FreeOclKrn(gml, mat->KrnIdx[i]);
+   }
+
+   memset(mat, 0, sizeof(MatSct));
+
+   return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Release a vector data and kernels                                          */
+/*----------------------------------------------------------------------------*/
+
+int GmlFreeVector(size_t GmlIdx, int VecIdx)
+{
+   GETGMLPTR(gml, GmlIdx);
+   VecSct   *vec;
+
+   if( (VecIdx < 1) || (VecIdx > gml->MaxVec) || !gml->vec[ VecIdx ]->use )
+      return(0);
+
+   vec = gml->vec[ VecIdx ];
+   GmlFreeData(GmlIdx, vec->idx);
+
+   if(vec->AddKrnIdx)
+      FreeOclKrn(gml, vec->AddKrnIdx);
+
+   if(vec->SclKrnIdx)
+      FreeOclKrn(gml, vec->SclKrnIdx);
+
+   if(vec->MulDiaKrnIdx)
+      FreeOclKrn(gml, vec->MulDiaKrnIdx);
+
+   if(vec->NrmKrnIdx)
+      FreeOclKrn(gml, vec->NrmKrnIdx);
+
+   memset(vec, 0, sizeof(VecSct));
+
+   return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Extract an element's entity node table                                     */
+/*----------------------------------------------------------------------------*/
+
+static void GetItmNod(  int *EleNod, int EleTyp,
+                        int ItmTyp, int ItmIdx, int *ItmTab )
+{
+   int i, j, tmp;
+
+   // Copy the hashed entity's vertices to the return table
+   switch(ItmTyp)
+   {
+      case GmlVertices :
+      {
+         ItmTab[0] = EleNod[ ItmIdx ];
+      }return;
+
+      case GmlEdges :
+      {
+         i = EleNod[ ItmEdgNod[ EleTyp ][ ItmIdx ][0] ];
+         j = EleNod[ ItmEdgNod[ EleTyp ][ ItmIdx ][1] ];
+         ItmTab[0] = MIN(i,j);
+         ItmTab[1] = MAX(i,j);
+      }return;
+
+      case GmlTriangles :
+      {
+         for(i=0;i<3;i++)
+            ItmTab[i] = EleNod[ ItmFacNod[ EleTyp ][ ItmIdx ][i] ];
+
+         // Sort the vertices to speed-up further comparison
+         for(i=0;i<3;i++)
+            for(j=i+1;j<3;j++)
+               if(ItmTab[i] > ItmTab[j])
+               {
+                  tmp       = ItmTab[i];
+                  ItmTab[i] = ItmTab[j];
+                  ItmTab[j] = tmp;
+               }
+      }return;
+
+      case GmlQuadrilaterals :
+      {
+         for(i=0;i<4;i++)
+            ItmTab[i] = EleNod[ ItmFacNod[ EleTyp ][ ItmIdx ][i] ];
+
+         // Sort the vertices to speed-up further comparison
+         for(i=0;i<4;i++)
+            for(j=i+1;j<4;j++)
+               if(ItmTab[i] > ItmTab[j])
+               {
+                  tmp       = ItmTab[i];
+                  ItmTab[i] = ItmTab[j];
+                  ItmTab[j] = tmp;
+               }
+      }return;
+   }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Extract the nodes of the face through which an element may have a          */
+/* neighbour: quad keys store triangles with a -1 fourth node                 */
+/*----------------------------------------------------------------------------*/
+
+static void GetNgbFac(int *EleNod, int EleTyp, int HshTyp, int FacIdx, int *ItmTab)
+{
+   if( (HshTyp == GmlQuadrilaterals) && (ItmFacDeg[ EleTyp ][ FacIdx ] == 3) )
+   {
+      GetItmNod(EleNod, EleTyp, GmlTriangles, FacIdx, ItmTab);
+      ItmTab[3] = -1;
+   }
+   else
+      GetItmNod(EleNod, EleTyp, HshTyp, FacIdx, ItmTab);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Setup a hash table split into as many partitions as there are threads      */
+/*----------------------------------------------------------------------------*/
+
+static int NewHsh(HshTabSct *lnk, int HshTyp, size_t NmbItm)
+{
+   int      i;
+   size_t   siz = HSHMINSIZ;
+
+   memset(lnk, 0, sizeof(HshTabSct));
+   lnk->HshTyp = HshTyp;
+   lnk->DatLen = ItmNmbVer[ HshTyp ];
+   lnk->NmbPrt = 1;
+
+   // Each partition owns the keys whose high bits select it
+   // and stores them in its own open addressing table
+#ifdef _OPENMP
+   if(NmbItm >= MINPARLIN)
+      lnk->NmbPrt = MIN(omp_get_max_threads(), MAXPRT);
+#endif
+
+   // Start with half full power of two sized partitions
+   while(siz < 2 * NmbItm / lnk->NmbPrt)
+      siz *= 2;
+
+   for(i=0;i<lnk->NmbPrt;i++)
+   {
+      lnk->prt[i].MaxDat = siz;
+
+      if(!(lnk->prt[i].DatTab = calloc(siz, sizeof(BucSct))))
+         return(0);
+   }
+
+   lnk->TabSiz = siz * lnk->NmbPrt;
+
+   return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Sum up the partitions statistics once the hash table is built              */
+/*----------------------------------------------------------------------------*/
+
+static void SumHsh(HshTabSct *lnk)
+{
+   int i;
+
+   lnk->NmbDat = lnk->NmbPrb = lnk->MaxPrb = lnk->TabSiz = 0;
+
+   for(i=0;i<lnk->NmbPrt;i++)
+   {
+      lnk->NmbDat += lnk->prt[i].NmbDat;
+      lnk->NmbPrb += lnk->prt[i].NmbPrb;
+      lnk->TabSiz += lnk->prt[i].MaxDat;
+      lnk->MaxPrb  = MAX(lnk->MaxPrb, lnk->prt[i].MaxPrb);
+   }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Release all partitions buckets                                             */
+/*----------------------------------------------------------------------------*/
+
+static void FreeHsh(HshTabSct *lnk)
+{
+   int i;
+
+   for(i=0;i<lnk->NmbPrt;i++)
+      if(lnk->prt[i].DatTab)
+         free(lnk->prt[i].DatTab);
+
+   memset(lnk, 0, sizeof(HshTabSct));
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Compute a well mixed 64-bit hash key from a sorted node table              */
+/*----------------------------------------------------------------------------*/
+
+static size_t CalHshKey(HshTabSct *lnk, int *ItmTab)
+{
+   int      i;
+   uint64_t k = 0;
+
+   // Combine the nodes and apply the MurmurHash3 64-bit finalizer
+   // so that close node indices do not end up in close buckets
+   for(i=0;i<lnk->DatLen;i++)
+      k = (k ^ (uint32_t)ItmTab[i]) * 0x9e3779b97f4a7c15ULL;
+
+   k ^= k >> 33;
+   k *= 0xff51afd7ed558ccdULL;
+   k ^= k >> 33;
+   k *= 0xc4ceb9fe1a85ec53ULL;
+   k ^= k >> 33;
+
+   return((size_t)k);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Double the size of a partition and insert its buckets again                */
+/*----------------------------------------------------------------------------*/
+
+static int GrowHsh(HshTabSct *lnk, HshPrtSct *prt)
+{
+   size_t   i, beg, pos, OldSiz = prt->MaxDat, msk = 2 * OldSiz - 1;
+   BucSct   *OldTab = prt->DatTab;
+
+   if(!(prt->DatTab = calloc(2 * OldSiz, sizeof(BucSct))))
+   {
+      prt->DatTab = OldTab;
+      return(0);
+   }
+
+   prt->MaxDat = 2 * OldSiz;
+
+   // Start right after an empty bucket so that no run of buckets
+   // wraps around and identical items keep their insertion order
+   for(beg=0; OldTab[ beg ].use; beg++);
+
+   for(i=1;i<=OldSiz;i++)
+   {
+      pos = (beg + i) & (OldSiz - 1);
+
+      if(!OldTab[ pos ].use)
+         continue;
+
+      // Linear probing up to the first empty bucket
+      pos = CalHshKey(lnk, OldTab[ pos ].nod) & msk;
+
+      while(prt->DatTab[ pos ].use)
+         pos = (pos + 1) & msk;
+
+      prt->DatTab[ pos ] = OldTab[ (beg + i) & (OldSiz - 1) ];
+   }
+
+   free(OldTab);
+
+   return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Add a pair element/entity to the hash table and handle any collision,      */
+/* return 0 if the partition could not be grown                               */
+/*----------------------------------------------------------------------------*/
+
+static int AddHsh(   HshTabSct *lnk, size_t HshKey, int EleTyp,
+                     int EleIdx, int ItmIdx, int *ItmTab )
+{
+   int i;
+   size_t pos, msk, prb = 1;
+   BucSct *buc;
+   HshPrtSct *prt = &lnk->prt[ HSHPRT(lnk, HshKey) ];
+
+   // Only the thread in charge of this key's partition may get here,
+   // so its table can be grown without any locking, keeping it half empty
+   if( (2 * (prt->NmbDat + 1) > prt->MaxDat) && !GrowHsh(lnk, prt) )
+      return(0);
+
+   msk = prt->MaxDat - 1;
+   pos = HshKey & msk;
+
+   // Identical items are stored one after the other in a same run of buckets
+   while(prt->DatTab[ pos ].use)
+   {
+      pos = (pos + 1) & msk;
+      prb++;
+   }
+
+   buc = &prt->DatTab[ pos ];
+   buc->use = 1;
+   buc->EleTyp = (char)EleTyp;
+   buc->ItmIdx = (char)ItmIdx;
+   buc->EleIdx = EleIdx;
+
+   for(i=0;i<lnk->DatLen;i++)
+      buc->nod[i] = ItmTab[i];
+
+   prt->NmbDat++;
+   prt->NmbPrb += prb;
+   prt->MaxPrb = MAX(prt->MaxPrb, prb);
+
+   return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Fetch an element/entity pair from the hash table                           */
+/*----------------------------------------------------------------------------*/
+
+static int GetHsh(   HshTabSct *lnk, size_t HshKey, int EleIdx, int ItmIdx,
+                     int *ItmTab, int *UsrTab, char *VoyTab, int *TypTab )
+{
+   int i, flg, deg = 0;
+   HshPrtSct *prt = &lnk->prt[ HSHPRT(lnk, HshKey) ];
+   size_t msk = prt->MaxDat - 1, pos = HshKey & msk;
+   BucSct *buc;
+
+   // Scan the run of buckets up to the first empty one,
+   // the matching items come in their insertion order
+   for(buc = &prt->DatTab[ pos ]; buc->use; buc = &prt->DatTab[ pos ])
+   {
+      flg = 1;
+
+      for(i=0;i<lnk->DatLen;i++)
+         if(buc->nod[i] != ItmTab[i])
+         {
+            flg = 0;
+            break;
+         }
+
+      if(flg)
+      {
+         if(UsrTab)
+            UsrTab[ deg ] = buc->EleIdx;
+
+         if(VoyTab)
+            VoyTab[ deg ] = buc->ItmIdx;
+
+         if(TypTab)
+            TypTab[ deg ] = buc->EleTyp;
+
+         deg++;
+      }
+
+      pos = (pos + 1) & msk;
+   }
+
+   return(deg);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Return the first bucket storing an entity, or NULL if it is not hashed     */
+/*----------------------------------------------------------------------------*/
+
+static BucSct *GetHshBuc(HshTabSct *lnk, size_t HshKey, int *ItmTab)
+{
+   int i, flg;
+   HshPrtSct *prt = &lnk->prt[ HSHPRT(lnk, HshKey) ];
+   size_t msk = prt->MaxDat - 1, pos = HshKey & msk;
+   BucSct *buc;
+
+   for(buc = &prt->DatTab[ pos ]; buc->use; buc = &prt->DatTab[ pos ])
+   {
+      flg = 1;
+
+      for(i=0;i<lnk->DatLen;i++)
+         if(buc->nod[i] != ItmTab[i])
+         {
+            flg = 0;
+            break;
+         }
+
+      if(flg)
+         return(buc);
+
+      pos = (pos + 1) & msk;
+   }
+
+   return(NULL);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Insert a list of items whose keys were computed beforehand: the keys are   */
+/* binned by partition with a stable counting sort, then each thread adds     */
+/* its own partition's items in the list order, skipping those already        */
+/* hashed if requested, so the result does not depend on the thread count     */
+/*----------------------------------------------------------------------------*/
+
+static int FilHsh(HshTabSct *lnk, size_t NmbKey, size_t *KeyTab, BucSct *KeyBuc, int UniFlg)
+{
+   int      c, p, NmbPrt = lnk->NmbPrt, ErrTab[ MAXPRT ] = {0};
+   size_t   i, n, pos, *LstTab, PrtBeg[ MAXPRT+1 ], CntTab[ MAXPRT ][ MAXPRT ];
+   BucSct   *buc;
+
+   if(!(LstTab = malloc(MAX(NmbKey, 1) * sizeof(size_t))))
+      return(0);
+
+   // Each thread counts the keys of its chunk of the list per partition
+#ifdef _OPENMP
+#pragma omp parallel for private(i, p) if(NmbPrt > 1)
+#endif
+   for(c=0;c<NmbPrt;c++)
+   {
+      for(p=0;p<NmbPrt;p++)
+         CntTab[c][p] = 0;
+
+      for(i = c * NmbKey / NmbPrt; i < (c+1) * NmbKey / NmbPrt; i++)
+         CntTab[c][ HSHPRT(lnk, KeyTab[i]) ]++;
+   }
+
+   // Partitions are laid out one after the other, each one
+   // listing the keys of the successive chunks
+   for(p=0, pos=0; p<NmbPrt; p++)
+   {
+      PrtBeg[p] = pos;
+
+      for(c=0;c<NmbPrt;c++)
+      {
+         n = CntTab[c][p];
+         CntTab[c][p] = pos;
+         pos += n;
+      }
+   }
+
+   PrtBeg[ NmbPrt ] = pos;
+
+#ifdef _OPENMP
+#pragma omp parallel for private(i) if(NmbPrt > 1)
+#endif
+   for(c=0;c<NmbPrt;c++)
+      for(i = c * NmbKey / NmbPrt; i < (c+1) * NmbKey / NmbPrt; i++)
+         LstTab[ CntTab[c][ HSHPRT(lnk, KeyTab[i]) ]++ ] = i;
+
+   // Only the thread in charge of a partition writes to its table
+#ifdef _OPENMP
+#pragma omp parallel for private(i, n, buc) if(NmbPrt > 1)
+#endif
+   for(p=0;p<NmbPrt;p++)
+      for(n=PrtBeg[p]; n<PrtBeg[ p+1 ]; n++)
+      {
+         i = LstTab[n];
+         buc = &KeyBuc[i];
+
+         if(UniFlg && GetHsh(lnk, KeyTab[i], buc->EleIdx, buc->ItmIdx,
+                              buc->nod, NULL, NULL, NULL))
+         {
+            continue;
+         }
+
+         if(!AddHsh(lnk, KeyTab[i], buc->EleTyp, buc->EleIdx, buc->ItmIdx, buc->nod))
+         {
+            ErrTab[p] = 1;
+            break;
+         }
+      }
+
+   free(LstTab);
+
+   for(p=0;p<NmbPrt;p++)
+      if(ErrTab[p])
+         return(0);
+
+   return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Double the size of the data, matrix, vector or kernel tables               */
+/*----------------------------------------------------------------------------*/
+
+static int GrowDatTab(GmlSct *gml)
+{
+   int      i, OldMax = gml->dat ? gml->MaxDat : -1;
+   int      NewMax = gml->dat ? 2 * gml->MaxDat : GmlMaxDat;
+   DatSct   **tab;
+
+   if(!(tab = realloc(gml->dat, (NewMax + 1) * sizeof(DatSct *))))
+      return(0);
+
+   gml->dat = tab;
+
+   // Slots are allocated one by one so that pointers to existing slots
+   // held by the caller remain valid after the table has been moved
+   for(i=OldMax+1; i<=NewMax; i++)
+      if(!(gml->dat[i] = calloc(1, sizeof(DatSct))))
+         break;
+
+   gml->MaxDat = i - 1;
+
+   return(gml->MaxDat > OldMax);
+}
+
+static int GrowMatTab(GmlSct *gml)
+{
+   int      i, OldMax = gml->mat ? gml->MaxMat : -1;
+   int      NewMax = gml->mat ? 2 * gml->MaxMat : GmlMaxMat;
+   MatSct   **tab;
+
+   if(!(tab = realloc(gml->mat, (NewMax + 1) * sizeof(MatSct *))))
+      return(0);
+
+   gml->mat = tab;
+
+   for(i=OldMax+1; i<=NewMax; i++)
+      if(!(gml->mat[i] = calloc(1, sizeof(MatSct))))
+         break;
+
+   gml->MaxMat = i - 1;
+
+   return(gml->MaxMat > OldMax);
+}
+
+static int GrowVecTab(GmlSct *gml)
+{
+   int      i, OldMax = gml->vec ? gml->MaxVec : -1;
+   int      NewMax = gml->vec ? 2 * gml->MaxVec : GmlMaxVec;
+   VecSct   **tab;
+
+   if(!(tab = realloc(gml->vec, (NewMax + 1) * sizeof(VecSct *))))
+      return(0);
+
+   gml->vec = tab;
+
+   for(i=OldMax+1; i<=NewMax; i++)
+      if(!(gml->vec[i] = calloc(1, sizeof(VecSct))))
+         break;
+
+   gml->MaxVec = i - 1;
+
+   return(gml->MaxVec > OldMax);
+}
+
+static int GrowKrnTab(GmlSct *gml)
+{
+   int      i, OldMax = gml->krn ? gml->MaxKrn : -1;
+   int      NewMax = gml->krn ? 2 * gml->MaxKrn : GmlMaxKrn;
+   KrnSct   **tab;
+
+   if(!(tab = realloc(gml->krn, (NewMax + 1) * sizeof(KrnSct *))))
+      return(0);
+
+   gml->krn = tab;
+
+   for(i=OldMax+1; i<=NewMax; i++)
+      if(!(gml->krn[i] = calloc(1, sizeof(KrnSct))))
+         break;
+
+   gml->MaxKrn = i - 1;
+
+   return(gml->MaxKrn > OldMax);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Find and return a free data slot in the GML structure                      */
+/*----------------------------------------------------------------------------*/
+
+static int GetNewDatIdx(GmlSct *gml)
+{
+   int i;
+
+   for(i=1;i<=gml->MaxDat;i++)
+      if(!gml->dat[i]->use)
+         break;
+
+   if( (i > gml->MaxDat) && !GrowDatTab(gml) )
+      return(0);
+
+   gml->dat[i]->use = 1;
+
+   return(i);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Find and return a free matrix slot in the GML structure                    */
+/*----------------------------------------------------------------------------*/
+
+static int GetNewMatIdx(GmlSct *gml)
+{
+   int i;
+
+   for(i=1;i<=gml->MaxMat;i++)
+      if(!gml->mat[i]->use)
+         break;
+
+   if( (i > gml->MaxMat) && !GrowMatTab(gml) )
+      return(0);
+
+   gml->mat[i]->use = 1;
+
+   return(i);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Find and return a free vector slot in the GML structure                    */
+/*----------------------------------------------------------------------------*/
+
+static int GetNewVecIdx(GmlSct *gml)
+{
+   int i;
+
+   for(i=1;i<=gml->MaxVec;i++)
+      if(!gml->vec[i]->use)
+         break;
+
+   if( (i > gml->MaxVec) && !GrowVecTab(gml) )
+      return(0);
+
+   gml->vec[i]->use = 1;
+
+   return(i);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Find and return a free kernel slot in the GML structure                    */
+/*----------------------------------------------------------------------------*/
+
+static int GetNewKrnIdx(GmlSct *gml)
+{
+   int i;
+
+   for(i=1;i<=gml->MaxKrn;i++)
+      if(!gml->krn[i]->use)
+         break;
+
+   if( (i > gml->MaxKrn) && !GrowKrnTab(gml) )
+      return(0);
+
+   gml->krn[i]->use = 1;
+
+   return(i);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Allocate an OpenCL buffer                                                  */
+/*----------------------------------------------------------------------------*/
+
+static int NewData(GmlSct *gml, DatSct *dat)
+{
+   int      MemAcs[4] = {0, CL_MEM_READ_ONLY, CL_MEM_WRITE_ONLY, CL_MEM_READ_WRITE};
+   cl_mem_flags flg = MemAcs[ dat->MemAcs ];
+   size_t   siz = dat->MemSiz;
+
+   if(gml->UniMem)
+   {
+      // On host unified devices, round the size up to a full cache line,
+      // as required by most drivers to avoid any hidden copy
+      siz = ((siz + HSTALN - 1) / HSTALN) * HSTALN;
+      dat->ZerCpy = 1;
+
+      // Device only data may be allocated in host memory by the driver
+      if(dat->MemAcs == GmlInternal)
+         flg |= CL_MEM_ALLOC_HOST_PTR;
+      else
+         flg |= CL_MEM_USE_HOST_PTR;
+   }
+
+   // Allocate the requested memory size on the CPU side,
+   // with a page alignment so that it can be used directly by the device
+   if( (dat->MemAcs != GmlInternal) && !(dat->CpuMem = NewHstMem(siz)) )
+   {
+      printf("Cannot allocate %zd MB on the CPU\n", dat->MemSiz/MB);
+      return(0);
+   }
+
+   // Allocate the requested memory size on the GPU: small buffers come from
+   // the memory pool, large ones get their own allocation and
+   // unified memory devices wrap the host memory in a buffer
+   if(!gml->UniMem && (siz <= POLMAXSIZ))
+      dat->GpuMem = NewPolBuf(gml, dat, flg, siz);
+   else
+      dat->GpuMem = clCreateBuffer( gml->context, flg, siz,
+                                    (flg & CL_MEM_USE_HOST_PTR) ? dat->CpuMem : NULL,
+                                    NULL );
+
+   if(!dat->GpuMem)
+   {
+      printf(  "Cannot allocate %zd MB on the GPU (%zd MB already used)\n",
+               dat->MemSiz / MB, GmlGetMemoryUsage((size_t)gml) / MB);
+
+      if(dat->CpuMem)
+      {
+         FreeHstMem(dat->CpuMem);
+         dat->CpuMem = NULL;
+      }
+
+      return(0);
+   }
+
+   // Nothing needs to be uploaded yet and the zeroed host mirror is valid
+   dat->DrtBeg = dat->NmbLin;
+   dat->DrtEnd = -1;
+   dat->HstBeg = 0;
+   dat->HstEnd = dat->NmbLin - 1;
+
+   // Keep track of allocated memory
+   gml->MemSiz += dat->MemSiz;
+
+   return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Allocate a zeroed and page aligned host memory block                       */
+/*----------------------------------------------------------------------------*/
+
+static void *NewHstMem(size_t siz)
+{
+   void *ptr;
+
+#ifdef _WIN32
+   if(!(ptr = _aligned_malloc(siz, HSTPAG)))
+      return(NULL);
+#else
+   if(posix_memalign(&ptr, HSTPAG, siz))
+      return(NULL);
+#endif
+
+   memset(ptr, 0, siz);
+
+   return(ptr);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Release a host memory block allocated with NewHstMem                       */
+/*----------------------------------------------------------------------------*/
+
+static void FreeHstMem(void *ptr)
+{
+#ifdef _WIN32
+   _aligned_free(ptr);
+#else
+   free(ptr);
+#endif
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Carve a sub-buffer out of the first memory pool chunk with enough space    */
+/*----------------------------------------------------------------------------*/
+
+static cl_mem NewPolBuf(GmlSct *gml, DatSct *dat, cl_mem_flags flg, size_t siz)
+{
+   int               i, j;
+   cl_int            err;
+   cl_mem            mem;
+   cl_buffer_region  reg;
+   PolSct            *pol = NULL;
+
+   // Keep every offset aligned on the device's base address alignment
+   siz = ((siz + gml->PolAln - 1) / gml->PolAln) * gml->PolAln;
+
+   if(siz > gml->PolChk)
+      return(NULL);
+
+   // First fit search among all chunks' free areas
+   for(i=0;i<gml->NmbPol && !pol;i++)
+      for(j=0;j<gml->pol[i].NmbFre;j++)
+         if(gml->pol[i].FreSiz[j] >= siz)
+         {
+            pol = &gml->pol[i];
+            break;
+         }
+
+   // Allocate a new chunk if none has enough room left
+   if(!pol)
+   {
+      if(gml->NmbPol == gml->MaxPol)
+      {
+         gml->MaxPol = gml->MaxPol ? 2 * gml->MaxPol : 4;
+         gml->pol = realloc(gml->pol, gml->MaxPol * sizeof(PolSct));
+         assert(gml->pol);
+      }
+
+      pol = &gml->pol[ gml->NmbPol ];
+      memset(pol, 0, sizeof(PolSct));
+      pol->siz = gml->PolChk;
+      pol->mem = clCreateBuffer( gml->context, CL_MEM_READ_WRITE, pol->siz,
+                                 NULL, NULL );
+
+      if(!pol->mem)
+         return(NULL);
+
+      pol->MaxFre = 16;
+      pol->FreOff = malloc(pol->MaxFre * sizeof(size_t));
+      pol->FreSiz = malloc(pol->MaxFre * sizeof(size_t));
+      assert(pol->FreOff && pol->FreSiz);
+      pol->NmbFre = 1;
+      pol->FreOff[0] = 0;
+      pol->FreSiz[0] = pol->siz;
+      i = ++gml->NmbPol;
+      j = 0;
+   }
+
+   // Create the sub-buffer at the beginning of the free area
+   reg.origin = pol->FreOff[j];
+   reg.size = siz;
+   mem = clCreateSubBuffer(pol->mem, flg, CL_BUFFER_CREATE_TYPE_REGION, &reg, &err);
+
+   if(!mem || (err != CL_SUCCESS))
+      return(NULL);
+
+   // Both search paths leave i set to the chunk index plus one
+   dat->PolIdx = i;
+   dat->PolOff = reg.origin;
+   dat->PolSiz = siz;
+
+   // Shrink or remove the free area
+   pol->FreOff[j] += siz;
+   pol->FreSiz[j] -= siz;
+
+   if(!pol->FreSiz[j])
+   {
+      memmove(&pol->FreOff[j], &pol->FreOff[ j+1 ], (pol->NmbFre - j - 1) * sizeof(size_t));
+      memmove(&pol->FreSiz[j], &pol->FreSiz[ j+1 ], (pol->NmbFre - j - 1) * sizeof(size_t));
+      pol->NmbFre--;
+   }
+
+   return(mem);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Give a sub-buffer area back to its chunk and merge it with its neighbours  */
+/*----------------------------------------------------------------------------*/
+
+static void FreePolBuf(GmlSct *gml, DatSct *dat)
+{
+   int      j;
+   size_t   off = dat->PolOff, siz = dat->PolSiz;
+   PolSct   *pol = &gml->pol[ dat->PolIdx - 1 ];
+
+   // Free areas are sorted by offset: find where this one fits
+   for(j=0;j<pol->NmbFre;j++)
+      if(pol->FreOff[j] > off)
+         break;
+
+   // Merge with the previous and/or the next free area
+   if(j && (pol->FreOff[ j-1 ] + pol->FreSiz[ j-1 ] == off))
+   {
+      pol->FreSiz[ j-1 ] += siz;
+
+      if( (j < pol->NmbFre) && (off + siz == pol->FreOff[j]) )
+      {
+         pol->FreSiz[ j-1 ] += pol->FreSiz[j];
+         memmove(&pol->FreOff[j], &pol->FreOff[ j+1 ], (pol->NmbFre - j - 1) * sizeof(size_t));
+         memmove(&pol->FreSiz[j], &pol->FreSiz[ j+1 ], (pol->NmbFre - j - 1) * sizeof(size_t));
+         pol->NmbFre--;
+      }
+   }
+   else if( (j < pol->NmbFre) && (off + siz == pol->FreOff[j]) )
+   {
+      pol->FreOff[j] = off;
+      pol->FreSiz[j] += siz;
+   }
+   else
+   {
+      // Otherwise insert a new free area
+      if(pol->NmbFre == pol->MaxFre)
+      {
+         pol->MaxFre *= 2;
+         pol->FreOff = realloc(pol->FreOff, pol->MaxFre * sizeof(size_t));
+         pol->FreSiz = realloc(pol->FreSiz, pol->MaxFre * sizeof(size_t));
+         assert(pol->FreOff && pol->FreSiz);
+      }
+
+      memmove(&pol->FreOff[ j+1 ], &pol->FreOff[j], (pol->NmbFre - j) * sizeof(size_t));
+      memmove(&pol->FreSiz[ j+1 ], &pol->FreSiz[j], (pol->NmbFre - j) * sizeof(size_t));
+      pol->FreOff[j] = off;
+      pol->FreSiz[j] = siz;
+      pol->NmbFre++;
+   }
+
+   dat->PolIdx = 0;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Release an OpenCL buffer                                                   */
+/*----------------------------------------------------------------------------*/
+
+int GmlFreeData(size_t GmlIdx, int idx)
+{
+   GETGMLPTR(gml, GmlIdx);
+   int      i, j, k;
+   DatSct   *dat;
+
+   if( (idx < 1) || (idx > gml->MaxDat) || !gml->dat[ idx ]->GpuMem )
+      return(0);
+
+   dat = gml->dat[ idx ];
+
+   // Free both GPU and CPU memory buffers
+   if(clReleaseMemObject(dat->GpuMem) != CL_SUCCESS)
+      return(0);
+
+   // Give a pooled buffer's area back to its chunk
+   if(dat->PolIdx)
+      FreePolBuf(gml, dat);
+
+   gml->MemSiz -= dat->MemSiz;
+
+   if(dat->CpuMem)
+      FreeHstMem(dat->CpuMem);
+
+   // Also free the scratch vector used to reduce this data
+   if(dat->RedIdx)
+      GmlFreeData(GmlIdx, dat->RedIdx);
+
+   // And the voyeurs table attached to a ball or shell
+   if(dat->VoyIdx)
+      GmlFreeData(GmlIdx, dat->VoyIdx);
+
+   // Remove any reference to this slot from the mesh and topology tables
+   for(i=0;i<GmlMaxEleTyp;i++)
+   {
+      if(gml->TypIdx[i] == idx)
+         gml->TypIdx[i] = 0;
+
+      if(gml->RefIdx[i] == idx)
+         gml->RefIdx[i] = 0;
+
+      if(gml->NgbTag[i] == idx)
+         gml->NgbTag[i] = 0;
+
+      for(j=0;j<MAXLNKCOL;j++)
+      {
+         if(gml->LnkMat[i][j] == idx)
+            gml->LnkMat[i][j] = 0;
+
+         // Losing any of its tiers leaves the uplink incomplete
+         for(k=0;k<MAXTIE;k++)
+            if(gml->TieMat[i][j][k] == idx)
+            {
+               gml->TieMat[i][j][k] = 0;
+               gml->NmbTie[i][j] = 0;
+            }
+
+         if(gml->CntMat[i][j] == idx)
+            gml->CntMat[i][j] = 0;
+
+         if(gml->CsrMat[i][j] == idx)
+            gml->CsrMat[i][j] = 0;
+
+         if(gml->PrmMat[i][j] == idx)
+            gml->PrmMat[i][j] = 0;
+
+         if(gml->InvMat[i][j] == idx)
+            gml->InvMat[i][j] = 0;
+      }
+   }
+
+   if(gml->ParIdx == idx)
+      gml->ParIdx = 0;
+
+   // The hybrid ball is unusable without any of its tables
+   if( (gml->HybBal == idx) || (gml->HybDeg == idx) || (gml->HybTyp == idx) )
+      gml->HybBal = gml->HybDeg = gml->HybTyp = 0;
+
+   // Clear the slot so that it may be reused by the next allocation
+   memset(dat, 0, sizeof(DatSct));
+
+   return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Set a line of mesh, link or solution data                                  */
+/*----------------------------------------------------------------------------*/
+
+int GmlSetDataLine(size_t GmlIdx, int idx, int lin, ...)
+{
+   GETGMLPTR(gml, GmlIdx);
+   CHKDATIDX(gml, idx);
+   DatSct   *dat = gml->dat[ idx ], *RefDat;
+   char     *adr = (void *)dat->CpuMem;
+   int      i, *EleTab, siz, *RefTab, *tab, RefIdx = 0, res = 0;
+   va_list  VarArg;
+
+   if( (lin < 0) || (lin >= dat->NmbLin) )
+      return(0);
+
+   va_start(VarArg, lin);
+
+   // Device only data have no host mirror:
+   // the line is directly written to the OpenCL buffer
+   if(!dat->CpuMem)
+   {
+      if( (dat->AloTyp == GmlRawDat) && ISHLF(dat->ItmTyp)
+      &&  (adr = malloc(dat->LinSiz)) )
+      {
+         CopyScalars(adr, 4, va_arg(VarArg, char *), 1, dat->LinSiz / sizeof(cl_half));
+         res = StageLine(gml, idx, lin, adr, 1);
+         free(adr);
+      }
+      else if(dat->AloTyp == GmlRawDat)
+      {
+         res = StageLine(gml, idx, lin, va_arg(VarArg, void *), 1);
+      }
+      else if( (dat->AloTyp == GmlLnkDat) && (tab = calloc(1, dat->LinSiz)) )
+      {
+         for(i=0;i<dat->NmbItm;i++)
+            tab[i] = va_arg(VarArg, int);
+
+         res = StageLine(gml, idx, lin, tab, 1);
+         free(tab);
+      }
+
+      va_end(VarArg);
+      return(res);
+   }
+
+   if( (dat->AloTyp == GmlRawDat) && ISHLF(dat->ItmTyp) )
+   {
+      // Half float data are set from the user's floats
+      CopyScalars(&adr[ (size_t)lin * dat->LinSiz ], 4, va_arg(VarArg, char *),
+                  1, dat->LinSiz / sizeof(cl_half));
+   }
+   else if(dat->AloTyp == GmlRawDat)
+   {
+      memcpy(&adr[ lin * dat->LinSiz ], va_arg(VarArg, void *), dat->LinSiz);
+   }
+   else if(dat->AloTyp == GmlLnkDat)
+   {
+      tab = (int *)dat->CpuMem;
+
+      for(i=0;i<dat->NmbItm;i++)
+         tab[ lin * dat->NmbItm + i ] = va_arg(VarArg, int);
+   }
+   else if( (dat->AloTyp == GmlEleDat) && (dat->MshTyp == GmlVertices) )
+   {
+      // Coordinates are stored as float4 or double4 vectors
+      RefIdx = gml->RefIdx[ dat->MshTyp ];
+      RefDat = gml->dat[ RefIdx ];
+      RefTab = (int *)RefDat->CpuMem;
+      siz = dat->ItmTyp / 5;
+
+      for(i=0;i<3;i++)
+         SetScalar(&adr[ (size_t)lin * dat->LinSiz ], siz, i, va_arg(VarArg, double));
+
+      SetScalar(&adr[ (size_t)lin * dat->LinSiz ], siz, 3, 0.);
+      RefTab[ lin ] = va_arg(VarArg, int);
+   }
+   else if( (dat->AloTyp == GmlEleDat) && (dat->MshTyp > GmlVertices) )
+   {
+      EleTab = (int *)dat->CpuMem;
+      siz = TypVecSiz[ MshItmTyp[ dat->MshTyp ] ];
+      RefIdx = gml->RefIdx[ dat->MshTyp ];
+      RefDat = gml->dat[ RefIdx ];
+      RefTab = (int *)RefDat->CpuMem;
+
+      for(i=0;i<EleNmbNod[ dat->MshTyp ];i++)
+         EleTab[ lin * siz + i ] = va_arg(VarArg, int);
+
+      RefTab[ lin ] = va_arg(VarArg, int);
+   }
+
+   va_end(VarArg);
+
+   SetDirtyLines(gml, idx, lin, lin);
+
+   if(RefIdx)
+      SetDirtyLines(gml, RefIdx, lin, lin);
+
+   // Send all modified lines when the last one is set,
+   // the others will be flushed before the next kernel launch
+   if(lin == dat->NmbLin - 1)
+   {
+      UploadLines(gml, idx, dat->DrtBeg, dat->DrtEnd);
+
+      if(RefIdx)
+         UploadLines(gml, RefIdx, gml->dat[ RefIdx ]->DrtBeg,
+                     gml->dat[ RefIdx ]->DrtEnd);
+   }
+
+   return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Get a line of solution or vertex coordinates from the librarie's buffers   */
+/*----------------------------------------------------------------------------*/
+
+int GmlGetDataLine(size_t GmlIdx, int idx, int lin, ...)
+{
+   GETGMLPTR(gml, GmlIdx);
+   CHKDATIDX(gml, idx);
+   DatSct   *dat = gml->dat[ idx ], *RefDat;
+   char     *adr = (void *)dat->CpuMem;
+   int      i, j, *EleTab, siz, *RefTab, RefIdx = 0, *UsrDat, *tab;
+   double   *UsrCrd;
+   va_list  VarArg;
+
+   if( (lin < 0) || (lin >= dat->NmbLin) )
+      return(0);
+
+   // Device only data are read on demand, line by line
+   if(!dat->CpuMem)
+   {
+      if( (dat->AloTyp != GmlRawDat) && (dat->AloTyp != GmlLnkDat) )
+         return(0);
+
+      va_start(VarArg, lin);
+
+      if( (dat->AloTyp == GmlRawDat) && ISHLF(dat->ItmTyp) )
+      {
+         if(!(adr = malloc(dat->LinSiz)))
+            i = 0;
+         else if( (i = StageLine(gml, idx, lin, adr, 0)) )
+            CopyScalars(va_arg(VarArg, char *), 1, adr, 4, dat->LinSiz / sizeof(cl_half));
+
+         free(adr);
+      }
+      else if(dat->AloTyp == GmlRawDat)
+         i = StageLine(gml, idx, lin, va_arg(VarArg, void *), 0);
+      else
+      {
+         // Link lines are returned one integer per pointer
+         if(!(tab = malloc(dat->LinSiz)))
+            i = 0;
+         else if( (i = StageLine(gml, idx, lin, tab, 0)) )
+            for(j=0;j<dat->NmbItm;j++)
+            {
+               UsrDat = va_arg(VarArg, int *);
+               *UsrDat = tab[j];
+            }
+
+         free(tab);
+      }
+
+      va_end(VarArg);
+
+      return(i);
+   }
+
+   // Download the whole data only if a kernel modified this line
+   if( (lin < dat->HstBeg) || (lin > dat->HstEnd) )
+      DownloadData(gml, idx);
+
+   va_start(VarArg, lin);
+
+   if( (dat->AloTyp == GmlRawDat) && ISHLF(dat->ItmTyp) )
+   {
+      CopyScalars(va_arg(VarArg, char *), 1, &adr[ (size_t)lin * dat->LinSiz ],
+                  4, dat->LinSiz / sizeof(cl_half));
+   }
+   else if(dat->AloTyp == GmlRawDat)
+   {
+      memcpy(va_arg(VarArg, void *), &adr[ lin * dat->LinSiz ], dat->LinSiz);
+   }
+   else if(dat->AloTyp == GmlLnkDat)
+   {
+      tab = (int *)dat->CpuMem;
+
+      for(i=0;i<dat->NmbItm;i++)
+      {
+         UsrDat = va_arg(VarArg, int *);
+         *UsrDat = tab[ lin * dat->NmbItm + i ];
+      }
+   }
+   else if( (dat->AloTyp == GmlEleDat) && (dat->MshTyp == GmlVertices) )
+   {
+      for(i=0;i<3;i++)
+      {
+         UsrCrd = va_arg(VarArg, double *);
+         *UsrCrd = GetScalar(&adr[ (size_t)lin * dat->LinSiz ], dat->ItmTyp / 5, i);
+      }
+   }
+   else if( (dat->AloTyp == GmlEleDat) && (dat->MshTyp > GmlVertices) )
+   {
+      EleTab = (int *)dat->CpuMem;
+      siz = TypVecSiz[ MshItmTyp[ dat->MshTyp ] ];
+      RefIdx = gml->RefIdx[ dat->MshTyp ];
+      RefDat = gml->dat[ RefIdx ];
+      RefTab = (int *)RefDat->CpuMem;
+
+      if( (lin < RefDat->HstBeg) || (lin > RefDat->HstEnd) )
+         DownloadData(gml, RefIdx);
+
+      for(i=0;i<EleNmbNod[ dat->MshTyp ];i++)
+      {
+         UsrDat = va_arg(VarArg, int *);
+         *UsrDat = EleTab[ lin * siz + i ];
+      }
+
+      UsrDat = va_arg(VarArg, int *);
+      *UsrDat = RefTab[ lin ];
+   }
+
+   va_end(VarArg);
+
+   return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Set a range of mesh data lines in a row                                    */
+/*----------------------------------------------------------------------------*/
+
+int GmlSetDataBlock( size_t GmlIdx, int   TypIdx,
+                     int    BegIdx, int   EndIdx,
+                     void  *DatBeg, void *DatEnd,
+                     int   *RefBeg, int  *RefEnd )
+{
+   GETGMLPTR(gml, GmlIdx);
+   CHKELETYP(TypIdx);
+   int      DatIdx = gml->TypIdx[ TypIdx ], RefIdx = gml->RefIdx[ TypIdx ];
+   DatSct   *dat = gml->dat[ DatIdx ], *RefDat;
+   int      i, j, *EleTab, siz, *RefTab, *UsrRef, *UsrEle;
+   char     *CrdTab, *UsrCrd;
+   size_t   DatLen, RefLen;
+
+   if( (EndIdx <= BegIdx) || (dat->AloTyp != GmlEleDat) )
+      return(0);
+
+   if(dat->MshTyp == GmlVertices)
+   {
+      // User's coordinates are floats or doubles, like the vertices storage
+      CrdTab = (char *)dat->CpuMem;
+      RefIdx = gml->RefIdx[ TypIdx ];
+      RefDat = gml->dat[ RefIdx ];
+      RefTab = (int *)RefDat->CpuMem;
+      UsrCrd = (char *)DatBeg;
+      UsrRef = (int *)RefBeg;
+      DatLen = ((char *)DatEnd - (char *)DatBeg) / (EndIdx - BegIdx);
+      RefLen = (RefEnd - RefBeg) / (EndIdx - BegIdx);
+      siz    = dat->ItmTyp / 5;
+
+      for(i=BegIdx;i<=EndIdx;i++)
+      {
+         CopyScalars(&CrdTab[ (size_t)i * dat->LinSiz ], siz,
+                     &UsrCrd[ (i - BegIdx) * DatLen ], siz, 3);
+
+         SetScalar(&CrdTab[ (size_t)i * dat->LinSiz ], siz, 3, 0.);
+
+         if(UsrRef)
+            RefTab[i] = UsrRef[ (i - BegIdx) * RefLen ];
+      }
+   }
+   else
+   {
+      EleTab = (int *)dat->CpuMem;
+      RefIdx = gml->RefIdx[ TypIdx ];
+      siz    = TypVecSiz[ MshItmTyp[ dat->MshTyp ] ];
+      RefDat = gml->dat[ gml->RefIdx[ dat->MshTyp ] ];
+      RefTab = (int *)RefDat->CpuMem;
+      UsrEle = (int *)DatBeg;
+      UsrRef = (int *)RefBeg;
+      DatLen = ((int *)DatEnd - (int *)DatBeg) / (EndIdx - BegIdx);
+      RefLen = (RefEnd - RefBeg) / (EndIdx - BegIdx);
+
+      for(i=BegIdx;i<=EndIdx;i++)
+      {
+         for(j=0; j<EleNmbNod[ dat->MshTyp ]; j++)
+            EleTab[ i * siz + j ] =  UsrEle[ (i - BegIdx) * DatLen + j ];
+
+         if(UsrRef)
+            RefTab[i] = UsrRef[ (i - BegIdx) * RefLen ];
+      }
+   }
+
+   SetDirtyLines(gml, DatIdx, BegIdx, EndIdx);
+   SetDirtyLines(gml, RefIdx, BegIdx, EndIdx);
+
+   if(EndIdx == dat->NmbLin - 1)
+   {
+      UploadLines(gml, DatIdx, dat->DrtBeg, dat->DrtEnd);
+      UploadLines(gml, RefIdx, gml->dat[ RefIdx ]->DrtBeg,
+                  gml->dat[ RefIdx ]->DrtEnd);
+   }
+
+   return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Get a range mesh data lines in a row                                       */
+/*----------------------------------------------------------------------------*/
+
+int GmlGetDataBlock( size_t GmlIdx, int   TypIdx,
+                     int    BegIdx, int   EndIdx,
+                     void  *DatBeg, void *DatEnd,
+                     int   *RefBeg, int  *RefEnd )
+{
+   GETGMLPTR(gml, GmlIdx);
+   CHKELETYP(TypIdx);
+   int      DatIdx = gml->TypIdx[ TypIdx ], RefIdx = gml->RefIdx[ TypIdx ];
+   DatSct   *dat = gml->dat[ DatIdx ], *RefDat;
+   int      i, j, *EleTab, siz, *RefTab, *UsrRef, *UsrEle;
+   char     *CrdTab, *UsrCrd;
+   size_t   DatLen, RefLen;
+
+   if( (EndIdx <= BegIdx) || (dat->AloTyp != GmlEleDat) )
+      return(0);
+
+   // Only fetch the requested lines that are not valid on the host side
+   if(!GetHostLines(gml, DatIdx, BegIdx, EndIdx)
+   || !GetHostLines(gml, RefIdx, BegIdx, EndIdx) )
+   {
+      return(0);
+   }
+
+   if(dat->MshTyp == GmlVertices)
+   {
+      CrdTab = (char *)dat->CpuMem;
+      RefDat = gml->dat[ RefIdx ];
+      RefTab = (int *)RefDat->CpuMem;
+      UsrCrd = (char *)DatBeg;
+      UsrRef = (int *)RefBeg;
+      DatLen = ((char *)DatEnd - (char *)DatBeg) / (EndIdx - BegIdx);
+      RefLen = (RefEnd - RefBeg) / (EndIdx - BegIdx);
+      siz    = dat->ItmTyp / 5;
+
+      for(i=BegIdx;i<=EndIdx;i++)
+      {
+         CopyScalars(&UsrCrd[ (i - BegIdx) * DatLen ], siz,
+                     &CrdTab[ (size_t)i * dat->LinSiz ], siz, 3);
+
+         if(UsrRef)
+            UsrRef[ (i - BegIdx) * RefLen ] = RefTab[i];
+      }
+   }
+   else
+   {
+      EleTab = (int *)dat->CpuMem;
       siz = TypVecSiz[ MshItmTyp[ dat->MshTyp ] ];
-      RefDat = &gml->dat[ gml->RefIdx[ dat->MshTyp ] ];
+      RefDat = gml->dat[ gml->RefIdx[ dat->MshTyp ] ];
       RefTab = (int *)RefDat->CpuMem;
       UsrEle = (int *)DatBeg;
       UsrRef = (int *)RefBeg;
       DatLen = ((int *)DatEnd - (int *)DatBeg) / (EndIdx - BegIdx);
       RefLen = (RefEnd - RefBeg) / (EndIdx - BegIdx);
 
-      for(i=BegIdx;i<=EndIdx;i++)
-      {
-         for(j=0; j<EleNmbNod[ dat->MshTyp ]; j++)
-            UsrEle[ (i - BegIdx) * DatLen + j ] = EleTab[ i * siz + j ];
+      for(i=BegIdx;i<=EndIdx;i++)
+      {
+         for(j=0; j<EleNmbNod[ dat->MshTyp ]; j++)
+            UsrEle[ (i - BegIdx) * DatLen + j ] = EleTab[ i * siz + j ];
+
+         if(UsrRef)
+            UsrRef[ (i - BegIdx) * RefLen ] = RefTab[i];
+      }
+   }
+
+   return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Blocking transfer of a single line between the device and a user buffer    */
+/*----------------------------------------------------------------------------*/
+
+static int StageLine(GmlSct *gml, int idx, int lin, void *UsrBuf, int WrtFlg)
+{
+   int      res;
+   size_t   off;
+   DatSct   *dat = gml->dat[ idx ];
+
+   if(!dat->GpuMem || !UsrBuf || (lin < 0) || (lin >= dat->NmbLin))
+      return(0);
+
+   off = (size_t)lin * (size_t)dat->LinSiz;
+
+   if(WrtFlg)
+      res = clEnqueueWriteBuffer(gml->queue, dat->GpuMem, CL_TRUE, off,
+                                 dat->LinSiz, UsrBuf, 0, NULL, NULL);
+   else
+      res = clEnqueueReadBuffer( gml->queue, dat->GpuMem, CL_TRUE, off,
+                                 dat->LinSiz, UsrBuf, 0, NULL, NULL);
+
+   if(res != CL_SUCCESS)
+   {
+      printf("Staging line %d of data %d failed with error %d\n", lin, idx, res);
+      return(0);
+   }
+
+   gml->MovSiz += dat->LinSiz;
+
+   return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Fill a whole data with a single item value on the device side              */
+/*----------------------------------------------------------------------------*/
+
+int GmlFillData(size_t GmlIdx, int DatIdx, void *pattern)
+{
+   GETGMLPTR(gml, GmlIdx);
+   CHKDATIDX(gml, DatIdx);
+   DatSct   *dat = gml->dat[ DatIdx ];
+   int      res;
+
+   if(!dat->GpuMem || !pattern)
+      return(0);
+
+   // The pattern is one item of the data (int, float4, double2...)
+   // whose size is always a power of two as required by OpenCL
+   res = clEnqueueFillBuffer( gml->queue, dat->GpuMem, pattern, dat->ItmSiz,
+                              0, dat->MemSiz, 0, NULL, NULL );
+
+   if(res != CL_SUCCESS)
+   {
+      printf("Filling the data %d failed with error %d\n", DatIdx, res);
+      return(0);
+   }
+
+   // The device now holds the reference values: pending host modifications
+   // are discarded and the host mirror will be downloaded on demand
+   dat->DrtBeg = dat->NmbLin;
+   dat->DrtEnd = -1;
+   dat->HstBeg = dat->NmbLin;
+   dat->HstEnd = -1;
+
+   return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Copy a whole data into another one of the same size on the device side     */
+/*----------------------------------------------------------------------------*/
+
+int GmlCopyData(size_t GmlIdx, int DstIdx, int SrcIdx)
+{
+   GETGMLPTR(gml, GmlIdx);
+   CHKDATIDX(gml, DstIdx);
+   CHKDATIDX(gml, SrcIdx);
+   DatSct   *dst = gml->dat[ DstIdx ], *src = gml->dat[ SrcIdx ];
+   int      res;
+
+   if( !dst->GpuMem || !src->GpuMem || (DstIdx == SrcIdx)
+   ||  (dst->NmbLin != src->NmbLin) || (dst->LinSiz != src->LinSiz) )
+   {
+      return(0);
+   }
+
+   // Make sure the source buffer includes the latest host modifications
+   if( (src->DrtBeg <= src->DrtEnd) && (src->MemAcs != GmlOutput) )
+      UploadLines(gml, SrcIdx, src->DrtBeg, src->DrtEnd);
+
+   res = clEnqueueCopyBuffer( gml->queue, src->GpuMem, dst->GpuMem, 0, 0,
+                              MIN(dst->MemSiz, src->MemSiz), 0, NULL, NULL );
+
+   if(res != CL_SUCCESS)
+   {
+      printf("Copying data %d into %d failed with error %d\n", SrcIdx, DstIdx, res);
+      return(0);
+   }
+
+   dst->DrtBeg = dst->NmbLin;
+   dst->DrtEnd = -1;
+   dst->HstBeg = dst->NmbLin;
+   dst->HstEnd = -1;
+
+   return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Set a range of solution data lines from a user's strided array             */
+/*----------------------------------------------------------------------------*/
+
+int GmlSetSolutionBlock(size_t GmlIdx, int   DatIdx,
+                        int    BegIdx, int   EndIdx, int UsrTyp,
+                        void  *DatBeg, void *DatEnd )
+{
+   GETGMLPTR(gml, GmlIdx);
+   CHKDATIDX(gml, DatIdx);
+   CHKOCLTYP(UsrTyp);
+   DatSct   *dat = gml->dat[ DatIdx ];
+   int      i, SolTyp, NmbScl, FstLin = 0, res = 1;
+   char     *SolTab, *UsrTab = (char *)DatBeg;
+   size_t   UsrLen, off, siz;
+
+   if( (dat->AloTyp != GmlRawDat) || !dat->GpuMem || !DatBeg
+   ||  (BegIdx < 0) || (EndIdx < BegIdx) || (EndIdx >= dat->NmbLin) )
+   {
+      return(0);
+   }
+
+   // Get the scalar types and the user's stride in bytes
+   SolTyp = dat->ItmTyp / 5;
+   UsrTyp = UsrTyp / 5;
+   NmbScl = dat->LinSiz / SclTypSiz[ SolTyp ];
+   SolTab = (char *)dat->CpuMem;
+   off    = (size_t)BegIdx * dat->LinSiz;
+   siz    = (size_t)(EndIdx - BegIdx + 1) * dat->LinSiz;
+
+   if(EndIdx > BegIdx)
+      UsrLen = ((char *)DatEnd - (char *)DatBeg) / (EndIdx - BegIdx);
+   else
+      UsrLen = (size_t)NmbScl * SclTypSiz[ UsrTyp ];
+
+   // A null stride (DatEnd == DatBeg) broadcasts the same user line
+   if(UsrLen && (UsrLen < (size_t)NmbScl * SclTypSiz[ UsrTyp ]))
+      return(0);
+
+   // Device only data are converted in a temporary staging buffer
+   if(!SolTab)
+   {
+      if(!(SolTab = malloc(siz)))
+         return(0);
+
+      FstLin = BegIdx;
+   }
+
+   // Copy and convert the lines straight into the host mirror or staging area
+#ifdef _OPENMP
+#pragma omp parallel for if(EndIdx - BegIdx >= MINPARLIN)
+#endif
+   for(i=BegIdx;i<=EndIdx;i++)
+      CopyScalars(&SolTab[ (size_t)(i - FstLin) * dat->LinSiz ], SolTyp,
+                  &UsrTab[ (size_t)(i - BegIdx) * UsrLen ], UsrTyp, NmbScl);
+
+   if(!dat->CpuMem)
+   {
+      if(clEnqueueWriteBuffer(gml->queue, dat->GpuMem, CL_TRUE, off, siz,
+                              SolTab, 0, NULL, NULL) != CL_SUCCESS)
+      {
+         res = 0;
+      }
+      else
+         gml->MovSiz += siz;
+
+      free(SolTab);
+      return(res);
+   }
+
+   SetDirtyLines(gml, DatIdx, BegIdx, EndIdx);
+
+   if(EndIdx == dat->NmbLin - 1)
+      UploadLines(gml, DatIdx, dat->DrtBeg, dat->DrtEnd);
+
+   return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Get a range of solution data lines into a user's strided array             */
+/*----------------------------------------------------------------------------*/
+
+int GmlGetSolutionBlock(size_t GmlIdx, int   DatIdx,
+                        int    BegIdx, int   EndIdx, int UsrTyp,
+                        void  *DatBeg, void *DatEnd )
+{
+   GETGMLPTR(gml, GmlIdx);
+   CHKDATIDX(gml, DatIdx);
+   CHKOCLTYP(UsrTyp);
+   DatSct   *dat = gml->dat[ DatIdx ];
+   int      i, SolTyp, NmbScl, FstLin = 0, res = 1;
+   char     *SolTab, *UsrTab = (char *)DatBeg;
+   size_t   UsrLen, off, siz;
+
+   if( (dat->AloTyp != GmlRawDat) || !dat->GpuMem || !DatBeg
+   ||  (BegIdx < 0) || (EndIdx < BegIdx) || (EndIdx >= dat->NmbLin) )
+   {
+      return(0);
+   }
+
+   SolTyp = dat->ItmTyp / 5;
+   UsrTyp = UsrTyp / 5;
+   NmbScl = dat->LinSiz / SclTypSiz[ SolTyp ];
+   SolTab = (char *)dat->CpuMem;
+   off    = (size_t)BegIdx * dat->LinSiz;
+   siz    = (size_t)(EndIdx - BegIdx + 1) * dat->LinSiz;
+
+   if(EndIdx > BegIdx)
+      UsrLen = ((char *)DatEnd - (char *)DatBeg) / (EndIdx - BegIdx);
+   else
+      UsrLen = (size_t)NmbScl * SclTypSiz[ UsrTyp ];
+
+   if(UsrLen < (size_t)NmbScl * SclTypSiz[ UsrTyp ])
+      return(0);
+
+   if(!SolTab)
+   {
+      // Device only data are read in a temporary staging buffer
+      if(!(SolTab = malloc(siz)))
+         return(0);
+
+      FstLin = BegIdx;
+
+      if(clEnqueueReadBuffer( gml->queue, dat->GpuMem, CL_TRUE, off, siz,
+                              SolTab, 0, NULL, NULL ) != CL_SUCCESS)
+      {
+         free(SolTab);
+         return(0);
+      }
+
+      gml->MovSiz += siz;
+   }
+   else if(!GetHostLines(gml, DatIdx, BegIdx, EndIdx))
+   {
+      // Only fetch the requested lines that are not valid on the host side
+      return(0);
+   }
+
+#ifdef _OPENMP
+#pragma omp parallel for if(EndIdx - BegIdx >= MINPARLIN)
+#endif
+   for(i=BegIdx;i<=EndIdx;i++)
+      CopyScalars(&UsrTab[ (size_t)(i - BegIdx) * UsrLen ], UsrTyp,
+                  &SolTab[ (size_t)(i - FstLin) * dat->LinSiz ], SolTyp, NmbScl);
+
+   if(!dat->CpuMem)
+      free(SolTab);
+
+   return(res);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Copy and convert a line of int, float, double or char scalars              */
+/*----------------------------------------------------------------------------*/
+
+#define CPYSCL(d,s) for(i=0;i<NmbScl;i++) ((d *)DstTab)[i] = (d)((s *)SrcTab)[i]
+
+static void CopyScalars(char *DstTab, int DstTyp,
+                        char *SrcTab, int SrcTyp, int NmbScl)
+{
+   int i;
+
+   if(DstTyp == SrcTyp)
+   {
+      memcpy(DstTab, SrcTab, (size_t)NmbScl * SclTypSiz[ DstTyp ]);
+      return;
+   }
+
+   // Half and short conversions go through a slower generic path
+   if( (DstTyp > 3) || (SrcTyp > 3) )
+   {
+      for(i=0;i<NmbScl;i++)
+         SetScalar(DstTab, DstTyp, i, GetScalar(SrcTab, SrcTyp, i));
+
+      return;
+   }
+
+   switch(DstTyp * 4 + SrcTyp)
+   {
+      case  1 : CPYSCL(cl_int,    cl_float);  break;
+      case  2 : CPYSCL(cl_int,    cl_double); break;
+      case  3 : CPYSCL(cl_int,    cl_char);   break;
+      case  4 : CPYSCL(cl_float,  cl_int);    break;
+      case  6 : CPYSCL(cl_float,  cl_double); break;
+      case  7 : CPYSCL(cl_float,  cl_char);   break;
+      case  8 : CPYSCL(cl_double, cl_int);    break;
+      case  9 : CPYSCL(cl_double, cl_float);  break;
+      case 11 : CPYSCL(cl_double, cl_char);   break;
+      case 12 : CPYSCL(cl_char,   cl_int);    break;
+      case 13 : CPYSCL(cl_char,   cl_float);  break;
+      case 14 : CPYSCL(cl_char,   cl_double); break;
+   }
+}
+
+#undef CPYSCL
+
+
+/*----------------------------------------------------------------------------*/
+/* Read any type of scalar from a table and return it as a double             */
+/*----------------------------------------------------------------------------*/
+
+static double GetScalar(char *tab, int typ, int idx)
+{
+   switch(typ)
+   {
+      case 0 : return((double)((cl_int    *)tab)[ idx ]);
+      case 1 : return((double)((cl_float  *)tab)[ idx ]);
+      case 2 : return((double)((cl_double *)tab)[ idx ]);
+      case 3 : return((double)((cl_char   *)tab)[ idx ]);
+      case 4 : return((double)HlfToFlt(((cl_half *)tab)[ idx ]));
+      case 5 : return((double)((cl_short  *)tab)[ idx ]);
+   }
+
+   return(0.);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Convert a double and store it in any type of scalar table                  */
+/*----------------------------------------------------------------------------*/
+
+static void SetScalar(char *tab, int typ, int idx, double val)
+{
+   switch(typ)
+   {
+      case 0 : ((cl_int    *)tab)[ idx ] = (cl_int)val;    break;
+      case 1 : ((cl_float  *)tab)[ idx ] = (cl_float)val;  break;
+      case 2 : ((cl_double *)tab)[ idx ] = (cl_double)val; break;
+      case 3 : ((cl_char   *)tab)[ idx ] = (cl_char)val;   break;
+      case 4 : ((cl_half   *)tab)[ idx ] = FltToHlf((float)val); break;
+      case 5 : ((cl_short  *)tab)[ idx ] = (cl_short)val;  break;
+   }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Convert an IEEE half float into a single precision one                     */
+/*----------------------------------------------------------------------------*/
+
+static float HlfToFlt(cl_half hlf)
+{
+   int   exp = (hlf >> 10) & 31, man = hlf & 1023;
+   float res;
+
+   if(!exp)
+      res = ldexpf((float)man, -24);
+   else if(exp == 31)
+      res = man ? NAN : INFINITY;
+   else
+      res = ldexpf((float)(man | 1024), exp - 25);
+
+   return((hlf & 0x8000) ? -res : res);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Round a single precision float to the nearest even IEEE half float         */
+/*----------------------------------------------------------------------------*/
+
+static cl_half FltToHlf(float flt)
+{
+   int            exp, sft;
+   unsigned int   bit, sgn, man, hlf, rem, mid;
+
+   memcpy(&bit, &flt, sizeof(float));
+   sgn = (bit >> 16) & 0x8000;
+   exp = (int)((bit >> 23) & 255) - 112;
+   man = bit & 0x7fffff;
+
+   // Infinity and NaN
+   if(exp == 143)
+      return((cl_half)(sgn | 0x7c00 | (man ? 0x200 : 0)));
+
+   // Overflow to infinity
+   if(exp >= 31)
+      return((cl_half)(sgn | 0x7c00));
+
+   // Normal numbers: keep the ten leading bits of the mantissa
+   if(exp > 0)
+   {
+      hlf = ((unsigned int)exp << 10) | (man >> 13);
+      rem = man & 0x1fff;
+      mid = 0x1000;
+   }
+   else
+   {
+      // Denormalized numbers or underflow to zero
+      if(exp < -10)
+         return((cl_half)sgn);
+
+      man |= 0x800000;
+      sft = 14 - exp;
+      hlf = man >> sft;
+      rem = man & ((1u << sft) - 1);
+      mid = 1u << (sft - 1);
+   }
+
+   // A carry propagates to the exponent, which is the right behaviour
+   if( (rem > mid) || ((rem == mid) && (hlf & 1)) )
+      hlf++;
+
+   return((cl_half)(sgn | hlf));
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Copy user's data into an OpenCL buffer                                     */
+/*----------------------------------------------------------------------------*/
+
+static int UploadData(GmlSct *gml, int idx)
+{
+   if( (idx < 1) || (idx > gml->MaxDat) )
+      return(0);
+
+   return(UploadLines(gml, idx, 0, gml->dat[ idx ]->NmbLin - 1));
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Copy an OpenCL buffer into user's data                                     */
+/*----------------------------------------------------------------------------*/
+
+static int DownloadData(GmlSct *gml, int idx)
+{
+   if( (idx < 1) || (idx > gml->MaxDat) )
+      return(0);
+
+   return(DownloadLines(gml, idx, 0, gml->dat[ idx ]->NmbLin - 1));
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Get the byte offset and size of a range of lines                           */
+/*----------------------------------------------------------------------------*/
+
+static void GetLinesExtent(DatSct *dat, int BegLin, int EndLin,
+                           size_t *off, size_t *siz)
+{
+   *off = (size_t)BegLin * (size_t)dat->LinSiz;
+
+   // The last line range also carries any trailing padding
+   if(EndLin == dat->NmbLin - 1)
+      *siz = dat->MemSiz - *off;
+   else
+      *siz = (size_t)(EndLin - BegLin + 1) * (size_t)dat->LinSiz;
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Copy a range of lines from the host mirror into the OpenCL buffer          */
+/*----------------------------------------------------------------------------*/
+
+static int UploadLines(GmlSct *gml, int idx, int BegLin, int EndLin)
+{
+   int      res;
+   size_t   off, siz;
+   DatSct   *dat;
+
+   // Check indices
+   if( (idx < 1) || (idx > gml->MaxDat) )
+      return(0);
+
+   dat = gml->dat[ idx ];
+
+   if(!dat->GpuMem || !dat->CpuMem || (dat->MemAcs == GmlOutput))
+      return(0);
+
+   if( (BegLin < 0) || (EndLin >= dat->NmbLin) || (BegLin > EndLin) )
+      return(0);
+
+   GetLinesExtent(dat, BegLin, EndLin, &off, &siz);
+
+   // Zero-copy buffers already hold the host data:
+   // a map/unmap cycle is enough to hand them back to the device
+   if(dat->ZerCpy)
+   {
+      if(!MapData(gml, dat, CL_MAP_WRITE_INVALIDATE_REGION, off, siz))
+         return(0);
+   }
+   else
+   {
+      // Upload buffer from CPU ram to GPU ram
+      // and keep track of the amount of uploaded data
+      res = clEnqueueWriteBuffer(gml->queue, dat->GpuMem, CL_FALSE, off, siz,
+                                 (char *)dat->CpuMem + off, 0, NULL, NULL);
+
+      if(res != CL_SUCCESS)
+      {
+         printf("Uploading the data to the GPu failed with error %d\n", res);
+         return(0);
+      }
+
+      gml->MovSiz += siz;
+   }
+
+   // The device is now up to date if the whole dirty range was sent
+   if( (BegLin <= dat->DrtBeg) && (EndLin >= dat->DrtEnd) )
+   {
+      dat->DrtBeg = dat->NmbLin;
+      dat->DrtEnd = -1;
+   }
+
+   return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Copy a range of lines from the OpenCL buffer into the host mirror          */
+/*----------------------------------------------------------------------------*/
+
+static int DownloadLines(GmlSct *gml, int idx, int BegLin, int EndLin)
+{
+   int      res;
+   size_t   off, siz;
+   DatSct   *dat;
+
+   // Check indices
+   if( (idx < 1) || (idx > gml->MaxDat) )
+      return(0);
+
+   dat = gml->dat[ idx ];
+
+   if(!dat->GpuMem || !dat->CpuMem)
+      return(0);
+
+   if( (BegLin < 0) || (EndLin >= dat->NmbLin) || (BegLin > EndLin) )
+      return(0);
+
+   // Send the pending host modifications first so they are not overwritten
+   if( (dat->DrtBeg <= dat->DrtEnd) && (dat->MemAcs != GmlOutput) )
+      UploadLines(gml, idx, dat->DrtBeg, dat->DrtEnd);
+
+   GetLinesExtent(dat, BegLin, EndLin, &off, &siz);
+
+   // Mapping a zero-copy buffer waits for the kernels writing to it
+   // and makes their results visible in the host memory
+   if(dat->ZerCpy)
+   {
+      if(!MapData(gml, dat, CL_MAP_READ, off, siz))
+         return(0);
+   }
+   else
+   {
+      // Download buffer from GPU ram to CPU ram
+      // and keep track of the amount of downloaded data
+      res = clEnqueueReadBuffer( gml->queue, dat->GpuMem, CL_TRUE, off, siz,
+                                 (char *)dat->CpuMem + off, 0, NULL, NULL );
+
+      if(res != CL_SUCCESS)
+      {
+         printf("Downloading the data from the GPu failed with error %d\n", res);
+         return(0);
+      }
+
+      gml->MovSiz += siz;
+   }
+
+   // Merge this range with the valid host one if they overlap or touch,
+   // otherwise only keep the latest one
+   if( (dat->HstBeg <= dat->HstEnd)
+   &&  (BegLin <= dat->HstEnd + 1) && (EndLin >= dat->HstBeg - 1) )
+   {
+      dat->HstBeg = MIN(dat->HstBeg, BegLin);
+      dat->HstEnd = MAX(dat->HstEnd, EndLin);
+   }
+   else
+   {
+      dat->HstBeg = BegLin;
+      dat->HstEnd = EndLin;
+   }
+
+   return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Synchronize a zero-copy buffer with a blocking map/unmap cycle             */
+/*----------------------------------------------------------------------------*/
+
+static int MapData(  GmlSct *gml, DatSct *dat, cl_map_flags flg,
+                     size_t off, size_t siz )
+{
+   cl_int   res;
+   char     *ptr;
+
+   ptr = clEnqueueMapBuffer(  gml->queue, dat->GpuMem, CL_TRUE, flg, off,
+                              siz, 0, NULL, NULL, &res );
+
+   if(!ptr || (res != CL_SUCCESS))
+   {
+      printf("Mapping the data failed with error %d\n", res);
+      return(0);
+   }
+
+   // A buffer created with the USE_HOST_PTR flag should be mapped in place,
+   // otherwise fall back to a plain copy between both memory areas
+   if(ptr != (char *)dat->CpuMem + off)
+   {
+      if(flg & CL_MAP_READ)
+         memcpy((char *)dat->CpuMem + off, ptr, siz);
+      else
+         memcpy(ptr, (char *)dat->CpuMem + off, siz);
+
+      gml->MovSiz += siz;
+   }
+
+   res = clEnqueueUnmapMemObject(gml->queue, dat->GpuMem, ptr, 0, NULL, NULL);
+
+   if(res != CL_SUCCESS)
+   {
+      printf("Unmapping the data failed with error %d\n", res);
+      return(0);
+   }
+
+   return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Add a range of modified host lines to the ones to be uploaded              */
+/*----------------------------------------------------------------------------*/
+
+static void SetDirtyLines(GmlSct *gml, int idx, int BegLin, int EndLin)
+{
+   DatSct *dat;
+
+   if( (idx < 1) || (idx > gml->MaxDat) )
+      return;
+
+   dat = gml->dat[ idx ];
+   dat->DrtBeg = MIN(dat->DrtBeg, BegLin);
+   dat->DrtEnd = MAX(dat->DrtEnd, EndLin);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Make sure a range of lines is up to date in the host mirror                */
+/*----------------------------------------------------------------------------*/
+
+static int GetHostLines(GmlSct *gml, int idx, int BegLin, int EndLin)
+{
+   DatSct *dat;
+
+   if( (idx < 1) || (idx > gml->MaxDat) )
+      return(0);
+
+   dat = gml->dat[ idx ];
+
+   if( (BegLin >= dat->HstBeg) && (EndLin <= dat->HstEnd) )
+      return(1);
+
+   return(DownloadLines(gml, idx, BegLin, EndLin));
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Explicitly upload a range of lines to the device                           */
+/*----------------------------------------------------------------------------*/
+
+int GmlUploadRange(size_t GmlIdx, int DatIdx, int BegLin, int EndLin)
+{
+   GETGMLPTR(gml, GmlIdx);
+   CHKDATIDX(gml, DatIdx);
+
+   return(UploadLines(gml, DatIdx, BegLin, EndLin));
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Explicitly download a range of lines from the device                       */
+/*----------------------------------------------------------------------------*/
+
+int GmlDownloadRange(size_t GmlIdx, int DatIdx, int BegLin, int EndLin)
+{
+   GETGMLPTR(gml, GmlIdx);
+   CHKDATIDX(gml, DatIdx);
+
+   return(DownloadLines(gml, DatIdx, BegLin, EndLin));
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Send the parameter structure data to the GPU                               */
+/*----------------------------------------------------------------------------*/
+
+int GmlUploadParameters(size_t idx)
+{
+   GETGMLPTR(gml, idx);
+
+   if(!UploadData(gml, gml->ParIdx))
+      return(0);
+   else
+      return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Get the parameter structure data from the GPU                              */
+/*----------------------------------------------------------------------------*/
+
+int GmlDownloadParameters(size_t idx)
+{
+   GETGMLPTR(gml, idx);
+
+   if(!DownloadData(gml, gml->ParIdx))
+      return(0);
+   else
+      return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/*----------------------------------------------------------------------------*/
+
+void GmlSetCompilerOptions(size_t GmlIdx, char *OptStr)
+{
+   GETGMLPTR(gml, GmlIdx);
+   strcpy(gml->cflags, OptStr);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Generate the kernel from user's source and data and compile it             */
+/*----------------------------------------------------------------------------*/
+
+int GmlCompileKernel(size_t GmlIdx, char *KrnSrc, char *PrcNam,
+                     int MshTyp, int NmbTyp, ...)
+{
+   GETGMLPTR(gml, GmlIdx);
+   int      i, j, flg, KrnIdx, KrnHghIdx, SrcTyp, DstTyp, NmbArg = 0, RefIdx;
+   int      FlgTab[ GmlMaxDat ], IdxTab[ GmlMaxDat ];
+   int      LnkTab[ GmlMaxDat ], CntTab[ GmlMaxDat ];
+   int      LnkItm, NmbItm, ItmTyp, ItmLen, LnkPos, CptPos, ArgHghPos;
+   int      RefFlg, HghVec, HghSiz, HghTyp, TieArg = -1, TieTyp, TieIdx, TieWid;
+   int      VoyArg = -1, PrmArg = -1, BalArg, CsrFlg, TieFlg, PrvIdx, t;
+   int      TagArg = -1, LnkCol, CavFlg;
+   char     *ParSrc, src[ GmlMaxSrcSiz ] = "\0", VoyNam[ GmlMaxStrSiz ];
+   char     BalNam[ GmlMaxStrSiz ], DegNam[ GmlMaxStrSiz ];
+   va_list  VarArg;
+   DatSct   *dat, *RefDat;
+   ArgSct   *arg, ArgTab[ GmlMaxOclTyp ];
+   KrnSct   *krn;
+
+   // Read user's datatypes arguments
+   ParSrc = gml->ParIdx ? gml->dat[ gml->ParIdx ]->src : NULL;
+
+   va_start(VarArg, NmbTyp);
+
+   for(i=0;i<NmbTyp;i++)
+   {
+      IdxTab[i] = va_arg(VarArg, int);
+      FlgTab[i] = va_arg(VarArg, int);
+      LnkTab[i] = va_arg(VarArg, int);
+      CntTab[i] = 0;
+   }
+
+   va_end(VarArg);
+
+   // Check or build datatype indirect access tables
+   for(i=0;i<NmbTyp;i++)
+   {
+      dat = gml->dat[ IdxTab[i] ];
+
+      // The hybrid ball links vertices to volume data and has its own degrees
+      if(LnkTab[i] && (LnkTab[i] == gml->HybBal))
+      {
+         if( (MshTyp != GmlVertices) || (MshTypDim[ dat->MshTyp ] != 3) )
+         {
+            puts("The hybrid ball only gives access to volume data from vertices.");
+            return(0);
+         }
+
+         CntTab[i] = gml->HybDeg;
+         continue;
+      }
+
+      // So do the cavity links
+      LnkCol = GetLnkCol(gml, MshTyp, dat->MshTyp, LnkTab[i]);
+
+      if(LnkCol != dat->MshTyp)
+      {
+         if(gml->CsrMat[ MshTyp ][ LnkCol ])
+            CntTab[i] = gml->CsrMat[ MshTyp ][ LnkCol ];
+         else
+            CntTab[i] = gml->CntMat[ MshTyp ][ LnkCol ];
+
+         continue;
+      }
+
+      if( LnkTab[i] || (dat->MshTyp == MshTyp) )
+         continue;
+
+      // Source and destination mesh datatype to access the connectivity matrix
+      SrcTyp = MshTyp;
+      DstTyp = dat->MshTyp;
+
+      if(MshTypDim[ SrcTyp ] > MshTypDim[ DstTyp ])
+      {
+         // Downlink
+         if(!gml->LnkMat[ MshTyp ][ dat->MshTyp ])
+         {
+            // Generate the default link between the two kinds of entities
+            sprintf(BalNam, "%s%sLnk", BalTypStr[ MshTyp ], BalTypStr[ DstTyp ]);
+            sprintf(DegNam, "%s%sDeg", BalTypStr[ MshTyp ], BalTypStr[ DstTyp ]);
+            NewBallData(gml, MshTyp, DstTyp, BalNam, DegNam, NULL);
+         }
+
+         LnkTab[i] = gml->LnkMat[ MshTyp ][ DstTyp ];
+         CntTab[i] = 0;
+      }
+      else if(MshTypDim[ SrcTyp ] < MshTypDim[ DstTyp ])
+      {
+         // Uplink
+         if(!gml->LnkMat[ MshTyp ][ dat->MshTyp ])
+         {
+            // Generate the default link between the two kinds of entities
+            sprintf(BalNam, "%s%sBal", BalTypStr[ MshTyp ], BalTypStr[ DstTyp ]);
+            sprintf(DegNam, "%s%sDeg", BalTypStr[ MshTyp ], BalTypStr[ DstTyp ]);
+            sprintf(VoyNam, "%s%sVoy", BalTypStr[ MshTyp ], BalTypStr[ DstTyp ]);
+            NewBallData(gml, MshTyp, DstTyp, BalNam, DegNam, VoyNam);
+         }
+
+         // Packed uplinks get their degrees from their offsets table
+         LnkTab[i] = gml->LnkMat[ MshTyp ][ DstTyp ];
+
+         if(gml->CsrMat[ MshTyp ][ DstTyp ])
+            CntTab[i] = gml->CsrMat[ MshTyp ][ DstTyp ];
+         else
+            CntTab[i] = gml->CntMat[ MshTyp ][ DstTyp ];
+      }
+   }
+
+   // Build the context arguments to store links
+   for(i=0;i<NmbTyp;i++)
+   {
+      // Process each datatype that needs a link
+      if(!LnkTab[i])
+         continue;
+
+      // Try to find if this link already exists in the previously defined arguments
+      dat = gml->dat[ IdxTab[i] ];
+      flg = 0;
+
+      for(j=0;j<NmbArg;j++)
+         if(ArgTab[j].DatIdx == LnkTab[i])
+            flg = 1;
+
+      if(flg)
+         continue;
+
+      // If not, get the link data index from the conectivity matrix
+      SrcTyp = MshTyp;
+      DstTyp = dat->MshTyp;
+      LnkCol = GetLnkCol(gml, MshTyp, DstTyp, LnkTab[i]);
+      CavFlg = (LnkCol != DstTyp) ? 1 : 0;
+      TieFlg = ( gml->NmbTie[ MshTyp ][ LnkCol ]
+               && (LnkTab[i] == gml->LnkMat[ MshTyp ][ LnkCol ]) ) ? 1 : 0;
+      CsrFlg = (TieFlg && gml->CsrMat[ MshTyp ][ LnkCol ]) ? 1 : 0;
+
+      // The hybrid ball is read as a whole along with its entries' kinds
+      // so that data of each kind only fetch the entries matching it
+      if(LnkTab[i] == gml->HybBal)
+      {
+         LnkItm = gml->dat[ LnkTab[i] ]->ItmLen;
+         GetCntVec(LnkItm, &NmbItm, &ItmLen, &ItmTyp);
+
+         arg = &ArgTab[ NmbArg ];
+         arg->ArgIdx = NmbArg;
+         NmbArg++;
+
+         arg->MshTyp = DstTyp;
+         arg->DatIdx = LnkTab[i];
+         arg->LnkDir = 1;
+         arg->LnkTyp = -1;
+         arg->LnkIdx = -1;
+         arg->CntIdx = -1;
+         arg->LnkDeg = -1;
+         arg->MaxDeg = LnkItm;
+         arg->NmbItm = NmbItm;
+         arg->ItmLen = ItmLen;
+         arg->ItmTyp = ItmTyp;
+         arg->FlgTab = GmlReadMode;
+         arg->CsrFlg = 0;
+         arg->TieFlg = 0;
+         arg->TagIdx = -1;
+         arg->nam    = gml->dat[ arg->DatIdx ]->nam;
+
+         if(FlgTab[i] & GmlVoyeurs)
+         {
+            arg->VoyNam  =  gml->dat[ arg->DatIdx ]->VoyNam;
+            arg->FlgTab |=  GmlVoyeurs;
+            FlgTab[i]   &= ~GmlVoyeurs;
+
+            arg = &ArgTab[ NmbArg ];
+            arg->ArgIdx = NmbArg;
+            NmbArg++;
+
+            arg->MshTyp = DstTyp;
+            arg->DatIdx = gml->dat[ LnkTab[i] ]->VoyIdx;
+            arg->LnkDir = 1;
+            arg->LnkTyp = -1;
+            arg->LnkIdx = -1;
+            arg->CntIdx = -1;
+            arg->LnkDeg = -1;
+            arg->MaxDeg = LnkItm;
+            arg->NmbItm = NmbItm;
+            arg->ItmLen = ItmLen;
+            arg->ItmTyp = GmlByt + ItmTyp - GmlInt;
+            arg->FlgTab = GmlReadMode | GmlManual;
+            arg->CsrFlg = 0;
+            arg->TieFlg = 0;
+            arg->TagIdx = -1;
+            arg->nam    = gml->dat[ arg->DatIdx ]->nam;
+         }
+
+         // Entries' kinds, read as they are
+         arg = &ArgTab[ NmbArg ];
+         arg->ArgIdx = NmbArg;
+         TagArg = NmbArg;
+         NmbArg++;
+
+         arg->MshTyp = MshTyp;
+         arg->DatIdx = gml->HybTyp;
+         arg->LnkDir = 1;
+         arg->LnkTyp = -1;
+         arg->LnkIdx = -1;
+         arg->CntIdx = -1;
+         arg->LnkDeg = -1;
+         arg->MaxDeg = LnkItm;
+         arg->NmbItm = NmbItm;
+         arg->ItmLen = ItmLen;
+         arg->ItmTyp = GmlByt + ItmTyp - GmlInt;
+         arg->FlgTab = GmlReadMode;
+         arg->CsrFlg = 0;
+         arg->TieFlg = 0;
+         arg->TagIdx = -1;
+         arg->nam    = gml->dat[ arg->DatIdx ]->nam;
+
+         // Variable counter argument
+         arg = &ArgTab[ NmbArg ];
+         arg->ArgIdx = NmbArg;
+         NmbArg++;
+
+         arg->MshTyp = DstTyp;
+         arg->DatIdx = gml->HybDeg;
+         arg->LnkDir = 0;
+         arg->LnkTyp = -1;
+         arg->LnkIdx = -1;
+         arg->CntIdx = -1;
+         arg->LnkDeg = 1;
+         arg->MaxDeg = 1;
+         arg->NmbItm = 1;
+         arg->ItmLen = 1;
+         arg->ItmTyp = GmlInt;
+         arg->FlgTab = GmlReadMode;
+         arg->CsrFlg = 0;
+         arg->TieFlg = 0;
+         arg->TagIdx = -1;
+         arg->nam    = gml->dat[ arg->DatIdx ]->nam;
+         continue;
+      }
+
+      // A packed uplink is a flat int table read up to its maximum degree
+      // and the library's uplinks are read with their first tier's width
+      if(CsrFlg)
+      {
+         LnkItm = gml->dat[ LnkTab[i] ]->ItmLen;
+         NmbItm = ItmLen = 1;
+         ItmTyp = GmlInt;
+      }
+      else
+      {
+         LnkItm = TieFlg ? gml->dat[ LnkTab[i] ]->ItmLen : LenMatBas[ MshTyp ][ DstTyp ];
+         GetCntVec(LnkItm, &NmbItm, &ItmLen, &ItmTyp);
+      }
+
+      // Create a new contextual arguments
+      arg = &ArgTab[ NmbArg ];
+      arg->ArgIdx = NmbArg;
+      NmbArg++;
+
+      if(!CavFlg && (MshTypDim[ SrcTyp ] > MshTypDim[ DstTyp ]))
+      {
+         // Downlink access arguments
+         arg->MshTyp = DstTyp;
+         arg->DatIdx = LnkTab[i];
+         arg->LnkDir = -1;
+         arg->LnkTyp = -1;
+         arg->LnkIdx = -1;
+         arg->CntIdx = -1;
+         arg->LnkDeg = LnkItm;
+         arg->MaxDeg = LnkItm;
+         arg->NmbItm = NmbItm;
+         arg->ItmLen = ItmLen;
+         arg->ItmTyp = ItmTyp;
+         arg->FlgTab = GmlReadMode;
+         arg->CsrFlg = 0;
+         arg->TieFlg = 0;
+         arg->TagIdx = -1;
+         arg->nam    = gml->dat[ arg->DatIdx ]->nam;
+      }
+      else if(!CavFlg && (MshTypDim[ SrcTyp ] == MshTypDim[ DstTyp ]))
+      {
+         // Neighbours access arguments
+         arg->MshTyp = DstTyp;
+         arg->DatIdx = LnkTab[i];
+         arg->LnkDir = 0;
+         arg->LnkTyp = -1;
+         arg->LnkIdx = -1;
+         arg->CntIdx = -1;
+         arg->LnkDeg = LnkItm;
+         arg->MaxDeg = LnkItm;
+         arg->NmbItm = NmbItm;
+         arg->ItmLen = ItmLen;
+         arg->ItmTyp = ItmTyp;
+         arg->FlgTab = GmlReadMode;
+         arg->CsrFlg = 0;
+         arg->TieFlg = 0;
+         arg->TagIdx = -1;
+         arg->nam    = gml->dat[ arg->DatIdx ]->nam;
+      }
+      else
+      {
+         // Uplink or cavity access arguments
+         arg->MshTyp = DstTyp;
+         arg->DatIdx = LnkTab[i];
+         arg->LnkDir = 1;
+         arg->LnkTyp = -1;
+         arg->LnkIdx = -1;
+         arg->CntIdx = -1;
+         arg->LnkDeg = -1;
+         arg->MaxDeg = LnkItm;
+         arg->NmbItm = NmbItm;
+         arg->ItmLen = ItmLen;
+         arg->ItmTyp = ItmTyp;
+         arg->FlgTab = GmlReadMode;
+         arg->CsrFlg = CsrFlg;
+         arg->TieFlg = 0;
+         arg->TagIdx = -1;
+         arg->nam    = gml->dat[ arg->DatIdx ]->nam;
+         BalArg      = arg->ArgIdx;
+
+         // Packed entries are not copied as a whole into a local vector
+         // but read one by one through the offsets by the data arguments
+         if(CsrFlg)
+            arg->FlgTab |= GmlManual;
+
+         // A single multi-tier uplink may split the kernel's launches
+         if(gml->NmbTie[ MshTyp ][ LnkCol ] > 1)
+         {
+            if(TieArg != -1)
+            {
+               puts("Current limitation prevents mixing two different kinds of uplink in the same kernel.");
+               return(0);
+            }
+
+            TieArg = arg->ArgIdx;
+            TieTyp = LnkCol;
+            arg->TieFlg = 1;
+         }
+
+         // If this uplink requires voyeurs to be set, add the proper flag
+         // to the argument and remove it from the user flag tab
+         if(FlgTab[i] & GmlVoyeurs)
+         {
+            arg->VoyNam  =  gml->dat[ arg->DatIdx ]->VoyNam;
+            arg->FlgTab |=  GmlVoyeurs;
+            FlgTab[i]   &= ~GmlVoyeurs;
+
+            if(!gml->dat[ arg->DatIdx ]->VoyIdx)
+            {
+               puts("This uplink has no voyeurs table.");
+               return(0);
+            }
+
+            // Voyeurs are stored in a separate char table with the same
+            // vector layout as the ball, read along with it by the kernel
+            arg = &ArgTab[ NmbArg ];
+            arg->ArgIdx = NmbArg;
+            NmbArg++;
+
+            if(TieArg == BalArg)
+               VoyArg = arg->ArgIdx;
+
+            arg->MshTyp = DstTyp;
+            arg->DatIdx = gml->dat[ LnkTab[i] ]->VoyIdx;
+            arg->LnkDir = 1;
+            arg->LnkTyp = -1;
+            arg->LnkIdx = -1;
+            arg->CntIdx = -1;
+            arg->LnkDeg = -1;
+            arg->MaxDeg = LnkItm;
+            arg->NmbItm = NmbItm;
+            arg->ItmLen = ItmLen;
+            arg->ItmTyp = GmlByt + ItmTyp - GmlInt;
+            arg->FlgTab = GmlReadMode | GmlManual;
+            arg->CsrFlg = 0;
+            arg->TieFlg = (TieArg == BalArg) ? 1 : 0;
+            arg->TagIdx = -1;
+            arg->nam    = gml->dat[ arg->DatIdx ]->nam;
+         }
+
+         // Variable counter argument
+         arg = &ArgTab[ NmbArg ];
+         arg->ArgIdx = NmbArg;
+         NmbArg++;
+
+         arg->MshTyp = DstTyp;
+         arg->DatIdx = CsrFlg ? gml->CsrMat[ MshTyp ][ LnkCol ]
+                              : gml->CntMat[ MshTyp ][ LnkCol ];
+         arg->LnkDir = 0;
+         arg->LnkTyp = -1;
+         arg->LnkIdx = -1;
+         arg->CntIdx = -1;
+         arg->LnkDeg = 1;
+         arg->MaxDeg = 1;
+         arg->NmbItm = 1;
+         arg->ItmLen = 1;
+         arg->ItmTyp = GmlInt;
+         arg->FlgTab = GmlReadMode;
+         arg->CsrFlg = CsrFlg;
+         arg->TieFlg = 0;
+         arg->TagIdx = -1;
+         arg->nam    = gml->dat[ arg->DatIdx ]->nam;
+
+         // The packed voyeurs are read through the offsets too
+         if(CsrFlg)
+            ArgTab[ BalArg ].CntIdx = arg->ArgIdx;
+
+         // Permuted tiers come with the entity stored at each position
+         if( (TieArg == BalArg) && gml->PrmMat[ MshTyp ][ LnkCol ] )
+         {
+            arg = &ArgTab[ NmbArg ];
+            arg->ArgIdx = NmbArg;
+            PrmArg = NmbArg;
+            NmbArg++;
+
+            arg->MshTyp = MshTyp;
+            arg->DatIdx = gml->PrmMat[ MshTyp ][ LnkCol ];
+            arg->LnkDir = 0;
+            arg->LnkTyp = -1;
+            arg->LnkIdx = -1;
+            arg->CntIdx = -1;
+            arg->LnkDeg = 1;
+            arg->MaxDeg = 1;
+            arg->NmbItm = 1;
+            arg->ItmLen = 1;
+            arg->ItmTyp = GmlInt;
+            arg->FlgTab = GmlReadMode | GmlManual;
+            arg->CsrFlg = 0;
+            arg->TieFlg = 0;
+            arg->TagIdx = -1;
+            arg->nam    = gml->dat[ arg->DatIdx ]->nam;
+         }
+      }
+   }
+
+   // Now that the links are defined first, the user's data can be accessed
+   for(i=0;i<NmbTyp;i++)
+   {
+      // For each datatype, try to find the arguments containing their link and counter
+      dat = gml->dat[ IdxTab[i] ];
+      DstTyp = dat->MshTyp;
+      LnkPos = CptPos = -1;
+
+      if(LnkTab[i])
+         for(j=0;j<NmbArg;j++)
+            if(ArgTab[j].DatIdx == LnkTab[i])
+               LnkPos = j;
+
+      if(CntTab[i])
+         for(j=0;j<NmbArg;j++)
+            if(ArgTab[j].DatIdx == CntTab[i])
+               CptPos = j;
+
+      // Create a new data argument
+      arg = &ArgTab[ NmbArg ];
+      arg->ArgIdx = NmbArg;
+      NmbArg++;
+
+      arg->MshTyp = DstTyp;
+      arg->DatIdx = IdxTab[i];
+      arg->LnkDir = 0;
+      arg->LnkTyp = DstTyp;
+      arg->LnkIdx = LnkPos;
+      arg->CntIdx = CptPos;
+
+      if(LnkPos != -1 && CptPos != -1)
+      {
+         // Downlink with variable counter
+         arg->LnkDeg = -1;
+         arg->MaxDeg = ArgTab[ LnkPos ].MaxDeg;
+         ArgHghPos   = arg->ArgIdx;
+      }
+      else if(LnkPos != -1 && CptPos == -1)
+      {
+         // Link with constant counter
+         arg->LnkDeg = ArgTab[ LnkPos ].LnkDeg;
+         arg->MaxDeg = ArgTab[ LnkPos ].MaxDeg;
+      }
+      else
+      {
+         // No link: straight access
+         arg->LnkDeg = -1;
+         arg->MaxDeg = -1;
+      }
+
+      if(FlgTab[i] & GmlRefFlag)
+      {
+         RefFlg = 1;
+         FlgTab[i]   &= ~GmlRefFlag;
+      }
+      else
+         RefFlg = 0;
+
+      arg->NmbItm = dat->NmbItm;
+      arg->ItmLen = dat->ItmLen;
+      arg->ItmTyp = dat->ItmTyp;
+      arg->FlgTab = FlgTab[i];
+      arg->CsrFlg = 0;
+      arg->TieFlg = 0;
+      arg->TagIdx = (LnkTab[i] && (LnkTab[i] == gml->HybBal)) ? TagArg : -1;
+      arg->nam    = dat->nam;
+
+      if(!RefFlg || (CptPos != -1))
+         continue;
+
+      // Create a new ref argument
+      arg = &ArgTab[ NmbArg ];
+      arg->ArgIdx = NmbArg;
+      NmbArg++;
+
+      RefIdx = gml->RefIdx[ DstTyp ];
+      RefDat = gml->dat[ RefIdx ];
+
+      arg->MshTyp = DstTyp;
+      arg->DatIdx = RefIdx;
+      arg->LnkDir = 0;
+      arg->LnkTyp = DstTyp;
+      arg->LnkIdx = LnkPos;
+      arg->CntIdx = CptPos;
+      arg->LnkDeg = -1;
+      arg->MaxDeg = ArgTab[ LnkPos ].MaxDeg;
+      arg->NmbItm = RefDat->NmbItm;
+      arg->ItmLen = RefDat->ItmLen;
+      arg->ItmTyp = RefDat->ItmTyp;
+      arg->FlgTab = FlgTab[i];
+      arg->CsrFlg = 0;
+      arg->TieFlg = 0;
+      arg->TagIdx = -1;
+      arg->nam    = RefDat->nam;
+   }
+
+   // Generate the kernel source code
+   WriteToolkitSource      (src, toolkit);
+   WriteUserToolkitSource  (src, gml->UsrTlk);
+   WriteUserTypedef        (src, ParSrc);
+   WriteProcedureHeader    (src, PrcNam, MshTyp, NmbArg, ArgTab);
+   WriteKernelVariables    (src, MshTyp, NmbArg, ArgTab);
+   WriteKernelCounters     (src, MshTyp, (PrmArg != -1) ? ArgTab[ PrmArg ].nam : NULL);
+   WriteKernelMemoryReads  (src, MshTyp, NmbArg, ArgTab);
+   WriteUserKernel         (src, KrnSrc);
+   WriteKernelMemoryWrites (src, MshTyp, NmbArg, ArgTab);
+
+   // And Compile it
+   KrnIdx = NewOclKrn      (gml, src, PrcNam, 0);
+
+   if(!KrnIdx)
+      return(0);
+
+   if(gml->DbgFlg)
+   {
+      puts(sep);
+      printf("Generated source for kernel=%s, index=%2d\n", PrcNam, KrnIdx);
+      puts(src);
+   }
+
+   // Store information usefull to the kernel: loop indices and arguments list
+   krn = gml->krn[ KrnIdx ];
+   krn->NmbDat    = NmbArg;
+   krn->NmbLin[1] = 0;
+
+   // In case of constant counter, the kernel loops from 0 to NmbLin-1
+   // Otherwise, it loops up to the start of the next degree tier
+   if(TieArg == -1)
+      krn->NmbLin[0] = gml->dat[ gml->TypIdx[ MshTyp ] ]->NmbLin;
+   else
+      krn->NmbLin[0] = gml->TieLin[ MshTyp ][ TieTyp ][1];
+
+   for(i=0;i<NmbArg;i++)
+      krn->DatTab[i] = ArgTab[i].DatIdx;
+
+   if(TieArg == -1)
+      return(KrnIdx);
+
+   // In case of multi-tier uplink, generate a kernel for each higher
+   // degree tier, chained to the previous one's launch
+   PrvIdx = KrnIdx;
+
+   for(t=1;t<gml->NmbTie[ MshTyp ][ TieTyp ];t++)
+   {
+      TieIdx = gml->TieMat[ MshTyp ][ TieTyp ][t];
+      TieWid = gml->dat[ TieIdx ]->ItmLen;
+      GetCntVec(TieWid, &HghVec, &HghSiz, &HghTyp);
+
+      // Modify the argument containing the uplink with the tier's sizes
+      ArgTab[ TieArg ].DatIdx = TieIdx;
+      ArgTab[ TieArg ].MaxDeg = TieWid;
+      ArgTab[ TieArg ].NmbItm = HghVec;
+      ArgTab[ TieArg ].ItmLen = HghSiz;
+      ArgTab[ TieArg ].ItmTyp = HghTyp;
+
+      // Along with its voyeurs table
+      if(VoyArg != -1)
+      {
+         ArgTab[ VoyArg ].DatIdx = gml->dat[ TieIdx ]->VoyIdx;
+         ArgTab[ VoyArg ].MaxDeg = TieWid;
+         ArgTab[ VoyArg ].NmbItm = HghVec;
+         ArgTab[ VoyArg ].ItmLen = HghSiz;
+         ArgTab[ VoyArg ].ItmTyp = GmlByt + HghTyp - GmlInt;
+      }
+
+      src[0] = '\0';
+
+      // Generate the kernel source code
+      WriteToolkitSource      (src, toolkit);
+      WriteUserToolkitSource  (src, gml->UsrTlk);
+      WriteUserTypedef        (src, ParSrc);
+      WriteProcedureHeader    (src, PrcNam, MshTyp, NmbArg, ArgTab);
+      WriteKernelVariables    (src, MshTyp, NmbArg, ArgTab);
+      WriteKernelCounters     (src, MshTyp, (PrmArg != -1) ? ArgTab[ PrmArg ].nam : NULL);
+      WriteKernelMemoryReads  (src, MshTyp, NmbArg, ArgTab);
+      WriteUserKernel         (src, KrnSrc);
+      WriteKernelMemoryWrites (src, MshTyp, NmbArg, ArgTab);
+
+      // And Compile it
+      KrnHghIdx = NewOclKrn   (gml, src, PrcNam, 0);
+
+      if(!KrnHghIdx)
+         return(0);
+
+      gml->krn[ PrvIdx ]->HghIdx = KrnHghIdx;
+      PrvIdx = KrnHghIdx;
+
+      // Store information usefull to the kernel: loop indices and arguments list
+      krn = gml->krn[ KrnHghIdx ];
+      krn->NmbDat    = NmbArg;
+      krn->NmbLin[0] = gml->TieLin[ MshTyp ][ TieTyp ][ t+1 ] - gml->TieLin[ MshTyp ][ TieTyp ][t];
+      krn->NmbLin[1] = gml->TieLin[ MshTyp ][ TieTyp ][t];
+
+      for(i=0;i<NmbArg;i++)
+         krn->DatTab[i] = ArgTab[i].DatIdx;
+
+      if(gml->DbgFlg)
+      {
+         puts(sep);
+         printf("Generated source for kernel=%s, tier %d, index=%2d\n", PrcNam, t, KrnHghIdx);
+         puts(src);
+      }
+   }
+
+   return(KrnIdx);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Add the geometrical toolkit prototypes and source code                     */
+/*----------------------------------------------------------------------------*/
+
+static void WriteToolkitSource(char *src, char *TlkSrc)
+{
+   strcat(src, "// GMlib MESHING AND GEOMETRICAL TOOLKIT\n");
+   strcat(src, TlkSrc);
+   strcat(src, "\n");
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Add the geometrical toolkit prototypes and source code                     */
+/*----------------------------------------------------------------------------*/
+
+static void WriteUserToolkitSource(char *src, char *TlkSrc)
+{
+   if(!TlkSrc)
+      return;
+
+   strcat(src, "// USER'S TOOLKIT\n");
+   strcat(src, TlkSrc);
+   strcat(src, "\n");
+}
+
+/*----------------------------------------------------------------------------*/
+/* Add the user's parameters structure definition to the source code          */
+/*----------------------------------------------------------------------------*/
+
+static void WriteUserTypedef(char *src, char *ParSrc)
+{
+   strcat(src, "// USER'S ARGUMENTS STRUCTURE\n");
+   strcat(src, ParSrc);
+   strcat(src, "\n");
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Write the procedure name and typedef with all arguments types and names    */
+/*----------------------------------------------------------------------------*/
+
+static void WriteProcedureHeader(char *src, char *PrcNam, int MshTyp,
+                                 int NmbArg, ArgSct *ArgTab)
+{
+   int      i;
+   char     str[ GmlMaxStrSiz ];
+   ArgSct   *arg;
+
+   strcat(src, "// KERNEL HEADER\n");
+   sprintf(str, "__kernel void %s(", PrcNam);
+   strcat(src, str);
+
+   for(i=0;i<NmbArg;i++)
+   {
+      arg = &ArgTab[i];
+
+      // Half floats are stored as a flat table, read and written
+      // through vload_half and vstore_half into float variables
+      if(ISHLF(arg->ItmTyp))
+      {
+         sprintf(str,  "\n   __global half      *%sTab,", arg->nam);
+         strcat(src, str);
+         continue;
+      }
+
+      sprintf(str,  "\n   __global %s ", OclTypStr[ arg->ItmTyp ]);
+      strcat(src, str);
+
+      if(arg->NmbItm <= 1)
+         sprintf(str, "*%sTab,", arg->nam);
+      else
+         sprintf(str, "(*%sTab)[%d],", arg->nam, arg->NmbItm);
+
+      strcat(src, str);
+   }
+
+   strcat(src, "\n   __global GmlParSct *GmlPar,");
+   strcat(src, "\n   const    int2       count )\n{\n");
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Write definition of automatic local variables                              */
+/*----------------------------------------------------------------------------*/
+
+static void WriteKernelVariables(char *src, int MshTyp,
+                                 int NmbArg, ArgSct *ArgTab)
+{
+   int      i;
+   char     str[ GmlMaxStrSiz ];
+   ArgSct   *arg, *LnkArg, *CptArg;
+
+   strcat(src, "// KERNEL VARIABLES DEFINITION\n");
+
+   for(i=0;i<NmbArg;i++)
+   {
+      arg = &ArgTab[i];
+
+      // Packed uplinks only need a local array to store their voyeurs
+      if(arg->CsrFlg && (arg->FlgTab & GmlManual) && (arg->FlgTab & GmlVoyeurs))
+      {
+         sprintf(str,  "   char      %s[%d];\n", arg->VoyNam, arg->MaxDeg);
+         strcat(src, str);
+      }
+
+      if(arg->FlgTab & GmlManual)
+         continue;
+
+      LnkArg = (arg->LnkIdx != -1) ? &ArgTab[ arg->LnkIdx ] : NULL;
+      CptArg = (arg->CntIdx != -1) ? &ArgTab[ arg->CntIdx ] : NULL;
+
+      if(LnkArg && LnkArg->MaxDeg > 1)
+      {
+         if(arg->NmbItm > 1)
+            sprintf( str,  "   %s %s[%d][%d];\n", OclTypStr[ arg->ItmTyp ],
+                     arg->nam, LnkArg->MaxDeg, arg->NmbItm );
+         else
+            sprintf( str,  "   %s %s[%d];\n", OclTypStr[ arg->ItmTyp ],
+                     arg->nam, LnkArg->MaxDeg );
+      }
+      else
+      {
+         if(arg->NmbItm > 1)
+            sprintf( str,  "   %s %s[%d];\n", OclTypStr[ arg->ItmTyp ],
+                     arg->nam, arg->NmbItm );
+         else
+            sprintf(str,  "   %s %s;\n", OclTypStr[ arg->ItmTyp ], arg->nam);
+      }
+
+      strcat(src, str);
+
+      if(CptArg)
+      {
+         sprintf(str,  "   %s %sDeg;\n", OclTypStr[ CptArg->ItmTyp ], arg->nam);
+         strcat(src, str);
+         sprintf(str,  "   %s %sNul;\n", OclTypStr[ arg->ItmTyp ], arg->nam);
+         strcat(src, str);
+         sprintf(str,  "   #define   %sDegMax %d\n", arg->nam, LnkArg->MaxDeg);
+         strcat(src, str);
+      }
+      else if(LnkArg && LnkArg->LnkDir == 0)
+      {
+         sprintf(str,  "   %s %sNul;\n", OclTypStr[ arg->ItmTyp ], arg->nam);
+         strcat(src, str);
+      }
+
+      // If ball or shell voyeurs are required, define a vector char
+      if(arg->FlgTab & GmlVoyeurs)
+      {
+         sprintf( str,  "   char      %s[%d];\n",
+                  arg->VoyNam, arg->NmbItm * arg->ItmLen );
+         strcat(src, str);
+      }
+   }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Define, read and compute the main kernel loop counter: the entity index is */
+/* read from the permutation table in case of permuted degree tiers           */
+/*----------------------------------------------------------------------------*/
+
+static void WriteKernelCounters(char *src, int MshTyp, const char *PrmNam)
+{
+   char str[ GmlMaxStrSiz ];
+
+   strcat (src, "// KERNEL COUNTERS\n");
+   strcat (src, "   int       cnt = get_global_id(0);\n");
+
+   if(!PrmNam)
+   {
+      sprintf(str, "   int       %sIdx = cnt + count.s1;\n\n", BalTypStr[ MshTyp ]);
+      strcat (src, str);
+      strcat (src, "   if(cnt >= count.s0)\n      return;\n\n");
+      return;
+   }
+
+   sprintf(str, "   int       %sIdx;\n\n", BalTypStr[ MshTyp ]);
+   strcat (src, str);
+   strcat (src, "   if(cnt >= count.s0)\n      return;\n\n");
+   sprintf(str, "   %sIdx = %sTab[ cnt + count.s1 ];\n\n", BalTypStr[ MshTyp ], PrmNam);
+   strcat (src, str);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Write the memory reading from the global structure to the local variables  */
+/*----------------------------------------------------------------------------*/
+
+static void WriteKernelMemoryReads( char *src, int MshTyp,
+                                    int NmbArg, ArgSct *ArgTab)
+{
+   int      i, j, k, l, siz;
+   char     str   [ 20*GmlMaxStrSiz ], ArgTd1[ 2*GmlMaxStrSiz ], ArgTd2[ GmlMaxStrSiz ];
+   char     LnkTd1[ GmlMaxStrSiz ], LnkTd2[ GmlMaxStrSiz ], LnkNam[ GmlMaxStrSiz ];
+   char     CptNam[ GmlMaxStrSiz ], DegTst[ 5*GmlMaxStrSiz ], DegNul[ 2*GmlMaxStrSiz ];
+   char     EleIdx[ GmlMaxStrSiz ];
+   ArgSct   *arg, *LnkArg, *CptArg;
+
+   strcat (src, "// KERNEL MEMORY READINGS\n");
+   sprintf(EleIdx, "%sIdx", BalTypStr[ MshTyp ]);
+
+   for(i=0;i<NmbArg;i++)
+   {
+      arg = &ArgTab[i];
+      LnkArg = (arg->LnkIdx != -1) ? &ArgTab[ arg->LnkIdx ] : NULL;
+      CptArg = (arg->CntIdx != -1) ? &ArgTab[ arg->CntIdx ] : NULL;
+
+      // Packed voyeurs are read from their line's offset up to its degree
+      if(arg->CsrFlg && CptArg && (arg->FlgTab & GmlVoyeurs))
+      {
+         sprintf( str, "   for(int k=0; k<%d; k++)\n", arg->MaxDeg);
+         strcat(src, str);
+         sprintf( str, "      %s[k] = (k < %sTab[ %s + 1 ] - %sTab[ %s ]) ?"
+                       " %sTab[ %sTab[ %s ] + k ] : 0;\n\n",
+                  arg->VoyNam, CptArg->nam, EleIdx, CptArg->nam, EleIdx,
+                  arg->VoyNam, CptArg->nam, EleIdx );
+         strcat(src, str);
+      }
+
+      if(!(arg->FlgTab & GmlReadMode) || (arg->FlgTab & GmlManual))
+         continue;
+
+      // Data read through a packed uplink: only fetch the line's real
+      // degree entries and pad the local array up to the maximum degree
+      if(CptArg && CptArg->CsrFlg)
+      {
+         sprintf( str, "   %sDeg = min(%sTab[ %s + 1 ] - %s, %sDegMax);\n",
+                  arg->nam, CptArg->nam, EleIdx, CptArg->nam, arg->nam );
+         strcat(src, str);
+         sprintf(str,  "   %sNul = %s;\n\n", arg->nam, OclNulVec[ arg->ItmTyp ]);
+         strcat(src, str);
+         sprintf(str,  "   for(int k=0; k<%sDeg; k++)\n   {\n", arg->nam);
+         strcat(src, str);
+
+         for(j=0;j<arg->NmbItm;j++)
+         {
+            if(arg->NmbItm > 1)
+               sprintf(ArgTd1, "[%d]", j);
+            else
+               ArgTd1[0] = '\0';
+
+            if(ISHLF(arg->ItmTyp))
+               sprintf( str, "      %s[k]%s = vload_half%s((size_t)%sTab[ %s + k ] * %d + %d, %sTab);\n",
+                        arg->nam, ArgTd1, HlfVecSfx[ arg->ItmTyp ], LnkArg->nam,
+                        CptArg->nam, arg->NmbItm, j, arg->nam );
+            else
+               sprintf( str, "      %s[k]%s = %sTab[ %sTab[ %s + k ] ]%s;\n",
+                        arg->nam, ArgTd1, arg->nam, LnkArg->nam, CptArg->nam, ArgTd1 );
+
+            strcat(src, str);
+         }
+
+         sprintf( str, "   }\n\n   for(int k=%sDeg; k<%sDegMax; k++)\n   {\n",
+                  arg->nam, arg->nam );
+         strcat(src, str);
+
+         for(j=0;j<arg->NmbItm;j++)
+         {
+            if(arg->NmbItm > 1)
+               sprintf(ArgTd1, "[%d]", j);
+            else
+               ArgTd1[0] = '\0';
+
+            sprintf(str, "      %s[k]%s = %sNul;\n", arg->nam, ArgTd1, arg->nam);
+            strcat(src, str);
+         }
+
+         strcat(src, "   }\n\n");
+         continue;
+      }
+
+      for(j=0;j<arg->NmbItm;j++)
+      {
+         if(CptArg)
+         {
+            sprintf(CptNam,  "%sDeg", arg->nam);
+            sprintf(str,  "   %s = %s;\n", CptNam, CptArg->nam);
+            strcat(src, str);
+            sprintf(str,  "   %sNul = %s;\n", arg->nam, OclNulVec[ arg->ItmTyp ]);
+            strcat(src, str);
+            strcat(src, "\n");
+         }
+         else if(LnkArg && LnkArg->LnkDir == 0)
+         {
+            sprintf(str,  "   %sNul = %s;\n", arg->nam, OclNulVec[ arg->ItmTyp ]);
+            strcat(src, str);
+         }
+
+         if(arg->NmbItm > 1)
+            sprintf(ArgTd1, "[%d]", j);
+         else
+            ArgTd1[0] = '\0';
+
+         if(LnkArg && LnkArg->NmbItm * LnkArg->ItmLen > 1)
+            siz = LnkArg->NmbItm * LnkArg->ItmLen;
+         else
+            siz = 1;
+
+         for(k=0;k<siz;k++)
+         {
+            if(siz > 1)
+               sprintf(ArgTd2, "[%d]", k);
+            else
+               ArgTd2[0] = '\0';
+
+            if(LnkArg && LnkArg->NmbItm > 1)
+               sprintf(LnkTd1, "[%d]", k/16);
+            else
+               LnkTd1[0] = '\0';
+
+            if(LnkArg && LnkArg->ItmLen > 1)
+               sprintf(LnkTd2, ".s%c", OclHexNmb[ k & 15 ]);
+            else
+               LnkTd2[0] = '\0';
+
+            // Tables stored per degree tier are indexed by the tier's
+            // line counter, all others by the entity index
+            if(LnkArg)
+               sprintf(LnkNam, "%s", LnkArg->nam);
+            else if(arg->TieFlg)
+               sprintf(LnkNam, "cnt");
+            else
+               sprintf(LnkNam, "%s", EleIdx);
+
+            // Hybrid ball entries are also filtered by their kind
+            if(CptArg && (arg->TagIdx != -1))
+            {
+               snprintf(DegTst, sizeof(DegTst), "((%s >= %d) && (%s%s%s == %d)) ?",
+                        CptNam, k + 1, ArgTab[ arg->TagIdx ].nam, LnkTd1, LnkTd2,
+                        arg->MshTyp );
+               sprintf(DegNul, ": %sNul", arg->nam);
+            }
+            else if(CptArg)
+            {
+               sprintf(DegTst, "(%s >= %d) ?", CptNam, k + 1);
+               sprintf(DegNul, ": %sNul", arg->nam);
+            }
+            else
+            {
+               if(LnkArg && LnkArg->LnkDir == 0)
+               {
+                  sprintf(DegTst, "%s%s ?", LnkArg->nam, LnkTd2);
+                  sprintf(DegNul, ": %sNul", arg->nam);
+               }
+               else
+                  DegNul[0] = DegTst[0] = '\0';
+            }
+
+            // If voyeurs need to be set, read the ball int vector and
+            // scatter the matching char vector from the voyeurs table
+            // into the local char array
+            if(arg->FlgTab & GmlVoyeurs)
+            {
+               sprintf( str, "   %s%s = %sTab[ %s ]%s;\n",
+                        arg->nam, ArgTd1, arg->nam, LnkNam, ArgTd1 );
+               strcat(src, str);
+
+               for(l=0;l<arg->ItmLen;l++)
+               {
+                  if(arg->ItmLen > 1)
+                     sprintf(LnkTd2, ".s%c", OclHexNmb[l]);
+                  else
+                     LnkTd2[0] = '\0';
+
+                  sprintf( str, "   %s[%d] = %sTab[ %s ]%s%s;\n",
+                           arg->VoyNam, j*arg->ItmLen + l,
+                           arg->VoyNam, LnkNam, ArgTd1, LnkTd2 );
+                  strcat(src, str);
+               }
+            }
+            else if(ISHLF(arg->ItmTyp))
+            {
+               // Convert half floats on the fly while reading them
+               sprintf( str, "   %s%s%s = %s vload_half%s((size_t)(%s%s%s) * %d + %d, %sTab) %s;\n",
+                        arg->nam, ArgTd2, ArgTd1, DegTst,
+                        HlfVecSfx[ arg->ItmTyp ], LnkNam, LnkTd1, LnkTd2,
+                        arg->NmbItm, j, arg->nam, DegNul );
+
+               strcat(src, str);
+            }
+            else
+            {
+               // Otherwise, read the data straight through the link
+               sprintf( str, "   %s%s%s = %s %sTab[ %s%s%s ]%s %s;\n",
+                        arg->nam, ArgTd2, ArgTd1, DegTst, arg->nam,
+                        LnkNam, LnkTd1, LnkTd2, ArgTd1, DegNul );
+
+               strcat(src, str);
+            }
+         }
+      }
+
+      strcat(src, "\n");
+   }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Pour the user's kernel code as it is                                       */
+/*----------------------------------------------------------------------------*/
+
+static void WriteUserKernel(char *src, char *KrnSrc)
+{
+   strcat(src, "// USER'S KERNEL CODE\n");
+   strcat                  (src, KrnSrc);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Write the final storage of requested variables from local to global struct */
+/*----------------------------------------------------------------------------*/
+
+static void WriteKernelMemoryWrites(char *src, int MshTyp,
+                                    int NmbArg, ArgSct *ArgTab)
+{
+   int      i, c;
+   char     str[ GmlMaxStrSiz ], ArgTd[ GmlMaxStrSiz ];
+   const char *EleNam = BalTypStr[ MshTyp ];
+   ArgSct   *arg;
+
+   strcat(src, "\n");
+   strcat(src, "// KERNEL MEMORY WRITINGS\n");
+
+   for(i=0;i<NmbArg;i++)
+   {
+      arg = &ArgTab[i];
+
+      if(!(arg->FlgTab & GmlWriteMode) || (arg->FlgTab & GmlManual))
+         continue;
+
+      if(ISHLF(arg->ItmTyp))
+      {
+         for(c=0;c<arg->NmbItm;c++)
+         {
+            if(arg->NmbItm > 1)
+               sprintf(ArgTd, "[%d]", c);
+            else
+               ArgTd[0] = '\0';
+
+            snprintf(str, sizeof(str),
+                     "   vstore_half%s(%s%s, (size_t)%sIdx * %d + %d, %sTab);\n",
+                     HlfVecSfx[ arg->ItmTyp ], arg->nam, ArgTd,
+                     EleNam, arg->NmbItm, c, arg->nam );
+            strcat(src, str);
+         }
+      }
+      else if(arg->NmbItm == 1)
+      {
+         sprintf( str, "   %sTab[ %sIdx ] = %s;\n",
+                  arg->nam, EleNam, arg->nam );
+         strcat(src, str);
+      }
+      else
+      {
+         for(c=0;c<arg->NmbItm;c++)
+         {
+            sprintf( str, "   %sTab[ %sIdx ][%d] = %s[%d];\n",
+                     arg->nam, EleNam, c, arg->nam, c );
+            strcat(src, str);
+         }
+      }
+   }
+
+   strcat(src, "}\n");
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Spread an arbitrary sized vector across a number of hardware smaller ones  */
+/*----------------------------------------------------------------------------*/
+
+static void GetCntVec(int siz, int *cnt, int *vec, int *typ)
+{
+   int p;
+
+   p = (int)ceil(log2(siz));
+   p = MIN(p, VECPOWMAX);
+
+   if(p > VECPOWOCL)
+   {
+      *cnt = 1 << (p - VECPOWOCL);
+      *vec = 1 << VECPOWOCL;
+      *typ = OclVecPow[ VECPOWOCL ];
+   }
+   else
+   {
+      *cnt = 1;
+      *vec = 1 << p;
+      *typ = OclVecPow[p];
+   }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Read and compile an OpenCL source code                                     */
+/*----------------------------------------------------------------------------*/
+
+static int NewOclKrn(GmlSct *gml, char *KernelSource, char *PrcNam, int ShrFlg)
+{
+   char     *buffer, *StrTab[1], OptStr[ STRSIZ ] = "\0";
+   int      i, err, res, idx;
+   KrnSct   *krn;
+   size_t   len, LenTab[1], GrpSiz, RetSiz = 0;
+
+   if(!(idx = GetNewKrnIdx(gml)))
+      return(0);
+
+   krn = gml->krn[ idx ];
+   // With double precision coordinates, user's kernels and the toolkit
+   // keep their double constants, library's kernels remain single precision
+   if(gml->CrdTyp == GmlDbl4 && !ShrFlg)
+      sprintf(OptStr, "-cl-mad-enable -DGML_DBL_CRD %s", gml->cflags);
+   else
+      sprintf(OptStr, "-cl-single-precision-constant -cl-mad-enable %s", gml->cflags);
+
+   // Library's sources are compiled once for a given set of options
+   // and the resulting program is shared among all the kernels using it
+   if(ShrFlg)
+   {
+      krn->PrgSrc = KernelSource;
+      strcpy(krn->PrgOpt, OptStr);
+
+      for(i=1;i<=gml->MaxKrn;i++)
+         if( (i != idx) && gml->krn[i]->use && (gml->krn[i]->PrgSrc == KernelSource)
+         &&  !strcmp(gml->krn[i]->PrgOpt, OptStr) )
+         {
+            krn->program = gml->krn[i]->program;
+            clRetainProgram(krn->program);
+            break;
+         }
+   }
+
+   if(!krn->program)
+   {
+      StrTab[0] = KernelSource;
+      LenTab[0] = strlen(KernelSource) - 1;
+
+      // Compile source code
+      krn->program = clCreateProgramWithSource( gml->context, 1, (const char **)StrTab,
+                                                (const size_t *)LenTab, &err );
+      if(!krn->program)
+      {
+         printf("Compiling the kernel %s failed at step 1 with error %d\n", PrcNam, err);
+         FreeOclKrn(gml, idx);
+         return(0);
+      }
+
+      res = clBuildProgram(krn->program, 0, NULL, OptStr, NULL, NULL);
+
+      if(res != CL_SUCCESS)
+      {
+         clGetProgramBuildInfo(  krn->program, gml->device_id[ gml->CurDev ],
+                                 CL_PROGRAM_BUILD_LOG, 0, NULL, &len);
+
+         if((buffer = malloc(len)))
+         {
+            clGetProgramBuildInfo(  krn->program, gml->device_id[ gml->CurDev ],
+                                    CL_PROGRAM_BUILD_LOG, len, buffer, &len);
+
+            printf("Compiling the kernel %s failed at step 2 with error %d\n", PrcNam, res);
+            printf("%s\n", buffer);
+            free(buffer);
+         }
+
+         FreeOclKrn(gml, idx);
+         return(0);
+      }
+   }
+
+   krn->kernel = clCreateKernel(krn->program, PrcNam, &err);
+
+   if( !krn->kernel || (err != CL_SUCCESS) )
+   {
+      printf("Compiling the kernel %s failed at step 3 with error %d\n", PrcNam, err);
+      FreeOclKrn(gml, idx);
+      return(0);
+   }
+
+   krn->idx = idx;
+
+   if(gml->DbgFlg)
+   {
+      puts(sep);
+      res = clGetProgramInfo( krn->program, CL_PROGRAM_BINARY_SIZES,
+                              sizeof(size_t), &len, NULL );
+
+      if(res == CL_SUCCESS )
+         printf("binary executable of kernel %s: %zd bytes\n", PrcNam, len);
+      else
+         printf("could not get the size of kernel %s executable\n", PrcNam);
+   }
+
+   // Get the maximum GPU workgroup size
+   res = clGetKernelWorkGroupInfo(  krn->kernel, gml->device_id[ gml->CurDev ],
+                                    CL_KERNEL_WORK_GROUP_SIZE, sizeof(size_t),
+                                    &GrpSiz, &RetSiz );
+
+   if(res != CL_SUCCESS )
+   {
+      printf("Geting the kernel workgroup size failed with error %d\n", res);
+      FreeOclKrn(gml, idx);
+      return(0);
+   }
+
+   krn->OptSiz = 0;
+   krn->NxtSiz = -1;
+   krn->MaxSiz = GrpSiz;
+   krn->EvtBlk = DEFEVTBLK;
+   krn->NmbEvt = 0;
+   krn->IniFlg = 0;
+   krn->EvtTab = malloc(krn->EvtBlk * sizeof(cl_event));
+   assert(krn->EvtTab);
+
+   return(idx);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Release a kernel, its events and its program if no other kernel uses it    */
+/*----------------------------------------------------------------------------*/
+
+static void FreeOclKrn(GmlSct *gml, int idx)
+{
+   int      i;
+   KrnSct   *krn = gml->krn[ idx ];
+
+   for(i=0;i<krn->NmbEvt;i++)
+      clReleaseEvent(krn->EvtTab[i]);
+
+   if(krn->EvtTab)
+      free(krn->EvtTab);
+
+   if(krn->kernel)
+      clReleaseKernel(krn->kernel);
+
+   // OpenCL keeps a reference count on programs shared by several kernels
+   if(krn->program)
+      clReleaseProgram(krn->program);
+
+   memset(krn, 0, sizeof(KrnSct));
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Free a user kernel along with its higher degree tiers companions           */
+/*----------------------------------------------------------------------------*/
+
+int GmlFreeKernel(size_t GmlIdx, int KrnIdx)
+{
+   GETGMLPTR(gml, GmlIdx);
+   int HghIdx;
+
+   if( (KrnIdx < 1) || (KrnIdx > gml->MaxKrn) || !gml->krn[ KrnIdx ]->use )
+      return(0);
+
+   // Walk down the chain of degree tier kernels
+   while(KrnIdx)
+   {
+      HghIdx = gml->krn[ KrnIdx ]->HghIdx;
+      FreeOclKrn(gml, KrnIdx);
+      KrnIdx = HghIdx;
+   }
+
+   return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Select arguments and launch an OpenCL kernel                               */
+/*----------------------------------------------------------------------------*/
+
+int GmlLaunchKernel(size_t GmlIdx, int idx)
+{
+   GETGMLPTR(gml, GmlIdx);
+   int      res;
+   KrnSct   *krn;
+
+   if( (idx < 1) || (idx > gml->MaxKrn) || !gml->krn[ idx ]->kernel )
+      return(-1);
+
+   krn = gml->krn[ idx ];
+
+   res = RunOclKrn(gml, krn);
+
+   // Then launch the kernels of the higher degree tiers
+   while( (res == 1) && krn->HghIdx )
+   {
+      krn = gml->krn[ krn->HghIdx ];
+      res = RunOclKrn(gml, krn);
+   }
+
+   return(res);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Select arguments and launch an OpenCL kernel                               */
+/*----------------------------------------------------------------------------*/
+
+static int RunOclKrn(GmlSct *gml, KrnSct *krn)
+{
+   int      i, res;
+   double   MinTim;
+   DatSct   *dat;
+
+   // The first time this kernel is called we add the arguments list
+   if(!krn->IniFlg)
+   {
+      krn->IniFlg = 1;
+
+      // Loop and add user's arguments
+      for(i=0;i<krn->NmbDat;i++)
+      {
+         if( (krn->DatTab[i] < 1) || (krn->DatTab[i] > gml->MaxDat)
+         ||  !gml->dat[ krn->DatTab[i] ]->GpuMem )
+         {
+            printf("Invalid user argument %d, DatTab[i]=%d\n", i, krn->DatTab[i]);
+            return(-1);
+         }
+
+         dat = gml->dat[ krn->DatTab[i] ];
+
+         res = clSetKernelArg(krn->kernel, i, sizeof(cl_mem), &dat->GpuMem);
+
+         if(res != CL_SUCCESS)
+         {
+            printf("Adding user argument %d failed with error: %d\n", i, res);
+            return(-2);
+         }
+      }
+
+      res = clSetKernelArg(krn->kernel, krn->NmbDat, sizeof(cl_mem),
+                           &gml->dat[ gml->ParIdx ]->GpuMem);
+
+      if(res != CL_SUCCESS)
+      {
+         printf("Adding the GMlib parameters argument failed with error %d\n", res);
+         return(-3);
+      }
+
+      // Add a last argument with the number of loop elements
+      res = clSetKernelArg(krn->kernel, krn->NmbDat+1, sizeof(cl_int2), krn->NmbLin);
+
+      if(res != CL_SUCCESS)
+      {
+         printf("Adding the kernel loop counter argument failed with error %d\n", res);
+         return(-4);
+      }
+   }
+
+   // The first 8 or 10 kernel runs are used to calibrate
+   // the run time according to the group size
+   if(!krn->OptSiz)
+   {
+      // First run: the calibration is unreliable so we use 16 as
+      // the default group size and do not take this timing into account
+      if(krn->NxtSiz == -1)
+      {
+         krn->TstDat = 0;
+         krn->NxtSiz = 0;
+         krn->GrpSiz = 16;
+      }
+      else if(krn->NxtSiz == 0)
+      {
+         // Begin the calibration with group size 1
+         krn->TstDat = 0;
+         krn->NxtSiz = 1;
+         krn->GrpSiz = krn->NxtSiz;
+      }
+      else if(krn->NxtSiz <= krn->MaxSiz / 2)
+      {
+         // Double the group size at each successive run until the maximum is reached
+         krn->TstDat++;
+         krn->NxtSiz *= 2;
+         krn->GrpSiz = krn->NxtSiz;
+      }
+      else
+      {
+         // We all sizes have been run, look for the fastest one
+         //  and store the optimal size
+         MinTim = krn->TstTim[0];
+         krn->OptSiz = 1;
+
+         for(i=0;i<=krn->TstDat;i++)
+            if(krn->TstTim[i] < MinTim)
+            {
+               MinTim = krn->TstTim[i];
+               krn->OptSiz = 1 << i;
+            }
+
+         //printf("Kernel %d: opt size = %zu\n", krn->idx, krn->OptSiz);
+         krn->GrpSiz = krn->OptSiz;
+      }
+   }
+
+   // Compute the hyperthreading level and set the workgroup size and counter,
+   // on each run as library's kernels may be launched on varying sizes
+   krn->NmbGrp = krn->NmbLin[0] / krn->GrpSiz;
+   krn->NmbGrp *= krn->GrpSiz;
+
+   if(krn->NmbGrp < krn->NmbLin[0])
+      krn->NmbGrp += krn->GrpSiz;
+
+   if(krn->NmbEvt == krn->EvtBlk)
+   {
+      krn->EvtBlk *= 2;
+      krn->EvtTab = realloc(krn->EvtTab, krn->EvtBlk * sizeof(cl_event));
+      assert(krn->EvtTab);
+   }
+
+   // Flush the lines modified on the host side since the last upload
+   // and invalidate the host copy of the data the kernel may modify
+   for(i=0;i<krn->NmbDat;i++)
+   {
+      dat = gml->dat[ krn->DatTab[i] ];
+
+      if(dat->DrtBeg <= dat->DrtEnd)
+         UploadLines(gml, krn->DatTab[i], dat->DrtBeg, dat->DrtEnd);
+
+      if(dat->MemAcs != GmlInput)
+      {
+         dat->HstBeg = dat->NmbLin;
+         dat->HstEnd = -1;
+      }
+   }
+
+   // Wait for any previous runing kernel to complete
+   clFinish(gml->queue);
+
+   // If the optimal size is yet to be found, start the timer
+   if(!krn->OptSiz)
+      krn->TstTim[ krn->TstDat ] = GmlGetWallClock();
+
+   // Launch GPU code
+   if(clEnqueueNDRangeKernel( gml->queue, krn->kernel, 1, NULL, &krn->NmbGrp,
+                              &krn->GrpSiz, 0, NULL, &krn->EvtTab[ krn->NmbEvt++ ]) )
+   {
+      return(-6);
+   }
+
+   // If the optimal size is yet to be found, stop the timer
+   // and store the run time associated to this work group size
+   if(!krn->OptSiz)
+   {
+      clFinish(gml->queue);
+      krn->TstTim[ krn->TstDat ] = GmlGetWallClock() - krn->TstTim[ krn->TstDat ];
+   }
+
+   return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Compute various reduction functions: min,max,L1,L2 norms                   */
+/*----------------------------------------------------------------------------*/
+
+int GmlReduceVector(size_t GmlIdx, int DatIdx, int RedOpp, double *nrm)
+{
+   GETGMLPTR(gml, GmlIdx);
+   int      i, NmbLin, ret;
+   float    res, *vec;
+   DatSct   *dat, *red;
+   KrnSct   *krn;
+   char     *RedNam[] = { "reduce_min", "reduce_max", "reduce_sum",
+            "reduce_L0", "reduce_L1", "reduce_L2", "reduce_Linf" };
+
+   // Check indices and data conformity
+   if( (DatIdx < 1) || (DatIdx > gml->MaxDat) )
+   {
+      printf("Invalid data index: %d\n", DatIdx);
+      return(-1);
+   }
+
+   dat = gml->dat[ DatIdx ];
+
+   if( (dat->ItmTyp != GmlFlt) || (dat->NmbItm != 1) || (dat->ItmLen != 1) )
+   {
+      printf(  "Invalid data structure: count %d, type %s, length %d\n",
+               dat->NmbItm, OclTypStr[ dat->ItmTyp ], dat->ItmLen );
+      return(-2);
+   }
+
+   if( (RedOpp < 0) || (RedOpp > GmlMaxRed) )
+   {
+      printf("Invalid operation code %d\n", RedOpp);
+      return(-3);
+   }
+
+   // Allocate an output vector the size of the input vector
+   if(!dat->RedIdx)
+      dat->RedIdx = GmlNewSolutionData(GmlIdx, dat->MshTyp, 1, GmlFlt, "reduce");
+
+   if(!dat->RedIdx)
+   {
+      printf(  "Failed to allocate a reduction vector of %d bytes\n",
+               OclTypSiz[ GmlFlt ] * dat->NmbLin );
+      return(-4);
+   }
+
+   // Compile a reduction kernel with the required operation if needed
+   if(!gml->RedKrn[ RedOpp ])
+      gml->RedKrn[ RedOpp ] = NewOclKrn(gml, reduce, RedNam[ RedOpp ], 1);
+
+   if(!gml->RedKrn[ RedOpp ])
+   {
+      printf("Failed to compile the %s reduction kernel\n", RedNam[ RedOpp ]);
+      return(-5);
+   }
+
+   // Set the kernel with two vectors: an input and a reduced output one
+   krn = gml->krn[ gml->RedKrn[ RedOpp ] ];
+   krn->NmbDat    = 2;
+   krn->DatTab[0] = DatIdx;
+   krn->DatTab[1] = dat->RedIdx;
+   krn->NmbLin[0] = dat->NmbLin;
+
+   // Launch the right reduction kernel according to the requested opperation
+   ret = RunOclKrn(gml, krn);
+
+   if(ret < 0)   
+      return(ret);
+
+   // Trim the size of the output vector down to the number of OpenCL groups
+   // used by the kernel and download this amount of data
+   red = gml->dat[ dat->RedIdx ];
+   red->MemSiz = dat->MemSiz / krn->GrpSiz;
+   NmbLin = (int)(dat->NmbLin / krn->GrpSiz);
+   DownloadData(gml, dat->RedIdx);
+   red->MemSiz = dat->MemSiz;
+   vec = (float *)red->CpuMem;
+
+   // Perform the last reduction step on the CPU
+   switch(RedOpp)
+   {
+      case GmlMin :
+      {
+         res = FLT_MAX;
+         for(i=0;i<NmbLin;i++)
+            res = MIN(res, vec[i]);
+      }break;
+
+      case GmlSum : case GmlL0 : case GmlL1 : case GmlL2 :
+      {
+         res = 0.;
+         for(i=0;i<NmbLin;i++)
+            res += vec[i];
+      }break;
+
+      case GmlMax : case GmlLinf :
+      {
+         res = -FLT_MAX;
+         for(i=0;i<NmbLin;i++)
+            res = MAX(res, vec[i]);
+      }break;
+   }
+
+   *nrm = res;
+
+   return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Multiply a sliced blocked sparse matrix by a blocked vector vector         */
+/*----------------------------------------------------------------------------*/
+
+int GmlMultMatVec(size_t GmlIdx, int MatIdx, int VecIdx1, int VecIdx2)
+{
+   int i, res;
+   GETGMLPTR(gml, GmlIdx);
+   MatSct *mat;
+   VecSct *vec1, *vec2;
+   KrnSct *krn;
+
+   // Check indices and data conformity
+   if( (MatIdx < 1) || (MatIdx > gml->MaxMat) || !gml->mat[ MatIdx ]->use )
+   {
+      printf("Invalid data index: %d\n", MatIdx);
+      return(-1);
+   }
+
+   mat = gml->mat[ MatIdx ];
+
+   if( (VecIdx1 < 1) || (VecIdx1 > gml->MaxVec) || !gml->vec[ VecIdx1 ]->use )
+   {
+      printf("Invalid data index: %d\n", VecIdx1);
+      return(-2);
+   }
+
+   vec1 = gml->vec[ VecIdx1 ];
+
+   if( (VecIdx2 < 1) || (VecIdx2 > gml->MaxVec) || !gml->vec[ VecIdx2 ]->use )
+   {
+      printf("Invalid data index: %d\n", VecIdx2);
+      return(-3);
+   }
+
+   vec2 = gml->vec[ VecIdx2 ];
+
+   if(mat->NmbLin != vec1->NmbLin || mat->NmbLin != vec2->NmbLin)
+   {
+      printf("vectors and matrix size differ: %d(%d) %d(%d) %d(%d)\n",
+            MatIdx, mat->NmbLin, VecIdx1, vec1->NmbLin, VecIdx2, vec2->NmbLin);
+      return(-4);
+   }
+
+   if(mat->PckFlg != vec1->PckFlg || mat->PckFlg != vec2->PckFlg)
+   {
+      printf("vectors and matrix layouts differ: %d(%d) %d(%d) %d(%d)\n",
+            MatIdx, mat->PckFlg, VecIdx1, vec1->PckFlg, VecIdx2, vec2->PckFlg);
+      return(-5);
+   }
+
+   // Launch the matrix kernels on the GPU
+   for(i=0;i<mat->NmbSlc;i++)
+   {
+      // Store information usefull to the kernel: loop indices and arguments list
+      krn = gml->krn[ mat->KrnIdx[i] ];
+      krn->NmbDat = 5;
+      krn->NmbLin[0] = mat->MatSlc[ i+1 ][1] - mat->MatSlc[i][1];
+      krn->NmbLin[1] = mat->MatSlc[i][1];
+      krn->DatTab[0] = mat->DegIdx[i];
+      krn->DatTab[1] = mat->ColIdx[i];
+      krn->DatTab[2] = mat->ValIdx[i];
+      krn->DatTab[3] = vec1->idx;
+      krn->DatTab[4] = vec2->idx;
+
+      res = RunOclKrn(gml, krn);
+
+      if(res != 1)
+         return(res);
+   }
+
+   // Ipdate the stats on bytes read/written and flops performed by the kernels
+   gml->MemAcc += mat->MemAcc;
+   gml->FltOpp += mat->FltOpp;
+
+   return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Add two vectors term by term                                               */
+/*----------------------------------------------------------------------------*/
+
+int GmlAddVec3(size_t GmlIdx, int VecIdx1, int VecIdx2, int VecIdx3, int VecIdx4)
+{
+   int i, res;
+   GETGMLPTR(gml, GmlIdx);
+   VecSct *vec1, *vec2, *vec3, *vec4;
+   KrnSct *krn;
+
+   if( (VecIdx1 < 1) || (VecIdx1 > gml->MaxVec) || !gml->vec[ VecIdx1 ]->use )
+   {
+      printf("Invalid data index: %d\n", VecIdx1);
+      return(-1);
+   }
+
+   vec1 = gml->vec[ VecIdx1 ];
+
+   if( (VecIdx2 < 1) || (VecIdx2 > gml->MaxVec) || !gml->vec[ VecIdx2 ]->use )
+   {
+      printf("Invalid data index: %d\n", VecIdx2);
+      return(-2);
+   }
+
+   vec2 = gml->vec[ VecIdx2 ];
+
+   if( (VecIdx3 < 1) || (VecIdx3 > gml->MaxVec) || !gml->vec[ VecIdx3 ]->use )
+   {
+      printf("Invalid data index: %d\n", VecIdx3);
+      return(-3);
+   }
+
+   vec3 = gml->vec[ VecIdx3 ];
+
+   if( (VecIdx4 < 1) || (VecIdx4 > gml->MaxVec) || !gml->vec[ VecIdx4 ]->use )
+   {
+      printf("Invalid data index: %d\n", VecIdx4);
+      return(-4);
+   }
+
+   vec4 = gml->vec[ VecIdx4 ];
+
+   if( (vec1->NmbLin != vec2->NmbLin) || (vec1->BlkSiz != vec2->BlkSiz) )
+   {
+      printf(  "vector sizes differ: ID %d (%d x %d) and ID %d (%d x %d)\n",
+               VecIdx1, vec1->NmbLin, vec1->BlkSiz,
+               VecIdx2, vec2->NmbLin, vec2->BlkSiz );
+
+      return(-4);
+   }
 
-         if(UsrRef)
-            UsrRef[ (i - BegIdx) * RefLen ] = RefTab[i];
-      }
+   if( (vec1->NmbLin != vec4->NmbLin) || (vec1->BlkSiz != vec4->BlkSiz) )
+   {
+      printf(  "vector sizes differ: ID %d (%d x %d) and ID %d (%d x %d)\n",
+               VecIdx1, vec1->NmbLin, vec1->BlkSiz,
+               VecIdx4, vec4->NmbLin, vec4->BlkSiz );
+
+      return(-5);
    }
 
+   if( (vec1->PckFlg != vec2->PckFlg) || (vec1->PckFlg != vec3->PckFlg)
+   ||  (vec1->PckFlg != vec4->PckFlg) )
+   {
+      printf("vector layouts differ: ID %d, %d, %d and %d\n",
+               VecIdx1, VecIdx2, VecIdx3, VecIdx4);
+      return(-6);
+   }
+
+   // Store information usefull to the kernel: loop indices and arguments list
+   krn = gml->krn[ vec1->AddKrnIdx ];
+   krn->NmbDat = 4;
+   krn->NmbLin[0] = vec1->PckFlg ? (vec1->NmbLin * vec1->BlkSiz + 3) / 4
+                                 : vec1->NmbLin;
+   krn->DatTab[0] = vec1->idx;
+   krn->DatTab[1] = vec2->idx;
+   krn->DatTab[2] = vec3->idx;
+   krn->DatTab[3] = vec4->idx;
+
+   // Launch the vector kernel on the GPU
+   res = RunOclKrn(gml, krn);
+
+   if(res != 1)
+      return(res);
+
+   // Ipdate the stats on bytes read/written and flops performed by the kernels
+   gml->MemAcc += vec1->NmbLin * vec1->BlkSiz * vec1->FltSiz * 3;
+   gml->FltOpp += vec1->NmbLin * vec1->BlkSiz;
+
    return(1);
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Copy user's data into an OpenCL buffer                                     */
+/* Multiply each term by a scalar                                             */
 /*----------------------------------------------------------------------------*/
 
-static int UploadData(GmlSct *gml, int idx)
+int GmlScaleVec(size_t GmlIdx, int VecIdx, double *mul)
 {
-   int      res;
-   DatSct   *dat = &gml->dat[ idx ];
+   int i, res;
+   GETGMLPTR(gml, GmlIdx);
+   VecSct *vec;
+   KrnSct *krn;
 
-   // Check indices
-   if( (idx < 1) || (idx > GmlMaxDat) || !dat->GpuMem
-   || !dat->CpuMem || (dat->MemAcs == GmlOutput) )
+   if( (VecIdx < 1) || (VecIdx > gml->MaxVec) || !gml->vec[ VecIdx ]->use )
    {
-      return(0);
+      printf("Invalid data index: %d\n", VecIdx);
+      return(-2);
    }
 
-   // Upload buffer from CPU ram to GPU ram
-   // and keep track of the amount of uploaded data
-   res = clEnqueueWriteBuffer(gml->queue, dat->GpuMem, CL_FALSE, 0,
-                              dat->MemSiz, dat->CpuMem, 0, NULL,NULL);
+   vec = gml->vec[ VecIdx ];
 
-   if(res != CL_SUCCESS)
+   // Store information usefull to the kernel: loop indices and arguments list
+   krn = gml->krn[ vec->SclKrnIdx ];
+   krn->NmbDat = 1;
+   krn->NmbLin[0] = vec->PckFlg ? (vec->NmbLin * vec->BlkSiz + 3) / 4
+                                : vec->NmbLin;
+   krn->DatTab[0] = vec->idx;
+
+   // Launch the vector kernel on the GPU
+   res = RunOclKrn(gml, krn);
+
+   if(res != 1)
+      return(res);
+
+   // Ipdate the stats on bytes read/written and flops performed by the kernels
+   gml->MemAcc += vec->NmbLin * vec->BlkSiz * vec->FltSiz * 2;
+   gml->FltOpp += vec->NmbLin * vec->BlkSiz;
+
+   return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Compute each field's L2 norm                                               */
+/*----------------------------------------------------------------------------*/
+
+int GmlNormVec(size_t GmlIdx, int VecIdx, int RedIdx, double *nrm)
+{
+   int i, res;
+   GETGMLPTR(gml, GmlIdx);
+   VecSct *vec;
+   KrnSct *krn;
+
+   if( (VecIdx < 1) || (VecIdx > gml->MaxVec) || !gml->vec[ VecIdx ]->use )
    {
-      printf("Uploading the data to the GPu failed with error %d\n", res);
-      return(0);
+      printf("Invalid data index: %d\n", VecIdx);
+      return(-2);
    }
-   else
+
+   vec = gml->vec[ VecIdx ];
+
+   // Store information usefull to the kernel: loop indices and arguments list
+   krn = gml->krn[ vec->NrmKrnIdx ];
+   krn->NmbDat = 2;
+   krn->NmbLin[0] = vec->NmbLin;
+   krn->DatTab[0] = vec->idx;
+   krn->DatTab[1] = RedIdx;
+
+   // Launch the vector kernel on the GPU
+   res = RunOclKrn(gml, krn);
+
+   if(res != 1)
+      return(res);
+
+   *nrm = 0.;
+   res = GmlReduceVector(GmlIdx, RedIdx, GmlL1, nrm);
+
+   if(res != 1)
+      return(res);
+
+   *nrm = sqrt(*nrm);
+
+   // Ipdate the stats on bytes read/written and flops performed by the kernels
+   gml->MemAcc += vec->NmbLin * vec->BlkSiz * vec->FltSiz * 2;
+   gml->FltOpp += vec->NmbLin * vec->BlkSiz * 2;
+
+   return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Multiply a diagonal matrix by a vector                                     */
+/*----------------------------------------------------------------------------*/
+
+int GmlMultDiagMatVec(size_t GmlIdx, int VecIdx1, int VecIdx2, int VecIdx3)
+{
+   int i, res;
+   GETGMLPTR(gml, GmlIdx);
+   VecSct *vec1, *vec2, *vec3;
+   KrnSct *krn;
+
+   if( (VecIdx1 < 1) || (VecIdx1 > gml->MaxVec) || !gml->vec[ VecIdx1 ]->use )
+   {
+      printf("Invalid data index: %d\n", VecIdx1);
+      return(-1);
+   }
+
+   vec1 = gml->vec[ VecIdx1 ];
+
+   if( (VecIdx2 < 1) || (VecIdx2 > gml->MaxVec) || !gml->vec[ VecIdx2 ]->use )
+   {
+      printf("Invalid data index: %d\n", VecIdx2);
+      return(-2);
+   }
+
+   vec2 = gml->vec[ VecIdx2 ];
+
+   if( (VecIdx3 < 1) || (VecIdx3 > gml->MaxVec) || !gml->vec[ VecIdx3 ]->use )
+   {
+      printf("Invalid data index: %d\n", VecIdx3);
+      return(-3);
+   }
+
+   vec3 = gml->vec[ VecIdx3 ];
+
+   if( (vec1->NmbLin != vec3->NmbLin) || (vec1->BlkSiz != POW(vec3->BlkSiz)) )
    {
-      gml->MovSiz += dat->MemSiz;
-      return((int)dat->MemSiz);
+      printf(  "vector sizes differ: ID %d (%d x %d) and ID %d (%d x %d)\n",
+               VecIdx1, vec1->NmbLin, vec1->BlkSiz,
+               VecIdx2, vec3->NmbLin, vec3->BlkSiz );
+
+      return(-4);
+   }
+
+   if( (vec1->PckFlg != vec2->PckFlg) || (vec1->PckFlg != vec3->PckFlg) )
+   {
+      printf("vector layouts differ: ID %d, %d and %d\n",
+               VecIdx1, VecIdx2, VecIdx3);
+      return(-5);
    }
+
+   // Store information usefull to the kernel: loop indices and arguments list
+   krn = gml->krn[ vec1->MulDiaKrnIdx ];
+   krn->NmbDat = 3;
+   krn->NmbLin[0] = vec1->NmbLin;
+   krn->DatTab[0] = vec1->idx;
+   krn->DatTab[1] = vec2->idx;
+   krn->DatTab[2] = vec3->idx;
+
+   // Launch the vector kernel on the GPU
+   res = RunOclKrn(gml, krn);
+
+   if(res != 1)
+      return(res);
+
+   // Ipdate the stats on bytes read/written and flops performed by the kernels
+   gml->MemAcc += vec1->NmbLin * (vec1->BlkSiz + 2 * vec2->BlkSiz) * vec1->FltSiz;
+   gml->FltOpp += vec1->NmbLin * 2 * vec1->BlkSiz;
+
+   return(1);
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Copy an OpenCL buffer into user's data                                     */
+/* Return memory currently allocated on the GPU                               */
 /*----------------------------------------------------------------------------*/
 
-static int DownloadData(GmlSct *gml, int idx)
+size_t GmlGetMemoryUsage(size_t GmlIdx)
 {
-   int      res;
-   DatSct   *dat = &gml->dat[ idx ];
+   GETGMLPTR(gml, GmlIdx);
+   return(gml->MemSiz);
+}
 
-   // Check indices
-   if( (idx < 1) || (idx > GmlMaxDat) || !dat->GpuMem || !dat->CpuMem )
-      return(0);
 
-   // Download buffer from GPU ram to CPU ram
-   // and keep track of the amount of downloaded data
-   res = clEnqueueReadBuffer( gml->queue, dat->GpuMem, CL_TRUE, 0,
-                              dat->MemSiz, dat->CpuMem, 0, NULL, NULL );
+/*----------------------------------------------------------------------------*/
+/* Return memory currently transfered to or from the GPU                      */
+/*----------------------------------------------------------------------------*/
+
+size_t GmlGetMemoryTransfer(size_t GmlIdx)
+{
+   GETGMLPTR(gml, GmlIdx);
+   return(gml->MovSiz);
+}
 
-   if(res != CL_SUCCESS)
+
+/*----------------------------------------------------------------------------*/
+/* Return the number of bytes accessed from the GPU kernels so far            */
+/*----------------------------------------------------------------------------*/
+
+float GmlGetMemoryAccess(size_t GmlIdx)
+{
+   GETGMLPTR(gml, GmlIdx);
+   return(gml->MemAcc);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Return the number of flops performed by the GPU kernels so far             */
+/*----------------------------------------------------------------------------*/
+
+float GmlGetFlops(size_t GmlIdx)
+{
+   GETGMLPTR(gml, GmlIdx);
+   return(gml->FltOpp);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Find out what kind of table a data slot holds and its related degrees      */
+/*----------------------------------------------------------------------------*/
+
+static int GetMemKnd(GmlSct *gml, int idx, int *DegIdx, int *DegOff, int *PrmIdx)
+{
+   int      i, j, t, BalIdx = idx, knd = GmlLnkMem;
+   DatSct   *dat = gml->dat[ idx ];
+
+   *DegIdx = *DegOff = *PrmIdx = 0;
+
+   switch(dat->AloTyp)
    {
-      printf("Downloading the data from the GPu failed with error %d\n", res);
-      return(0);
+      case GmlArgDat : return(GmlParMem);
+      case GmlEleDat : return(GmlMshMem);
+      case GmlRefDat : return(GmlRefMem);
    }
-   else
+
+   if(dat->AloTyp == GmlRawDat)
    {
-      gml->MovSiz += dat->MemSiz;
-      return((int)dat->MemSiz);
+      if(dat->MshTyp == GmlMatDat)
+         return(GmlMatMem);
+
+      if(dat->MshTyp == GmlVecDat)
+         return(GmlVecMem);
+
+      for(i=1;i<=gml->MaxDat;i++)
+         if(gml->dat[i]->use && (gml->dat[i]->RedIdx == idx))
+            return(GmlRedMem);
+
+      return(GmlSolMem);
    }
+
+   // A voyeurs table shares the layout and filling of its ball table
+   for(i=1;i<=gml->MaxDat;i++)
+      if(gml->dat[i]->use && (gml->dat[i]->VoyIdx == idx))
+         BalIdx = i;
+
+   // Uplinks come with a degree table that gives the filling
+   // of each of their degree tiers, packed ones are full
+   for(i=0;i<GmlMaxEleTyp;i++)
+      for(j=0;j<MAXLNKCOL;j++)
+      {
+         if(!gml->CntMat[i][j])
+            continue;
+
+         if(gml->CntMat[i][j] == idx)
+            return(GmlDegMem);
+
+         if(gml->CsrMat[i][j] == idx)
+            return(GmlOffMem);
+
+         if( (gml->PrmMat[i][j] == idx) || (gml->InvMat[i][j] == idx) )
+            return(GmlPrmMem);
+
+         if(gml->CsrMat[i][j] && (gml->LnkMat[i][j] == BalIdx))
+            knd = GmlCsrMem;
+         else if(gml->LnkMat[i][j] == BalIdx)
+         {
+            *DegIdx = gml->CntMat[i][j];
+            *PrmIdx = gml->PrmMat[i][j];
+            knd = GmlBalMem;
+         }
+         else for(t=1;t<gml->NmbTie[i][j];t++)
+            if(gml->TieMat[i][j][t] == BalIdx)
+            {
+               *DegIdx = gml->CntMat[i][j];
+               *DegOff = gml->TieLin[i][j][t];
+               *PrmIdx = gml->PrmMat[i][j];
+               knd = GmlHghMem;
+            }
+      }
+
+   return( (BalIdx != idx) ? GmlVoyMem : knd );
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Send the parameter structure data to the GPU                               */
+/* Get the name, kind, device and host sizes and occupancy of the next data   */
+/* allocated after DatIdx: start from 0 and loop until it returns 0           */
 /*----------------------------------------------------------------------------*/
 
-int GmlUploadParameters(size_t idx)
+int GmlGetDataInfo(  size_t GmlIdx, int DatIdx, const char **nam, int *MemKnd,
+                     size_t *DevSiz, size_t *HstSiz, float *occ )
 {
-   GETGMLPTR(gml, idx);
+   GETGMLPTR(gml, GmlIdx);
+   int      i, j, l, knd, DegIdx, DegOff, PrmIdx, *DegTab, *PrmTab;
+   size_t   dev, hst, use, DegTot = 0;
+   DatSct   *dat, *deg;
 
-   if(!UploadData(gml, gml->ParIdx))
+   for(i=MAX(DatIdx, 0)+1; i<=gml->MaxDat; i++)
+      if(gml->dat[i]->use && gml->dat[i]->GpuMem)
+         break;
+
+   if(i > gml->MaxDat)
       return(0);
+
+   dat = gml->dat[i];
+   knd = GetMemKnd(gml, i, &DegIdx, &DegOff, &PrmIdx);
+
+   // Device sizes include the pool alignment or the zero-copy rounding
+   if(dat->PolIdx)
+      dev = dat->PolSiz;
+   else if(dat->ZerCpy)
+      dev = ((dat->MemSiz + HSTALN - 1) / HSTALN) * HSTALN;
    else
-      return(1);
-}
+      dev = dat->MemSiz;
+
+   if(!dat->CpuMem)
+      hst = 0;
+   else
+      hst = dat->ZerCpy ? dev : dat->MemSiz;
+
+   // Count the useful bytes: three coordinates out of four for the vertices
+   // and the stored entries only for the balls and their voyeurs
+   if( (knd == GmlMshMem) && (dat->MshTyp == GmlVertices) )
+      use = dat->MemSiz / 4 * 3;
+   else if(DegIdx && gml->dat[ DegIdx ]->CpuMem)
+   {
+      deg = gml->dat[ DegIdx ];
+      DegTab = (int *)deg->CpuMem;
+      PrmTab = PrmIdx ? (int *)gml->dat[ PrmIdx ]->CpuMem : NULL;
 
+      // Permuted tiers store their lines in the permutation's order
+      for(j=0; (j < dat->NmbLin) && (DegOff + j < deg->NmbLin); j++)
+      {
+         l = PrmTab ? PrmTab[ DegOff + j ] : DegOff + j;
+         DegTot += MIN(DegTab[l], dat->ItmLen);
+      }
 
-/*----------------------------------------------------------------------------*/
-/* Get the parameter structure data from the GPU                              */
-/*----------------------------------------------------------------------------*/
+      use = DegTot * (OclTypSiz[ dat->ItmTyp ] / TypVecSiz[ dat->ItmTyp ]);
+   }
+   else
+      use = dat->MemSiz;
 
-int GmlDownloadParameters(size_t idx)
-{
-   GETGMLPTR(gml, idx);
+   if(nam)
+      *nam = dat->nam ? dat->nam : "";
 
-   if(!DownloadData(gml, gml->ParIdx))
-      return(0);
-   else
-      return(1);
-}
+   if(MemKnd)
+      *MemKnd = knd;
 
+   if(DevSiz)
+      *DevSiz = dev;
 
-/*----------------------------------------------------------------------------*/
-/*----------------------------------------------------------------------------*/
+   if(HstSiz)
+      *HstSiz = hst;
 
-void GmlSetCompilerOptions(size_t GmlIdx, char *OptStr)
-{
-   GETGMLPTR(gml, GmlIdx);
-   strcpy(gml->cflags, OptStr);
+   if(occ)
+      *occ = dev ? (float)use / (float)dev : 0.f;
+
+   return(i);
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Generate the kernel from user's source and data and compile it             */
+/* Write the memory usage of every allocated data as a JSON file or to stdout */
 /*----------------------------------------------------------------------------*/
 
-int GmlCompileKernel(size_t GmlIdx, char *KrnSrc, char *PrcNam,
-                     int MshTyp, int NmbTyp, ...)
+int GmlExportMemoryUsage(size_t GmlIdx, char *JsnNam)
 {
    GETGMLPTR(gml, GmlIdx);
-   int      i, j, flg, KrnIdx, KrnHghIdx, SrcTyp, DstTyp, NmbArg = 0, RefIdx;
-   int      FlgTab[ GmlMaxDat ], IdxTab[ GmlMaxDat ];
-   int      LnkTab[ GmlMaxDat ], CntTab[ GmlMaxDat ];
-   int      LnkItm, NmbItm, ItmTyp, ItmLen, LnkPos, CptPos, ArgHghPos;
-   int      RefFlg, NmbHgh, HghVec, HghSiz, HghTyp, HghArg = -1, HghIdx = -1;
-   char     *ParSrc, src[ GmlMaxSrcSiz ] = "\0", VoyNam[ GmlMaxStrSiz ];
-   char     BalNam[ GmlMaxStrSiz ], DegNam[ GmlMaxStrSiz ];
-   va_list  VarArg;
-   DatSct   *dat, *RefDat;
-   ArgSct   *arg, ArgTab[ GmlMaxOclTyp ];
-   KrnSct   *krn;
-
-   // Read user's datatypes arguments
-   ParSrc = gml->ParIdx ? gml->dat[ gml->ParIdx ].src : NULL;
-
-   va_start(VarArg, NmbTyp);
+   int         i, idx, knd, NmbDat = 0;
+   size_t      dev, hst, PolTot = 0, KndDev[ GmlMaxMemKnd ] = {0};
+   size_t      KndHst[ GmlMaxMemKnd ] = {0};
+   float       occ;
+   const char  *nam;
+   FILE        *hdl = stdout;
 
-   for(i=0;i<NmbTyp;i++)
+   if(JsnNam && !(hdl = fopen(JsnNam, "w")))
    {
-      IdxTab[i] = va_arg(VarArg, int);
-      FlgTab[i] = va_arg(VarArg, int);
-      LnkTab[i] = va_arg(VarArg, int);
-      CntTab[i] = 0;
+      printf("Cannot create the memory usage file %s\n", JsnNam);
+      return(0);
    }
 
-   va_end(VarArg);
+   for(i=0;i<gml->NmbPol;i++)
+      PolTot += gml->pol[i].siz;
 
-   // Check or build datatype indirect access tables
-   for(i=0;i<NmbTyp;i++)
+   fprintf(hdl, "{\n");
+   fprintf(hdl, "   \"allocated_bytes\": %zu,\n", gml->MemSiz);
+   fprintf(hdl, "   \"pool_chunk_bytes\": %zu,\n", PolTot);
+   fprintf(hdl, "   \"transferred_bytes\": %zu,\n", gml->MovSiz);
+   fprintf(hdl, "   \"data\": [");
+
+   for(idx = GmlGetDataInfo(GmlIdx, 0, &nam, &knd, &dev, &hst, &occ); idx;
+       idx = GmlGetDataInfo(GmlIdx, idx, &nam, &knd, &dev, &hst, &occ))
    {
-      dat = &gml->dat[ IdxTab[i] ];
+      fprintf( hdl, "%s\n      {\"index\": %d, \"name\": \"%s\", \"kind\": \"%s\", "
+               "\"lines\": %d, \"device_bytes\": %zu, \"host_bytes\": %zu, "
+               "\"zero_copy\": %s, \"occupancy\": %.3f}",
+               NmbDat ? "," : "", idx, nam, MemKndStr[ knd ],
+               gml->dat[ idx ]->NmbLin, dev, hst,
+               gml->dat[ idx ]->ZerCpy ? "true" : "false", occ );
 
-      if( LnkTab[i] || (dat->MshTyp == MshTyp) )
-         continue;
+      KndDev[ knd ] += dev;
+      KndHst[ knd ] += hst;
+      NmbDat++;
+   }
 
-      // Source and destination mesh datatype to access the connectivity matrix
-      SrcTyp = MshTyp;
-      DstTyp = dat->MshTyp;
+   fprintf(hdl, "\n   ],\n   \"kinds\": {");
 
-      if(MshTypDim[ SrcTyp ] > MshTypDim[ DstTyp ])
-      {
-         // Downlink
-         if(!gml->LnkMat[ MshTyp ][ dat->MshTyp ])
-         {
-            // Generate the default link between the two kinds of entities
-            sprintf(BalNam, "%s%sLnk", BalTypStr[ MshTyp ], BalTypStr[ DstTyp ]);
-            sprintf(DegNam, "%s%sDeg", BalTypStr[ MshTyp ], BalTypStr[ DstTyp ]);
-            NewBallData(gml, MshTyp, DstTyp, BalNam, DegNam, NULL);
-         }
+   for(i=0;i<GmlMaxMemKnd;i++)
+      fprintf( hdl, "%s\n      \"%s\": {\"device_bytes\": %zu, \"host_bytes\": %zu}",
+               i ? "," : "", MemKndStr[i], KndDev[i], KndHst[i] );
 
-         LnkTab[i] = gml->LnkMat[ MshTyp ][ DstTyp ];
-         CntTab[i] = 0;
-      }
-      else if(MshTypDim[ SrcTyp ] < MshTypDim[ DstTyp ])
-      {
-         // Uplink
-         if(!gml->LnkMat[ MshTyp ][ dat->MshTyp ])
-         {
-            // Generate the default link between the two kinds of entities
-            sprintf(BalNam, "%s%sBal", BalTypStr[ MshTyp ], BalTypStr[ DstTyp ]);
-            sprintf(DegNam, "%s%sDeg", BalTypStr[ MshTyp ], BalTypStr[ DstTyp ]);
-            sprintf(VoyNam, "%s%sVoy", BalTypStr[ MshTyp ], BalTypStr[ DstTyp ]);
-            NewBallData(gml, MshTyp, DstTyp, BalNam, DegNam, VoyNam);
-         }
+   fprintf(hdl, "\n   }\n}\n");
 
-         LnkTab[i] = gml->LnkMat[ MshTyp ][ DstTyp ];
-         CntTab[i] = gml->CntMat[ MshTyp ][ DstTyp ];
-      }
-   }
+   if(JsnNam)
+      fclose(hdl);
 
-   // Build the context arguments to store links
-   for(i=0;i<NmbTyp;i++)
-   {
-      // Process each datatype that needs a link
-      if(!LnkTab[i])
-         continue;
+   return(1);
+}
 
-      // Try to find if this link already exists in the previously defined arguments
-      dat = &gml->dat[ IdxTab[i] ];
-      flg = 0;
 
-      for(j=0;j<NmbArg;j++)
-         if(ArgTab[j].DatIdx == LnkTab[i])
-            flg = 1;
+/*----------------------------------------------------------------------------*/
+/* Tell whether a data slot belongs to the mesh state saved in a file         */
+/*----------------------------------------------------------------------------*/
 
-      if(flg)
-         continue;
+static int IsStaDat(GmlSct *gml, int idx)
+{
+   int      i, j;
+   DatSct   *dat = gml->dat[ idx ];
 
-      // If not, get the link data index from the conectivity matrix
-      SrcTyp = MshTyp;
-      DstTyp = dat->MshTyp;
-      LnkItm = LenMatBas[ MshTyp ][ DstTyp ];
-      GetCntVec(LnkItm, &NmbItm, &ItmLen, &ItmTyp);
+   // Parameters and device only scratch tables are not part of the state
+   if(!dat->use || !dat->CpuMem || (dat->AloTyp == GmlArgDat))
+      return(0);
 
-      // Create a new contextual arguments
-      arg = &ArgTab[ NmbArg ];
-      arg->ArgIdx = NmbArg;
-      NmbArg++;
+   // Nor are the tables owned by reductions, matrices and vectors
+   // as they are rebuilt along with their structures
+   for(i=1;i<=gml->MaxDat;i++)
+      if(gml->dat[i]->use && (gml->dat[i]->RedIdx == idx))
+         return(0);
 
-      if(MshTypDim[ SrcTyp ] > MshTypDim[ DstTyp ])
-      {
-         // Downlink access arguments
-         arg->MshTyp = DstTyp;
-         arg->DatIdx = LnkTab[i];
-         arg->LnkDir = -1;
-         arg->LnkTyp = -1;
-         arg->LnkIdx = -1;
-         arg->CntIdx = -1;
-         arg->LnkDeg = LnkItm;
-         arg->MaxDeg = LnkItm;
-         arg->NmbItm = NmbItm;
-         arg->ItmLen = ItmLen;
-         arg->ItmTyp = ItmTyp;
-         arg->FlgTab = GmlReadMode;
-         arg->nam    = gml->dat[ arg->DatIdx ].nam;
-      }
-      else if(MshTypDim[ SrcTyp ] == MshTypDim[ DstTyp ])
-      {
-         // Neighbours access arguments
-         arg->MshTyp = DstTyp;
-         arg->DatIdx = LnkTab[i];
-         arg->LnkDir = 0;
-         arg->LnkTyp = -1;
-         arg->LnkIdx = -1;
-         arg->CntIdx = -1;
-         arg->LnkDeg = LnkItm;
-         arg->MaxDeg = LnkItm;
-         arg->NmbItm = NmbItm;
-         arg->ItmLen = ItmLen;
-         arg->ItmTyp = ItmTyp;
-         arg->FlgTab = GmlReadMode;
-         arg->nam    = gml->dat[ arg->DatIdx ].nam;
-      }
-      else if(MshTypDim[ SrcTyp ] < MshTypDim[ DstTyp ])
-      {
-         // Uplink access arguments
-         arg->MshTyp = DstTyp;
-         arg->DatIdx = LnkTab[i];
-         arg->LnkDir = 1;
-         arg->LnkTyp = -1;
-         arg->LnkIdx = -1;
-         arg->CntIdx = -1;
-         arg->LnkDeg = -1;
-         arg->MaxDeg = LnkItm;
-         arg->NmbItm = NmbItm;
-         arg->ItmLen = ItmLen;
-         arg->ItmTyp = ItmTyp;
-         arg->FlgTab = GmlReadMode;
-         arg->nam    = gml->dat[ arg->DatIdx ].nam;
+   for(i=1;i<=gml->MaxMat;i++)
+      if(gml->mat[i]->use)
+         for(j=0;j<gml->mat[i]->NmbSlc;j++)
+            if( (gml->mat[i]->ValIdx[j] == idx) || (gml->mat[i]->ColIdx[j] == idx)
+            ||  (gml->mat[i]->DegIdx[j] == idx) )
+            {
+               return(0);
+            }
 
-         if( (HghIdx != -1) && (HghIdx != gml->LnkHgh[ MshTyp ][ DstTyp ]) )
-         {
-            puts("Current limitation prevents mixing two different kinds of uplink in the same kernel.");
-            return(0);
-         }
+   for(i=1;i<=gml->MaxVec;i++)
+      if(gml->vec[i]->use && (gml->vec[i]->idx == idx))
+         return(0);
 
-         HghArg      = arg->ArgIdx;
-         HghIdx      = gml->LnkHgh[ MshTyp ][ DstTyp ];
-         NmbHgh      = gml->SizMatHgh[ MshTyp ][ DstTyp ];
+   return(1);
+}
 
-         // If this uplink requires voyeurs to be set, add the proper flag
-         // to the argument and remove it from the user flag tab
-         if(FlgTab[i] & GmlVoyeurs)
-         {
-            arg->VoyNam  =  gml->dat[ arg->DatIdx ].VoyNam;
-            arg->FlgTab |=  GmlVoyeurs;
-            FlgTab[i]   &= ~GmlVoyeurs;
-         }
 
-         // Variable counter argument
-         arg = &ArgTab[ NmbArg ];
-         arg->ArgIdx = NmbArg;
-         NmbArg++;
+/*----------------------------------------------------------------------------*/
+/* List the metadata tables that describe the mesh, links and tiers           */
+/*----------------------------------------------------------------------------*/
 
-         arg->MshTyp = DstTyp;
-         arg->DatIdx = gml->CntMat[ MshTyp ][ DstTyp ];
-         arg->LnkDir = 0;
-         arg->LnkTyp = -1;
-         arg->LnkIdx = -1;
-         arg->CntIdx = -1;
-         arg->LnkDeg = 1;
-         arg->MaxDeg = 1;
-         arg->NmbItm = 1;
-         arg->ItmLen = 1;
-         arg->ItmTyp = GmlInt;
-         arg->FlgTab = GmlReadMode;
-         arg->nam    = gml->dat[ arg->DatIdx ].nam;
-      }
-   }
+static int GetStaTab(GmlSct *gml, void **tab, size_t *siz)
+{
+   int n = 0;
+
+   tab[n] = &gml->CrdTyp;  siz[n++] = sizeof(gml->CrdTyp);
+   tab[n] = &gml->HybBal;  siz[n++] = sizeof(gml->HybBal);
+   tab[n] = &gml->HybDeg;  siz[n++] = sizeof(gml->HybDeg);
+   tab[n] = &gml->HybTyp;  siz[n++] = sizeof(gml->HybTyp);
+   tab[n] = gml->TypIdx;   siz[n++] = sizeof(gml->TypIdx);
+   tab[n] = gml->RefIdx;   siz[n++] = sizeof(gml->RefIdx);
+   tab[n] = gml->NgbTag;   siz[n++] = sizeof(gml->NgbTag);
+   tab[n] = gml->NmbEle;   siz[n++] = sizeof(gml->NmbEle);
+   tab[n] = gml->LnkMat;   siz[n++] = sizeof(gml->LnkMat);
+   tab[n] = gml->CntMat;   siz[n++] = sizeof(gml->CntMat);
+   tab[n] = gml->CsrMat;   siz[n++] = sizeof(gml->CsrMat);
+   tab[n] = gml->NmbTie;   siz[n++] = sizeof(gml->NmbTie);
+   tab[n] = gml->TieMat;   siz[n++] = sizeof(gml->TieMat);
+   tab[n] = gml->TieLin;   siz[n++] = sizeof(gml->TieLin);
+   tab[n] = gml->PrmMat;   siz[n++] = sizeof(gml->PrmMat);
+   tab[n] = gml->InvMat;   siz[n++] = sizeof(gml->InvMat);
+
+   return(n);
+}
 
-   // Now that the links are defined first, the user's data can be accessed
-   for(i=0;i<NmbTyp;i++)
-   {
-      // For each datatype, try to find the arguments containing their link and counter
-      dat = &gml->dat[ IdxTab[i] ];
-      DstTyp = dat->MshTyp;
-      LnkPos = CptPos = -1;
 
-      if(LnkTab[i])
-         for(j=0;j<NmbArg;j++)
-            if(ArgTab[j].DatIdx == LnkTab[i])
-               LnkPos = j;
+/*----------------------------------------------------------------------------*/
+/* Save the mesh, links and solutions along with their metadata in a binary   */
+/* file whose tables start on page boundaries so that it can be mapped        */
+/*----------------------------------------------------------------------------*/
 
-      if(CntTab[i])
-         for(j=0;j<NmbArg;j++)
-            if(ArgTab[j].DatIdx == CntTab[i])
-               CptPos = j;
+int GmlSaveState(size_t GmlIdx, char *FilNam)
+{
+   GETGMLPTR(gml, GmlIdx);
+   int      i, n, NmbDat = 0, NmbTab, HdrTab[8];
+   char     pad[ HSTPAG ] = {0};
+   void     *tab[ MAXSTATAB ];
+   size_t   siz[ MAXSTATAB ], pos, MetSiz = 0;
+   DatSct   *dat;
+   StaSct   *sta;
+   FILE     *hdl;
 
-      // Create a new data argument
-      arg = &ArgTab[ NmbArg ];
-      arg->ArgIdx = NmbArg;
-      NmbArg++;
+   NmbTab = GetStaTab(gml, tab, siz);
 
-      arg->MshTyp = DstTyp;
-      arg->DatIdx = IdxTab[i];
-      arg->LnkDir = 0;
-      arg->LnkTyp = DstTyp;
-      arg->LnkIdx = LnkPos;
-      arg->CntIdx = CptPos;
+   for(i=0;i<NmbTab;i++)
+      MetSiz += siz[i];
 
-      if(LnkPos != -1 && CptPos != -1)
-      {
-         // Downlink with variable counter
-         arg->LnkDeg = -1;
-         arg->MaxDeg = ArgTab[ LnkPos ].MaxDeg;
-         ArgHghPos   = arg->ArgIdx;
-      }
-      else if(LnkPos != -1 && CptPos == -1)
-      {
-         // Link with constant counter
-         arg->LnkDeg = ArgTab[ LnkPos ].LnkDeg;
-         arg->MaxDeg = ArgTab[ LnkPos ].MaxDeg;
-      }
-      else
-      {
-         // No link: straight access
-         arg->LnkDeg = -1;
-         arg->MaxDeg = -1;
-      }
+   if(!(sta = calloc(gml->MaxDat, sizeof(StaSct))))
+      return(0);
 
-      if(FlgTab[i] & GmlRefFlag)
+   for(i=1;i<=gml->MaxDat;i++)
+   {
+      if(!IsStaDat(gml, i))
+         continue;
+
+      dat = gml->dat[i];
+
+      // Fetch the results of the kernels into the host mirror
+      if( (dat->NmbLin > 0) && !GetHostLines(gml, i, 0, dat->NmbLin - 1) )
       {
-         RefFlg = 1;
-         FlgTab[i]   &= ~GmlRefFlag;
+         printf("Cannot fetch the data %d from the device\n", i);
+         free(sta);
+         return(0);
       }
-      else
-         RefFlg = 0;
 
-      arg->NmbItm = dat->NmbItm;
-      arg->ItmLen = dat->ItmLen;
-      arg->ItmTyp = dat->ItmTyp;
-      arg->FlgTab = FlgTab[i];
-      arg->nam    = dat->nam;
+      sta[ NmbDat ].idx    = i;
+      sta[ NmbDat ].AloTyp = dat->AloTyp;
+      sta[ NmbDat ].MemAcs = dat->MemAcs;
+      sta[ NmbDat ].MshTyp = dat->MshTyp;
+      sta[ NmbDat ].LnkTyp = dat->LnkTyp;
+      sta[ NmbDat ].ItmTyp = dat->ItmTyp;
+      sta[ NmbDat ].NmbItm = dat->NmbItm;
+      sta[ NmbDat ].ItmLen = dat->ItmLen;
+      sta[ NmbDat ].ItmSiz = dat->ItmSiz;
+      sta[ NmbDat ].NmbLin = dat->NmbLin;
+      sta[ NmbDat ].LinSiz = dat->LinSiz;
+      sta[ NmbDat ].VoyIdx = dat->VoyIdx;
+      sta[ NmbDat ].MemSiz = dat->MemSiz;
+
+      if(dat->nam)
+         strncpy(sta[ NmbDat ].nam, dat->nam, 15);
 
-      if(!RefFlg || (CptPos != -1))
-         continue;
+      NmbDat++;
+   }
 
-      // Create a new ref argument
-      arg = &ArgTab[ NmbArg ];
-      arg->ArgIdx = NmbArg;
-      NmbArg++;
+   // The header, the data descriptors and the metadata come first
+   // and each table starts on the next page boundary
+   HdrTab[0] = STAVER;
+   HdrTab[1] = GmlMaxEleTyp;
+   HdrTab[2] = MAXLNKCOL;
+   HdrTab[3] = MAXTIE;
+   HdrTab[4] = NmbDat;
+   HdrTab[5] = NmbTab;
+   HdrTab[6] = (int)sizeof(StaSct);
+   HdrTab[7] = (int)MetSiz;
 
-      RefIdx = gml->RefIdx[ DstTyp ];
-      RefDat = &gml->dat[ RefIdx ];
+   pos = 8 + sizeof(HdrTab) + NmbDat * sizeof(StaSct) + MetSiz;
 
-      arg->MshTyp = DstTyp;
-      arg->DatIdx = RefIdx;
-      arg->LnkDir = 0;
-      arg->LnkTyp = DstTyp;
-      arg->LnkIdx = LnkPos;
-      arg->CntIdx = CptPos;
-      arg->LnkDeg = -1;
-      arg->MaxDeg = ArgTab[ LnkPos ].MaxDeg;
-      arg->NmbItm = RefDat->NmbItm;
-      arg->ItmLen = RefDat->ItmLen;
-      arg->ItmTyp = RefDat->ItmTyp;
-      arg->FlgTab = FlgTab[i];
-      arg->nam    = RefDat->nam;
+   for(n=0;n<NmbDat;n++)
+   {
+      sta[n].FilOff = ((pos + HSTPAG - 1) / HSTPAG) * HSTPAG;
+      pos = sta[n].FilOff + sta[n].MemSiz;
    }
 
-   // Generate the kernel source code
-   WriteToolkitSource      (src, toolkit);
-   WriteUserToolkitSource  (src, gml->UsrTlk);
-   WriteUserTypedef        (src, ParSrc);
-   WriteProcedureHeader    (src, PrcNam, MshTyp, NmbArg, ArgTab);
-   WriteKernelVariables    (src, MshTyp, NmbArg, ArgTab);
-   WriteKernelCounters     (src, MshTyp);
-   WriteKernelMemoryReads  (src, MshTyp, NmbArg, ArgTab);
-   WriteUserKernel         (src, KrnSrc);
-   WriteKernelMemoryWrites (src, MshTyp, NmbArg, ArgTab);
+   if(!(hdl = fopen(FilNam, "wb")))
+   {
+      printf("Cannot create the state file %s\n", FilNam);
+      free(sta);
+      return(0);
+   }
 
-   // And Compile it
-   KrnIdx = NewOclKrn      (gml, src, PrcNam);
+   fwrite("GMLSTATE", 1, 8, hdl);
+   fwrite(HdrTab, sizeof(HdrTab), 1, hdl);
+   fwrite(sta, sizeof(StaSct), NmbDat, hdl);
 
-   if(!KrnIdx)
-      return(0);
+   for(i=0;i<NmbTab;i++)
+      fwrite(tab[i], siz[i], 1, hdl);
+
+   pos = 8 + sizeof(HdrTab) + NmbDat * sizeof(StaSct) + MetSiz;
+
+   for(n=0;n<NmbDat;n++)
+   {
+      fwrite(pad, 1, sta[n].FilOff - pos, hdl);
+
+      if(fwrite(gml->dat[ sta[n].idx ]->CpuMem, 1, sta[n].MemSiz, hdl) != sta[n].MemSiz)
+      {
+         printf("Cannot write the data %d to the state file %s\n", sta[n].idx, FilNam);
+         fclose(hdl);
+         free(sta);
+         return(0);
+      }
+
+      pos = sta[n].FilOff + sta[n].MemSiz;
+   }
+
+   fclose(hdl);
+   free(sta);
 
    if(gml->DbgFlg)
    {
       puts(sep);
-      printf("Generated source for kernel=%s, index=%2d\n", PrcNam, KrnIdx);
-      puts(src);
+      printf("Saved %d data, %zu bytes, to the state file %s\n", NmbDat, pos, FilNam);
    }
 
-   // Store information usefull to the kernel: loop indices and arguments list
-   krn = &gml->krn[ KrnIdx ];
-   krn->NmbDat    = NmbArg;
-   krn->NmbLin[1] = 0;
+   return(1);
+}
 
-   // In case of constant counter, the kernel loops from 0 to NmbLin-1
-   // Otherwise, it loops up to the start of high degree entities
-   if(HghIdx == -1)
-      krn->NmbLin[0] = gml->dat[ gml->TypIdx[ MshTyp ] ].NmbLin;
-   else
-      krn->NmbLin[0] = gml->dat[ gml->TypIdx[ MshTyp ] ].NmbLin - gml->dat[ HghIdx ].NmbLin;
 
-   for(i=0;i<NmbArg;i++)
-      krn->DatTab[i] = ArgTab[i].DatIdx;
+/*----------------------------------------------------------------------------*/
+/* Restore the tables and metadata read from a state file                     */
+/*----------------------------------------------------------------------------*/
 
-   if(HghArg == -1 || !HghIdx)
-      return(KrnIdx);
+static int ReadState(GmlSct *gml, FILE *hdl, int NmbDat, StaSct *sta)
+{
+   int      i, n, NmbTab, res = 1;
+   char     pad[ HSTPAG ], *MetBuf, *adr;
+   void     *tab[ MAXSTATAB ];
+   size_t   siz[ MAXSTATAB ], pos, MetSiz = 0;
+   DatSct   *dat;
 
-   // In case of uplink kernel, generate a second high degree kernel
-   GetCntVec(NmbHgh, &HghVec, &HghSiz, &HghTyp);
+   if(fread(sta, sizeof(StaSct), NmbDat, hdl) != (size_t)NmbDat)
+      return(0);
 
-   // Mofify the argument containing the uplink with the high count sizes
-   ArgTab[ HghArg ].DatIdx = HghIdx;
-   ArgTab[ HghArg ].MaxDeg = NmbHgh;
-   ArgTab[ HghArg ].NmbItm = HghVec;
-   ArgTab[ HghArg ].ItmLen = HghSiz;
-   ArgTab[ HghArg ].ItmTyp = HghTyp;
-   src[0] = '\0';
+   // Tables are restored at their former indices so that the
+   // metadata and the links between them remain valid
+   for(n=0;n<NmbDat;n++)
+   {
+      while(sta[n].idx > gml->MaxDat)
+         if(!GrowDatTab(gml))
+            return(0);
 
-   // Generate the kernel source code
-   WriteToolkitSource      (src, toolkit);
-   WriteUserToolkitSource  (src, gml->UsrTlk);
-   WriteUserTypedef        (src, ParSrc);
-   WriteProcedureHeader    (src, PrcNam, MshTyp, NmbArg, ArgTab);
-   WriteKernelVariables    (src, MshTyp, NmbArg, ArgTab);
-   WriteKernelCounters     (src, MshTyp);
-   WriteKernelMemoryReads  (src, MshTyp, NmbArg, ArgTab);
-   WriteUserKernel         (src, KrnSrc);
-   WriteKernelMemoryWrites (src, MshTyp, NmbArg, ArgTab);
+      if( (sta[n].idx < 1) || gml->dat[ sta[n].idx ]->use )
+      {
+         printf("Cannot restore the data %d as its slot is already used\n", sta[n].idx);
+         return(0);
+      }
+   }
 
-   // And Compile it
-   KrnHghIdx = NewOclKrn   (gml, src, PrcNam);
+   // The metadata is kept aside until every table has been loaded
+   // so that a failure leaves the library as it was
+   NmbTab = GetStaTab(gml, tab, siz);
+
+   for(i=0;i<NmbTab;i++)
+      MetSiz += siz[i];
 
-   if(!KrnHghIdx)
+   if(!(MetBuf = malloc(MetSiz)))
       return(0);
 
-   gml->krn[ KrnIdx ].HghIdx = KrnHghIdx;
+   if(fread(MetBuf, MetSiz, 1, hdl) != 1)
+   {
+      free(MetBuf);
+      return(0);
+   }
 
-   // Store information usefull to the kernel: loop indices and arguments list
-   krn = &gml->krn[ KrnHghIdx ];
-   krn->NmbDat    = NmbArg;
-   krn->NmbLin[0] = gml->dat[ HghIdx ].NmbLin;
-   krn->NmbLin[1] = gml->dat[ gml->TypIdx[ MshTyp ] ].NmbLin - gml->dat[ HghIdx ].NmbLin;
+   pos = 8 + 8 * sizeof(int) + NmbDat * sizeof(StaSct) + MetSiz;
 
-   for(i=0;i<NmbArg;i++)
-      krn->DatTab[i] = ArgTab[i].DatIdx;
+   for(n=0;n<NmbDat;n++)
+   {
+      if( (sta[n].FilOff < pos) || (sta[n].FilOff - pos > HSTPAG) )
+      {
+         res = 0;
+         break;
+      }
 
-   if(gml->DbgFlg)
+      dat = gml->dat[ sta[n].idx ];
+
+      dat->use    = 1;
+      dat->AloTyp = sta[n].AloTyp;
+      dat->MemAcs = sta[n].MemAcs;
+      dat->MshTyp = sta[n].MshTyp;
+      dat->LnkTyp = sta[n].LnkTyp;
+      dat->ItmTyp = sta[n].ItmTyp;
+      dat->NmbItm = sta[n].NmbItm;
+      dat->ItmLen = sta[n].ItmLen;
+      dat->ItmSiz = sta[n].ItmSiz;
+      dat->NmbLin = sta[n].NmbLin;
+      dat->LinSiz = sta[n].LinSiz;
+      dat->VoyIdx = sta[n].VoyIdx;
+      dat->MemSiz = sta[n].MemSiz;
+      dat->GpuMem = dat->CpuMem = NULL;
+      strncpy(dat->NamBuf, sta[n].nam, 15);
+      dat->nam    = dat->NamBuf;
+
+      if(!NewData(gml, dat))
+      {
+         memset(dat, 0, sizeof(DatSct));
+         res = 0;
+         break;
+      }
+
+      // Skip the padding and read the table straight into
+      // the page aligned host mirror before sending it to the device
+      if( (fread(pad, 1, sta[n].FilOff - pos, hdl) != sta[n].FilOff - pos)
+      ||  (fread(dat->CpuMem, 1, dat->MemSiz, hdl) != dat->MemSiz)
+      ||  !UploadData(gml, sta[n].idx) )
+      {
+         res = 0;
+         break;
+      }
+
+      pos = sta[n].FilOff + sta[n].MemSiz;
+   }
+
+   // Release the tables loaded so far, the metadata was left untouched
+   if(!res)
    {
-      puts(sep);
-      printf("Generated source for kernel=%s, index=%2d\n", PrcNam, KrnIdx);
-      puts(src);
+      for(n=0;n<NmbDat;n++)
+      {
+         dat = gml->dat[ sta[n].idx ];
+
+         if(dat->GpuMem)
+            GmlFreeData((size_t)gml, sta[n].idx);
+         else
+            memset(dat, 0, sizeof(DatSct));
+      }
+
+      free(MetBuf);
+      return(0);
    }
 
-   return(KrnIdx);
+   for(i=0, adr=MetBuf; i<NmbTab; adr+=siz[i++])
+      memcpy(tab[i], adr, siz[i]);
+
+   free(MetBuf);
+
+   // Ball tables get back the name of their voyeurs
+   for(n=0;n<NmbDat;n++)
+      if(sta[n].VoyIdx)
+         gml->dat[ sta[n].idx ]->VoyNam = gml->dat[ sta[n].VoyIdx ]->nam;
+
+   return(1);
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Add the geometrical toolkit prototypes and source code                     */
+/* Load a state file saved by GmlSaveState into a freshly initialized library */
 /*----------------------------------------------------------------------------*/
 
-static void WriteToolkitSource(char *src, char *TlkSrc)
+int GmlLoadState(size_t GmlIdx, char *FilNam)
 {
-   strcat(src, "// GMlib MESHING AND GEOMETRICAL TOOLKIT\n");
-   strcat(src, TlkSrc);
-   strcat(src, "\n");
-}
+   GETGMLPTR(gml, GmlIdx);
+   int      i, res, NmbTab, HdrTab[8];
+   char     MagStr[8];
+   void     *tab[ MAXSTATAB ];
+   size_t   siz[ MAXSTATAB ], MetSiz = 0;
+   StaSct   *sta;
+   FILE     *hdl;
+
+   NmbTab = GetStaTab(gml, tab, siz);
 
+   for(i=0;i<NmbTab;i++)
+      MetSiz += siz[i];
 
+   if(!(hdl = fopen(FilNam, "rb")))
+   {
+      printf("Cannot open the state file %s\n", FilNam);
+      return(0);
+   }
+
+   // The file must have been written by a library built with the same sizes
+   if( (fread(MagStr, 1, 8, hdl) != 8) || memcmp(MagStr, "GMLSTATE", 8)
+   ||  (fread(HdrTab, sizeof(HdrTab), 1, hdl) != 1)
+   ||  (HdrTab[0] != STAVER) || (HdrTab[1] != GmlMaxEleTyp)
+   ||  (HdrTab[2] != MAXLNKCOL) || (HdrTab[3] != MAXTIE) || (HdrTab[4] < 0)
+   ||  (HdrTab[5] != NmbTab) || (HdrTab[6] != (int)sizeof(StaSct))
+   ||  (HdrTab[7] != (int)MetSiz) )
+   {
+      printf("The state file %s does not match this library\n", FilNam);
+      fclose(hdl);
+      return(0);
+   }
+
+   if(!(sta = calloc(MAX(HdrTab[4], 1), sizeof(StaSct))))
+   {
+      fclose(hdl);
+      return(0);
+   }
+
+   res = ReadState(gml, hdl, HdrTab[4], sta);
+
+   fclose(hdl);
+   free(sta);
+
+   if(!res)
+      printf("Cannot read the state file %s\n", FilNam);
+   else if(gml->DbgFlg)
+   {
+      puts(sep);
+      printf("Loaded %d data from the state file %s\n", HdrTab[4], FilNam);
+   }
+
+   return(res);
+}
+   
 /*----------------------------------------------------------------------------*/
-/* Add the geometrical toolkit prototypes and source code                     */
+/* Turning the printing of debugging information on or off                    */
 /*----------------------------------------------------------------------------*/
 
-static void WriteUserToolkitSource(char *src, char *TlkSrc)
+void GmlDebugOn(size_t GmlIdx)
 {
-   if(!TlkSrc)
-      return;
+   GETGMLPTR(gml, GmlIdx);
+   gml->DbgFlg = 1;
+}
 
-   strcat(src, "// USER'S TOOLKIT\n");
-   strcat(src, TlkSrc);
-   strcat(src, "\n");
+void GmlDebugOff(size_t GmlIdx)
+{
+   GETGMLPTR(gml, GmlIdx);
+   gml->DbgFlg = 0;
 }
 
+
 /*----------------------------------------------------------------------------*/
-/* Add the user's parameters structure definition to the source code          */
+/* Select the padded or packed storage of the next vectors and matrices       */
 /*----------------------------------------------------------------------------*/
 
-static void WriteUserTypedef(char *src, char *ParSrc)
+void GmlSetVectorLayout(size_t GmlIdx, int layout)
 {
-   strcat(src, "// USER'S ARGUMENTS STRUCTURE\n");
-   strcat(src, ParSrc);
-   strcat(src, "\n");
+   GETGMLPTR(gml, GmlIdx);
+   gml->VecLay = (layout == GmlPacked) ? GmlPacked : GmlPadded;
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Write the procedure name and typedef with all arguments types and names    */
+/* Select float4 or double4 vertex coordinates before allocating them         */
 /*----------------------------------------------------------------------------*/
 
-static void WriteProcedureHeader(char *src, char *PrcNam, int MshTyp,
-                                 int NmbArg, ArgSct *ArgTab)
+int GmlSetVertexType(size_t GmlIdx, int typ)
 {
-   int      i;
-   char     str[ GmlMaxStrSiz ];
-   ArgSct   *arg;
-
-   strcat(src, "// KERNEL HEADER\n");
-   sprintf(str, "__kernel void %s(", PrcNam);
-   strcat(src, str);
-
-   for(i=0;i<NmbArg;i++)
-   {
-      arg = &ArgTab[i];
+   GETGMLPTR(gml, GmlIdx);
 
-      sprintf(str,  "\n   __global %s ", OclTypStr[ arg->ItmTyp ]);
-      strcat(src, str);
+   if( (typ != GmlFlt4) && (typ != GmlDbl4) )
+      return(0);
 
-      if(arg->NmbItm <= 1)
-         sprintf(str, "*%sTab,", arg->nam);
-      else
-         sprintf(str, "(*%sTab)[%d],", arg->nam, arg->NmbItm);
+   // The coordinates' type cannot be changed once the vertices are allocated
+   if(gml->TypIdx[ GmlVertices ])
+      return(0);
 
-      strcat(src, str);
+   if( (typ == GmlDbl4) && !gml->DblExt )
+   {
+      puts("Double precision coordinates require the cl_khr_fp64 extension.");
+      return(0);
    }
 
-   strcat(src, "\n   __global GmlParSct *GmlPar,");
-   strcat(src, "\n   const    int2       count )\n{\n");
+   gml->CrdTyp = typ;
+
+   return(1);
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Write definition of automatic local variables                              */
+/* Select the host hash tables or the device sort to build the next links     */
 /*----------------------------------------------------------------------------*/
 
-static void WriteKernelVariables(char *src, int MshTyp,
-                                 int NmbArg, ArgSct *ArgTab)
+int GmlSetTopologyBuilder(size_t GmlIdx, int bld)
 {
-   int      i;
-   char     str[ GmlMaxStrSiz ];
-   ArgSct   *arg, *LnkArg, *CptArg;
-
-   strcat(src, "// KERNEL VARIABLES DEFINITION\n");
-
-   for(i=0;i<NmbArg;i++)
-   {
-      arg = &ArgTab[i];
-
-      if(arg->FlgTab & GmlManual)
-         continue;
-
-      LnkArg = (arg->LnkIdx != -1) ? &ArgTab[ arg->LnkIdx ] : NULL;
-      CptArg = (arg->CntIdx != -1) ? &ArgTab[ arg->CntIdx ] : NULL;
-
-      if(LnkArg && LnkArg->MaxDeg > 1)
-      {
-         if(arg->NmbItm > 1)
-            sprintf( str,  "   %s %s[%d][%d];\n", OclTypStr[ arg->ItmTyp ],
-                     arg->nam, LnkArg->MaxDeg, arg->NmbItm );
-         else
-            sprintf( str,  "   %s %s[%d];\n", OclTypStr[ arg->ItmTyp ],
-                     arg->nam, LnkArg->MaxDeg );
-      }
-      else
-      {
-         if(arg->NmbItm > 1)
-            sprintf( str,  "   %s %s[%d];\n", OclTypStr[ arg->ItmTyp ],
-                     arg->nam, arg->NmbItm );
-         else
-            sprintf(str,  "   %s %s;\n", OclTypStr[ arg->ItmTyp ], arg->nam);
-      }
-
-      strcat(src, str);
+   GETGMLPTR(gml, GmlIdx);
 
-      if(CptArg)
-      {
-         sprintf(str,  "   %s %sDeg;\n", OclTypStr[ CptArg->ItmTyp ], arg->nam);
-         strcat(src, str);
-         sprintf(str,  "   %s %sNul;\n", OclTypStr[ arg->ItmTyp ], arg->nam);
-         strcat(src, str);
-         sprintf(str,  "   #define   %sDegMax %d\n", arg->nam, LnkArg->MaxDeg);
-         strcat(src, str);
-      }
-      else if(LnkArg && LnkArg->LnkDir == 0)
-      {
-         sprintf(str,  "   %s %sNul;\n", OclTypStr[ arg->ItmTyp ], arg->nam);
-         strcat(src, str);
-      }
+   if( (bld != GmlHostTopology) && (bld != GmlDeviceTopology) )
+      return(0);
 
-      // If ball or shell voyeurs are required, define a vector char
-      if(arg->FlgTab & GmlVoyeurs)
-      {
-         sprintf( str,  "   char      %s[%d];\n",
-                  arg->VoyNam, arg->NmbItm * arg->ItmLen );
-         strcat(src, str);
-      }
-   }
+   gml->TpoBld = bld;
+
+   return(1);
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Define, read and compute the main kernel loop counter                      */
+/* Check the 64-bit floating point extension GPU's capacity                   */
 /*----------------------------------------------------------------------------*/
 
-static void WriteKernelCounters(char *src, int MshTyp)
+int GmlCheckFP64(size_t GmlIdx)
 {
-   char str[ GmlMaxStrSiz ];
-
-   strcat (src, "// KERNEL COUNTERS\n");
-   strcat (src, "   int       cnt = get_global_id(0);\n");
-   sprintf(str, "   int       %sIdx = cnt + count.s1;\n\n", BalTypStr[ MshTyp ]);
-   strcat (src, str);
-   strcat (src, "   if(cnt >= count.s0)\n      return;\n\n");
+   GETGMLPTR(gml, GmlIdx);
+   return(gml->DblExt);
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Write the memory reading from the global structure to the local variables  */
+/* Exctract the list of unique volume edges from any kind of elements and     */
+/* store the elements' downlinks to them. Existing edges keep their index and */
+/* reference while the new ones are numbered in the elements' order: each     */
+/* element counts the edges it owns, a prefix sum gives their positions and   */
+/* all lines are written directly in the tables before a single upload        */
 /*----------------------------------------------------------------------------*/
 
-static void WriteKernelMemoryReads( char *src, int MshTyp,
-                                    int NmbArg, ArgSct *ArgTab)
+int GmlExtractEdges(size_t GmlIdx)
 {
-   int      i, j, k, l, siz;
-   char     str   [ 15*GmlMaxStrSiz ], ArgTd1[ 2*GmlMaxStrSiz ], ArgTd2[ GmlMaxStrSiz ];
-   char     LnkTd1[ GmlMaxStrSiz ], LnkTd2[ GmlMaxStrSiz ], LnkNam[ GmlMaxStrSiz ];
-   char     CptNam[ GmlMaxStrSiz ], DegTst[ 2*GmlMaxStrSiz ], DegNul[ 2*GmlMaxStrSiz ];
-   char     BalSft[ GmlMaxStrSiz ];
-   ArgSct   *arg, *LnkArg, *CptArg;
+   int         i, j, p, typ, pos, msk, EdgIdx, RefIdx, NmbItm, EleLen, EdgLen;
+   int         NmbEdg = 0, OldNmbEdg = 0, NmbEle = 0, EleBeg[ GmlMaxEleTyp ];
+   int         ItmTab[3], *EleNod, *nod, *EdgNod, *RefTab, *PosTab, *LnkTab;
+   int         *OldNod = NULL, *OldRef = NULL, LnkIdx[ GmlMaxEleTyp ] = {0};
+   short       *OwnTab;
+   char        LnkNam[ GmlMaxStrSiz ];
+   size_t      HshKey, idx, NmbKey, KeyBeg, *KeyTab;
+   BucSct      *buc, *KeyBuc;
+   DatSct      *dat, *lnk;
+   HshTabSct   EdgHsh;
 
-   strcat (src, "// KERNEL MEMORY READINGS\n");
+   GETGMLPTR(gml, GmlIdx);
 
-   for(i=0;i<NmbArg;i++)
+   // Count the number of inner and surface edges
+   // and give each element kind a range of owner lines
+   for(typ=GmlEdges; typ<GmlMaxEleTyp; typ++)
    {
-      arg = &ArgTab[i];
+      EleBeg[ typ ] = NmbEle;
 
-      if(!(arg->FlgTab & GmlReadMode) || (arg->FlgTab & GmlManual))
+      if(!gml->TypIdx[ typ ])
          continue;
 
-      LnkArg = (arg->LnkIdx != -1) ? &ArgTab[ arg->LnkIdx ] : NULL;
-      CptArg = (arg->CntIdx != -1) ? &ArgTab[ arg->CntIdx ] : NULL;
+      dat = gml->dat[ gml->TypIdx[ typ ] ];
 
-      for(j=0;j<arg->NmbItm;j++)
+      if(!GetHostLines(gml, gml->TypIdx[ typ ], 0, dat->NmbLin - 1))
+         return(0);
+
+      NmbEdg += dat->NmbLin * ((typ == GmlEdges) ? 1 : ItmNmbEdg[ typ ]);
+
+      if(typ != GmlEdges)
+         NmbEle += dat->NmbLin;
+   }
+
+   // Setup a hash table
+   if(!NewHsh(&EdgHsh, GmlEdges, NmbEdg))
+   {
+      FreeHsh(&EdgHsh);
+      return(0);
+   }
+
+   if(gml->DbgFlg)
+      printf(  "Hash table: buckets=%d, stored items=%d, partitions=%d\n",
+               (int)EdgHsh.TabSiz, EdgHsh.DatLen, EdgHsh.NmbPrt);
+
+   // Existing edges are hashed first so that they own their entity
+   // and keep their index, their nodes and references are saved
+   if(gml->TypIdx[ GmlEdges ])
+   {
+      dat = gml->dat[ gml->TypIdx[ GmlEdges ] ];
+      OldNmbEdg = dat->NmbLin;
+      EdgLen = dat->ItmLen;
+      OldNod = malloc((size_t)OldNmbEdg * EdgLen * sizeof(int));
+      OldRef = malloc((size_t)OldNmbEdg * sizeof(int));
+
+      if( !OldNod || !OldRef || !gml->RefIdx[ GmlEdges ]
+      ||  !GetHostLines(gml, gml->RefIdx[ GmlEdges ], 0, OldNmbEdg - 1) )
       {
-         if(CptArg)
+         if(OldNod)
+            free(OldNod);
+
+         if(OldRef)
+            free(OldRef);
+
+         FreeHsh(&EdgHsh);
+         return(0);
+      }
+
+      memcpy(OldNod, dat->CpuMem, (size_t)OldNmbEdg * EdgLen * sizeof(int));
+      memcpy(OldRef, gml->dat[ gml->RefIdx[ GmlEdges ] ]->CpuMem, (size_t)OldNmbEdg * sizeof(int));
+
+      for(i=0;i<OldNmbEdg;i++)
+      {
+         GetItmNod(&OldNod[ (size_t)i * EdgLen ], GmlEdges, GmlEdges, 0, ItmTab);
+         HshKey = CalHshKey(&EdgHsh, ItmTab);
+
+         if( !GetHsh(&EdgHsh, HshKey, i, 0, ItmTab, NULL, NULL, NULL)
+         &&  !AddHsh(&EdgHsh, HshKey, GmlEdges, i, 0, ItmTab) )
          {
-            sprintf(CptNam,  "%sDeg", arg->nam);
-            sprintf(str,  "   %s = %s;\n", CptNam, CptArg->nam);
-            strcat(src, str);
-            sprintf(str,  "   %sNul = %s;\n", arg->nam, OclNulVec[ arg->ItmTyp ]);
-            strcat(src, str);
-            strcat(src, "\n");
+            free(OldNod);
+            free(OldRef);
+            FreeHsh(&EdgHsh);
+            return(0);
          }
-         else if(LnkArg && LnkArg->LnkDir == 0)
+      }
+   }
+
+   // Compute the keys of all elements' edges once and in parallel,
+   // then each thread adds the new edges belonging to its partition
+   NmbKey = (size_t)NmbEdg - OldNmbEdg;
+   KeyTab = malloc(MAX(NmbKey, 1) * sizeof(size_t));
+   KeyBuc = malloc(MAX(NmbKey, 1) * sizeof(BucSct));
+
+   for(typ=GmlEdges+1, KeyBeg=0; KeyTab && KeyBuc && (typ<GmlMaxEleTyp); typ++)
+   {
+      if(!gml->TypIdx[ typ ])
+         continue;
+
+      dat = gml->dat[ gml->TypIdx[ typ ] ];
+      EleNod = (int *)dat->CpuMem;
+      EleLen = dat->ItmLen;
+      NmbItm = ItmNmbEdg[ typ ];
+
+#ifdef _OPENMP
+#pragma omp parallel for private(j, idx, nod) if(dat->NmbLin >= MINPARLIN)
+#endif
+      for(i=0;i<dat->NmbLin;i++)
+      {
+         nod = &EleNod[ (size_t)i * EleLen ];
+
+         for(j=0;j<NmbItm;j++)
          {
-            sprintf(str,  "   %sNul = %s;\n", arg->nam, OclNulVec[ arg->ItmTyp ]);
-            strcat(src, str);
+            idx = KeyBeg + (size_t)i * NmbItm + j;
+            GetItmNod(nod, typ, EdgHsh.HshTyp, j, KeyBuc[ idx ].nod);
+            KeyBuc[ idx ].EleTyp = (char)typ;
+            KeyBuc[ idx ].ItmIdx = (char)j;
+            KeyBuc[ idx ].EleIdx = i;
+            KeyTab[ idx ] = CalHshKey(&EdgHsh, KeyBuc[ idx ].nod);
          }
+      }
 
-         if(arg->NmbItm > 1)
-            sprintf(ArgTd1, "[%d]", j);
-         else
-            ArgTd1[0] = '\0';
+      KeyBeg += (size_t)dat->NmbLin * NmbItm;
+   }
 
-         if(LnkArg && LnkArg->NmbItm * LnkArg->ItmLen > 1)
-            siz = LnkArg->NmbItm * LnkArg->ItmLen;
-         else
-            siz = 1;
+   if(!KeyTab || !KeyBuc || !FilHsh(&EdgHsh, NmbKey, KeyTab, KeyBuc, 1))
+   {
+      if(KeyTab)
+         free(KeyTab);
 
-         for(k=0;k<siz;k++)
-         {
-            if(siz > 1)
-               sprintf(ArgTd2, "[%d]", k);
-            else
-               ArgTd2[0] = '\0';
+      if(KeyBuc)
+         free(KeyBuc);
 
-            if(LnkArg && LnkArg->NmbItm > 1)
-               sprintf(LnkTd1, "[%d]", k/16);
-            else
-               LnkTd1[0] = '\0';
+      if(OldNod)
+         free(OldNod);
 
-            if(LnkArg && LnkArg->ItmLen > 1)
-               sprintf(LnkTd2, ".s%c", OclHexNmb[ k & 15 ]);
-            else
-               LnkTd2[0] = '\0';
+      if(OldRef)
+         free(OldRef);
 
-            if(LnkArg)
-               sprintf(LnkNam, "%s", LnkArg->nam);
-            else if(arg->LnkDir == 1)
-               sprintf(LnkNam, "cnt");
-            else
-               sprintf(LnkNam, "cnt + count.s1");
+      FreeHsh(&EdgHsh);
+      return(0);
+   }
 
-            if(CptArg)
-            {
-               sprintf(DegTst, "(%s >= %d) ?", CptNam, k + 1);
-               sprintf(DegNul, ": %sNul", arg->nam);
-            }
-            else
-            {
-               if(LnkArg && LnkArg->LnkDir == 0)
-               {
-                  sprintf(DegTst, "%s%s ?", LnkArg->nam, LnkTd2);
-                  sprintf(DegNul, ": %sNul", arg->nam);
-               }
-               else
-                  DegNul[0] = DegTst[0] = '\0';
-            }
+   free(KeyTab);
+   free(KeyBuc);
+   SumHsh(&EdgHsh);
 
-            if(arg->LnkDir == 1)
-               sprintf(BalSft, ">> 4");
-            else
-               BalSft[0] = '\0';
+   if(gml->DbgFlg)
+      printf(  "Hashed %d entities: occupency=%d%%, mean probes=%g, max probes=%d\n",
+               (int)EdgHsh.NmbDat, (int)((100 * EdgHsh.NmbDat) / EdgHsh.TabSiz),
+               (double)EdgHsh.NmbPrb / (double)EdgHsh.NmbDat, (int)EdgHsh.MaxPrb );
 
-            // If voyeurs need to bet set, read the ball int vector, perform
-            // a logical AND to get the four rightmost bits that store the voyeur
-            // indices and convert the result to a vector char. Finaly perform
-            // a 4 bits right shift to the ball data to get the right idices
-            if(arg->FlgTab & GmlVoyeurs)
-            {
-               sprintf( str, "   %s%s = %sTab[ %s ]%s;\n",
-                        arg->nam, ArgTd1, arg->nam, LnkNam, ArgTd1 );
-               strcat(src, str);
+   PosTab = malloc(((size_t)NmbEle + 1) * sizeof(int));
+   OwnTab = malloc(((size_t)NmbEle + 1) * sizeof(short));
 
-               for(l=0;l<arg->ItmLen;l++)
-               {
-                  sprintf( str, "   %s[%d] = %s%s.s%c & 7;\n",
-                           arg->VoyNam, j*arg->ItmLen + l,
-                           arg->nam, ArgTd1, OclHexNmb[l] );
-                  strcat(src, str);
-               }
+   if(!PosTab || !OwnTab)
+   {
+      if(PosTab)
+         free(PosTab);
 
-               sprintf( str, "   %s%s = %s%s %s;\n",
-                        arg->nam, ArgTd1, arg->nam, ArgTd1, BalSft);
-               strcat(src, str);
-            }
-            else
-            {
-               // Otherwise, read the ball data and perform the right shift on the fly
-               sprintf( str, "   %s%s%s = %s %sTab[ %s%s%s ]%s %s %s;\n",
-                        arg->nam, ArgTd2, ArgTd1, DegTst, arg->nam,
-                        LnkNam, LnkTd1, LnkTd2, ArgTd1, BalSft, DegNul );
+      if(OwnTab)
+         free(OwnTab);
 
-               strcat(src, str);
+      if(OldNod)
+         free(OldNod);
+
+      if(OldRef)
+         free(OldRef);
+
+      FreeHsh(&EdgHsh);
+      return(0);
+   }
+
+   // Each element counts the edges it owns and flags them
+   for(typ=GmlEdges+1; typ<GmlMaxEleTyp; typ++)
+   {
+      if(!gml->TypIdx[ typ ])
+         continue;
+
+      dat = gml->dat[ gml->TypIdx[ typ ] ];
+      EleNod = (int *)dat->CpuMem;
+      EleLen = dat->ItmLen;
+      NmbItm = ItmNmbEdg[ typ ];
+
+#ifdef _OPENMP
+#pragma omp parallel for private(j, nod, ItmTab, HshKey, buc) if(dat->NmbLin >= MINPARLIN)
+#endif
+      for(i=0;i<dat->NmbLin;i++)
+      {
+         nod = &EleNod[ (size_t)i * EleLen ];
+         PosTab[ EleBeg[ typ ] + i ] = OwnTab[ EleBeg[ typ ] + i ] = 0;
+
+         for(j=0;j<NmbItm;j++)
+         {
+            GetItmNod(nod, typ, EdgHsh.HshTyp, j, ItmTab);
+            HshKey = CalHshKey(&EdgHsh, ItmTab);
+            buc = GetHshBuc(&EdgHsh, HshKey, ItmTab);
+
+            if( (buc->EleTyp == typ) && (buc->EleIdx == i) && (buc->ItmIdx == j) )
+            {
+               PosTab[ EleBeg[ typ ] + i ]++;
+               OwnTab[ EleBeg[ typ ] + i ] |= (short)(1 << j);
             }
          }
       }
+   }
 
-      strcat(src, "\n");
+   // The new edges follow the existing ones in the elements' order
+   for(i=0, pos=OldNmbEdg; i<NmbEle; i++)
+   {
+      p = PosTab[i];
+      PosTab[i] = pos;
+      pos += p;
    }
-}
 
+   NmbEdg = pos;
 
-/*----------------------------------------------------------------------------*/
-/* Pour the user's kernel code as it is                                       */
-/*----------------------------------------------------------------------------*/
+   // Replace the edge table with a larger one, along with any link
+   // pointing to or from the old edges, and copy back the existing edges
+   if(gml->TypIdx[ GmlEdges ])
+   {
+      RefIdx = gml->RefIdx[ GmlEdges ];
+      GmlFreeData(GmlIdx, gml->TypIdx[ GmlEdges ]);
+      GmlFreeData(GmlIdx, RefIdx);
 
-static void WriteUserKernel(char *src, char *KrnSrc)
-{
-   strcat(src, "// USER'S KERNEL CODE\n");
-   strcat                  (src, KrnSrc);
-}
+      // The elements' downlinks keep their size and are refilled below
+      for(typ=GmlVertices; typ<GmlMaxEleTyp; typ++)
+      {
+         FreeLnkDat(gml, GmlEdges, typ);
 
+         if(typ < GmlEdges)
+            FreeLnkDat(gml, typ, GmlEdges);
+      }
+   }
 
-/*----------------------------------------------------------------------------*/
-/* Write the final storage of requested variables from local to global struct */
-/*----------------------------------------------------------------------------*/
+   if(!(EdgIdx = GmlNewMeshData(GmlIdx, GmlEdges, NmbEdg)))
+   {
+      free(PosTab);
+      free(OwnTab);
 
-static void WriteKernelMemoryWrites(char *src, int MshTyp,
-                                    int NmbArg, ArgSct *ArgTab)
-{
-   int      i, c;
-   char     str[ GmlMaxStrSiz ];
-   ArgSct   *arg;
+      if(OldNod)
+         free(OldNod);
 
-   strcat(src, "\n");
-   strcat(src, "// KERNEL MEMORY WRITINGS\n");
+      if(OldRef)
+         free(OldRef);
 
-   for(i=0;i<NmbArg;i++)
+      FreeHsh(&EdgHsh);
+      return(0);
+   }
+
+   dat = gml->dat[ EdgIdx ];
+   EdgNod = (int *)dat->CpuMem;
+   EdgLen = dat->ItmLen;
+   RefTab = (int *)gml->dat[ gml->RefIdx[ GmlEdges ] ]->CpuMem;
+
+   for(i=0;i<OldNmbEdg;i++)
    {
-      arg = &ArgTab[i];
+      EdgNod[ (size_t)i * EdgLen     ] = OldNod[ (size_t)i * EdgLen     ];
+      EdgNod[ (size_t)i * EdgLen + 1 ] = OldNod[ (size_t)i * EdgLen + 1 ];
+      RefTab[i] = OldRef[i];
+   }
 
-      if(!(arg->FlgTab & GmlWriteMode) || (arg->FlgTab & GmlManual))
+   // Each owner writes its edges at their positions and stores their
+   // index in the hash table, that no other thread reads at this stage
+   for(typ=GmlEdges+1; typ<GmlMaxEleTyp; typ++)
+   {
+      if(!gml->TypIdx[ typ ])
          continue;
 
-      if(arg->NmbItm == 1)
+      dat = gml->dat[ gml->TypIdx[ typ ] ];
+      EleNod = (int *)dat->CpuMem;
+      EleLen = dat->ItmLen;
+      NmbItm = ItmNmbEdg[ typ ];
+
+#ifdef _OPENMP
+#pragma omp parallel for private(j, pos, msk, nod, ItmTab, HshKey, buc) if(dat->NmbLin >= MINPARLIN)
+#endif
+      for(i=0;i<dat->NmbLin;i++)
       {
-         sprintf( str, "   %sTab[ cnt + count.s1 ] = %s;\n",
-                  arg->nam, arg->nam );
-         strcat(src, str);
+         nod = &EleNod[ (size_t)i * EleLen ];
+         pos = PosTab[ EleBeg[ typ ] + i ];
+         msk = OwnTab[ EleBeg[ typ ] + i ];
+
+         for(j=0;j<NmbItm;j++)
+         {
+            if(!(msk & (1 << j)))
+               continue;
+
+            GetItmNod(nod, typ, EdgHsh.HshTyp, j, ItmTab);
+            HshKey = CalHshKey(&EdgHsh, ItmTab);
+            buc = GetHshBuc(&EdgHsh, HshKey, ItmTab);
+            buc->EleTyp = GmlEdges;
+            buc->EleIdx = pos;
+
+            EdgNod[ (size_t)pos * EdgLen     ] = ItmTab[0];
+            EdgNod[ (size_t)pos * EdgLen + 1 ] = ItmTab[1];
+            RefTab[ pos ] = 0;
+            pos++;
+         }
       }
-      else
+   }
+
+   UploadData(gml, EdgIdx);
+   UploadData(gml, gml->RefIdx[ GmlEdges ]);
+
+   // All buckets now store their edge index: fill the elements'
+   // downlinks, reusing the existing tables as they keep their size
+   for(typ=GmlEdges+1; typ<GmlMaxEleTyp; typ++)
+   {
+      if(!gml->TypIdx[ typ ])
+         continue;
+
+      if(!(LnkIdx[ typ ] = gml->LnkMat[ typ ][ GmlEdges ]))
       {
-         for(c=0;c<arg->NmbItm;c++)
+         sprintf(LnkNam, "%s%sLnk", BalTypStr[ typ ], BalTypStr[ GmlEdges ]);
+
+         if(!(LnkIdx[ typ ] = NewDwnLnk(gml, typ, GmlEdges, LnkNam)))
+         {
+            NmbEdg = 0;
+            break;
+         }
+      }
+
+      dat = gml->dat[ gml->TypIdx[ typ ] ];
+      lnk = gml->dat[ LnkIdx[ typ ] ];
+      EleNod = (int *)dat->CpuMem;
+      EleLen = dat->ItmLen;
+      NmbItm = ItmNmbEdg[ typ ];
+
+#ifdef _OPENMP
+#pragma omp parallel for private(j, nod, ItmTab, HshKey, LnkTab) if(dat->NmbLin >= MINPARLIN)
+#endif
+      for(i=0;i<dat->NmbLin;i++)
+      {
+         nod = &EleNod[ (size_t)i * EleLen ];
+         LnkTab = (int *)lnk->CpuMem + (size_t)i * lnk->ItmLen;
+
+         for(j=0;j<NmbItm;j++)
          {
-            sprintf( str, "   %sTab[ cnt + count.s1 ][%d] = %s[%d];\n",
-                     arg->nam, c, arg->nam, c );
-            strcat(src, str);
+            GetItmNod(nod, typ, EdgHsh.HshTyp, j, ItmTab);
+            HshKey = CalHshKey(&EdgHsh, ItmTab);
+            LnkTab[j] = GetHshBuc(&EdgHsh, HshKey, ItmTab)->EleIdx;
          }
+
+         for(j=NmbItm;j<lnk->ItmLen;j++)
+            LnkTab[j] = 0;
       }
+
+      UploadData(gml, LnkIdx[ typ ]);
    }
 
-   strcat(src, "}\n");
-}
+   free(PosTab);
+   free(OwnTab);
 
+   if(OldNod)
+      free(OldNod);
 
-/*----------------------------------------------------------------------------*/
-/* Spread an arbitrary sized vector across a number of hardware smaller ones  */
-/*----------------------------------------------------------------------------*/
+   if(OldRef)
+      free(OldRef);
 
-static void GetCntVec(int siz, int *cnt, int *vec, int *typ)
-{
-   int p;
+   FreeHsh(&EdgHsh);
 
-   p = (int)ceil(log2(siz));
-   p = MIN(p, VECPOWMAX);
+   if(gml->DbgFlg && NmbEdg)
+      printf("Hashed, setup and transfered %d edges to the GMlib.\n", NmbEdg);
 
-   if(p > VECPOWOCL)
-   {
-      *cnt = 1 << (p - VECPOWOCL);
-      *vec = 1 << VECPOWOCL;
-      *typ = OclVecPow[ VECPOWOCL ];
-   }
-   else
-   {
-      *cnt = 1;
-      *vec = 1 << p;
-      *typ = OclVecPow[p];
-   }
+   return(NmbEdg);
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Read and compile an OpenCL source code                                     */
+/* Extract the unique faces of one kind along with their shells and the       */
+/* elements' downlinks in a single hashing pass: existing faces are hashed    */
+/* first and keep their index, the first element storing a new face owns it,  */
+/* a prefix sum of the owned faces gives their positions and each owner       */
+/* writes its face, its shells' line and the sharing elements' downlinks      */
 /*----------------------------------------------------------------------------*/
 
-static int NewOclKrn(GmlSct *gml, char *KernelSource, char *PrcNam)
+static int ExtFacTyp(GmlSct *gml, int FacTyp)
 {
-   char     *buffer, *StrTab[1], OptStr[200] = "\0";
-   int      err, res, idx = ++gml->NmbKrn;
-   KrnSct   *krn = &gml->krn[ idx ];
-   size_t   len, LenTab[1], GrpSiz, RetSiz = 0;
-
-   if(idx > GmlMaxKrn)
-      return(0);
-
-   StrTab[0] = KernelSource;
-   LenTab[0] = strlen(KernelSource) - 1;
-
-   // Compile source code
-   krn->program = clCreateProgramWithSource( gml->context, 1, (const char **)StrTab,
-                                             (const size_t *)LenTab, &err );
-   if(!krn->program)
-   {
-      printf("Compiling the kernel %s failed at step 1 with error %d\n", PrcNam, err);
-      return(0);
-   }
-
-   sprintf(OptStr, "-cl-single-precision-constant -cl-mad-enable %s", gml->cflags);
+   int         i, j, k, l, p, typ, pos, cpt, msk, wid, NmbItm, EleLen, FacLen;
+   int         NmbFac = 0, OldNmbFac = 0, NmbEle = 0, RefIdx, FacIdx;
+   int         EleBeg[ GmlMaxEleTyp ], TypItm[ GmlMaxEleTyp ], ItmFac[ GmlMaxEleTyp ][6];
+   int         ShlIdx[ GmlMaxEleTyp ] = {0}, LnkIdx[ GmlMaxEleTyp ] = {0};
+   int         FacNod[4], IdxLst[ MAXFACELE ], TypLst[ MAXFACELE ];
+   int         *EleNod, *nod, *FacTab, *RefTab, *DegTab, *BalTab, *LnkTab;
+   int         *PosTab = NULL, *OldNod = NULL, *OldRef = NULL;
+   char        VoyLst[ MAXFACELE ], BalNam[ GmlMaxStrSiz ], *VoyTab;
+   short       *OwnTab = NULL;
+   size_t      HshKey, idx, KeyBeg, *KeyTab = NULL;
+   BucSct      *buc, *KeyBuc = NULL;
+   DatSct      *dat, *bal;
+   HshTabSct   FacHsh;
+
+   // The face kind itself and the volume elements storing such faces take
+   // part, the k-th face of this kind being the element's ItmFac-th face
+   for(typ=GmlVertices; typ<GmlMaxEleTyp; typ++)
+   {
+      EleBeg[ typ ] = NmbEle;
+      TypItm[ typ ] = 0;
+
+      if( !gml->TypIdx[ typ ] || ((typ != FacTyp) && (typ < GmlTetrahedra)) )
+         continue;
 
-   res = clBuildProgram(krn->program, 0, NULL, OptStr, NULL, NULL);
+      for(j=k=0;j<ItmNmbFac[ typ ];j++)
+         if(ItmFacDeg[ typ ][j] == EleNmbNod[ FacTyp ])
+            ItmFac[ typ ][ k++ ] = j;
 
-   if(res != CL_SUCCESS)
-   {
-      clGetProgramBuildInfo(  krn->program, gml->device_id[ gml->CurDev ],
-                              CL_PROGRAM_BUILD_LOG, 0, NULL, &len);
+      if(!(TypItm[ typ ] = k))
+         continue;
 
-      if(!(buffer = malloc(len)))
-         return(0);
+      dat = gml->dat[ gml->TypIdx[ typ ] ];
 
-      clGetProgramBuildInfo(  krn->program, gml->device_id[ gml->CurDev ],
-                              CL_PROGRAM_BUILD_LOG, len, buffer, &len);
+      if(!GetHostLines(gml, gml->TypIdx[ typ ], 0, dat->NmbLin - 1))
+         return(-1);
 
-      printf("Compiling the kernel %s failed at step 2 with error %d\n", PrcNam, res);
-      printf("%s\n", buffer);
-      free(buffer);
-      return(0);
+      NmbFac += dat->NmbLin * k;
+      NmbEle += dat->NmbLin;
    }
 
-   krn->kernel = clCreateKernel(krn->program, PrcNam, &err);
+   // Existing faces are left untouched if there are no volume faces
+   if(gml->TypIdx[ FacTyp ])
+      OldNmbFac = gml->dat[ gml->TypIdx[ FacTyp ] ]->NmbLin;
 
-   if( !krn->kernel || (err != CL_SUCCESS) )
+   if(NmbFac == OldNmbFac)
+      return(OldNmbFac);
+
+   if(!NewHsh(&FacHsh, FacTyp, NmbFac))
    {
-      printf("Compiling the kernel %s failed at step 3 with error %d\n", PrcNam, err);
-      return(0);
+      FreeHsh(&FacHsh);
+      return(-1);
    }
 
-   krn->idx = idx;
-
    if(gml->DbgFlg)
-   {
-      puts(sep);
-      res = clGetProgramInfo( krn->program, CL_PROGRAM_BINARY_SIZES,
-                              sizeof(size_t), &len, NULL );
-
-      if(res == CL_SUCCESS )
-         printf("binary executable of kernel %s: %zd bytes\n", PrcNam, len);
-      else
-         printf("could not get the size of kernel %s executable\n", PrcNam);
-   }
+      printf(  "%s hash table: buckets=%d, stored items=%d, partitions=%d\n",
+               BalTypStr[ FacTyp ], (int)FacHsh.TabSiz, FacHsh.DatLen, FacHsh.NmbPrt );
 
-   // Get the maximum GPU workgroup size
-   res = clGetKernelWorkGroupInfo(  krn->kernel, gml->device_id[ gml->CurDev ],
-                                    CL_KERNEL_WORK_GROUP_SIZE, sizeof(size_t),
-                                    &GrpSiz, &RetSiz );
+   // Compute the keys of all faces once and in parallel, then each thread
+   // adds the keys belonging to its partition: the existing faces come first
+   // and the elements sharing a face are stored in increasing type and index order
+   KeyTab = malloc(MAX(NmbFac, 1) * sizeof(size_t));
+   KeyBuc = malloc(MAX(NmbFac, 1) * sizeof(BucSct));
 
-   if(res != CL_SUCCESS )
+   for(typ=FacTyp, KeyBeg=0; KeyTab && KeyBuc && (typ<GmlMaxEleTyp); typ++)
    {
-      printf("Geting the kernel workgroup size failed with error %d\n", res);
-      return(-5);
-   }
-
-   krn->OptSiz = 0;
-   krn->NxtSiz = -1;
-   krn->MaxSiz = GrpSiz;
-   krn->EvtBlk = DEFEVTBLK;
-   krn->NmbEvt = 0;
-   krn->IniFlg = 0;
-   krn->EvtTab = malloc(krn->EvtBlk * sizeof(cl_event));
-   assert(krn->EvtTab);
-
-   return(idx);
-}
-
-
-/*----------------------------------------------------------------------------*/
-/* Select arguments and launch an OpenCL kernel                               */
-/*----------------------------------------------------------------------------*/
+      if(!(NmbItm = TypItm[ typ ]))
+         continue;
 
-int GmlLaunchKernel(size_t GmlIdx, int idx)
-{
-   GETGMLPTR(gml, GmlIdx);
-   int      res;
-   KrnSct   *krn = &gml->krn[ idx ];
+      dat = gml->dat[ gml->TypIdx[ typ ] ];
+      EleNod = (int *)dat->CpuMem;
+      EleLen = dat->ItmLen;
 
-   if( (idx < 1) || (idx > gml->NmbKrn) || !krn->kernel )
-      return(-1);
+#ifdef _OPENMP
+#pragma omp parallel for private(k, idx, nod) if(dat->NmbLin >= MINPARLIN)
+#endif
+      for(i=0;i<dat->NmbLin;i++)
+      {
+         nod = &EleNod[ (size_t)i * EleLen ];
 
-   res = RunOclKrn(gml, krn);
+         for(k=0;k<NmbItm;k++)
+         {
+            idx = KeyBeg + (size_t)i * NmbItm + k;
+            GetItmNod(nod, typ, FacTyp, ItmFac[ typ ][k], KeyBuc[ idx ].nod);
+            KeyBuc[ idx ].EleTyp = (char)typ;
+            KeyBuc[ idx ].ItmIdx = (char)k;
+            KeyBuc[ idx ].EleIdx = i;
+            KeyTab[ idx ] = CalHshKey(&FacHsh, KeyBuc[ idx ].nod);
+         }
+      }
 
-   if(res != 1)
-      return(res);
+      KeyBeg += (size_t)dat->NmbLin * NmbItm;
+   }
 
-   if(krn->HghIdx)
-      res = RunOclKrn(gml, &gml->krn[ krn->HghIdx ]);
+   if(!KeyTab || !KeyBuc || !FilHsh(&FacHsh, NmbFac, KeyTab, KeyBuc, 0))
+   {
+      NmbFac = -1;
+      goto FreTab;
+   }
 
-   return(res);
-}
+   free(KeyTab);
+   free(KeyBuc);
+   KeyTab = NULL;
+   KeyBuc = NULL;
+   SumHsh(&FacHsh);
 
+   if(gml->DbgFlg)
+      printf(  "Hashed %d %s: occupency=%d%%, mean probes=%g, max probes=%d\n",
+               (int)FacHsh.NmbDat, BalTypStr[ FacTyp ],
+               (int)((100 * FacHsh.NmbDat) / FacHsh.TabSiz),
+               (double)FacHsh.NmbPrb / (double)FacHsh.NmbDat, (int)FacHsh.MaxPrb );
 
-/*----------------------------------------------------------------------------*/
-/* Select arguments and launch an OpenCL kernel                               */
-/*----------------------------------------------------------------------------*/
+   PosTab = malloc(((size_t)NmbEle + 1) * sizeof(int));
+   OwnTab = malloc(((size_t)NmbEle + 1) * sizeof(short));
 
-static int RunOclKrn(GmlSct *gml, KrnSct *krn)
-{
-   int      i, res;
-   double   MinTim;
-   DatSct   *dat;
+   if(!PosTab || !OwnTab)
+   {
+      NmbFac = -1;
+      goto FreTab;
+   }
 
-   // The first time this kernel is called we add the arguments list
-   if(!krn->IniFlg)
+   // Each volume element counts and flags the new faces it owns
+   for(typ=GmlTetrahedra; typ<GmlMaxEleTyp; typ++)
    {
-      krn->IniFlg = 1;
+      if(!(NmbItm = TypItm[ typ ]))
+         continue;
 
-      // Loop and add user's arguments
-      for(i=0;i<krn->NmbDat;i++)
+      dat = gml->dat[ gml->TypIdx[ typ ] ];
+      EleNod = (int *)dat->CpuMem;
+      EleLen = dat->ItmLen;
+
+#ifdef _OPENMP
+#pragma omp parallel for private(k, nod, FacNod, HshKey, buc) if(dat->NmbLin >= MINPARLIN)
+#endif
+      for(i=0;i<dat->NmbLin;i++)
       {
-         dat = &gml->dat[ krn->DatTab[i] ];
+         nod = &EleNod[ (size_t)i * EleLen ];
+         PosTab[ EleBeg[ typ ] + i ] = OwnTab[ EleBeg[ typ ] + i ] = 0;
 
-         if((krn->DatTab[i] < 1) || (krn->DatTab[i] > GmlMaxDat) || !dat->GpuMem)
+         for(k=0;k<NmbItm;k++)
          {
-            printf(  "Invalid user argument %d, DatTab[i]=%d, GpuMem=%p\n",
-                     i, krn->DatTab[i], dat->GpuMem );
-            return(-1);
-         }
-
-         res = clSetKernelArg(krn->kernel, i, sizeof(cl_mem), &dat->GpuMem);
+            GetItmNod(nod, typ, FacTyp, ItmFac[ typ ][k], FacNod);
+            HshKey = CalHshKey(&FacHsh, FacNod);
+            buc = GetHshBuc(&FacHsh, HshKey, FacNod);
 
-         if(res != CL_SUCCESS)
-         {
-            printf("Adding user argument %d failed with error: %d\n", i, res);
-            return(-2);
+            if( (buc->EleTyp == typ) && (buc->EleIdx == i) && (buc->ItmIdx == k) )
+            {
+               PosTab[ EleBeg[ typ ] + i ]++;
+               OwnTab[ EleBeg[ typ ] + i ] |= (short)(1 << k);
+            }
          }
       }
+   }
 
-      res = clSetKernelArg(krn->kernel, krn->NmbDat, sizeof(cl_mem),
-                           &gml->dat[ gml->ParIdx ].GpuMem);
+   // Existing faces keep their position and own themselves
+   // unless they are duplicates
+   if(OldNmbFac)
+   {
+      dat = gml->dat[ gml->TypIdx[ FacTyp ] ];
+      EleNod = (int *)dat->CpuMem;
+      EleLen = dat->ItmLen;
 
-      if(res != CL_SUCCESS)
+      for(i=0;i<OldNmbFac;i++)
       {
-         printf("Adding the GMlib parameters argument failed with error %d\n", res);
-         return(-3);
+         GetItmNod(&EleNod[ (size_t)i * EleLen ], FacTyp, FacTyp, 0, FacNod);
+         HshKey = CalHshKey(&FacHsh, FacNod);
+         buc = GetHshBuc(&FacHsh, HshKey, FacNod);
+         PosTab[ EleBeg[ FacTyp ] + i ] = i;
+         OwnTab[ EleBeg[ FacTyp ] + i ] = (buc->EleTyp == FacTyp) && (buc->EleIdx == i);
       }
+   }
 
-      // Add a last argument with the number of loop elements
-      res = clSetKernelArg(krn->kernel, krn->NmbDat+1, sizeof(cl_int2), krn->NmbLin);
+   for(typ=GmlTetrahedra, pos=OldNmbFac; typ<GmlMaxEleTyp; typ++)
+   {
+      if(!TypItm[ typ ])
+         continue;
 
-      if(res != CL_SUCCESS)
+      for(i=EleBeg[ typ ]; i<EleBeg[ typ ] + gml->dat[ gml->TypIdx[ typ ] ]->NmbLin; i++)
       {
-         printf("Adding the kernel loop counter argument failed with error %d\n", res);
-         return(-4);
+         p = PosTab[i];
+         PosTab[i] = pos;
+         pos += p;
       }
    }
 
-   // The first 8 or 10 kernel runs are used to calibrate
-   // the run time according to the group size
-   if(!krn->OptSiz)
-   {
-      // First run: the calibration is unreliable so we use 16 as
-      // the default group size and do not take this timing into account
-      if(krn->NxtSiz == -1)
-      {
-         krn->TstDat = 0;
-         krn->NxtSiz = 0;
-         krn->GrpSiz = 16;
-      }
-      else if(krn->NxtSiz == 0)
-      {
-         // Begin the calibration with group size 1
-         krn->TstDat = 0;
-         krn->NxtSiz = 1;
-         krn->GrpSiz = krn->NxtSiz;
-      }
-      else if(krn->NxtSiz <= krn->MaxSiz / 2)
-      {
-         // Double the group size at each successive run until the maximum is reached
-         krn->TstDat++;
-         krn->NxtSiz *= 2;
-         krn->GrpSiz = krn->NxtSiz;
-      }
-      else
-      {
-         // We all sizes have been run, look for the fastest one
-         //  and store the optimal size
-         MinTim = krn->TstTim[0];
-         krn->OptSiz = 1;
+   NmbFac = pos;
 
-         for(i=0;i<=krn->TstDat;i++)
-            if(krn->TstTim[i] < MinTim)
-            {
-               MinTim = krn->TstTim[i];
-               krn->OptSiz = 1 << i;
-            }
+   // Save the existing faces and replace their table with a larger one,
+   // along with any link pointing to or from them
+   if(OldNmbFac)
+   {
+      dat = gml->dat[ gml->TypIdx[ FacTyp ] ];
+      FacLen = dat->ItmLen;
+      OldNod = malloc((size_t)OldNmbFac * FacLen * sizeof(int));
+      OldRef = malloc((size_t)OldNmbFac * sizeof(int));
+      RefIdx = gml->RefIdx[ FacTyp ];
 
-         //printf("Kernel %d: opt size = %zu\n", krn->idx, krn->OptSiz);
-         krn->GrpSiz = krn->OptSiz;
+      if( !OldNod || !OldRef || !RefIdx
+      ||  !GetHostLines(gml, RefIdx, 0, OldNmbFac - 1) )
+      {
+         NmbFac = -1;
+         goto FreTab;
       }
 
-      // Compute the hyperthreading level and set the workgroup size and counter
-      krn->NmbGrp = krn->NmbLin[0] / krn->GrpSiz;
-      krn->NmbGrp *= krn->GrpSiz;
-
-      if(krn->NmbGrp < krn->NmbLin[0])
-         krn->NmbGrp += krn->GrpSiz;
+      memcpy(OldNod, dat->CpuMem, (size_t)OldNmbFac * FacLen * sizeof(int));
+      memcpy(OldRef, gml->dat[ RefIdx ]->CpuMem, (size_t)OldNmbFac * sizeof(int));
+      GmlFreeData((size_t)gml, gml->TypIdx[ FacTyp ]);
+      GmlFreeData((size_t)gml, RefIdx);
    }
 
-   if(krn->NmbEvt == krn->EvtBlk)
+   for(typ=GmlTetrahedra; typ<GmlMaxEleTyp; typ++)
    {
-      krn->EvtBlk *= 2;
-      krn->EvtTab = realloc(krn->EvtTab, krn->EvtBlk * sizeof(cl_event));
-      assert(krn->EvtTab);
+      FreeLnkDat(gml, FacTyp, typ);
+      FreeLnkDat(gml, typ, FacTyp);
    }
 
-   // Wait for any previous runing kernel to complete
-   clFinish(gml->queue);
+   if(!(FacIdx = GmlNewMeshData((size_t)gml, FacTyp, NmbFac)))
+   {
+      NmbFac = -1;
+      goto FreTab;
+   }
 
-   // If the optimal size is yet to be found, start the timer
-   if(!krn->OptSiz)
-      krn->TstTim[ krn->TstDat ] = GmlGetWallClock();
+   dat = gml->dat[ FacIdx ];
+   FacTab = (int *)dat->CpuMem;
+   FacLen = dat->ItmLen;
+   RefTab = (int *)gml->dat[ gml->RefIdx[ FacTyp ] ]->CpuMem;
 
-   // Launch GPU code
-   if(clEnqueueNDRangeKernel( gml->queue, krn->kernel, 1, NULL, &krn->NmbGrp,
-                              &krn->GrpSiz, 0, NULL, &krn->EvtTab[ krn->NmbEvt++ ]) )
+   if(OldNmbFac)
    {
-      return(-6);
+      memcpy(FacTab, OldNod, (size_t)OldNmbFac * FacLen * sizeof(int));
+      memcpy(RefTab, OldRef, (size_t)OldNmbFac * sizeof(int));
    }
 
-   // If the optimal size is yet to be found, stop the timer
-   // and store the run time associated to this work group size
-   if(!krn->OptSiz)
+   // Allocate the faces' single tier shells of each volume kind
+   // and the volumes' downlinks to the faces
+   for(typ=GmlTetrahedra; typ<GmlMaxEleTyp; typ++)
    {
-      clFinish(gml->queue);
-      krn->TstTim[ krn->TstDat ] = GmlGetWallClock() - krn->TstTim[ krn->TstDat ];
+      if(!TypItm[ typ ] || !LenMatBas[ FacTyp ][ typ ])
+         continue;
+
+      sprintf(BalNam, "%s%sLnk", BalTypStr[ typ ], BalTypStr[ FacTyp ]);
+      LnkIdx[ typ ] = NewDwnLnk(gml, typ, FacTyp, BalNam);
+      ShlIdx[ typ ] = NewFacShl(gml, FacTyp, typ);
+
+      if(!LnkIdx[ typ ] || !ShlIdx[ typ ])
+      {
+         NmbFac = -1;
+         goto FreTab;
+      }
    }
 
-   return(1);
-}
+   // Each owner writes its face and its line of all shells, and stores its
+   // index in the downlinks of the elements sharing it: every line or slot
+   // has a single writer and the hash table is only read at this stage
+   for(typ=FacTyp; typ<GmlMaxEleTyp; typ++)
+   {
+      if(!(NmbItm = TypItm[ typ ]))
+         continue;
 
+      dat = gml->dat[ gml->TypIdx[ typ ] ];
+      EleNod = (int *)dat->CpuMem;
+      EleLen = dat->ItmLen;
 
-/*----------------------------------------------------------------------------*/
-/* Compute various reduction functions: min,max,L1,L2 norms                   */
-/*----------------------------------------------------------------------------*/
+#ifdef _OPENMP
+#pragma omp parallel for private(j, k, l, pos, msk, cpt, wid, nod, FacNod, HshKey, IdxLst, TypLst, VoyLst, DegTab, BalTab, VoyTab, LnkTab, bal) if(dat->NmbLin >= MINPARLIN)
+#endif
+      for(i=0;i<dat->NmbLin;i++)
+      {
+         nod = &EleNod[ (size_t)i * EleLen ];
+         pos = PosTab[ EleBeg[ typ ] + i ];
+         msk = OwnTab[ EleBeg[ typ ] + i ];
 
-int GmlReduceVector(size_t GmlIdx, int DatIdx, int RedOpp, double *nrm)
-{
-   GETGMLPTR(gml, GmlIdx);
-   int      i, NmbLin, ret;
-   float    res, *vec;
-   DatSct   *dat, *red;
-   KrnSct   *krn;
-   char     *RedNam[] = { "reduce_min", "reduce_max", "reduce_sum",
-            "reduce_L0", "reduce_L1", "reduce_L2", "reduce_Linf" };
+         for(k=0;k<NmbItm;k++)
+         {
+            if(!(msk & (1 << k)))
+               continue;
+
+            GetItmNod(nod, typ, FacTyp, ItmFac[ typ ][k], FacNod);
+            HshKey = CalHshKey(&FacHsh, FacNod);
+
+            if(typ != FacTyp)
+            {
+               for(j=0;j<EleNmbNod[ FacTyp ];j++)
+                  FacTab[ (size_t)pos * FacLen + j ] = FacNod[j];
+
+               RefTab[ pos ] = 0;
+            }
 
-   // Check indices and data conformity
-   if( (DatIdx < 1) || (DatIdx > GmlMaxDat) )
-   {
-      printf("Invalid data index: %d\n", DatIdx);
-      return(-1);
-   }
+            // Faces shared by more elements than expected are left unlinked
+            if((cpt = GetHsh(&FacHsh, HshKey, i, k, FacNod, NULL, NULL, NULL)) > MAXFACELE)
+            {
+               pos++;
+               continue;
+            }
 
-   dat = &gml->dat[ DatIdx ];
+            GetHsh(&FacHsh, HshKey, i, k, FacNod, IdxLst, VoyLst, TypLst);
 
-   if( (dat->ItmTyp != GmlFlt) || (dat->NmbItm != 1) || (dat->ItmLen != 1) )
-   {
-      printf(  "Invalid data structure: count %d, type %s, length %d\n",
-               dat->NmbItm, OclTypStr[ dat->ItmTyp ], dat->ItmLen );
-      return(-2);
-   }
+            for(j=0;j<cpt;j++)
+            {
+               if(!ShlIdx[ TypLst[j] ])
+                  continue;
 
-   if( (RedOpp < 0) || (RedOpp > GmlMaxRed) )
-   {
-      printf("Invalid operation code %d\n", RedOpp);
-      return(-3);
-   }
+               // Downlink of the sharing element
+               LnkTab = (int *)gml->dat[ LnkIdx[ TypLst[j] ] ]->CpuMem;
+               LnkTab[ (size_t)IdxLst[j] * gml->dat[ LnkIdx[ TypLst[j] ] ]->ItmLen + VoyLst[j] ] = pos;
 
-   // Allocate an output vector the size of the input vector
-   if(!dat->RedIdx)
-      dat->RedIdx = GmlNewSolutionData(GmlIdx, dat->MshTyp, 1, GmlFlt, "reduce");
+               // Shell entry, truncated to the shell's width as when building it
+               bal = gml->dat[ ShlIdx[ TypLst[j] ] ];
+               DegTab = (int *)gml->dat[ gml->CntMat[ FacTyp ][ TypLst[j] ] ]->CpuMem;
+               BalTab = (int *)bal->CpuMem + (size_t)pos * bal->ItmLen;
+               VoyTab = (char *)gml->dat[ bal->VoyIdx ]->CpuMem + (size_t)pos * bal->ItmLen;
+               wid = bal->ItmLen;
+               l = DegTab[ pos ]++;
 
-   if(!dat->RedIdx)
-   {
-      printf(  "Failed to allocate a reduction vector of %d bytes\n",
-               OclTypSiz[ GmlFlt ] * dat->NmbLin );
-      return(-4);
+               if(l < wid)
+               {
+                  BalTab[l] = IdxLst[j];
+                  VoyTab[l] = VoyLst[j];
+               }
+            }
+
+            pos++;
+         }
+      }
    }
 
-   // Compile a reduction kernel with the required operation if needed
-   if(!gml->RedKrn[ RedOpp ])
-      gml->RedKrn[ RedOpp ] = NewOclKrn(gml, reduce, RedNam[ RedOpp ]);
+   UploadData(gml, FacIdx);
+   UploadData(gml, gml->RefIdx[ FacTyp ]);
 
-   if(!gml->RedKrn[ RedOpp ])
+   for(typ=GmlTetrahedra; typ<GmlMaxEleTyp; typ++)
    {
-      printf("Failed to compile the %s reduction kernel\n", RedNam[ RedOpp ]);
-      return(-5);
+      if(!ShlIdx[ typ ])
+         continue;
+
+      UploadData(gml, LnkIdx[ typ ]);
+      UploadData(gml, ShlIdx[ typ ]);
+      UploadData(gml, gml->dat[ ShlIdx[ typ ] ]->VoyIdx);
+      UploadData(gml, gml->CntMat[ FacTyp ][ typ ]);
    }
 
-   // Set the kernel with two vectors: an input and a reduced output one
-   krn = &gml->krn[ gml->RedKrn[ RedOpp ] ];
-   krn->NmbDat    = 2;
-   krn->DatTab[0] = DatIdx;
-   krn->DatTab[1] = dat->RedIdx;
-   krn->NmbLin[0] = dat->NmbLin;
+   if(gml->DbgFlg)
+      printf(  "Hashed, setup and transfered %d %s to the GMlib.\n",
+               NmbFac, BalTypStr[ FacTyp ] );
 
-   // Launch the right reduction kernel according to the requested opperation
-   ret = RunOclKrn(gml, krn);
+   // Single exit freeing the work tables, on success or failure
+FreTab:
+   if(KeyTab)
+      free(KeyTab);
 
-   if(ret < 0)   
-      return(ret);
+   if(KeyBuc)
+      free(KeyBuc);
 
-   // Trim the size of the output vector down to the number of OpenCL groups
-   // used by the kernel and download this amount of data
-   red = &gml->dat[ dat->RedIdx ];
-   red->MemSiz = dat->MemSiz / krn->GrpSiz;
-   NmbLin = (int)(dat->NmbLin / krn->GrpSiz);
-   DownloadData(gml, dat->RedIdx);
-   red->MemSiz = dat->MemSiz;
-   vec = (float *)red->CpuMem;
+   if(PosTab)
+      free(PosTab);
 
-   // Perform the last reduction step on the CPU
-   switch(RedOpp)
-   {
-      case GmlMin :
-      {
-         res = FLT_MAX;
-         for(i=0;i<NmbLin;i++)
-            res = MIN(res, vec[i]);
-      }break;
+   if(OwnTab)
+      free(OwnTab);
 
-      case GmlSum : case GmlL0 : case GmlL1 : case GmlL2 :
-      {
-         res = 0.;
-         for(i=0;i<NmbLin;i++)
-            res += vec[i];
-      }break;
+   if(OldNod)
+      free(OldNod);
 
-      case GmlMax : case GmlLinf :
-      {
-         res = -FLT_MAX;
-         for(i=0;i<NmbLin;i++)
-            res = MAX(res, vec[i]);
-      }break;
-   }
+   if(OldRef)
+      free(OldRef);
 
-   *nrm = res;
+   FreeHsh(&FacHsh);
 
-   return(1);
+   return(NmbFac);
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Multiply a sliced blocked sparse matrix by a blocked vector vector         */
+/* Build the list of inner faces and add them to the existing boundary ones,  */
+/* along with the faces' shells and the elements' downlinks to them           */
 /*----------------------------------------------------------------------------*/
 
-int GmlMultMatVec(size_t GmlIdx, int MatIdx, int VecIdx1, int VecIdx2)
+int GmlExtractFaces(size_t GmlIdx)
 {
-   int i, res;
+   int NmbTri, NmbQad;
+
    GETGMLPTR(gml, GmlIdx);
-   MatSct *mat;
-   VecSct *vec1, *vec2;
-   KrnSct *krn;
 
-   // Check indices and data conformity
-   if( (MatIdx < 1) || (MatIdx > GmlMaxMat) )
-   {
-      printf("Invalid data index: %d\n", MatIdx);
-      return(-1);
-   }
+   if((NmbTri = ExtFacTyp(gml, GmlTriangles)) < 0)
+      return(0);
 
-   mat = &gml->mat[ MatIdx ];
+   if((NmbQad = ExtFacTyp(gml, GmlQuadrilaterals)) < 0)
+      return(0);
 
-   if( (VecIdx1 < 1) || (VecIdx1 > GmlMaxDat) )
-   {
-      printf("Invalid data index: %d\n", VecIdx1);
-      return(-2);
-   }
+   // As there are two resulting values, return the sum instead of the data index
+   return(NmbTri + NmbQad);
+}
 
-   vec1 = &gml->vec[ VecIdx1 ];
 
-   if( (VecIdx2 < 1) || (VecIdx2 > GmlMaxDat) )
-   {
-      printf("Invalid data index: %d\n", VecIdx2);
-      return(-3);
-   }
+/*----------------------------------------------------------------------------*/
+/* Build, allocate and transfer neighbourhood information: two elements of    */
+/* any kinds of the same dimension are neighbours if they share a face, and   */
+/* each entry comes with its neighbour's kind in a char tag table, -1 when    */
+/* there is none. Triangles and quads are hashed in the same table, the       */
+/* triangles' missing fourth node being set to -1 so that they never match    */
+/*----------------------------------------------------------------------------*/
 
-   vec2 = &gml->vec[ VecIdx2 ];
+int GmlSetNeighbours(size_t GmlIdx, int typ)
+{
+   int         i, j, k, t, cpt, HshTyp, NgbIdx, TagIdx, NmbItm, EleLen;
+   int         NmbFac[ GmlMaxEleTyp ], IdxLst[ MAXFACELE ], TypLst[ MAXFACELE ];
+   int         ItmTab[4], *EleNod, *nod, *NgbTab;
+   char        VoyLst[ MAXFACELE ], *TagTab;
+   size_t      HshKey, idx, KeyBeg, NmbKey = 0, *KeyTab;
+   BucSct      *KeyBuc;
+   DatSct      *dat, *ngb, *tag;
+   HshTabSct   lnk;
 
-   if(mat->NmbLin != vec1->NmbLin || mat->NmbLin != vec2->NmbLin)
-   {
-      printf("vectors and matrix size differ: %d(%d) %d(%d) %d(%d)\n",
-            MatIdx, mat->NmbLin, VecIdx1, vec1->NmbLin, VecIdx2, vec2->NmbLin);
-      return(-4);
-   }
+   GETGMLPTR(gml, GmlIdx);
 
-   // Launch the matrix kernels on the GPU
-   for(i=0;i<mat->NmbSlc;i++)
-   {
-      // Store information usefull to the kernel: loop indices and arguments list
-      krn = &gml->krn[ mat->KrnIdx[i] ];
-      krn->NmbDat = 5;
-      krn->NmbLin[0] = mat->MatSlc[ i+1 ][1] - mat->MatSlc[i][1];
-      krn->NmbLin[1] = mat->MatSlc[i][1];
-      krn->DatTab[0] = mat->DegIdx[i];
-      krn->DatTab[1] = mat->ColIdx[i];
-      krn->DatTab[2] = mat->ValIdx[i];
-      krn->DatTab[3] = vec1->idx;
-      krn->DatTab[4] = vec2->idx;
+   // Get and check the source and destination mesh datatypes
+   CHKELETYP(typ);
 
-      res = RunOclKrn(gml, krn);
+   if( (typ == GmlVertices) || !gml->TypIdx[ typ ] )
+      return(0);
 
-      if(res != 1)
-         return(res);
-   }
+   // Elements are linked through their vertices, edges or faces
+   // depending on their dimension, any kind of this dimension taking part
+   if(MshTypDim[ typ ] == 1)
+      HshTyp = GmlVertices;
+   else if(MshTypDim[ typ ] == 2)
+      HshTyp = GmlEdges;
+   else
+      HshTyp = GmlQuadrilaterals;
 
-   // Ipdate the stats on bytes read/written and flops performed by the kernels
-   gml->MemAcc += mat->MemAcc;
-   gml->FltOpp += mat->FltOpp;
+   for(t=GmlEdges; t<GmlMaxEleTyp; t++)
+   {
+      NmbFac[t] = 0;
 
-   return(1);
-}
+      if( (MshTypDim[t] != MshTypDim[ typ ]) || !gml->TypIdx[t] )
+         continue;
 
+      if(HshTyp == GmlVertices)
+         NmbFac[t] = 2;
+      else if(HshTyp == GmlEdges)
+         NmbFac[t] = ItmNmbEdg[t];
+      else
+         NmbFac[t] = ItmNmbFac[t];
 
-/*----------------------------------------------------------------------------*/
-/* Add two vectors term by term                                               */
-/*----------------------------------------------------------------------------*/
+      if(!GetHostLines(gml, gml->TypIdx[t], 0, gml->dat[ gml->TypIdx[t] ]->NmbLin - 1))
+         return(0);
 
-int GmlAddVec3(size_t GmlIdx, int VecIdx1, int VecIdx2, int VecIdx3, int VecIdx4)
-{
-   int i, res;
-   GETGMLPTR(gml, GmlIdx);
-   VecSct *vec1, *vec2, *vec3, *vec4;
-   KrnSct *krn;
+      NmbKey += (size_t)gml->dat[ gml->TypIdx[t] ]->NmbLin * NmbFac[t];
+   }
 
-   if( (VecIdx1 < 1) || (VecIdx1 > GmlMaxDat) )
+   // Setup a hash table
+   if(!NewHsh(&lnk, HshTyp, NmbKey))
    {
-      printf("Invalid data index: %d\n", VecIdx1);
-      return(-1);
+      FreeHsh(&lnk);
+      return(0);
    }
 
-   vec1 = &gml->vec[ VecIdx1 ];
+   if(gml->DbgFlg)
+      printf(  "Hash table: buckets=%d, stored items=%d, partitions=%d\n",
+               (int)lnk.TabSiz, lnk.DatLen, lnk.NmbPrt);
+
+   // Compute the keys of the faces of all kinds of elements once and in
+   // parallel, then add them to the hash table, partition by partition
+   KeyTab = malloc(MAX(NmbKey, 1) * sizeof(size_t));
+   KeyBuc = malloc(MAX(NmbKey, 1) * sizeof(BucSct));
 
-   if( (VecIdx2 < 1) || (VecIdx2 > GmlMaxDat) )
+   for(t=GmlEdges, KeyBeg=0; KeyTab && KeyBuc && (t<GmlMaxEleTyp); t++)
    {
-      printf("Invalid data index: %d\n", VecIdx2);
-      return(-2);
-   }
+      if(!(NmbItm = NmbFac[t]))
+         continue;
 
-   vec2 = &gml->vec[ VecIdx2 ];
+      dat = gml->dat[ gml->TypIdx[t] ];
+      EleNod = (int *)dat->CpuMem;
+      EleLen = dat->ItmLen;
 
-   if( (VecIdx3 < 1) || (VecIdx3 > GmlMaxDat) )
-   {
-      printf("Invalid data index: %d\n", VecIdx3);
-      return(-3);
+#ifdef _OPENMP
+#pragma omp parallel for private(j, idx, nod) if(dat->NmbLin >= MINPARLIN)
+#endif
+      for(i=0;i<dat->NmbLin;i++)
+      {
+         nod = &EleNod[ (size_t)i * EleLen ];
+
+         for(j=0;j<NmbItm;j++)
+         {
+            idx = KeyBeg + (size_t)i * NmbItm + j;
+            GetNgbFac(nod, t, HshTyp, j, KeyBuc[ idx ].nod);
+            KeyBuc[ idx ].EleTyp = (char)t;
+            KeyBuc[ idx ].ItmIdx = (char)j;
+            KeyBuc[ idx ].EleIdx = i;
+            KeyTab[ idx ] = CalHshKey(&lnk, KeyBuc[ idx ].nod);
+         }
+      }
+
+      KeyBeg += (size_t)dat->NmbLin * NmbItm;
    }
 
-   vec3 = &gml->vec[ VecIdx3 ];
+   cpt = KeyTab && KeyBuc && FilHsh(&lnk, NmbKey, KeyTab, KeyBuc, 0);
+
+   if(KeyTab)
+      free(KeyTab);
 
-   if( (VecIdx4 < 1) || (VecIdx4 > GmlMaxDat) )
+   if(KeyBuc)
+      free(KeyBuc);
+
+   if(!cpt)
    {
-      printf("Invalid data index: %d\n", VecIdx4);
-      return(-4);
+      FreeHsh(&lnk);
+      return(0);
    }
 
-   vec4 = &gml->vec[ VecIdx4 ];
+   SumHsh(&lnk);
 
-   if( (vec1->NmbLin != vec2->NmbLin) || (vec1->BlkSiz != vec2->BlkSiz) )
-   {
-      printf(  "vector sizes differ: ID %d (%d x %d) and ID %d (%d x %d)\n",
-               VecIdx1, vec1->NmbLin, vec1->BlkSiz,
-               VecIdx2, vec2->NmbLin, vec2->BlkSiz );
+   if(gml->DbgFlg)
+      printf(  "Hashed %d entities: occupency=%d%%, mean probes=%g, max probes=%d\n",
+               (int)lnk.NmbDat, (int)((100 * lnk.NmbDat) / lnk.TabSiz),
+               (double)lnk.NmbPrb / (double)lnk.NmbDat, (int)lnk.MaxPrb );
 
-      return(-4);
-   }
+   // Build the neighbours and their kinds
+   NmbItm = NmbFac[ typ ];
 
-   if( (vec1->NmbLin != vec4->NmbLin) || (vec1->BlkSiz != vec4->BlkSiz) )
+   if(!(NgbIdx = GmlNewLinkData(GmlIdx, typ, typ, NmbItm, "ngb")))
    {
-      printf(  "vector sizes differ: ID %d (%d x %d) and ID %d (%d x %d)\n",
-               VecIdx1, vec1->NmbLin, vec1->BlkSiz,
-               VecIdx4, vec4->NmbLin, vec4->BlkSiz );
-
-      return(-5);
+      FreeHsh(&lnk);
+      return(0);
    }
 
-   // Store information usefull to the kernel: loop indices and arguments list
-   krn = &gml->krn[ vec1->AddKrnIdx ];
-   krn->NmbDat = 4;
-   krn->NmbLin[0] = vec1->NmbLin;
-   krn->DatTab[0] = vec1->idx;
-   krn->DatTab[1] = vec2->idx;
-   krn->DatTab[2] = vec3->idx;
-   krn->DatTab[3] = vec4->idx;
+   if(gml->NgbTag[ typ ])
+      GmlFreeData(GmlIdx, gml->NgbTag[ typ ]);
 
-   // Launch the vector kernel on the GPU
-   res = RunOclKrn(gml, krn);
+   if(!(TagIdx = GmlNewSolutionData(GmlIdx, typ, 1, GmlByt8, "NgbTyp")))
+   {
+      FreeHsh(&lnk);
+      return(0);
+   }
 
-   if(res != 1)
-      return(res);
+   gml->NgbTag[ typ ] = TagIdx;
 
-   // Ipdate the stats on bytes read/written and flops performed by the kernels
-   gml->MemAcc += vec1->NmbLin * vec1->BlkSiz * vec1->FltSiz * 3;
-   gml->FltOpp += vec1->NmbLin * vec1->BlkSiz;
+   // Each element writes its own line of the link and tag tables,
+   // faces shared by other than two elements have no neighbour
+   dat = gml->dat[ gml->TypIdx[ typ ] ];
+   EleNod = (int *)dat->CpuMem;
+   EleLen = dat->ItmLen;
+   ngb = gml->dat[ NgbIdx ];
+   tag = gml->dat[ TagIdx ];
 
-   return(1);
-}
+#ifdef _OPENMP
+#pragma omp parallel for private(j, k, nod, ItmTab, HshKey, cpt, IdxLst, TypLst, VoyLst, NgbTab, TagTab) if(dat->NmbLin >= MINPARLIN)
+#endif
+   for(i=0;i<dat->NmbLin;i++)
+   {
+      nod = &EleNod[ (size_t)i * EleLen ];
+      NgbTab = (int *)((char *)ngb->CpuMem + (size_t)i * ngb->LinSiz);
+      TagTab = (char *)tag->CpuMem + (size_t)i * tag->LinSiz;
 
+      for(j=0;j<8;j++)
+         TagTab[j] = -1;
 
-/*----------------------------------------------------------------------------*/
-/* Multiply each term by a scalar                                             */
-/*----------------------------------------------------------------------------*/
+      for(j=0;j<NmbItm;j++)
+      {
+         GetNgbFac(nod, typ, HshTyp, j, ItmTab);
+         HshKey = CalHshKey(&lnk, ItmTab);
+         NgbTab[j] = 0;
 
-int GmlScaleVec(size_t GmlIdx, int VecIdx, double *mul)
-{
-   int i, res;
-   GETGMLPTR(gml, GmlIdx);
-   VecSct *vec;
-   KrnSct *krn;
+         if(GetHsh(&lnk, HshKey, i, j, ItmTab, NULL, NULL, NULL) != 2)
+            continue;
 
-   if( (VecIdx < 1) || (VecIdx > GmlMaxDat) )
-   {
-      printf("Invalid data index: %d\n", VecIdx);
-      return(-2);
+         cpt = GetHsh(&lnk, HshKey, i, j, ItmTab, IdxLst, VoyLst, TypLst);
+
+         for(k=0;k<cpt;k++)
+            if( (TypLst[k] != typ) || (IdxLst[k] != i) )
+            {
+               NgbTab[j] = IdxLst[k];
+               TagTab[j] = (char)TypLst[k];
+            }
+      }
    }
 
-   vec = &gml->vec[ VecIdx ];
+   UploadData(gml, NgbIdx);
+   UploadData(gml, TagIdx);
 
-   // Store information usefull to the kernel: loop indices and arguments list
-   krn = &gml->krn[ vec->SclKrnIdx ];
-   krn->NmbDat = 1;
-   krn->NmbLin[0] = vec->NmbLin;
-   krn->DatTab[0] = vec->idx;
+   if(gml->DbgFlg)
+      printf("Stored %d uniq entries in the link table\n", dat->NmbLin * NmbItm);
+
+   FreeHsh(&lnk);
 
-   // Launch the vector kernel on the GPU
-   res = RunOclKrn(gml, krn);
+   return(NgbIdx);
+}
 
-   if(res != 1)
-      return(res);
 
-   // Ipdate the stats on bytes read/written and flops performed by the kernels
-   gml->MemAcc += vec->NmbLin * vec->BlkSiz * vec->FltSiz * 2;
-   gml->FltOpp += vec->NmbLin * vec->BlkSiz;
+/*----------------------------------------------------------------------------*/
+/* Return the index of the tag table giving the kind of each neighbour        */
+/*----------------------------------------------------------------------------*/
 
-   return(1);
+int GmlGetNeighbourTypes(size_t GmlIdx, int typ)
+{
+   GETGMLPTR(gml, GmlIdx);
+   CHKELETYP(typ);
+
+   return(gml->NgbTag[ typ ]);
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Compute each field's L2 norm                                               */
+/* Build a single vertex ball spanning all kinds of volume elements: each     */
+/* entry comes with its element's kind in a char tag table and its local      */
+/* vertex index in the voyeurs table. Kernels reading volume data through it  */
+/* only fetch the entries matching each data's kind                           */
 /*----------------------------------------------------------------------------*/
 
-int GmlNormVec(size_t GmlIdx, int VecIdx, int RedIdx, double *nrm)
+int GmlSetHybridBall(size_t GmlIdx)
 {
-   int i, res;
+   int      i, j, t, n, NmbVer, NmbEnt = 0, MaxDeg = 0, LnkTyp = 0, BalSiz;
+   int      BalIdx, DegIdx, TypIdx, VecCnt, VecSiz, ItmTyp, OldIdx[3];
+   int      *OffTab, *CurTab, *EntTab, *EleNod, *BalTab, *DegTab;
+   char     *EntTyp, *EntVoy, *TypTab, *VoyTab;
+   DatSct   *dat, *BalDat, *DegDat, *TypDat, *VoyDat;
+
    GETGMLPTR(gml, GmlIdx);
-   VecSct *vec;
-   KrnSct *krn;
 
-   if( (VecIdx < 1) || (VecIdx > GmlMaxVec) )
+   if(!gml->TypIdx[ GmlVertices ])
+      return(0);
+
+   NmbVer = gml->dat[ gml->TypIdx[ GmlVertices ] ]->NmbLin;
+
+   // Free a previous hybrid ball
+   OldIdx[0] = gml->HybBal;
+   OldIdx[1] = gml->HybDeg;
+   OldIdx[2] = gml->HybTyp;
+
+   for(i=0;i<3;i++)
+      if(OldIdx[i])
+         GmlFreeData(GmlIdx, OldIdx[i]);
+
+   gml->HybBal = gml->HybDeg = gml->HybTyp = 0;
+
+   // Count the volume elements around each vertex
+   if(!(OffTab = calloc((size_t)NmbVer + 1, sizeof(int))))
+      return(0);
+
+   for(t=GmlTetrahedra; t<=GmlHexahedra; t++)
    {
-      printf("Invalid data index: %d\n", VecIdx);
-      return(-2);
+      if(!gml->TypIdx[t])
+         continue;
+
+      dat = gml->dat[ gml->TypIdx[t] ];
+
+      if(!GetHostLines(gml, gml->TypIdx[t], 0, dat->NmbLin - 1))
+      {
+         free(OffTab);
+         return(0);
+      }
+
+      if(!LnkTyp)
+         LnkTyp = t;
+
+      EleNod = (int *)dat->CpuMem;
+
+      for(i=0;i<dat->NmbLin;i++)
+         for(j=0;j<EleNmbNod[t];j++)
+            OffTab[ EleNod[ (size_t)i * dat->ItmLen + j ] + 1 ]++;
+
+      NmbEnt += dat->NmbLin * EleNmbNod[t];
    }
 
-   vec = &gml->vec[ VecIdx ];
+   if(!NmbEnt)
+   {
+      free(OffTab);
+      return(0);
+   }
 
-   // Store information usefull to the kernel: loop indices and arguments list
-   krn = &gml->krn[ vec->NrmKrnIdx ];
-   krn->NmbDat = 2;
-   krn->NmbLin[0] = vec->NmbLin;
-   krn->DatTab[0] = vec->idx;
-   krn->DatTab[1] = RedIdx;
+   for(i=0;i<NmbVer;i++)
+   {
+      MaxDeg = MAX(MaxDeg, OffTab[ i+1 ]);
+      OffTab[ i+1 ] += OffTab[i];
+   }
 
-   // Launch the vector kernel on the GPU
-   res = RunOclKrn(gml, krn);
+   // Store the entries by kind, element and vertex,
+   // which gives the same order as the single kind balls
+   CurTab = malloc(((size_t)NmbVer + 1) * sizeof(int));
+   EntTab = malloc((size_t)NmbEnt * sizeof(int));
+   EntTyp = malloc((size_t)NmbEnt);
+   EntVoy = malloc((size_t)NmbEnt);
 
-   if(res != 1)
-      return(res);
+   if(!CurTab || !EntTab || !EntTyp || !EntVoy)
+   {
+      free(OffTab); free(CurTab); free(EntTab); free(EntTyp); free(EntVoy);
+      return(0);
+   }
 
-   *nrm = 0.;
-   res = GmlReduceVector(GmlIdx, RedIdx, GmlL1, nrm);
+   memcpy(CurTab, OffTab, ((size_t)NmbVer + 1) * sizeof(int));
 
-   if(res != 1)
-      return(res);
+   for(t=GmlTetrahedra; t<=GmlHexahedra; t++)
+   {
+      if(!gml->TypIdx[t])
+         continue;
 
-   *nrm = sqrt(*nrm);
+      dat = gml->dat[ gml->TypIdx[t] ];
+      EleNod = (int *)dat->CpuMem;
 
-   // Ipdate the stats on bytes read/written and flops performed by the kernels
-   gml->MemAcc += vec->NmbLin * vec->BlkSiz * vec->FltSiz * 2;
-   gml->FltOpp += vec->NmbLin * vec->BlkSiz * 2;
+      for(i=0;i<dat->NmbLin;i++)
+         for(j=0;j<EleNmbNod[t];j++)
+         {
+            n = CurTab[ EleNod[ (size_t)i * dat->ItmLen + j ] ]++;
+            EntTab[n] = i;
+            EntTyp[n] = (char)t;
+            EntVoy[n] = (char)j;
+         }
+   }
 
-   return(1);
-}
+   free(CurTab);
 
+   // A single tier as wide as the largest degree, up to the widest vector
+   GetCntVec(MaxDeg, &VecCnt, &VecSiz, &ItmTyp);
+   BalSiz = VecCnt * VecSiz;
 
-/*----------------------------------------------------------------------------*/
-/* Multiply a diagonal matrix by a vector                                     */
-/*----------------------------------------------------------------------------*/
+   if(MaxDeg > BalSiz)
+      printf("Hybrid ball truncated from degree %d to %d\n", MaxDeg, BalSiz);
 
-int GmlMultDiagMatVec(size_t GmlIdx, int VecIdx1, int VecIdx2, int VecIdx3)
-{
-   int i, res;
-   GETGMLPTR(gml, GmlIdx);
-   VecSct *vec1, *vec2, *vec3;
-   KrnSct *krn;
+   BalIdx = DegIdx = TypIdx = 0;
 
-   if( (VecIdx1 < 1) || (VecIdx1 > GmlMaxDat) )
+   if((DegIdx = GetNewDatIdx(gml)))
    {
-      printf("Invalid data index: %d\n", VecIdx1);
-      return(-1);
-   }
+      DegDat = gml->dat[ DegIdx ];
+      DegDat->AloTyp = GmlLnkDat;
+      DegDat->MshTyp = GmlVertices;
+      DegDat->LnkTyp = LnkTyp;
+      DegDat->MemAcs = GmlInout;
+      DegDat->ItmTyp = GmlInt;
+      DegDat->NmbItm = 1;
+      DegDat->ItmSiz = OclTypSiz[ GmlInt ];
+      DegDat->ItmLen = 0;
+      DegDat->NmbLin = NmbVer;
+      DegDat->LinSiz = DegDat->NmbItm * DegDat->ItmSiz;
+      DegDat->MemSiz = (size_t)DegDat->NmbLin * (size_t)DegDat->LinSiz;
+      DegDat->GpuMem = DegDat->CpuMem = NULL;
+      DegDat->nam    = "VerVolDeg";
 
-   vec1 = &gml->vec[ VecIdx1 ];
+      if(!NewData(gml, DegDat))
+         DegIdx = 0;
+   }
 
-   if( (VecIdx2 < 1) || (VecIdx2 > GmlMaxDat) )
+   if(DegIdx && (BalIdx = GetNewDatIdx(gml)))
    {
-      printf("Invalid data index: %d\n", VecIdx2);
-      return(-2);
+      BalDat = gml->dat[ BalIdx ];
+      BalDat->AloTyp = GmlLnkDat;
+      BalDat->MshTyp = GmlVertices;
+      BalDat->LnkTyp = LnkTyp;
+      BalDat->MemAcs = GmlInout;
+      BalDat->ItmTyp = ItmTyp;
+      BalDat->NmbItm = VecCnt;
+      BalDat->ItmSiz = VecCnt * OclTypSiz[ ItmTyp ];
+      BalDat->ItmLen = BalSiz;
+      BalDat->NmbLin = NmbVer;
+      BalDat->LinSiz = BalDat->NmbItm * BalDat->ItmSiz;
+      BalDat->MemSiz = (size_t)BalDat->NmbLin * (size_t)BalDat->LinSiz;
+      BalDat->GpuMem = BalDat->CpuMem = NULL;
+      BalDat->nam    = "VerVolBal";
+      BalDat->VoyNam = "VerVolVoy";
+
+      if(!NewData(gml, BalDat) || !NewVoyData(gml, BalIdx))
+         BalIdx = 0;
    }
 
-   vec2 = &gml->vec[ VecIdx2 ];
+   if(BalIdx)
+      TypIdx = NewChrTab(gml, BalIdx, "VerVolTyp");
 
-   if( (VecIdx3 < 1) || (VecIdx3 > GmlMaxDat) )
+   // Free the tables allocated before the failure, the voyeurs going along
+   // with their ball
+   if(!DegIdx || !BalIdx || !TypIdx)
    {
-      printf("Invalid data index: %d\n", VecIdx3);
-      return(-3);
+      if(DegIdx)
+         GmlFreeData(GmlIdx, DegIdx);
+
+      if(BalIdx)
+         GmlFreeData(GmlIdx, BalIdx);
+
+      free(OffTab); free(EntTab); free(EntTyp); free(EntVoy);
+      return(0);
    }
 
-   vec3 = &gml->vec[ VecIdx3 ];
+   // Each vertex writes its own line, unused entries get a null kind
+   BalDat = gml->dat[ BalIdx ];
+   DegDat = gml->dat[ DegIdx ];
+   TypDat = gml->dat[ TypIdx ];
+   VoyDat = gml->dat[ BalDat->VoyIdx ];
+   DegTab = (int *)DegDat->CpuMem;
 
-   if( (vec1->NmbLin != vec3->NmbLin) || (vec1->BlkSiz != POW(vec3->BlkSiz)) )
+#ifdef _OPENMP
+#pragma omp parallel for private(j, n, BalTab, TypTab, VoyTab) if(NmbVer >= MINPARLIN)
+#endif
+   for(i=0;i<NmbVer;i++)
    {
-      printf(  "vector sizes differ: ID %d (%d x %d) and ID %d (%d x %d)\n",
-               VecIdx1, vec1->NmbLin, vec1->BlkSiz,
-               VecIdx2, vec3->NmbLin, vec3->BlkSiz );
+      BalTab = (int *)((char *)BalDat->CpuMem + (size_t)i * BalDat->LinSiz);
+      TypTab = (char *)TypDat->CpuMem + (size_t)i * TypDat->LinSiz;
+      VoyTab = (char *)VoyDat->CpuMem + (size_t)i * VoyDat->LinSiz;
+      n = MIN(OffTab[ i+1 ] - OffTab[i], BalSiz);
+      DegTab[i] = n;
 
-      return(-4);
+      for(j=0;j<BalSiz;j++)
+      {
+         BalTab[j] = (j < n) ? EntTab[ OffTab[i] + j ] : 0;
+         TypTab[j] = (j < n) ? EntTyp[ OffTab[i] + j ] : -1;
+         VoyTab[j] = (j < n) ? EntVoy[ OffTab[i] + j ] : 0;
+      }
    }
 
-   // Store information usefull to the kernel: loop indices and arguments list
-   krn = &gml->krn[ vec1->MulDiaKrnIdx ];
-   krn->NmbDat = 3;
-   krn->NmbLin[0] = vec1->NmbLin;
-   krn->DatTab[0] = vec1->idx;
-   krn->DatTab[1] = vec2->idx;
-   krn->DatTab[2] = vec3->idx;
+   free(OffTab);
+   free(EntTab);
+   free(EntTyp);
+   free(EntVoy);
 
-   // Launch the vector kernel on the GPU
-   res = RunOclKrn(gml, krn);
+   UploadData(gml, DegIdx);
+   UploadData(gml, BalIdx);
+   UploadData(gml, TypIdx);
+   UploadData(gml, BalDat->VoyIdx);
 
-   if(res != 1)
-      return(res);
+   gml->HybBal = BalIdx;
+   gml->HybDeg = DegIdx;
+   gml->HybTyp = TypIdx;
 
-   // Ipdate the stats on bytes read/written and flops performed by the kernels
-   gml->MemAcc += vec1->NmbLin * (vec1->BlkSiz + 2 * vec2->BlkSiz) * vec1->FltSiz;
-   gml->FltOpp += vec1->NmbLin * 2 * vec1->BlkSiz;
+   if(gml->DbgFlg)
+      printf(  "Hybrid ball: %d entries, max degree=%d, width=%d\n",
+               NmbEnt, MaxDeg, BalSiz );
 
-   return(1);
+   return(BalIdx);
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Return memory currently allocated on the GPU                               */
+/* Insert an entity in a sorted list of unique ones                           */
 /*----------------------------------------------------------------------------*/
 
-size_t GmlGetMemoryUsage(size_t GmlIdx)
+static void AddCavLst(int *lst, int *NmbLst, int itm)
 {
-   GETGMLPTR(gml, GmlIdx);
-   return(gml->MemSiz);
-}
+   int i, j;
 
+   for(i=0; (i < *NmbLst) && (lst[i] < itm); i++);
 
-/*----------------------------------------------------------------------------*/
-/* Return memory currently transfered to or from the GPU                      */
-/*----------------------------------------------------------------------------*/
+   if( ((i < *NmbLst) && (lst[i] == itm)) || (*NmbLst >= MAXCAVLST) )
+      return;
 
-size_t GmlGetMemoryTransfer(size_t GmlIdx)
-{
-   GETGMLPTR(gml, GmlIdx);
-   return(gml->MovSiz);
+   for(j=*NmbLst; j>i; j--)
+      lst[j] = lst[ j-1 ];
+
+   lst[i] = itm;
+   (*NmbLst)++;
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Return the number of bytes accessed from the GPU kernels so far            */
+/* Get the sorted list of the destination entities sharing a vertex or an     */
+/* edge with a source entity, the source itself excluded: they are gathered   */
+/* from the vertex balls, an edge's shell being the entities of its first     */
+/* vertex's ball that also hold its second one                                */
 /*----------------------------------------------------------------------------*/
 
-float GmlGetMemoryAccess(size_t GmlIdx)
+static int GetCavLst(GmlSct *gml, int SrcTyp, int DstTyp, int ConTyp, int idx, int *lst)
 {
-   GETGMLPTR(gml, GmlIdx);
-   return(gml->MemAcc);
-}
+   int      j, k, l, d, n, wid, hit, NmbNod, NmbItm = 0, NmbLst = 0, BalIdx, RowIdx;
+   int      ItmTab[ 2 << VECPOWMAX ], *SrcNod, *DstNod, *EdgNod, *DegTab, *row;
+   DatSct   *src, *dst, *edg;
 
+   src = gml->dat[ gml->TypIdx[ SrcTyp ] ];
+   dst = gml->dat[ gml->TypIdx[ DstTyp ] ];
+   SrcNod = (int *)src->CpuMem;
+   DstNod = (int *)dst->CpuMem;
+   NmbNod = (ConTyp == GmlVertices) ? 1 : 2;
 
-/*----------------------------------------------------------------------------*/
-/* Return the number of flops performed by the GPU kernels so far             */
-/*----------------------------------------------------------------------------*/
+   // List the source entity's vertices or edges as one or two nodes items
+   if(ConTyp == GmlVertices)
+   {
+      if(SrcTyp == GmlVertices)
+         ItmTab[ NmbItm++ ] = idx;
+      else
+         for(j=0;j<EleNmbNod[ SrcTyp ];j++)
+            ItmTab[ NmbItm++ ] = SrcNod[ (size_t)idx * src->ItmLen + j ];
+   }
+   else if(SrcTyp == GmlVertices)
+   {
+      // A vertex's edges are given by its ball of edges
+      edg = gml->dat[ gml->TypIdx[ GmlEdges ] ];
+      EdgNod = (int *)edg->CpuMem;
+      row = GetBalRow(gml, GmlVertices, GmlEdges, idx, &wid, NULL, &BalIdx, &RowIdx);
+      DegTab = (int *)gml->dat[ gml->CntMat[ GmlVertices ][ GmlEdges ] ]->CpuMem;
+      n = MIN(DegTab[ idx ], wid);
 
-float GmlGetFlops(size_t GmlIdx)
-{
-   GETGMLPTR(gml, GmlIdx);
-   return(gml->FltOpp);
-}
-   
-/*----------------------------------------------------------------------------*/
-/* Turning the printing of debugging information on or off                    */
-/*----------------------------------------------------------------------------*/
+      for(l=0;l<n;l++, NmbItm++)
+      {
+         ItmTab[ NmbItm*2 ] = idx;
+         ItmTab[ NmbItm*2 + 1 ] = EdgNod[ (size_t)row[l] * edg->ItmLen ];
 
-void GmlDebugOn(size_t GmlIdx)
-{
-   GETGMLPTR(gml, GmlIdx);
-   gml->DbgFlg = 1;
-}
+         if(ItmTab[ NmbItm*2 + 1 ] == idx)
+            ItmTab[ NmbItm*2 + 1 ] = EdgNod[ (size_t)row[l] * edg->ItmLen + 1 ];
+      }
+   }
+   else
+   {
+      for(j=0;j<ItmNmbEdg[ SrcTyp ];j++, NmbItm++)
+         for(k=0;k<2;k++)
+            ItmTab[ NmbItm*2 + k ] = SrcNod[ (size_t)idx * src->ItmLen + ItmEdgNod[ SrcTyp ][j][k] ];
+   }
 
-void GmlDebugOff(size_t GmlIdx)
-{
-   GETGMLPTR(gml, GmlIdx);
-   gml->DbgFlg = 0;
-}
+   // Gather the destination entities sharing each item
+   for(l=0;l<NmbItm;l++)
+   {
+      if(DstTyp == GmlVertices)
+      {
+         for(k=0;k<NmbNod;k++)
+            if( (SrcTyp != GmlVertices) || (ItmTab[ l*NmbNod + k ] != idx) )
+               AddCavLst(lst, &NmbLst, ItmTab[ l*NmbNod + k ]);
 
+         continue;
+      }
 
-/*----------------------------------------------------------------------------*/
-/* Check the 64-bit floating point extension GPU's capacity                   */
-/*----------------------------------------------------------------------------*/
+      row = GetBalRow(  gml, GmlVertices, DstTyp, ItmTab[ l*NmbNod ],
+                        &wid, NULL, &BalIdx, &RowIdx );
+      DegTab = (int *)gml->dat[ gml->CntMat[ GmlVertices ][ DstTyp ] ]->CpuMem;
+      n = MIN(DegTab[ ItmTab[ l*NmbNod ] ], wid);
 
-int GmlCheckFP64(size_t GmlIdx)
-{
-   GETGMLPTR(gml, GmlIdx);
-   return(gml->DblExt);
+      for(j=0;j<n;j++)
+      {
+         d = row[j];
+
+         if( (SrcTyp == DstTyp) && (d == idx) )
+            continue;
+
+         for(k=0, hit=(NmbNod == 1); !hit && (k < EleNmbNod[ DstTyp ]); k++)
+            if(DstNod[ (size_t)d * dst->ItmLen + k ] == ItmTab[ l*NmbNod + 1 ])
+               hit = 1;
+
+         if(hit)
+            AddCavLst(lst, &NmbLst, d);
+      }
+   }
+
+   return(NmbLst);
 }
 
 
 /*----------------------------------------------------------------------------*/
-/* Exctract the list of unique volume edges from any kind of elements         */
+/* Allocate an int link table: a single int per line if the width is null,    */
+/* a vector layout otherwise                                                  */
 /*----------------------------------------------------------------------------*/
 
-int GmlExtractEdges(size_t GmlIdx)
+static int NewCavTab(GmlSct *gml, int SrcTyp, int DstTyp, int NmbLin, int wid, const char *nam)
 {
-   int         i, j, typ, cod, HshKey, ItmTab[3], (*EdgTab)[3] = NULL;
-   int         EdgIdx, NmbItm, EleLen, NmbEdg = 0, *EleNod, *nod;
-   int         OldNmbEdg, IdxLst[2], EdgNod[2];
-   DatSct      *dat;
-   HshTabSct   EdgHsh;
+   int      idx, VecCnt = 1, VecSiz, ItmTyp = GmlInt;
+   DatSct   *dat;
 
-   GETGMLPTR(gml, GmlIdx);
+   if(!(idx = GetNewDatIdx(gml)))
+      return(0);
 
-   // Count the number of inner and surface edges
-   for(typ=GmlEdges+1; typ<GmlMaxEleTyp; typ++)
-      if(gml->TypIdx[ typ ])
-         NmbEdg += gml->dat[ gml->TypIdx[ typ ] ].NmbLin;
+   if(wid)
+      GetCntVec(wid, &VecCnt, &VecSiz, &ItmTyp);
 
-   // Setup a hash table
-   memset(&EdgHsh, 0, sizeof(HshTabSct));
-   EdgHsh.HshTyp = GmlEdges;
-   EdgHsh.TabSiz = NmbEdg;
-   EdgHsh.DatLen = ItmNmbVer[ EdgHsh.HshTyp ];
-   EdgHsh.KeyLen = HshLenTab[ EdgHsh.DatLen ];
-   EdgHsh.NmbDat = EdgHsh.TabSiz;
-   EdgHsh.NxtDat = 1;
-   EdgHsh.HshTab = calloc(EdgHsh.TabSiz, sizeof(int));
-   EdgHsh.DatTab = malloc(EdgHsh.TabSiz * sizeof(BucSct));
+   dat = gml->dat[ idx ];
 
-   NmbEdg = 0;
+   dat->AloTyp = GmlLnkDat;
+   dat->MshTyp = SrcTyp;
+   dat->LnkTyp = DstTyp;
+   dat->MemAcs = GmlInout;
+   dat->ItmTyp = ItmTyp;
+   dat->NmbItm = VecCnt;
+   dat->ItmSiz = VecCnt * OclTypSiz[ ItmTyp ];
+   dat->ItmLen = wid;
+   dat->NmbLin = MAX(NmbLin, 1);
+   dat->LinSiz = dat->NmbItm * dat->ItmSiz;
+   dat->MemSiz = (size_t)dat->NmbLin * (size_t)dat->LinSiz;
+   dat->GpuMem = dat->CpuMem = NULL;
+   dat->nam    = strncpy(dat->NamBuf, nam, 15);
+   dat->NamBuf[15] = '\0';
 
-   if(!EdgHsh.HshTab || !EdgHsh.DatTab)
+   if(!NewData(gml, dat))
       return(0);
 
-   if(gml->DbgFlg)
-      printf(  "Hash table: lines=%d, stored items=%d, hash keys=%d\n",
-               (int)EdgHsh.TabSiz, EdgHsh.DatLen, EdgHsh.KeyLen);
-
-   for(typ=GmlEdges+1; typ<GmlMaxEleTyp; typ++)
-   {
-      if(!gml->TypIdx[ typ ])
-         continue;
-
-      dat = &gml->dat[ gml->TypIdx[ typ ] ];
-      EleNod = (int *)dat->CpuMem;
-      EleLen = dat->ItmLen;
-      NmbItm = ItmNmbEdg[ typ ];
+   return(idx);
+}
 
-      // Add edges to the hash table
-      for(i=0;i<dat->NmbLin;i++)
-      {
-         nod = &EleNod[ i * EleLen ];
 
-         for(j=0;j<NmbItm;j++)
-         {
-            GetItmNod(nod, typ, EdgHsh.HshTyp, j, ItmTab);
-            HshKey = CalHshKey(&EdgHsh, ItmTab);
+/*----------------------------------------------------------------------------*/
+/* Get the column of the link matrices storing a link: cavity links are       */
+/* stored past the regular ones, one set of columns per kind of connection    */
+/*----------------------------------------------------------------------------*/
 
-            if(GetHsh(&EdgHsh, HshKey, i, j, ItmTab, NULL, NULL))
-               continue;
+static int GetLnkCol(GmlSct *gml, int SrcTyp, int DstTyp, int LnkIdx)
+{
+   int c;
 
-            AddHsh(&EdgHsh, HshKey, typ, i, j, ItmTab);
-            NmbEdg++;
-         }
-      }
-   }
+   for(c=GmlVertices; c<=GmlEdges; c++)
+      if(LnkIdx && (gml->LnkMat[ SrcTyp ][ CAVCOL(DstTyp, c) ] == LnkIdx))
+         return(CAVCOL(DstTyp, c));
 
-   if(gml->DbgFlg)
-      printf(  "Hashed %d entities: occupency=%d%%, collisions=%g\n",
-               (int)EdgHsh.NxtDat-1, (int)((100 * EdgHsh.NmbHit) / EdgHsh.TabSiz),
-               (double)EdgHsh.NmbMis / (double)EdgHsh.TabSiz );
+   return(DstTyp);
+}
 
-   // If there are surface edges, save their references and hash them
-   GmlGetMeshInfo(GmlIdx, GmlEdges, &OldNmbEdg, &EdgIdx);
 
-   if(OldNmbEdg)
-   {
-      EdgTab = malloc(OldNmbEdg * 3 * sizeof(int));
+/*----------------------------------------------------------------------------*/
+/* Build a cavity link: the list of the destination entities sharing a vertex */
+/* or an edge with each source entity. Vertices linked to vertices through    */
+/* edges give the vertex rings, elements linked to elements through vertices  */
+/* their second ring. The link is made of degree tiers or packed entries as   */
+/* the balls are, and is stored in its own column of the link matrices        */
+/*----------------------------------------------------------------------------*/
 
-      if(!EdgTab)
-         return(0);
+int GmlNewCavityLink(size_t GmlIdx, int SrcTyp, int DstTyp, int ConTyp)
+{
+   int      i, j, p, t, n, col, NmbLin, NmbTie, NmbBal = 0, NmbCut = 0, CsrFlg = 0;
+   int      BalSiz, MaxSiz, MaxDeg, DegIdx, OffIdx, PrmIdx, InvIdx, TabIdx;
+   int      BalIdx, RowIdx, wid, BalTyp[2], TieLin[ MAXTIE+1 ], TieWid[ MAXTIE ];
+   int      BucPos[ MAXTIE ], *DegTab, *OffTab, *PrmTab, *InvTab, *row, lst[ MAXCAVLST ];
+   char     BalNam[ GmlMaxStrSiz ], DegNam[ GmlMaxStrSiz ], VoyNam[ GmlMaxStrSiz ];
+   char     CavNam[ GmlMaxStrSiz ], TabNam[ GmlMaxStrSiz + 4 ];
+   size_t   DegTot = 0, PadTot;
 
-      for(i=0;i<OldNmbEdg;i++)
-          GmlGetDataLine(GmlIdx, EdgIdx, i, &EdgTab[i][0], &EdgTab[i][1], &EdgTab[i][2]);
+   GETGMLPTR(gml, GmlIdx);
+   CHKELETYP(SrcTyp);
+   CHKELETYP(DstTyp);
 
-      // Then free the existing edge data type
-      // and allocate a new one with the increased size
-      GmlFreeData(GmlIdx, EdgIdx);
-      EdgIdx = GmlNewMeshData(GmlIdx, GmlEdges, NmbEdg);
-      NmbEdg = 0;
+   if( ((ConTyp != GmlVertices) && (ConTyp != GmlEdges))
+   ||  !gml->TypIdx[ SrcTyp ] || !gml->TypIdx[ DstTyp ] )
+   {
+      return(0);
+   }
 
-      for(i=0;i<OldNmbEdg;i++)
+   // Vertices reach their edges through their ball of edges
+   if( (SrcTyp == GmlVertices) && (ConTyp == GmlEdges) )
+   {
+      if(!gml->TypIdx[ GmlEdges ])
       {
-         GetItmNod(EdgTab[i], GmlEdges, GmlEdges, 0, EdgNod);
-         HshKey = CalHshKey(&EdgHsh, EdgNod);
+         puts("Edges must be extracted before linking vertices through them.");
+         return(0);
+      }
 
-         // If it is in the hash table, send its data to the GMlib
-         if(GetHsh(&EdgHsh, HshKey, i, 0, EdgNod, IdxLst, NULL) != 1)
-            continue;
+      BalTyp[ NmbBal++ ] = GmlEdges;
+   }
 
-         if(IdxLst[0] >> 4 != i)
-            continue;
+   if(DstTyp != GmlVertices)
+      BalTyp[ NmbBal++ ] = DstTyp;
 
-         GmlSetDataLine(GmlIdx, EdgIdx, NmbEdg, EdgNod[0], EdgNod[1], EdgTab[i][2]);
+   // Get the vertex balls the cavities are gathered from, build them if need be
+   for(i=0;i<NmbBal;i++)
+   {
+      if(!gml->LnkMat[ GmlVertices ][ BalTyp[i] ])
+      {
+         sprintf(BalNam, "%s%sBal", BalTypStr[ GmlVertices ], BalTypStr[ BalTyp[i] ]);
+         sprintf(DegNam, "%s%sDeg", BalTypStr[ GmlVertices ], BalTypStr[ BalTyp[i] ]);
+         sprintf(VoyNam, "%s%sVoy", BalTypStr[ GmlVertices ], BalTypStr[ BalTyp[i] ]);
+         NewBallData(gml, GmlVertices, BalTyp[i], BalNam, DegNam, VoyNam);
+      }
 
-         NmbEdg++;
+      if( !GetHostBall(gml, GmlVertices, BalTyp[i])
+      ||  !GetHostLines(gml, gml->TypIdx[ BalTyp[i] ], 0, gml->dat[ gml->TypIdx[ BalTyp[i] ] ]->NmbLin - 1) )
+      {
+         return(0);
       }
    }
-   else
-   {
-      EdgIdx = GmlNewMeshData(GmlIdx, GmlEdges, NmbEdg);
-      NmbEdg = 0;
-   }
 
-   // Loop over all kinds of elements and setup the inner edges
-   for(typ=GmlEdges+1; typ<GmlMaxEleTyp; typ++)
-   {
-      if(!gml->TypIdx[ typ ])
-         continue;
+   NmbLin = gml->dat[ gml->TypIdx[ SrcTyp ] ]->NmbLin;
 
-      dat = &gml->dat[ gml->TypIdx[ typ ] ];
-      EleNod = (int *)dat->CpuMem;
-      EleLen = dat->ItmLen;
-      NmbItm = ItmNmbEdg[ typ ];
+   if(!GetHostLines(gml, gml->TypIdx[ SrcTyp ], 0, NmbLin - 1))
+      return(0);
 
-      // Get edges from the hash table
-      for(i=0;i<dat->NmbLin;i++)
-      {
-         nod = &EleNod[ i * EleLen ];
+   // Replace a previous link of the same kinds
+   col = CAVCOL(DstTyp, ConTyp);
+   FreeLnkDat(gml, SrcTyp, col);
+   sprintf(CavNam, "%s%s%s", BalTypStr[ SrcTyp ], BalTypStr[ DstTyp ], BalTypStr[ ConTyp ]);
 
-         for(j=0;j<NmbItm;j++)
-         {
-            GetItmNod(nod, typ, EdgHsh.HshTyp, j, ItmTab);
-            HshKey = CalHshKey(&EdgHsh, ItmTab);
-            cod = 0;
+   snprintf(TabNam, sizeof(TabNam), "%sDeg", CavNam);
 
-            if(!GetHsh(&EdgHsh, HshKey, i, j, ItmTab, &cod, NULL))
-               continue;
+   if(!(DegIdx = NewCavTab(gml, SrcTyp, DstTyp, NmbLin, 0, TabNam)))
+      return(0);
 
-            if(cod >> 4 != i)
-               continue;
+   gml->CntMat[ SrcTyp ][ col ] = DegIdx;
+   DegTab = (int *)gml->dat[ DegIdx ]->CpuMem;
 
-            GmlSetDataLine(GmlIdx, EdgIdx, NmbEdg, ItmTab[0], ItmTab[1], 0);
-            NmbEdg++;
-         }
-      }
-   }
-   if(EdgTab)
-      free(EdgTab);
+   // Each source entity counts its own cavity
+#ifdef _OPENMP
+#pragma omp parallel for private(lst) if(NmbLin >= MINPARLIN)
+#endif
+   for(i=0;i<NmbLin;i++)
+      DegTab[i] = GetCavLst(gml, SrcTyp, DstTyp, ConTyp, i, lst);
 
-   free(EdgHsh.HshTab);
-   free(EdgHsh.DatTab);
+   // The base width is the mean degree's power of two and the
+   // widest tier four times as large, longer lines are truncated
+   for(i=0;i<NmbLin;i++)
+      DegTot += DegTab[i];
 
-   if(gml->DbgFlg)
-      printf("Hashed, setup and transfered %d edges to the GMlib.\n", NmbEdg);
+   for(BalSiz=1; (BalSiz < (1 << VECPOWMAX)) && ((size_t)BalSiz * NmbLin < DegTot); BalSiz *= 2);
 
-   return(NmbEdg);
-}
+   MaxSiz = MIN(4 * BalSiz, 1 << VECPOWMAX);
+
+   for(i=0;i<NmbLin;i++)
+      if(DegTab[i] > MaxSiz)
+      {
+         DegTab[i] = MaxSiz;
+         NmbCut++;
+      }
 
+   if(NmbCut)
+      printf("%d cavities truncated to %d entities\n", NmbCut, MaxSiz);
 
-/*----------------------------------------------------------------------------*/
-/* Build the list of inner faces and add them to the existing boundary ones   */
-/*----------------------------------------------------------------------------*/
+   NmbTie = GetTieLay(  NmbLin, DegTab, BalSiz, MaxSiz,
+                        TieLin, TieWid, BucPos, &DegTot, &PadTot );
+   MaxDeg = TieWid[ NmbTie-1 ];
 
-int GmlExtractFaces(size_t GmlIdx)
-{
-   int         i, j, typ, idx, TriIdx, QadIdx, HshKey;
-   int         NmbFac, NmbTri = 0, NmbQad = 0, OldNmbTri, OldNmbQad;
-   int         EleLen, *EleNod, *MshNod, FacNod[4], IdxLst[4];
-   int         (*QadTab)[5], (*TriTab)[4], TypTab[4];
-   DatSct      *dat;
-   HshTabSct   TriHsh, QadHsh;
+   // Same padding rule as the balls to switch to packed entries
+   if(100 * DegTot < CSRMINOCC * PadTot)
+   {
+      CsrFlg = 1;
+      NmbTie = 1;
+      TieLin[1] = NmbLin;
 
-   GETGMLPTR(gml, GmlIdx);
+      snprintf(TabNam, sizeof(TabNam), "%sOff", CavNam);
 
-   // Count the number of inner and surface triangles and quads
-   for(typ=GmlTriangles; typ<GmlMaxEleTyp; typ++)
-      if((idx = gml->TypIdx[ typ ]))
+      if(!(OffIdx = NewCavTab(gml, SrcTyp, DstTyp, NmbLin + 1, 0, TabNam)))
       {
-         NmbTri += gml->dat[ idx ].NmbLin * ItmNmbTri[ typ ];
-         NmbQad += gml->dat[ idx ].NmbLin * ItmNmbQad[ typ ];
+         FreeLnkDat(gml, SrcTyp, col);
+         return(0);
       }
 
-   // Setup a triangle hash table
-   if(NmbTri)
+      gml->CsrMat[ SrcTyp ][ col ] = OffIdx;
+      OffTab = (int *)gml->dat[ OffIdx ]->CpuMem;
+      OffTab[0] = 0;
+
+      for(i=0;i<NmbLin;i++)
+         OffTab[ i+1 ] = OffTab[i] + DegTab[i];
+   }
+   else if(NmbTie > 1)
    {
-      memset(&TriHsh, 0, sizeof(HshTabSct));
-      TriHsh.HshTyp = GmlTriangles;
-      TriHsh.TabSiz = NmbTri;
-      TriHsh.DatLen = ItmNmbVer[ TriHsh.HshTyp ];
-      TriHsh.KeyLen = HshLenTab[ TriHsh.DatLen ];
-      TriHsh.NmbDat = TriHsh.TabSiz;
-      TriHsh.NxtDat = 1;
-      TriHsh.HshTab = calloc(TriHsh.TabSiz, sizeof(int));
-      TriHsh.DatTab = malloc(TriHsh.TabSiz * sizeof(BucSct));
+      // Lines are sorted by tier through a permutation and its inverse
+      snprintf(TabNam, sizeof(TabNam), "%sPrm", CavNam);
+      PrmIdx = NewCavTab(gml, SrcTyp, DstTyp, NmbLin, 0, TabNam);
+      gml->PrmMat[ SrcTyp ][ col ] = PrmIdx;
+      snprintf(TabNam, sizeof(TabNam), "%sInv", CavNam);
+      InvIdx = PrmIdx ? NewCavTab(gml, SrcTyp, DstTyp, NmbLin, 0, TabNam) : 0;
+      gml->InvMat[ SrcTyp ][ col ] = InvIdx;
 
-      if(!TriHsh.HshTab || !TriHsh.DatTab)
+      if(!InvIdx)
+      {
+         FreeLnkDat(gml, SrcTyp, col);
          return(0);
+      }
 
-      NmbTri = 0;
+      PrmTab = (int *)gml->dat[ PrmIdx ]->CpuMem;
+      InvTab = (int *)gml->dat[ InvIdx ]->CpuMem;
 
-      if(gml->DbgFlg)
-         printf(  "Triangle hash table: heads=%d, storage=%d, hash keys=%d\n",
-                  (int)TriHsh.TabSiz, TriHsh.DatLen, TriHsh.KeyLen);
+      for(i=0;i<NmbLin;i++)
+      {
+         p = BucPos[ GetDegBuc(DegTab[i], BalSiz, MaxSiz) ]++;
+         PrmTab[p] = i;
+         InvTab[i] = p;
+      }
    }
 
-   // Setup a quad hash table
-   if(NmbQad)
+   // Allocate the tiers or the packed entries table
+   for(t=0;t<NmbTie;t++)
    {
-      memset(&QadHsh, 0, sizeof(HshTabSct));
-      QadHsh.HshTyp = GmlQuadrilaterals;
-      QadHsh.TabSiz = NmbQad;
-      QadHsh.DatLen = ItmNmbVer[ QadHsh.HshTyp ];
-      QadHsh.KeyLen = HshLenTab[ QadHsh.DatLen ];
-      QadHsh.NmbDat = QadHsh.TabSiz;
-      QadHsh.NxtDat = 1;
-      QadHsh.HshTab = calloc(QadHsh.TabSiz, sizeof(int));
-      QadHsh.DatTab = malloc(QadHsh.TabSiz * sizeof(BucSct));
+      if(CsrFlg)
+         TabIdx = NewCavTab(gml, SrcTyp, DstTyp, (int)DegTot, 0, CavNam);
+      else
+         TabIdx = NewCavTab(gml, SrcTyp, DstTyp, TieLin[ t+1 ] - TieLin[t], TieWid[t], CavNam);
 
-      if(!QadHsh.HshTab || !QadHsh.DatTab)
+      if(!TabIdx)
+      {
+         FreeLnkDat(gml, SrcTyp, col);
          return(0);
+      }
 
-      NmbQad = 0;
+      if(CsrFlg)
+         gml->dat[ TabIdx ]->ItmLen = MaxDeg;
 
-      if(gml->DbgFlg)
-         printf(  "Quad hash table: heads=%d, storage=%d, hash keys=%d\n",
-                  (int)QadHsh.TabSiz, QadHsh.DatLen, QadHsh.KeyLen);
+      gml->TieMat[ SrcTyp ][ col ][t] = TabIdx;
+      gml->TieLin[ SrcTyp ][ col ][t] = TieLin[t];
+      gml->TieLin[ SrcTyp ][ col ][ t+1 ] = NmbLin;
+      gml->NmbTie[ SrcTyp ][ col ] = t+1;
    }
 
-   // Loop over each element of each type
-   for(typ=GmlTriangles; typ<GmlMaxEleTyp; typ++)
+   gml->LnkMat[ SrcTyp ][ col ] = gml->TieMat[ SrcTyp ][ col ][0];
+
+   // Each source entity writes its own line
+#ifdef _OPENMP
+#pragma omp parallel for private(j, n, lst, row, wid, BalIdx, RowIdx) if(NmbLin >= MINPARLIN)
+#endif
+   for(i=0;i<NmbLin;i++)
    {
-      if(!gml->TypIdx[ typ ])
-         continue;
+      n = GetCavLst(gml, SrcTyp, DstTyp, ConTyp, i, lst);
+      row = GetBalRow(gml, SrcTyp, col, i, &wid, NULL, &BalIdx, &RowIdx);
 
-      // Get the nodes pointer, table width and the number of faces
-      dat = &gml->dat[ gml->TypIdx[ typ ] ];
-      MshNod = (int *)dat->CpuMem;
-      EleLen = dat->ItmLen;
-      NmbFac = ItmNmbFac[ typ ];
+      for(j=0;j<wid;j++)
+         row[j] = (j < n) ? lst[j] : 0;
+   }
 
-      // Add faces to the dedicated hash table
-      for(i=0;i<dat->NmbLin;i++)
-      {
-         EleNod = &MshNod[ i * EleLen ];
+   UploadData(gml, DegIdx);
 
-         for(j=0;j<NmbFac;j++)
-         {
-            // Add a triangle to the hash table
-            if(ItmFacDeg[ typ ][j] == 3)
-            {
-               // Get its nodes and hash key
-               GetItmNod(EleNod, typ, TriHsh.HshTyp, j, FacNod);
-               HshKey = CalHshKey(&TriHsh, FacNod);
+   if(CsrFlg)
+      UploadData(gml, gml->CsrMat[ SrcTyp ][ col ]);
 
-               // If it is not in the hash table, add it
-               if(!GetHsh(&TriHsh, HshKey, i, j, FacNod, NULL, NULL))
-               {
-                  AddHsh(&TriHsh, HshKey, typ, i, j, FacNod);
-                  NmbTri++;
-               }
-            }
-            else if(ItmFacDeg[ typ ][j] == 4)
-            {
-               // Add a quad to the hash table
-               GetItmNod(EleNod, typ, QadHsh.HshTyp, j, FacNod);
-               HshKey = CalHshKey(&QadHsh, FacNod);
+   if(gml->PrmMat[ SrcTyp ][ col ])
+   {
+      UploadData(gml, gml->PrmMat[ SrcTyp ][ col ]);
+      UploadData(gml, gml->InvMat[ SrcTyp ][ col ]);
+   }
 
-               // If it is not in the hash table, add it
-               if(!GetHsh(&QadHsh, HshKey, i, j, FacNod, NULL, NULL))
-               {
-                  AddHsh(&QadHsh, HshKey, typ, i, j, FacNod);
-                  NmbQad++;
-               }
-            }
-            else
-               continue;
-         }
-      }
+   for(t=0;t<NmbTie;t++)
+      UploadData(gml, gml->TieMat[ SrcTyp ][ col ][t]);
+
+   if(gml->DbgFlg)
+   {
+      puts(sep);
+      printf(  "Cavity link %s: %zu entries, %d tiers up to width %d, occupency = %g%%\n",
+               CavNam, DegTot, NmbTie, MaxDeg, (100. * DegTot) / (double)MAX(PadTot, 1) );
    }
 
-   if(gml->DbgFlg && NmbTri)
-      printf(  "Hashed %d triangles: occupency=%d%%, collisions=%g\n",
-               (int)TriHsh.NxtDat-1, (int)((100 * TriHsh.NmbHit) / TriHsh.TabSiz),
-               (double)TriHsh.NmbMis / (double)TriHsh.TabSiz );
+   return(gml->LnkMat[ SrcTyp ][ col ]);
+}
 
-   if(gml->DbgFlg && NmbQad)
-      printf(  "Hashed %d quads: occupency=%d%%, collisions=%g\n",
-               (int)QadHsh.NxtDat-1, (int)((100 * QadHsh.NmbHit) / QadHsh.TabSiz),
-               (double)QadHsh.NmbMis / (double)QadHsh.TabSiz );
 
-   // Setup a new triangle data type and transfer the old data
-   if(NmbTri)
-   {
-      // If there are surface triangles, save their references
-      GmlGetMeshInfo(GmlIdx, GmlTriangles, &OldNmbTri, &TriIdx);
+/*----------------------------------------------------------------------------*/
+/* Update the links after a local mesh modification: the listed elements were */
+/* given new nodes through GmlSetDataLine and OldNod holds their previous     */
+/* ones. Downlinks, balls, shells and neighbours are modified in place on the */
+/* host and only the changed lines are uploaded. Lower dimension kinds must   */
+/* be updated first as their balls are used to search the downlinks           */
+/*----------------------------------------------------------------------------*/
 
-      TriTab = malloc(OldNmbTri * 4 * sizeof(int));
+int GmlUpdateLinks(size_t GmlIdx, int EleTyp, int NmbEle, int *EleTab, int *OldNod)
+{
+   int      i, j, k, e, n, typ, res = 1, NmbItm, NmbKey, EleLen, ItmNod[4], HshTyp, NmbNod;
+   int      NmbMod, NmbNgb, NmbLst, CurTab[ MAXTIE ], *EleNod, *NewKey, *OldKey;
+   int      *LnkTab, *NgbLst, *OldLnk[ GmlMaxEleTyp ] = {NULL};
+   char     BalNam[ GmlMaxStrSiz ], DegNam[ GmlMaxStrSiz ], *TagTab, *KndTab;
+   size_t   LnkStr;
+   DatSct   *ele, *lnk, *knd = NULL;
 
-      if(!TriTab)
-         return(0);
+   GETGMLPTR(gml, GmlIdx);
+   CHKELETYP(EleTyp);
 
-      for(i=0;i<OldNmbTri;i++)
-          GmlGetDataLine(GmlIdx, TriIdx, i, &TriTab[i][0], &TriTab[i][1],
-                        &TriTab[i][2], &TriTab[i][3]);
+   // Vertices carry no nodes
+   if( (EleTyp == GmlVertices) || !NmbEle )
+      return(1);
 
-      // Then free the existing triangle data type
-      // and allocate a new one with the increased size
-      GmlFreeData(GmlIdx, TriIdx);
-      TriIdx = GmlNewMeshData(GmlIdx, GmlTriangles, NmbTri);
-      NmbTri = 0;
+   if(!gml->TypIdx[ EleTyp ])
+      return(0);
 
-      for(i=0;i<OldNmbTri;i++)
+   // Neighbours are only searched among the same kind of elements: those
+   // set across several kinds of the same dimension cannot be updated
+   for(typ=GmlEdges; typ<GmlMaxEleTyp; typ++)
+      if( (typ != EleTyp) && (MshTypDim[ typ ] == MshTypDim[ EleTyp ])
+      &&  gml->TypIdx[ typ ] && (gml->NgbTag[ EleTyp ] || gml->NgbTag[ typ ]) )
       {
-         GetItmNod(TriTab[i], GmlTriangles, GmlTriangles, 0, FacNod);
-         HshKey = CalHshKey(&TriHsh, FacNod);
-
-         // If it is in the hash table, send its data to the GMlib
-         if(GetHsh(&TriHsh, HshKey, i, j, FacNod, IdxLst, NULL) != 1)
-            continue;
+         printf(  "Updating the neighbours between %s and %s is not supported, they should be rebuilt.\n",
+                  BalTypStr[ EleTyp ], BalTypStr[ typ ] );
+         return(0);
+      }
 
-         if(IdxLst[0] >> 4 != i)
-            continue;
+   ele = gml->dat[ gml->TypIdx[ EleTyp ] ];
 
-         GmlSetDataLine(GmlIdx, TriIdx, NmbTri, FacNod[0],
-                        FacNod[1], FacNod[2], TriTab[i][3]);
+   if(!GetHostLines(gml, gml->TypIdx[ EleTyp ], 0, ele->NmbLin - 1))
+      return(0);
 
-         NmbTri++;
-      }
-   }
+   EleNod = (int *)ele->CpuMem;
+   EleLen = ele->ItmLen;
 
-   // Setup a new quad data type
-   if(NmbQad)
+   // Search the modified elements' downlinks in the
+   // balls of their items' first vertex
+   for(typ=GmlEdges; res && (typ<EleTyp); typ++)
    {
-      // If there are surface quads, save their references
-      GmlGetMeshInfo(GmlIdx, GmlQuadrilaterals, &OldNmbQad, &QadIdx);
-      QadTab = malloc(OldNmbQad * 5 * sizeof(int));
+      if(!gml->LnkMat[ EleTyp ][ typ ] || !gml->TypIdx[ typ ])
+         continue;
 
-      if(!QadTab)
-         return(0);
+      if(!gml->LnkMat[ GmlVertices ][ typ ])
+      {
+         sprintf(BalNam, "%s%sBal", BalTypStr[ GmlVertices ], BalTypStr[ typ ]);
+         sprintf(DegNam, "%s%sDeg", BalTypStr[ GmlVertices ], BalTypStr[ typ ]);
+         NewBallData(gml, GmlVertices, typ, BalNam, DegNam, NULL);
+      }
 
-      for(i=0;i<OldNmbQad;i++)
-         GmlGetDataLine(GmlIdx, QadIdx, i, &QadTab[i][0], &QadTab[i][1],
-                        &QadTab[i][2], &QadTab[i][3], &QadTab[i][4]);
+      lnk = gml->dat[ gml->LnkMat[ EleTyp ][ typ ] ];
+      NmbItm = NmbTpoLnk[ EleTyp ][ typ ];
+      LnkStr = lnk->LinSiz / lnk->NmbItm;
 
-      // Then free the existing quad data type
-      // and allocate a new one with the increased size
-      GmlFreeData(GmlIdx, QadIdx);
-      QadIdx = GmlNewMeshData(GmlIdx, GmlQuadrilaterals, NmbQad);
-      NmbQad = 0;
+      if( !GetHostBall(gml, GmlVertices, typ)
+      ||  !GetHostLines(gml, gml->TypIdx[ typ ], 0, gml->dat[ gml->TypIdx[ typ ] ]->NmbLin - 1)
+      ||  !GetHostLines(gml, gml->LnkMat[ EleTyp ][ typ ], 0, lnk->NmbLin - 1)
+      ||  !(OldLnk[ typ ] = malloc((size_t)NmbEle * NmbItm * sizeof(int))) )
+      {
+         res = 0;
+         break;
+      }
 
-      for(i=0;i<OldNmbQad;i++)
+      // Keep the previous downlinks as they are the old shells' keys
+      for(e=0; res && (e<NmbEle); e++)
       {
-         GetItmNod(QadTab[i], GmlQuadrilaterals, GmlQuadrilaterals, 0, FacNod);
-         HshKey = CalHshKey(&QadHsh, FacNod);
+         LnkTab = (int *)((char *)lnk->CpuMem + (size_t)EleTab[e] * LnkStr);
+         memcpy(&OldLnk[ typ ][ e * NmbItm ], LnkTab, NmbItm * sizeof(int));
 
-         // If it is in the hash table, send its data to the GMlib
-         if(GetHsh(&QadHsh, HshKey, i, j, FacNod, IdxLst, NULL) != 1)
-            continue;
+         for(j=0;j<NmbItm;j++)
+         {
+            GetItmNod(&EleNod[ (size_t)EleTab[e] * EleLen ], EleTyp, typ, j, ItmNod);
 
-         if(IdxLst[0] >> 4 != i)
-            continue;
+            // New items must have been added to their mesh table beforehand
+            if((n = SchBal(gml, typ, ItmNod, ItmNmbVer[ typ ], EleTab[e], -1)) < 0)
+            {
+               printf(  "The %s %d of the %s %d is not in the mesh.\n",
+                        BalTypStr[ typ ], j, BalTypStr[ EleTyp ], EleTab[e] );
+               res = 0;
+               break;
+            }
 
-         GmlSetDataLine(GmlIdx, QadIdx, NmbQad, FacNod[0],
-                        FacNod[1], FacNod[2], FacNod[3], QadTab[i][3]);
+            LnkTab[j] = n;
+         }
 
-         NmbQad++;
+         SetDirtyRow(gml, gml->LnkMat[ EleTyp ][ typ ], EleTab[e]);
       }
    }
 
-   // Loop over all kinds of elements and setup the faces
-   for(typ=GmlTetrahedra; typ<=GmlHexahedra; typ++)
+   // Remove the elements from their old balls and shells
+   // and insert them in the new ones
+   for(typ=GmlVertices; res && (typ<EleTyp); typ++)
    {
-      if(!gml->TypIdx[ typ ])
+      if(!gml->NmbTie[ typ ][ EleTyp ] || !gml->CntMat[ typ ][ EleTyp ])
          continue;
 
-      // Get the nodes pointer, table width and the number of faces
-      dat = &gml->dat[ gml->TypIdx[ typ ] ];
-      MshNod = (int *)dat->CpuMem;
-      EleLen = dat->ItmLen;
-      NmbFac = ItmNmbFac[ typ ];
-
-      // Get edges from the hash table
-      for(i=0;i<dat->NmbLin;i++)
+      if( (typ != GmlVertices) && !OldLnk[ typ ] )
       {
-         EleNod = &MshNod[ i * EleLen ];
+         printf(  "Updating the %s shells requires their downlinks.\n",
+                  BalTypStr[ typ ] );
+         res = 0;
+         break;
+      }
 
-         for(j=0;j<NmbFac;j++)
-         {
-            // Get a triangle to the hash table
-            if(ItmFacDeg[ typ ][j] == 3)
-            {
-               // Get its nodes and hash key
-               GetItmNod(EleNod, typ, TriHsh.HshTyp, j, FacNod);
-               HshKey = CalHshKey(&TriHsh, FacNod);
+      if(!GetHostBall(gml, typ, EleTyp))
+      {
+         res = 0;
+         break;
+      }
 
-               // If it is in the hash table, send its data to the GMlib
-               if(GetHsh(&TriHsh, HshKey, i, j, FacNod, IdxLst, TypTab) != 1)
-                  continue;
+      // Packed entries are refilled as a whole
+      if(gml->CsrMat[ typ ][ EleTyp ])
+      {
+         SetCsrBal(gml, typ, EleTyp);
+         continue;
+      }
 
-               if( (IdxLst[0] >> 4 != i) || (TypTab[0] != typ) )
-                  continue;
+      if(typ == GmlVertices)
+         NmbKey = EleNmbNod[ EleTyp ];
+      else
+         NmbKey = NmbTpoLnk[ EleTyp ][ typ ];
 
-               GmlSetDataLine(GmlIdx, TriIdx, NmbTri, FacNod[0],
-                              FacNod[1], FacNod[2], 0);
+      lnk = (typ == GmlVertices) ? NULL : gml->dat[ gml->LnkMat[ EleTyp ][ typ ] ];
 
-               NmbTri++;
-            }
-            else if(ItmFacDeg[ typ ][j] == 4)
-            {
-               // Get the quad's nodes and hash key
-               GetItmNod(EleNod, typ, QadHsh.HshTyp, j, FacNod);
-               HshKey = CalHshKey(&QadHsh, FacNod);
+      for(e=0;e<NmbEle;e++)
+      {
+         OldKey = lnk ? &OldLnk[ typ ][ e * NmbKey ] : &OldNod[ e * NmbKey ];
 
-               // If it is in the hash table, send its data to the GMlib
-               if(GetHsh(&QadHsh, HshKey, i, j, FacNod, IdxLst, TypTab) != 1)
-                  continue;
+         for(j=0;j<NmbKey;j++)
+            DelBalEnt(gml, typ, EleTyp, OldKey[j], EleTab[e], j);
+      }
 
-               if( (IdxLst[0] >> 4 != i) || (TypTab[0] != typ) )
-                  continue;
+      for(k=0;k<MAXTIE;k++)
+         CurTab[k] = 0;
 
-               GmlSetDataLine(GmlIdx, QadIdx, NmbQad, FacNod[0],
-                              FacNod[1], FacNod[2], FacNod[3], 0);
+      for(e=0;e<NmbEle;e++)
+      {
+         if(lnk)
+            NewKey = (int *)((char *)lnk->CpuMem
+                   + (size_t)EleTab[e] * (lnk->LinSiz / lnk->NmbItm));
+         else
+            NewKey = &EleNod[ (size_t)EleTab[e] * EleLen ];
 
-               NmbQad++;
-            }
-            else
-               continue;
-         }
+         for(j=0;j<NmbKey;j++)
+            if(!AddBalEnt(gml, typ, EleTyp, NewKey[j], EleTab[e], j, CurTab))
+               res = 0;
       }
-   }
-
-   // Cleanup hash and ref tables
-   if(NmbTri)
-   {
-      free(TriTab);
-      free(TriHsh.HshTab);
-      free(TriHsh.DatTab);
 
-      if(gml->DbgFlg)
-         printf("Hashed, setup and transfered %d triangles to the GMlib.\n", NmbTri);
+      if(!res)
+         printf(  "Could not move some %s-%s lines to a wider tier, the links should be rebuilt.\n",
+                  BalTypStr[ typ ], BalTypStr[ EleTyp ] );
    }
 
-   if(NmbQad)
+   // Neighbours are searched in the elements' vertex balls: recompute the
+   // modified elements and their old neighbours, then their new neighbours
+   if(res && gml->LnkMat[ EleTyp ][ EleTyp ] && (NgbTyp[ EleTyp ] >= 0))
    {
-      free(QadTab);
-      free(QadHsh.HshTab);
-      free(QadHsh.DatTab);
-
-      if(gml->DbgFlg)
-         printf("Hashed, setup and transfered %d quads to the GMlib.\n", NmbQad);
-   }
-
-   // As there are two resulting values, return the sum instead of the data index
-   return(NmbTri + NmbQad);
-}
+      if(!gml->LnkMat[ GmlVertices ][ EleTyp ])
+      {
+         sprintf(BalNam, "%s%sBal", BalTypStr[ GmlVertices ], BalTypStr[ EleTyp ]);
+         sprintf(DegNam, "%s%sDeg", BalTypStr[ GmlVertices ], BalTypStr[ EleTyp ]);
+         NewBallData(gml, GmlVertices, EleTyp, BalNam, DegNam, NULL);
+      }
 
+      // Faces are listed and read as in GmlSetNeighbours,
+      // pyramids and prisms mixing triangles and quads
+      if(MshTypDim[ EleTyp ] == 1)
+      {
+         HshTyp = GmlVertices;
+         NmbItm = 2;
+      }
+      else if(MshTypDim[ EleTyp ] == 2)
+      {
+         HshTyp = GmlEdges;
+         NmbItm = ItmNmbEdg[ EleTyp ];
+      }
+      else
+      {
+         HshTyp = GmlQuadrilaterals;
+         NmbItm = ItmNmbFac[ EleTyp ];
+      }
 
-/*----------------------------------------------------------------------------*/
-/* Build, allocate and transfer neighbourhood information                     */
-/*----------------------------------------------------------------------------*/
+      lnk = gml->dat[ gml->LnkMat[ EleTyp ][ EleTyp ] ];
+      LnkStr = lnk->LinSiz / lnk->NmbItm;
+      TagTab = calloc(ele->NmbLin, sizeof(char));
+      NgbLst = malloc((size_t)NmbEle * (2 * NmbItm + 1) * sizeof(int));
 
-int GmlSetNeighbours(size_t GmlIdx, int typ)
-{
-   int         i, j, k, cpt, cod[2], HshKey, ItmTab[4], TetNgb[4];
-   int         NgbIdx;
-   int         NmbItm, EleLen, *EleNod, *nod;
-   DatSct      *dat;
-   HshTabSct   lnk;
+      // The neighbours' kinds set along with them are rewritten too
+      if(gml->NgbTag[ EleTyp ])
+         knd = gml->dat[ gml->NgbTag[ EleTyp ] ];
 
-   if(typ == GmlPyramids || typ == GmlPrisms)
-   {
-      puts("Neighbours calculation between prisms or pyramids is not yet implemented.");
-      return(0);
-   }
+      if( !TagTab || !NgbLst || !GetHostBall(gml, GmlVertices, EleTyp)
+      ||  !GetHostLines(gml, gml->LnkMat[ EleTyp ][ EleTyp ], 0, lnk->NmbLin - 1)
+      ||  (knd && !GetHostLines(gml, gml->NgbTag[ EleTyp ], 0, knd->NmbLin - 1)) )
+      {
+         res = 0;
+      }
+      else
+      {
+         NmbLst = 0;
 
-   GETGMLPTR(gml, GmlIdx);
+         for(e=0;e<NmbEle;e++)
+            if(!TagTab[ EleTab[e] ])
+            {
+               TagTab[ EleTab[e] ] = 1;
+               NgbLst[ NmbLst++ ] = EleTab[e];
+            }
 
-   // Get and check the source and destination mesh datatypes
-   CHKELETYP(typ);
-   dat = &gml->dat[ gml->TypIdx[ typ ] ];
-   EleNod = (int *)dat->CpuMem;
+         NmbMod = NmbLst;
 
-   // Setup a hash table
-   memset(&lnk, 0, sizeof(HshTabSct));
-   lnk.HshTyp = NgbTyp[ typ ];
-   lnk.TabSiz = dat->NmbLin * NmbTpoLnk[ typ ][ typ ] / 2;
-   lnk.DatLen = ItmNmbVer[ lnk.HshTyp ];
-   lnk.KeyLen = HshLenTab[ lnk.DatLen ];
-   lnk.NmbDat = lnk.TabSiz;
-   lnk.NxtDat = 1;
-   lnk.HshTab = calloc(lnk.TabSiz, sizeof(int));
-   lnk.DatTab = malloc(lnk.TabSiz * sizeof(BucSct));
+         // Without the kinds, a zero neighbour cannot be told from none
+         for(e=0;e<NmbEle;e++)
+         {
+            LnkTab = (int *)((char *)lnk->CpuMem + (size_t)EleTab[e] * LnkStr);
+            KndTab = knd ? (char *)knd->CpuMem + (size_t)EleTab[e] * knd->LinSiz : NULL;
 
-   if(!lnk.HshTab || !lnk.DatTab)
-      return(0);
+            for(j=0;j<NmbItm;j++)
+               if( (LnkTab[j] || (KndTab && (KndTab[j] >= 0))) && !TagTab[ LnkTab[j] ] )
+               {
+                  TagTab[ LnkTab[j] ] = 1;
+                  NgbLst[ NmbLst++ ] = LnkTab[j];
+               }
+         }
 
-   if(gml->DbgFlg)
-      printf(  "Hash table: lines=%d, stored items=%d, hash keys=%d\n",
-               (int)lnk.TabSiz, lnk.DatLen, lnk.KeyLen);
+         // The second pass adds the new neighbours of the modified elements:
+         // those of the old neighbours are either listed or unchanged, which
+         // bounds the list to NmbEle * (2 * NmbItm + 1) entries
+         for(k=0, NmbNgb=NmbLst; k<2; k++)
+         {
+            for(i=(k ? NmbNgb : 0); i<(k ? NmbLst : NmbNgb); i++)
+            {
+               e = NgbLst[i];
+               LnkTab = (int *)((char *)lnk->CpuMem + (size_t)e * LnkStr);
+               KndTab = knd ? (char *)knd->CpuMem + (size_t)e * knd->LinSiz : NULL;
 
-   NmbItm = NmbTpoLnk[ typ ][ lnk.HshTyp ];
-   EleLen = ItmNmbVer[ typ ];
+               for(j=0;j<NmbItm;j++)
+               {
+                  GetNgbFac(&EleNod[ (size_t)e * EleLen ], EleTyp, HshTyp, j, ItmNod);
+                  NmbNod = ( (HshTyp == GmlQuadrilaterals) && (ItmNod[3] < 0) ) ? 3 : ItmNmbVer[ HshTyp ];
+                  n = SchBal(gml, EleTyp, ItmNod, NmbNod, e, 0);
+                  LnkTab[j] = MAX(n, 0);
+
+                  if(KndTab)
+                     KndTab[j] = (char)((n >= 0) ? EleTyp : -1);
+
+                  if(!k && (i < NmbMod) && (n >= 0) && !TagTab[n])
+                  {
+                     TagTab[n] = 1;
+                     NgbLst[ NmbLst++ ] = n;
+                  }
+               }
 
-   // Add destination entities to the hash table
-   for(i=0;i<dat->NmbLin;i++)
-   {
-      nod = &EleNod[ i * EleLen ];
+               SetDirtyRow(gml, gml->LnkMat[ EleTyp ][ EleTyp ], e);
 
-      for(j=0;j<NmbItm;j++)
-      {
-         GetItmNod(nod, typ, lnk.HshTyp, j, ItmTab);
-         HshKey = CalHshKey(&lnk, ItmTab);
-         AddHsh(&lnk, HshKey, typ, i, j, ItmTab);
+               if(knd)
+                  SetDirtyLines(gml, gml->NgbTag[ EleTyp ], e, e);
+            }
+         }
       }
-   }
 
-   if(gml->DbgFlg)
-      printf(  "Hashed %d entities: occupency=%d%%, collisions=%g\n",
-               (int)lnk.NmbDat, (int)((100 * lnk.NmbHit) / lnk.TabSiz),
-               (double)lnk.NmbMis / (double)lnk.TabSiz );
+      if(TagTab)
+         free(TagTab);
 
-   // Build downlinks and neighbours
-   NgbIdx = GmlNewLinkData(GmlIdx, typ, typ, ItmNmbFac[ typ ], "ngb");
+      if(NgbLst)
+         free(NgbLst);
+   }
 
-   for(i=0;i<dat->NmbLin;i++)
-   {
-      nod = &EleNod[ i * EleLen ];
+   for(typ=0;typ<GmlMaxEleTyp;typ++)
+      if(OldLnk[ typ ])
+         free(OldLnk[ typ ]);
 
-      for(j=0;j<NmbItm;j++)
+   // Send the modified lines to the device
+   for(i=1;i<=gml->MaxDat;i++)
+      if( gml->dat[i] && ((gml->dat[i]->AloTyp == GmlLnkDat) || (i == gml->NgbTag[ EleTyp ]))
+      &&  (gml->dat[i]->DrtBeg <= gml->dat[i]->DrtEnd) )
       {
-         GetItmNod(nod, typ, lnk.HshTyp, j, ItmTab);
-         HshKey = CalHshKey(&lnk, ItmTab);
-         cpt = GetHsh(&lnk, HshKey, i, j, ItmTab, cod, NULL);
-         TetNgb[j] = 0;
-
-         for(k=0;k<cpt;k++)
-            if(cod[k] >> 4 != i)
-               TetNgb[j] = cod[k] >> 4;
+         UploadLines(gml, i, gml->dat[i]->DrtBeg, gml->dat[i]->DrtEnd);
       }
 
-      GmlSetDataLine(GmlIdx, NgbIdx, i, &TetNgb);
-   }
-
-   if(gml->DbgFlg)
-      printf("Stored %d uniq entries in the link table\n", dat->NmbLin * NmbItm);
-
-   free(lnk.HshTab);
-   free(lnk.DatTab);
-
-   return(NgbIdx);
+   return(res);
 }
 
 
@@ -4284,7 +9682,7 @@ int GmlGetMeshInfo(size_t GmlIdx, int typ, int *NmbLin, int *DatIdx)
    if(!(idx = gml->TypIdx[ typ ]))
       return(0);
 
-   if(!(dat = &gml->dat[ idx ]))
+   if(!(dat = gml->dat[ idx ]))
       return(0);
 
    if(!dat->NmbLin)
@@ -4301,7 +9699,8 @@ int GmlGetMeshInfo(size_t GmlIdx, int typ, int *NmbLin, int *DatIdx)
 
 
 /*----------------------------------------------------------------------------*/
-/* Return an internal link lengths and widths                                 */
+/* Return an internal link lengths and widths: the first degree tier's ones   */
+/* and the number of lines and maximum width of all higher tiers              */
 /*----------------------------------------------------------------------------*/
 
 int GmlGetLinkInfo(  size_t GmlIdx, int SrcTyp, int DstTyp,
@@ -4310,27 +9709,25 @@ int GmlGetLinkInfo(  size_t GmlIdx, int SrcTyp, int DstTyp,
    GETGMLPTR   (gml, GmlIdx);
    CHKELETYP   (SrcTyp);
    CHKELETYP   (DstTyp);
-   int         BalIdx, HghIdx;
+   int         t, BalIdx;
    DatSct      *BalDat, *HghDat;
 
    BalIdx = gml->LnkMat[ SrcTyp ][ DstTyp ];
-   HghIdx = gml->LnkHgh[ SrcTyp ][ DstTyp ];
 
    if(!BalIdx)
       return(0);
 
-   BalDat = &gml->dat[ BalIdx ];
+   BalDat = gml->dat[ BalIdx ];
    *n = BalDat->NmbLin;
    *w = BalDat->ItmLen;
+   *N = *W = 0;
 
-   if(HghIdx)
+   for(t=1;t<gml->NmbTie[ SrcTyp ][ DstTyp ];t++)
    {
-      HghDat = &gml->dat[ HghIdx ];
-      *N = HghDat->NmbLin;
-      *W = HghDat->ItmLen;
+      HghDat = gml->dat[ gml->TieMat[ SrcTyp ][ DstTyp ][t] ];
+      *N += HghDat->NmbLin;
+      *W  = MAX(*W, HghDat->ItmLen);
    }
-   else
-      *N = *W = 0;
 
    return(1);
 }
@@ -4346,11 +9743,13 @@ double GmlGetKernelRunTime(size_t GmlIdx, int KrnIdx)
    int      i;
    double   RunTim = 0.;
    cl_ulong start, end;
-   KrnSct   *krn = &gml->krn[ KrnIdx ];
+   KrnSct   *krn;
 
-   if( (KrnIdx < 1) || (KrnIdx > gml->NmbKrn) || !krn->kernel )
+   if( (KrnIdx < 1) || (KrnIdx > gml->MaxKrn) || !gml->krn[ KrnIdx ]->kernel )
       return(-1);
 
+   krn = gml->krn[ KrnIdx ];
+
    for(i=0;i<krn->NmbEvt;i++)
    {
       if( (clGetEventProfilingInfo( krn->EvtTab[i], CL_PROFILING_COMMAND_QUEUED,
@@ -4418,7 +9817,7 @@ float GmlEvaluateNumbering(size_t GmlIdx)
       if(!gml->TypIdx[ typ ])
          continue;
 
-      dat = &gml->dat[ gml->TypIdx[ typ ] ];
+      dat = gml->dat[ gml->TypIdx[ typ ] ];
       EleTab = (int *)dat->CpuMem;
 
       for(i=0;i<dat->NmbLin;i++)
@@ -4479,9 +9878,11 @@ static int Gmf2Gml(int kwd)
 
 int GmlImportMesh(size_t GmlIdx, char *MshNam, ...)
 {
+   GETGMLPTR(gml, GmlIdx);
    int         i, j, k, NmbLin, typ, ver, dim, kwd, DatIdx, NmbKwd = 0, EleSiz;
    int         KwdTab[10][4]={0}, *RefTab, *EleTab;
    float       (*CrdTab)[3];
+   double      (*DblCrd)[3];
    int64_t     InpMsh;
    va_list     VarArg;
 
@@ -4532,7 +9933,27 @@ int GmlImportMesh(size_t GmlIdx, char *MshNam, ...)
       KwdTab[k][2] = NmbLin;
       KwdTab[k][3] = DatIdx;
 
-      if(typ == GmlVertices)
+      if( (typ == GmlVertices) && (gml->CrdTyp == GmlDbl4) )
+      {
+         // Keep the file's full precision with double coordinates
+         DblCrd = malloc( (NmbLin+1) * 3 * sizeof(double));
+         RefTab = malloc( (NmbLin+1)     * sizeof(int));
+
+         if(!DblCrd || !RefTab)
+            return(0);
+
+         GmfGetBlock(InpMsh, GmfVertices, 1, NmbLin, 0, NULL, NULL,
+                     GmfDoubleVec, 3, DblCrd[1],  DblCrd[ NmbLin ],
+                     GmfInt,         &RefTab[1], &RefTab[ NmbLin ]);
+
+         GmlSetDataBlock(  GmlIdx, GmlVertices, 0, NmbLin-1,
+                            DblCrd[1],  DblCrd[ NmbLin],
+                           &RefTab[1], &RefTab[ NmbLin ]);
+
+         free(DblCrd);
+         free(RefTab);
+      }
+      else if(typ == GmlVertices)
       {
          CrdTab = malloc( (NmbLin+1) * 3 * sizeof(float));
          RefTab = malloc( (NmbLin+1)     * sizeof(int));
@@ -4605,7 +10026,7 @@ int GmlExportSolution(size_t GmlIdx, char *SolNam, ...)
    // Scan each user's GML datatypes
    while( (DatIdx = va_arg(VarArg, int)) && (NmbDat < 10) )
    {
-      if(!(dat = &gml->dat[ DatIdx ]))
+      if(!(dat = gml->dat[ DatIdx ]) || !dat->CpuMem)
          continue;
 
       // Add a new GML datatyp to the list and download its data from the GPU
@@ -4696,7 +10117,7 @@ int GmlExportSolution(size_t GmlIdx, char *SolNam, ...)
 
    for(i=0;i<NmbKwd;i++)
       for(j=0; j<KwdDatTab[i][1]; j++)
-         for(k=0; k<gml->dat[ DatTab[ KwdDatTab[i][ j+4 ] ][0] ].ItmLen; k++)
+         for(k=0; k<gml->dat[ DatTab[ KwdDatTab[i][ j+4 ] ][0] ]->ItmLen; k++)
             cpt++;
 
    // Set the ref comment strings with user's data names
@@ -4715,7 +10136,7 @@ int GmlExportSolution(size_t GmlIdx, char *SolNam, ...)
       for(j=0;j<NmbFld;j++)
       {
          DatIdx = DatTab[ KwdDatTab[i][ j+4 ] ][0];
-         dat = &gml->dat[ DatIdx ];
+         dat = gml->dat[ DatIdx ];
 
          for(k=0;k<dat->ItmLen;k++)
          {
@@ -40,7 +40,7 @@
 
 
 /*----------------------------------------------------------------------------*/
-/* Set max user data                                                          */
+/* Initial sizes of the growable user data tables and max sizes               */
 /*----------------------------------------------------------------------------*/
 
 #define GmlMaxDat    100
@@ -55,6 +55,7 @@
 #define GmlWriteMode 4
 #define GmlVoyeurs   8
 #define GmlManual    16
+#define GmlDeviceOnly 32
 #ifndef MAX_WORKGROUP_SIZE
 #define MAX_WORKGROUP_SIZE 1024
 #endif
@@ -66,8 +67,16 @@ enum  opencl_type    {GmlInt, GmlInt2, GmlInt4, GmlInt8, GmlInt16,
                       GmlFlt, GmlFlt2, GmlFlt4, GmlFlt8, GmlFlt16,
                       GmlDbl, GmlDbl2, GmlDbl4, GmlDbl8, GmlDbl16,
                       GmlByt, GmlByt2, GmlByt4, GmlByt8, GmlByt16,
+                      GmlHlf, GmlHlf2, GmlHlf4, GmlHlf8, GmlHlf16,
+                      GmlSht, GmlSht2, GmlSht4, GmlSht8, GmlSht16,
                       GmlMaxOclTyp};
 enum reduction_opp   {GmlMin, GmlMax, GmlSum, GmlL0, GmlL1, GmlL2, GmlLinf, GmlMaxRed};
+enum vector_layout   {GmlPadded, GmlPacked};
+enum topology_builder{GmlHostTopology, GmlDeviceTopology};
+enum memory_kind     {GmlParMem, GmlMshMem, GmlRefMem, GmlSolMem, GmlLnkMem,
+                      GmlBalMem, GmlHghMem, GmlDegMem, GmlVoyMem, GmlMatMem,
+                      GmlVecMem, GmlRedMem, GmlCsrMem, GmlOffMem, GmlPrmMem,
+                      GmlMaxMemKnd};
 
 
 /*----------------------------------------------------------------------------*/
@@ -84,6 +93,9 @@ int      GmlNewLinkData       (size_t, int, int, int, char *);
 int      GmlNewMatrix         (size_t, int, int, int, void *, int *, int *, int);
 int      GmlNewVector         (size_t, int, int, void *, int);
 int      GmlFreeData          (size_t, int);
+int      GmlFreeMatrix        (size_t, int);
+int      GmlFreeVector        (size_t, int);
+int      GmlFreeKernel        (size_t, int);
 int      GmlSetDataLine       (size_t, int, int, ...);
 int      GmlGetDataLine       (size_t, int, int, ...);
 void     GmlSetCompilerOptions(size_t, char *);
@@ -92,6 +104,10 @@ int      GmlLaunchKernel      (size_t, int);
 int      GmlReduceVector      (size_t, int, int, double *);
 size_t   GmlGetMemoryUsage    (size_t);
 size_t   GmlGetMemoryTransfer (size_t);
+int      GmlGetDataInfo       (size_t, int, const char **, int *, size_t *, size_t *, float *);
+int      GmlExportMemoryUsage (size_t, char *);
+int      GmlSaveState         (size_t, char *);
+int      GmlLoadState         (size_t, char *);
 float    GmlGetMemoryAccess   (size_t);
 float    GmlGetFlops          (size_t);
 void     GmlDebugOn           (size_t);
@@ -99,11 +115,21 @@ void     GmlDebugOff          (size_t);
 int      GmlExtractEdges      (size_t);
 int      GmlExtractFaces      (size_t);
 int      GmlSetNeighbours     (size_t, int);
+int      GmlGetNeighbourTypes (size_t, int);
+int      GmlSetHybridBall     (size_t);
+int      GmlNewCavityLink     (size_t, int, int, int);
+int      GmlUpdateLinks       (size_t, int, int, int *, int *);
 int      GmlCheckFP64         (size_t);
 int      GmlGetMeshInfo       (size_t, int, int *, int *);
 int      GmlGetLinkInfo       (size_t, int, int, int *, int *, int *, int *);
 int      GmlSetDataBlock      (size_t, int, int, int, void *, void *, int *, int *);
 int      GmlGetDataBlock      (size_t, int, int, int, void *, void *, int *, int *);
+int      GmlUploadRange       (size_t, int, int, int);
+int      GmlDownloadRange     (size_t, int, int, int);
+int      GmlFillData          (size_t, int, void *);
+int      GmlCopyData          (size_t, int, int);
+int      GmlSetSolutionBlock  (size_t, int, int, int, int, void *, void *);
+int      GmlGetSolutionBlock  (size_t, int, int, int, int, void *, void *);
 double   GmlGetKernelRunTime  (size_t, int);
 double   GmlGetReduceRunTime  (size_t, int);
 double   GmlGetWallClock      ();
@@ -116,6 +142,9 @@ int      GmlMultDiagMatVec    (size_t, int, int, int);
 int      GmlAddVec3           (size_t, int, int, int, int);
 int      GmlScaleVec          (size_t, int, double *);
 int      GmlNormVec           (size_t, int, int, double *);
+void     GmlSetVectorLayout   (size_t, int);
+int      GmlSetVertexType     (size_t, int);
+int      GmlSetTopologyBuilder(size_t, int);
 
 #ifdef WITH_LIBMESHB
 int      GmlImportMesh        (size_t, char *, ...);
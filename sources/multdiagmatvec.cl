@@ -41,6 +41,91 @@ __kernel void MultDiaglMatVec(__global fpn16 *D,
    V[l] = v;
 }
 
+#elif defined(PACKED)
+
+#if BLKSIZ == 36
+#define VECSIZ 6
+#elif BLKSIZ == 49
+#define VECSIZ 7
+#else
+#define VECSIZ 5
+#endif
+
+// Unpadded blocks of VECSIZ scalars are loaded into the lower part of an fpn8
+fpn8 LodVec(int i, __global fpn *p)
+{
+   fpn8 v = (fpn8)(0.);
+
+   p += i * VECSIZ;
+   v.s0123 = vload4(0, p);
+#if VECSIZ == 5
+   v.s4 = p[4];
+#elif VECSIZ == 6
+   v.s45 = vload2(0, p + 4);
+#elif VECSIZ == 7
+   v.s456 = vload3(0, p + 4);
+#else
+   v.s4567 = vload4(0, p + 4);
+#endif
+
+   return(v);
+}
+
+void StoVec(fpn8 v, int i, __global fpn *p)
+{
+   p += i * VECSIZ;
+   vstore4(v.s0123, 0, p);
+#if VECSIZ == 5
+   p[4] = v.s4;
+#elif VECSIZ == 6
+   vstore2(v.s45, 0, p + 4);
+#elif VECSIZ == 7
+   vstore3(v.s456, 0, p + 4);
+#else
+   vstore4(v.s4567, 0, p + 4);
+#endif
+}
+
+fpn RowDot(fpn8 a, fpn8 b)
+{
+   fpn8 c = a * b;
+
+   return(c.s0 + c.s1 + c.s2 + c.s3 + c.s4 + c.s5 + c.s6 + c.s7);
+}
+
+__kernel void MultDiaglMatVec(__global fpn *D,
+                              __global fpn *U,
+                              __global fpn *V,
+                              __global void *par,
+                              const int2 N)
+{
+   int l;
+   fpn8 u, v = (fpn8)(0.);
+
+   l = get_global_id(0);
+
+   if(l >= N.s0)
+      return;
+
+   // Each line of the diagonal matrix is made of VECSIZ rows of VECSIZ scalars
+   D += l * BLKSIZ;
+   u = LodVec(l, U);
+
+   v.s0 = RowDot(LodVec(0, D), u);
+   v.s1 = RowDot(LodVec(1, D), u);
+   v.s2 = RowDot(LodVec(2, D), u);
+   v.s3 = RowDot(LodVec(3, D), u);
+   v.s4 = RowDot(LodVec(4, D), u);
+#if VECSIZ > 5
+   v.s5 = RowDot(LodVec(5, D), u);
+#endif
+#if VECSIZ > 6
+   v.s6 = RowDot(LodVec(6, D), u);
+#endif
+
+   StoVec(v, l, V);
+}
+
 #else
 
 __kernel void MultDiaglMatVec(__global fpn16 (*D)[2],
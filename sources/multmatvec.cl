@@ -13,6 +13,55 @@
 #endif
 
 
+// Unpadded blocks are loaded into and stored from the lower part of an fpn8
+#ifdef PACKED
+
+#define VECSIZ BLKSIZ
+#define VecTyp fpn
+
+fpn8 LodVec(int i, __global fpn *p)
+{
+   fpn8 v = (fpn8)(0.);
+
+   p += i * VECSIZ;
+   v.s0123 = vload4(0, p);
+#if VECSIZ == 5
+   v.s4 = p[4];
+#elif VECSIZ == 6
+   v.s45 = vload2(0, p + 4);
+#elif VECSIZ == 7
+   v.s456 = vload3(0, p + 4);
+#else
+   v.s4567 = vload4(0, p + 4);
+#endif
+
+   return(v);
+}
+
+void StoVec(fpn8 v, int i, __global fpn *p)
+{
+   p += i * VECSIZ;
+   vstore4(v.s0123, 0, p);
+#if VECSIZ == 5
+   p[4] = v.s4;
+#elif VECSIZ == 6
+   vstore2(v.s45, 0, p + 4);
+#elif VECSIZ == 7
+   vstore3(v.s456, 0, p + 4);
+#else
+   vstore4(v.s4567, 0, p + 4);
+#endif
+}
+
+#else
+
+#define VecTyp fpn8
+#define LodVec(i,p)   (p)[i]
+#define StoVec(v,i,p) (p)[i] = (v)
+
+#endif
+
+
 #if BLKSIZ == 4
 
 fpn4 MulMatVec(fpn16 a, fpn4 x)
@@ -950,8 +999,8 @@ fpn8 MulMatVec16(fpn16 ma, fpn16 mb, fpn8 x)
 __kernel void MulMatVecSlc16( __global int   *D,
                               __global int16 *C,
                               __global fpn16 (*A)[25],
-                              __global fpn8  *B,
-                              __global fpn8  *X,
+                              __global VecTyp *B,
+                              __global VecTyp *X,
                               __global void  *par,
                               const int2     N )
 {
@@ -967,31 +1016,31 @@ __kernel void MulMatVecSlc16( __global int   *D,
    d = D[l];
    c = C[l];
 
-               b  = MulMatVec01(A[l][ 0], A[l][ 1],           X[ c.s0 ]);
-   if(d >  1)  b += MulMatVec02(A[l][ 1], A[l][ 2], A[l][ 3], X[ c.s1 ]);
-   if(d >  2)  b += MulMatVec03(A[l][ 3], A[l][ 4],           X[ c.s2 ]);
-   if(d >  3)  b += MulMatVec04(A[l][ 4], A[l][ 5], A[l][ 6], X[ c.s3 ]);
-   if(d >  4)  b += MulMatVec05(A[l][ 6], A[l][ 7],           X[ c.s4 ]);
-   if(d >  5)  b += MulMatVec06(A[l][ 7], A[l][ 8], A[l][ 9], X[ c.s5 ]);
-   if(d >  6)  b += MulMatVec07(A[l][ 9], A[l][10],           X[ c.s6 ]);
-   if(d >  7)  b += MulMatVec08(A[l][10], A[l][11], A[l][12], X[ c.s7 ]);
-   if(d >  8)  b += MulMatVec09(A[l][12], A[l][13], A[l][14], X[ c.s8 ]);
-   if(d >  9)  b += MulMatVec10(A[l][14], A[l][15],           X[ c.s9 ]);
-   if(d > 10)  b += MulMatVec11(A[l][15], A[l][16], A[l][17], X[ c.sa ]);
-   if(d > 11)  b += MulMatVec12(A[l][17], A[l][18],           X[ c.sb ]);
-   if(d > 12)  b += MulMatVec13(A[l][18], A[l][19], A[l][20], X[ c.sc ]);
-   if(d > 13)  b += MulMatVec14(A[l][20], A[l][21],           X[ c.sd ]);
-   if(d > 14)  b += MulMatVec15(A[l][21], A[l][22], A[l][23], X[ c.se ]);
-   if(d > 15)  b += MulMatVec16(A[l][23], A[l][24],           X[ c.sf ]);
-
-   B[l+N.s1] = b;
+               b  = MulMatVec01(A[l][ 0], A[l][ 1],           LodVec(c.s0, X));
+   if(d >  1)  b += MulMatVec02(A[l][ 1], A[l][ 2], A[l][ 3], LodVec(c.s1, X));
+   if(d >  2)  b += MulMatVec03(A[l][ 3], A[l][ 4],           LodVec(c.s2, X));
+   if(d >  3)  b += MulMatVec04(A[l][ 4], A[l][ 5], A[l][ 6], LodVec(c.s3, X));
+   if(d >  4)  b += MulMatVec05(A[l][ 6], A[l][ 7],           LodVec(c.s4, X));
+   if(d >  5)  b += MulMatVec06(A[l][ 7], A[l][ 8], A[l][ 9], LodVec(c.s5, X));
+   if(d >  6)  b += MulMatVec07(A[l][ 9], A[l][10],           LodVec(c.s6, X));
+   if(d >  7)  b += MulMatVec08(A[l][10], A[l][11], A[l][12], LodVec(c.s7, X));
+   if(d >  8)  b += MulMatVec09(A[l][12], A[l][13], A[l][14], LodVec(c.s8, X));
+   if(d >  9)  b += MulMatVec10(A[l][14], A[l][15],           LodVec(c.s9, X));
+   if(d > 10)  b += MulMatVec11(A[l][15], A[l][16], A[l][17], LodVec(c.sa, X));
+   if(d > 11)  b += MulMatVec12(A[l][17], A[l][18],           LodVec(c.sb, X));
+   if(d > 12)  b += MulMatVec13(A[l][18], A[l][19], A[l][20], LodVec(c.sc, X));
+   if(d > 13)  b += MulMatVec14(A[l][20], A[l][21],           LodVec(c.sd, X));
+   if(d > 14)  b += MulMatVec15(A[l][21], A[l][22], A[l][23], LodVec(c.se, X));
+   if(d > 15)  b += MulMatVec16(A[l][23], A[l][24],           LodVec(c.sf, X));
+
+   StoVec(b, l+N.s1, B);
 }
 
 __kernel void MulMatVecSlc32( __global int   *D,
                               __global int16 (*C)[2],
                               __global fpn16 (*A)[50],
-                              __global fpn8  *B,
-                              __global fpn8  *X,
+                              __global VecTyp *B,
+                              __global VecTyp *X,
                               __global void  *par,
                               const int2     N )
 {
@@ -1007,50 +1056,50 @@ __kernel void MulMatVecSlc32( __global int   *D,
    d = D[l];
    c = C[l][0];
 
-   b  = MulMatVec01(A[l][ 0], A[l][ 1],           X[ c.s0 ]);
-      + MulMatVec02(A[l][ 1], A[l][ 2], A[l][ 3], X[ c.s1 ]);
-      + MulMatVec03(A[l][ 3], A[l][ 4],           X[ c.s2 ]);
-      + MulMatVec04(A[l][ 4], A[l][ 5], A[l][ 6], X[ c.s3 ]);
-      + MulMatVec05(A[l][ 6], A[l][ 7],           X[ c.s4 ]);
-      + MulMatVec06(A[l][ 7], A[l][ 8], A[l][ 9], X[ c.s5 ]);
-      + MulMatVec07(A[l][ 9], A[l][10],           X[ c.s6 ]);
-      + MulMatVec08(A[l][10], A[l][11], A[l][12], X[ c.s7 ]);
-      + MulMatVec09(A[l][12], A[l][13], A[l][14], X[ c.s8 ]);
-      + MulMatVec10(A[l][14], A[l][15],           X[ c.s9 ]);
-      + MulMatVec11(A[l][15], A[l][16], A[l][17], X[ c.sa ]);
-      + MulMatVec12(A[l][17], A[l][18],           X[ c.sb ]);
-      + MulMatVec13(A[l][18], A[l][19], A[l][20], X[ c.sc ]);
-      + MulMatVec14(A[l][20], A[l][21],           X[ c.sd ]);
-      + MulMatVec15(A[l][21], A[l][22], A[l][23], X[ c.se ]);
-      + MulMatVec16(A[l][23], A[l][24],           X[ c.sf ]);
+   b  = MulMatVec01(A[l][ 0], A[l][ 1],           LodVec(c.s0, X));
+      + MulMatVec02(A[l][ 1], A[l][ 2], A[l][ 3], LodVec(c.s1, X));
+      + MulMatVec03(A[l][ 3], A[l][ 4],           LodVec(c.s2, X));
+      + MulMatVec04(A[l][ 4], A[l][ 5], A[l][ 6], LodVec(c.s3, X));
+      + MulMatVec05(A[l][ 6], A[l][ 7],           LodVec(c.s4, X));
+      + MulMatVec06(A[l][ 7], A[l][ 8], A[l][ 9], LodVec(c.s5, X));
+      + MulMatVec07(A[l][ 9], A[l][10],           LodVec(c.s6, X));
+      + MulMatVec08(A[l][10], A[l][11], A[l][12], LodVec(c.s7, X));
+      + MulMatVec09(A[l][12], A[l][13], A[l][14], LodVec(c.s8, X));
+      + MulMatVec10(A[l][14], A[l][15],           LodVec(c.s9, X));
+      + MulMatVec11(A[l][15], A[l][16], A[l][17], LodVec(c.sa, X));
+      + MulMatVec12(A[l][17], A[l][18],           LodVec(c.sb, X));
+      + MulMatVec13(A[l][18], A[l][19], A[l][20], LodVec(c.sc, X));
+      + MulMatVec14(A[l][20], A[l][21],           LodVec(c.sd, X));
+      + MulMatVec15(A[l][21], A[l][22], A[l][23], LodVec(c.se, X));
+      + MulMatVec16(A[l][23], A[l][24],           LodVec(c.sf, X));
 
    c = C[l][1];
 
-               b += MulMatVec01(A[l][ 0+25], A[l][ 1+25],              X[ c.s0 ]);
-   if(d > 17)  b += MulMatVec02(A[l][ 1+25], A[l][ 2+25], A[l][ 3+25], X[ c.s1 ]);
-   if(d > 18)  b += MulMatVec03(A[l][ 3+25], A[l][ 4+25],              X[ c.s2 ]);
-   if(d > 19)  b += MulMatVec04(A[l][ 4+25], A[l][ 5+25], A[l][ 6+25], X[ c.s3 ]);
-   if(d > 20)  b += MulMatVec05(A[l][ 6+25], A[l][ 7+25],              X[ c.s4 ]);
-   if(d > 21)  b += MulMatVec06(A[l][ 7+25], A[l][ 8+25], A[l][ 9+25], X[ c.s5 ]);
-   if(d > 22)  b += MulMatVec07(A[l][ 9+25], A[l][10+25],              X[ c.s6 ]);
-   if(d > 23)  b += MulMatVec08(A[l][10+25], A[l][11+25], A[l][12+25], X[ c.s7 ]);
-   if(d > 24)  b += MulMatVec09(A[l][12+25], A[l][13+25], A[l][14+25], X[ c.s8 ]);
-   if(d > 25)  b += MulMatVec10(A[l][14+25], A[l][15+25],              X[ c.s9 ]);
-   if(d > 26)  b += MulMatVec11(A[l][15+25], A[l][16+25], A[l][17+25], X[ c.sa ]);
-   if(d > 27)  b += MulMatVec12(A[l][17+25], A[l][18+25],              X[ c.sb ]);
-   if(d > 28)  b += MulMatVec13(A[l][18+25], A[l][19+25], A[l][20+25], X[ c.sc ]);
-   if(d > 29)  b += MulMatVec14(A[l][20+25], A[l][21+25],              X[ c.sd ]);
-   if(d > 30)  b += MulMatVec15(A[l][21+25], A[l][22+25], A[l][23+25], X[ c.se ]);
-   if(d > 31)  b += MulMatVec16(A[l][23+25], A[l][24+25],              X[ c.sf ]);
-
-   B[l+N.s1] = b;
+               b += MulMatVec01(A[l][ 0+25], A[l][ 1+25],              LodVec(c.s0, X));
+   if(d > 17)  b += MulMatVec02(A[l][ 1+25], A[l][ 2+25], A[l][ 3+25], LodVec(c.s1, X));
+   if(d > 18)  b += MulMatVec03(A[l][ 3+25], A[l][ 4+25],              LodVec(c.s2, X));
+   if(d > 19)  b += MulMatVec04(A[l][ 4+25], A[l][ 5+25], A[l][ 6+25], LodVec(c.s3, X));
+   if(d > 20)  b += MulMatVec05(A[l][ 6+25], A[l][ 7+25],              LodVec(c.s4, X));
+   if(d > 21)  b += MulMatVec06(A[l][ 7+25], A[l][ 8+25], A[l][ 9+25], LodVec(c.s5, X));
+   if(d > 22)  b += MulMatVec07(A[l][ 9+25], A[l][10+25],              LodVec(c.s6, X));
+   if(d > 23)  b += MulMatVec08(A[l][10+25], A[l][11+25], A[l][12+25], LodVec(c.s7, X));
+   if(d > 24)  b += MulMatVec09(A[l][12+25], A[l][13+25], A[l][14+25], LodVec(c.s8, X));
+   if(d > 25)  b += MulMatVec10(A[l][14+25], A[l][15+25],              LodVec(c.s9, X));
+   if(d > 26)  b += MulMatVec11(A[l][15+25], A[l][16+25], A[l][17+25], LodVec(c.sa, X));
+   if(d > 27)  b += MulMatVec12(A[l][17+25], A[l][18+25],              LodVec(c.sb, X));
+   if(d > 28)  b += MulMatVec13(A[l][18+25], A[l][19+25], A[l][20+25], LodVec(c.sc, X));
+   if(d > 29)  b += MulMatVec14(A[l][20+25], A[l][21+25],              LodVec(c.sd, X));
+   if(d > 30)  b += MulMatVec15(A[l][21+25], A[l][22+25], A[l][23+25], LodVec(c.se, X));
+   if(d > 31)  b += MulMatVec16(A[l][23+25], A[l][24+25],              LodVec(c.sf, X));
+
+   StoVec(b, l+N.s1, B);
 }
 
 __kernel void MulMatVecSlc64( __global int   *D,
                               __global int16 (*C)[4],
                               __global fpn16 (*A)[100],
-                              __global fpn8  *B,
-                              __global fpn8  *X,
+                              __global VecTyp *B,
+                              __global VecTyp *X,
                               __global void  *par,
                               const int2     N )
 {
@@ -1066,88 +1115,88 @@ __kernel void MulMatVecSlc64( __global int   *D,
    d = D[l];
    c = C[l][0];
 
-   b  = MulMatVec01(A[l][ 0], A[l][ 1],           X[ c.s0 ]);
-      + MulMatVec02(A[l][ 1], A[l][ 2], A[l][ 3], X[ c.s1 ]);
-      + MulMatVec03(A[l][ 3], A[l][ 4],           X[ c.s2 ]);
-      + MulMatVec04(A[l][ 4], A[l][ 5], A[l][ 6], X[ c.s3 ]);
-      + MulMatVec05(A[l][ 6], A[l][ 7],           X[ c.s4 ]);
-      + MulMatVec06(A[l][ 7], A[l][ 8], A[l][ 9], X[ c.s5 ]);
-      + MulMatVec07(A[l][ 9], A[l][10],           X[ c.s6 ]);
-      + MulMatVec08(A[l][10], A[l][11], A[l][12], X[ c.s7 ]);
-      + MulMatVec09(A[l][12], A[l][13], A[l][14], X[ c.s8 ]);
-      + MulMatVec10(A[l][14], A[l][15],           X[ c.s9 ]);
-      + MulMatVec11(A[l][15], A[l][16], A[l][17], X[ c.sa ]);
-      + MulMatVec12(A[l][17], A[l][18],           X[ c.sb ]);
-      + MulMatVec13(A[l][18], A[l][19], A[l][20], X[ c.sc ]);
-      + MulMatVec14(A[l][20], A[l][21],           X[ c.sd ]);
-      + MulMatVec15(A[l][21], A[l][22], A[l][23], X[ c.se ]);
-      + MulMatVec16(A[l][23], A[l][24],           X[ c.sf ]);
+   b  = MulMatVec01(A[l][ 0], A[l][ 1],           LodVec(c.s0, X));
+      + MulMatVec02(A[l][ 1], A[l][ 2], A[l][ 3], LodVec(c.s1, X));
+      + MulMatVec03(A[l][ 3], A[l][ 4],           LodVec(c.s2, X));
+      + MulMatVec04(A[l][ 4], A[l][ 5], A[l][ 6], LodVec(c.s3, X));
+      + MulMatVec05(A[l][ 6], A[l][ 7],           LodVec(c.s4, X));
+      + MulMatVec06(A[l][ 7], A[l][ 8], A[l][ 9], LodVec(c.s5, X));
+      + MulMatVec07(A[l][ 9], A[l][10],           LodVec(c.s6, X));
+      + MulMatVec08(A[l][10], A[l][11], A[l][12], LodVec(c.s7, X));
+      + MulMatVec09(A[l][12], A[l][13], A[l][14], LodVec(c.s8, X));
+      + MulMatVec10(A[l][14], A[l][15],           LodVec(c.s9, X));
+      + MulMatVec11(A[l][15], A[l][16], A[l][17], LodVec(c.sa, X));
+      + MulMatVec12(A[l][17], A[l][18],           LodVec(c.sb, X));
+      + MulMatVec13(A[l][18], A[l][19], A[l][20], LodVec(c.sc, X));
+      + MulMatVec14(A[l][20], A[l][21],           LodVec(c.sd, X));
+      + MulMatVec15(A[l][21], A[l][22], A[l][23], LodVec(c.se, X));
+      + MulMatVec16(A[l][23], A[l][24],           LodVec(c.sf, X));
 
    c = C[l][1];
 
-   b += MulMatVec01(A[l][ 0+25], A[l][ 1+25],              X[ c.s0 ]);
-      + MulMatVec02(A[l][ 1+25], A[l][ 2+25], A[l][ 3+25], X[ c.s1 ]);
-      + MulMatVec03(A[l][ 3+25], A[l][ 4+25],              X[ c.s2 ]);
-      + MulMatVec04(A[l][ 4+25], A[l][ 5+25], A[l][ 6+25], X[ c.s3 ]);
-      + MulMatVec05(A[l][ 6+25], A[l][ 7+25],              X[ c.s4 ]);
-      + MulMatVec06(A[l][ 7+25], A[l][ 8+25], A[l][ 9+25], X[ c.s5 ]);
-      + MulMatVec07(A[l][ 9+25], A[l][10+25],              X[ c.s6 ]);
-      + MulMatVec08(A[l][10+25], A[l][11+25], A[l][12+25], X[ c.s7 ]);
-      + MulMatVec09(A[l][12+25], A[l][13+25], A[l][14+25], X[ c.s8 ]);
-      + MulMatVec10(A[l][14+25], A[l][15+25],              X[ c.s9 ]);
-      + MulMatVec11(A[l][15+25], A[l][16+25], A[l][17+25], X[ c.sa ]);
-      + MulMatVec12(A[l][17+25], A[l][18+25],              X[ c.sb ]);
-      + MulMatVec13(A[l][18+25], A[l][19+25], A[l][20+25], X[ c.sc ]);
-      + MulMatVec14(A[l][20+25], A[l][21+25],              X[ c.sd ]);
-      + MulMatVec15(A[l][21+25], A[l][22+25], A[l][23+25], X[ c.se ]);
-      + MulMatVec16(A[l][23+25], A[l][24+25],              X[ c.sf ]);
+   b += MulMatVec01(A[l][ 0+25], A[l][ 1+25],              LodVec(c.s0, X));
+      + MulMatVec02(A[l][ 1+25], A[l][ 2+25], A[l][ 3+25], LodVec(c.s1, X));
+      + MulMatVec03(A[l][ 3+25], A[l][ 4+25],              LodVec(c.s2, X));
+      + MulMatVec04(A[l][ 4+25], A[l][ 5+25], A[l][ 6+25], LodVec(c.s3, X));
+      + MulMatVec05(A[l][ 6+25], A[l][ 7+25],              LodVec(c.s4, X));
+      + MulMatVec06(A[l][ 7+25], A[l][ 8+25], A[l][ 9+25], LodVec(c.s5, X));
+      + MulMatVec07(A[l][ 9+25], A[l][10+25],              LodVec(c.s6, X));
+      + MulMatVec08(A[l][10+25], A[l][11+25], A[l][12+25], LodVec(c.s7, X));
+      + MulMatVec09(A[l][12+25], A[l][13+25], A[l][14+25], LodVec(c.s8, X));
+      + MulMatVec10(A[l][14+25], A[l][15+25],              LodVec(c.s9, X));
+      + MulMatVec11(A[l][15+25], A[l][16+25], A[l][17+25], LodVec(c.sa, X));
+      + MulMatVec12(A[l][17+25], A[l][18+25],              LodVec(c.sb, X));
+      + MulMatVec13(A[l][18+25], A[l][19+25], A[l][20+25], LodVec(c.sc, X));
+      + MulMatVec14(A[l][20+25], A[l][21+25],              LodVec(c.sd, X));
+      + MulMatVec15(A[l][21+25], A[l][22+25], A[l][23+25], LodVec(c.se, X));
+      + MulMatVec16(A[l][23+25], A[l][24+25],              LodVec(c.sf, X));
 
       c = C[l][2];
 
-               b += MulMatVec01(A[l][ 0+50], A[l][ 1+50],              X[ c.s0 ]);
-   if(d > 33)  b += MulMatVec02(A[l][ 1+50], A[l][ 2+50], A[l][ 3+50], X[ c.s1 ]);
-   if(d > 34)  b += MulMatVec03(A[l][ 3+50], A[l][ 4+50],              X[ c.s2 ]);
-   if(d > 35)  b += MulMatVec04(A[l][ 4+50], A[l][ 5+50], A[l][ 6+50], X[ c.s3 ]);
-   if(d > 36)  b += MulMatVec05(A[l][ 6+50], A[l][ 7+50],              X[ c.s4 ]);
-   if(d > 37)  b += MulMatVec06(A[l][ 7+50], A[l][ 8+50], A[l][ 9+50], X[ c.s5 ]);
-   if(d > 38)  b += MulMatVec07(A[l][ 9+50], A[l][10+50],              X[ c.s6 ]);
-   if(d > 39)  b += MulMatVec08(A[l][10+50], A[l][11+50], A[l][12+50], X[ c.s7 ]);
-   if(d > 40)  b += MulMatVec09(A[l][12+50], A[l][13+50], A[l][14+50], X[ c.s8 ]);
-   if(d > 41)  b += MulMatVec10(A[l][14+50], A[l][15+50],              X[ c.s9 ]);
-   if(d > 42)  b += MulMatVec11(A[l][15+50], A[l][16+50], A[l][17+50], X[ c.sa ]);
-   if(d > 43)  b += MulMatVec12(A[l][17+50], A[l][18+50],              X[ c.sb ]);
-   if(d > 44)  b += MulMatVec13(A[l][18+50], A[l][19+50], A[l][20+50], X[ c.sc ]);
-   if(d > 45)  b += MulMatVec14(A[l][20+50], A[l][21+50],              X[ c.sd ]);
-   if(d > 46)  b += MulMatVec15(A[l][21+50], A[l][22+50], A[l][23+50], X[ c.se ]);
-   if(d > 47)  b += MulMatVec16(A[l][23+50], A[l][24+50],              X[ c.sf ]);
+               b += MulMatVec01(A[l][ 0+50], A[l][ 1+50],              LodVec(c.s0, X));
+   if(d > 33)  b += MulMatVec02(A[l][ 1+50], A[l][ 2+50], A[l][ 3+50], LodVec(c.s1, X));
+   if(d > 34)  b += MulMatVec03(A[l][ 3+50], A[l][ 4+50],              LodVec(c.s2, X));
+   if(d > 35)  b += MulMatVec04(A[l][ 4+50], A[l][ 5+50], A[l][ 6+50], LodVec(c.s3, X));
+   if(d > 36)  b += MulMatVec05(A[l][ 6+50], A[l][ 7+50],              LodVec(c.s4, X));
+   if(d > 37)  b += MulMatVec06(A[l][ 7+50], A[l][ 8+50], A[l][ 9+50], LodVec(c.s5, X));
+   if(d > 38)  b += MulMatVec07(A[l][ 9+50], A[l][10+50],              LodVec(c.s6, X));
+   if(d > 39)  b += MulMatVec08(A[l][10+50], A[l][11+50], A[l][12+50], LodVec(c.s7, X));
+   if(d > 40)  b += MulMatVec09(A[l][12+50], A[l][13+50], A[l][14+50], LodVec(c.s8, X));
+   if(d > 41)  b += MulMatVec10(A[l][14+50], A[l][15+50],              LodVec(c.s9, X));
+   if(d > 42)  b += MulMatVec11(A[l][15+50], A[l][16+50], A[l][17+50], LodVec(c.sa, X));
+   if(d > 43)  b += MulMatVec12(A[l][17+50], A[l][18+50],              LodVec(c.sb, X));
+   if(d > 44)  b += MulMatVec13(A[l][18+50], A[l][19+50], A[l][20+50], LodVec(c.sc, X));
+   if(d > 45)  b += MulMatVec14(A[l][20+50], A[l][21+50],              LodVec(c.sd, X));
+   if(d > 46)  b += MulMatVec15(A[l][21+50], A[l][22+50], A[l][23+50], LodVec(c.se, X));
+   if(d > 47)  b += MulMatVec16(A[l][23+50], A[l][24+50],              LodVec(c.sf, X));
 
    c = C[l][3];
 
-   if(d > 48)  b += MulMatVec01(A[l][ 0+75], A[l][ 1+75],              X[ c.s0 ]);
-   if(d > 49)  b += MulMatVec02(A[l][ 1+75], A[l][ 2+75], A[l][ 3+75], X[ c.s1 ]);
-   if(d > 50)  b += MulMatVec03(A[l][ 3+75], A[l][ 4+75],              X[ c.s2 ]);
-   if(d > 51)  b += MulMatVec04(A[l][ 4+75], A[l][ 5+75], A[l][ 6+75], X[ c.s3 ]);
-   if(d > 52)  b += MulMatVec05(A[l][ 6+75], A[l][ 7+75],              X[ c.s4 ]);
-   if(d > 53)  b += MulMatVec06(A[l][ 7+75], A[l][ 8+75], A[l][ 9+75], X[ c.s5 ]);
-   if(d > 54)  b += MulMatVec07(A[l][ 9+75], A[l][10+75],              X[ c.s6 ]);
-   if(d > 55)  b += MulMatVec08(A[l][10+75], A[l][11+75], A[l][12+75], X[ c.s7 ]);
-   if(d > 56)  b += MulMatVec09(A[l][12+75], A[l][13+75], A[l][14+75], X[ c.s8 ]);
-   if(d > 57)  b += MulMatVec10(A[l][14+75], A[l][15+75],              X[ c.s9 ]);
-   if(d > 58)  b += MulMatVec11(A[l][15+75], A[l][16+75], A[l][17+75], X[ c.sa ]);
-   if(d > 59)  b += MulMatVec12(A[l][17+75], A[l][18+75],              X[ c.sb ]);
-   if(d > 60)  b += MulMatVec13(A[l][18+75], A[l][19+75], A[l][20+75], X[ c.sc ]);
-   if(d > 61)  b += MulMatVec14(A[l][20+75], A[l][21+75],              X[ c.sd ]);
-   if(d > 62)  b += MulMatVec15(A[l][21+75], A[l][22+75], A[l][23+75], X[ c.se ]);
-   if(d > 63)  b += MulMatVec16(A[l][23+75], A[l][24+75],              X[ c.sf ]);
-
-   B[l+N.s1] = b;
+   if(d > 48)  b += MulMatVec01(A[l][ 0+75], A[l][ 1+75],              LodVec(c.s0, X));
+   if(d > 49)  b += MulMatVec02(A[l][ 1+75], A[l][ 2+75], A[l][ 3+75], LodVec(c.s1, X));
+   if(d > 50)  b += MulMatVec03(A[l][ 3+75], A[l][ 4+75],              LodVec(c.s2, X));
+   if(d > 51)  b += MulMatVec04(A[l][ 4+75], A[l][ 5+75], A[l][ 6+75], LodVec(c.s3, X));
+   if(d > 52)  b += MulMatVec05(A[l][ 6+75], A[l][ 7+75],              LodVec(c.s4, X));
+   if(d > 53)  b += MulMatVec06(A[l][ 7+75], A[l][ 8+75], A[l][ 9+75], LodVec(c.s5, X));
+   if(d > 54)  b += MulMatVec07(A[l][ 9+75], A[l][10+75],              LodVec(c.s6, X));
+   if(d > 55)  b += MulMatVec08(A[l][10+75], A[l][11+75], A[l][12+75], LodVec(c.s7, X));
+   if(d > 56)  b += MulMatVec09(A[l][12+75], A[l][13+75], A[l][14+75], LodVec(c.s8, X));
+   if(d > 57)  b += MulMatVec10(A[l][14+75], A[l][15+75],              LodVec(c.s9, X));
+   if(d > 58)  b += MulMatVec11(A[l][15+75], A[l][16+75], A[l][17+75], LodVec(c.sa, X));
+   if(d > 59)  b += MulMatVec12(A[l][17+75], A[l][18+75],              LodVec(c.sb, X));
+   if(d > 60)  b += MulMatVec13(A[l][18+75], A[l][19+75], A[l][20+75], LodVec(c.sc, X));
+   if(d > 61)  b += MulMatVec14(A[l][20+75], A[l][21+75],              LodVec(c.sd, X));
+   if(d > 62)  b += MulMatVec15(A[l][21+75], A[l][22+75], A[l][23+75], LodVec(c.se, X));
+   if(d > 63)  b += MulMatVec16(A[l][23+75], A[l][24+75],              LodVec(c.sf, X));
+
+   StoVec(b, l+N.s1, B);
 }
 
 __kernel void MulMatVecSlc128(__global int   *D,
                               __global int16 (*C)[8],
                               __global fpn16 (*A)[200],
-                              __global fpn8  *B,
-                              __global fpn8  *X,
+                              __global VecTyp *B,
+                              __global VecTyp *X,
                               __global void  *par,
                               const int2     N )
 {
@@ -1163,164 +1212,164 @@ __kernel void MulMatVecSlc128(__global int   *D,
    d = D[l];
    c = C[l][0];
 
-   b  = MulMatVec01(A[l][ 0], A[l][ 1],           X[ c.s0 ]);
-      + MulMatVec02(A[l][ 1], A[l][ 2], A[l][ 3], X[ c.s1 ]);
-      + MulMatVec03(A[l][ 3], A[l][ 4],           X[ c.s2 ]);
-      + MulMatVec04(A[l][ 4], A[l][ 5], A[l][ 6], X[ c.s3 ]);
-      + MulMatVec05(A[l][ 6], A[l][ 7],           X[ c.s4 ]);
-      + MulMatVec06(A[l][ 7], A[l][ 8], A[l][ 9], X[ c.s5 ]);
-      + MulMatVec07(A[l][ 9], A[l][10],           X[ c.s6 ]);
-      + MulMatVec08(A[l][10], A[l][11], A[l][12], X[ c.s7 ]);
-      + MulMatVec09(A[l][12], A[l][13], A[l][14], X[ c.s8 ]);
-      + MulMatVec10(A[l][14], A[l][15],           X[ c.s9 ]);
-      + MulMatVec11(A[l][15], A[l][16], A[l][17], X[ c.sa ]);
-      + MulMatVec12(A[l][17], A[l][18],           X[ c.sb ]);
-      + MulMatVec13(A[l][18], A[l][19], A[l][20], X[ c.sc ]);
-      + MulMatVec14(A[l][20], A[l][21],           X[ c.sd ]);
-      + MulMatVec15(A[l][21], A[l][22], A[l][23], X[ c.se ]);
-      + MulMatVec16(A[l][23], A[l][24],           X[ c.sf ]);
+   b  = MulMatVec01(A[l][ 0], A[l][ 1],           LodVec(c.s0, X));
+      + MulMatVec02(A[l][ 1], A[l][ 2], A[l][ 3], LodVec(c.s1, X));
+      + MulMatVec03(A[l][ 3], A[l][ 4],           LodVec(c.s2, X));
+      + MulMatVec04(A[l][ 4], A[l][ 5], A[l][ 6], LodVec(c.s3, X));
+      + MulMatVec05(A[l][ 6], A[l][ 7],           LodVec(c.s4, X));
+      + MulMatVec06(A[l][ 7], A[l][ 8], A[l][ 9], LodVec(c.s5, X));
+      + MulMatVec07(A[l][ 9], A[l][10],           LodVec(c.s6, X));
+      + MulMatVec08(A[l][10], A[l][11], A[l][12], LodVec(c.s7, X));
+      + MulMatVec09(A[l][12], A[l][13], A[l][14], LodVec(c.s8, X));
+      + MulMatVec10(A[l][14], A[l][15],           LodVec(c.s9, X));
+      + MulMatVec11(A[l][15], A[l][16], A[l][17], LodVec(c.sa, X));
+      + MulMatVec12(A[l][17], A[l][18],           LodVec(c.sb, X));
+      + MulMatVec13(A[l][18], A[l][19], A[l][20], LodVec(c.sc, X));
+      + MulMatVec14(A[l][20], A[l][21],           LodVec(c.sd, X));
+      + MulMatVec15(A[l][21], A[l][22], A[l][23], LodVec(c.se, X));
+      + MulMatVec16(A[l][23], A[l][24],           LodVec(c.sf, X));
 
    c = C[l][1];
 
-   b += MulMatVec01(A[l][ 0+25], A[l][ 1+25],              X[ c.s0 ]);
-      + MulMatVec02(A[l][ 1+25], A[l][ 2+25], A[l][ 3+25], X[ c.s1 ]);
-      + MulMatVec03(A[l][ 3+25], A[l][ 4+25],              X[ c.s2 ]);
-      + MulMatVec04(A[l][ 4+25], A[l][ 5+25], A[l][ 6+25], X[ c.s3 ]);
-      + MulMatVec05(A[l][ 6+25], A[l][ 7+25],              X[ c.s4 ]);
-      + MulMatVec06(A[l][ 7+25], A[l][ 8+25], A[l][ 9+25], X[ c.s5 ]);
-      + MulMatVec07(A[l][ 9+25], A[l][10+25],              X[ c.s6 ]);
-      + MulMatVec08(A[l][10+25], A[l][11+25], A[l][12+25], X[ c.s7 ]);
-      + MulMatVec09(A[l][12+25], A[l][13+25], A[l][14+25], X[ c.s8 ]);
-      + MulMatVec10(A[l][14+25], A[l][15+25],              X[ c.s9 ]);
-      + MulMatVec11(A[l][15+25], A[l][16+25], A[l][17+25], X[ c.sa ]);
-      + MulMatVec12(A[l][17+25], A[l][18+25],              X[ c.sb ]);
-      + MulMatVec13(A[l][18+25], A[l][19+25], A[l][20+25], X[ c.sc ]);
-      + MulMatVec14(A[l][20+25], A[l][21+25],              X[ c.sd ]);
-      + MulMatVec15(A[l][21+25], A[l][22+25], A[l][23+25], X[ c.se ]);
-      + MulMatVec16(A[l][23+25], A[l][24+25],              X[ c.sf ]);
+   b += MulMatVec01(A[l][ 0+25], A[l][ 1+25],              LodVec(c.s0, X));
+      + MulMatVec02(A[l][ 1+25], A[l][ 2+25], A[l][ 3+25], LodVec(c.s1, X));
+      + MulMatVec03(A[l][ 3+25], A[l][ 4+25],              LodVec(c.s2, X));
+      + MulMatVec04(A[l][ 4+25], A[l][ 5+25], A[l][ 6+25], LodVec(c.s3, X));
+      + MulMatVec05(A[l][ 6+25], A[l][ 7+25],              LodVec(c.s4, X));
+      + MulMatVec06(A[l][ 7+25], A[l][ 8+25], A[l][ 9+25], LodVec(c.s5, X));
+      + MulMatVec07(A[l][ 9+25], A[l][10+25],              LodVec(c.s6, X));
+      + MulMatVec08(A[l][10+25], A[l][11+25], A[l][12+25], LodVec(c.s7, X));
+      + MulMatVec09(A[l][12+25], A[l][13+25], A[l][14+25], LodVec(c.s8, X));
+      + MulMatVec10(A[l][14+25], A[l][15+25],              LodVec(c.s9, X));
+      + MulMatVec11(A[l][15+25], A[l][16+25], A[l][17+25], LodVec(c.sa, X));
+      + MulMatVec12(A[l][17+25], A[l][18+25],              LodVec(c.sb, X));
+      + MulMatVec13(A[l][18+25], A[l][19+25], A[l][20+25], LodVec(c.sc, X));
+      + MulMatVec14(A[l][20+25], A[l][21+25],              LodVec(c.sd, X));
+      + MulMatVec15(A[l][21+25], A[l][22+25], A[l][23+25], LodVec(c.se, X));
+      + MulMatVec16(A[l][23+25], A[l][24+25],              LodVec(c.sf, X));
 
    c = C[l][2];
 
-   b += MulMatVec01(A[l][ 0+50], A[l][ 1+50],              X[ c.s0 ]);
-      + MulMatVec02(A[l][ 1+50], A[l][ 2+50], A[l][ 3+50], X[ c.s1 ]);
-      + MulMatVec03(A[l][ 3+50], A[l][ 4+50],              X[ c.s2 ]);
-      + MulMatVec04(A[l][ 4+50], A[l][ 5+50], A[l][ 6+50], X[ c.s3 ]);
-      + MulMatVec05(A[l][ 6+50], A[l][ 7+50],              X[ c.s4 ]);
-      + MulMatVec06(A[l][ 7+50], A[l][ 8+50], A[l][ 9+50], X[ c.s5 ]);
-      + MulMatVec07(A[l][ 9+50], A[l][10+50],              X[ c.s6 ]);
-      + MulMatVec08(A[l][10+50], A[l][11+50], A[l][12+50], X[ c.s7 ]);
-      + MulMatVec09(A[l][12+50], A[l][13+50], A[l][14+50], X[ c.s8 ]);
-      + MulMatVec10(A[l][14+50], A[l][15+50],              X[ c.s9 ]);
-      + MulMatVec11(A[l][15+50], A[l][16+50], A[l][17+50], X[ c.sa ]);
-      + MulMatVec12(A[l][17+50], A[l][18+50],              X[ c.sb ]);
-      + MulMatVec13(A[l][18+50], A[l][19+50], A[l][20+50], X[ c.sc ]);
-      + MulMatVec14(A[l][20+50], A[l][21+50],              X[ c.sd ]);
-      + MulMatVec15(A[l][21+50], A[l][22+50], A[l][23+50], X[ c.se ]);
-      + MulMatVec16(A[l][23+50], A[l][24+50],              X[ c.sf ]);
+   b += MulMatVec01(A[l][ 0+50], A[l][ 1+50],              LodVec(c.s0, X));
+      + MulMatVec02(A[l][ 1+50], A[l][ 2+50], A[l][ 3+50], LodVec(c.s1, X));
+      + MulMatVec03(A[l][ 3+50], A[l][ 4+50],              LodVec(c.s2, X));
+      + MulMatVec04(A[l][ 4+50], A[l][ 5+50], A[l][ 6+50], LodVec(c.s3, X));
+      + MulMatVec05(A[l][ 6+50], A[l][ 7+50],              LodVec(c.s4, X));
+      + MulMatVec06(A[l][ 7+50], A[l][ 8+50], A[l][ 9+50], LodVec(c.s5, X));
+      + MulMatVec07(A[l][ 9+50], A[l][10+50],              LodVec(c.s6, X));
+      + MulMatVec08(A[l][10+50], A[l][11+50], A[l][12+50], LodVec(c.s7, X));
+      + MulMatVec09(A[l][12+50], A[l][13+50], A[l][14+50], LodVec(c.s8, X));
+      + MulMatVec10(A[l][14+50], A[l][15+50],              LodVec(c.s9, X));
+      + MulMatVec11(A[l][15+50], A[l][16+50], A[l][17+50], LodVec(c.sa, X));
+      + MulMatVec12(A[l][17+50], A[l][18+50],              LodVec(c.sb, X));
+      + MulMatVec13(A[l][18+50], A[l][19+50], A[l][20+50], LodVec(c.sc, X));
+      + MulMatVec14(A[l][20+50], A[l][21+50],              LodVec(c.sd, X));
+      + MulMatVec15(A[l][21+50], A[l][22+50], A[l][23+50], LodVec(c.se, X));
+      + MulMatVec16(A[l][23+50], A[l][24+50],              LodVec(c.sf, X));
 
    c = C[l][3];
 
-   b += MulMatVec01(A[l][ 0+75], A[l][ 1+75],              X[ c.s0 ]);
-      + MulMatVec02(A[l][ 1+75], A[l][ 2+75], A[l][ 3+75], X[ c.s1 ]);
-      + MulMatVec03(A[l][ 3+75], A[l][ 4+75],              X[ c.s2 ]);
-      + MulMatVec04(A[l][ 4+75], A[l][ 5+75], A[l][ 6+75], X[ c.s3 ]);
-      + MulMatVec05(A[l][ 6+75], A[l][ 7+75],              X[ c.s4 ]);
-      + MulMatVec06(A[l][ 7+75], A[l][ 8+75], A[l][ 9+75], X[ c.s5 ]);
-      + MulMatVec07(A[l][ 9+75], A[l][10+75],              X[ c.s6 ]);
-      + MulMatVec08(A[l][10+75], A[l][11+75], A[l][12+75], X[ c.s7 ]);
-      + MulMatVec09(A[l][12+75], A[l][13+75], A[l][14+75], X[ c.s8 ]);
-      + MulMatVec10(A[l][14+75], A[l][15+75],              X[ c.s9 ]);
-      + MulMatVec11(A[l][15+75], A[l][16+75], A[l][17+75], X[ c.sa ]);
-      + MulMatVec12(A[l][17+75], A[l][18+75],              X[ c.sb ]);
-      + MulMatVec13(A[l][18+75], A[l][19+75], A[l][20+75], X[ c.sc ]);
-      + MulMatVec14(A[l][20+75], A[l][21+75],              X[ c.sd ]);
-      + MulMatVec15(A[l][21+75], A[l][22+75], A[l][23+75], X[ c.se ]);
-      + MulMatVec16(A[l][23+75], A[l][24+75],              X[ c.sf ]);
+   b += MulMatVec01(A[l][ 0+75], A[l][ 1+75],              LodVec(c.s0, X));
+      + MulMatVec02(A[l][ 1+75], A[l][ 2+75], A[l][ 3+75], LodVec(c.s1, X));
+      + MulMatVec03(A[l][ 3+75], A[l][ 4+75],              LodVec(c.s2, X));
+      + MulMatVec04(A[l][ 4+75], A[l][ 5+75], A[l][ 6+75], LodVec(c.s3, X));
+      + MulMatVec05(A[l][ 6+75], A[l][ 7+75],              LodVec(c.s4, X));
+      + MulMatVec06(A[l][ 7+75], A[l][ 8+75], A[l][ 9+75], LodVec(c.s5, X));
+      + MulMatVec07(A[l][ 9+75], A[l][10+75],              LodVec(c.s6, X));
+      + MulMatVec08(A[l][10+75], A[l][11+75], A[l][12+75], LodVec(c.s7, X));
+      + MulMatVec09(A[l][12+75], A[l][13+75], A[l][14+75], LodVec(c.s8, X));
+      + MulMatVec10(A[l][14+75], A[l][15+75],              LodVec(c.s9, X));
+      + MulMatVec11(A[l][15+75], A[l][16+75], A[l][17+75], LodVec(c.sa, X));
+      + MulMatVec12(A[l][17+75], A[l][18+75],              LodVec(c.sb, X));
+      + MulMatVec13(A[l][18+75], A[l][19+75], A[l][20+75], LodVec(c.sc, X));
+      + MulMatVec14(A[l][20+75], A[l][21+75],              LodVec(c.sd, X));
+      + MulMatVec15(A[l][21+75], A[l][22+75], A[l][23+75], LodVec(c.se, X));
+      + MulMatVec16(A[l][23+75], A[l][24+75],              LodVec(c.sf, X));
 
    c = C[l][4];
 
-               b += MulMatVec01(A[l][ 0+100], A[l][ 1+100],               X[ c.s0 ]);
-   if(d > 65)  b += MulMatVec02(A[l][ 1+100], A[l][ 2+100], A[l][ 3+100], X[ c.s1 ]);
-   if(d > 66)  b += MulMatVec03(A[l][ 3+100], A[l][ 4+100],               X[ c.s2 ]);
-   if(d > 67)  b += MulMatVec04(A[l][ 4+100], A[l][ 5+100], A[l][ 6+100], X[ c.s3 ]);
-   if(d > 68)  b += MulMatVec05(A[l][ 6+100], A[l][ 7+100],               X[ c.s4 ]);
-   if(d > 69)  b += MulMatVec06(A[l][ 7+100], A[l][ 8+100], A[l][ 9+100], X[ c.s5 ]);
-   if(d > 70)  b += MulMatVec07(A[l][ 9+100], A[l][10+100],               X[ c.s6 ]);
-   if(d > 71)  b += MulMatVec08(A[l][10+100], A[l][11+100], A[l][12+100], X[ c.s7 ]);
-   if(d > 72)  b += MulMatVec09(A[l][12+100], A[l][13+100], A[l][14+100], X[ c.s8 ]);
-   if(d > 73)  b += MulMatVec10(A[l][14+100], A[l][15+100],               X[ c.s9 ]);
-   if(d > 74)  b += MulMatVec11(A[l][15+100], A[l][16+100], A[l][17+100], X[ c.sa ]);
-   if(d > 75)  b += MulMatVec12(A[l][17+100], A[l][18+100],               X[ c.sb ]);
-   if(d > 76)  b += MulMatVec13(A[l][18+100], A[l][19+100], A[l][20+100], X[ c.sc ]);
-   if(d > 77)  b += MulMatVec14(A[l][20+100], A[l][21+100],               X[ c.sd ]);
-   if(d > 78)  b += MulMatVec15(A[l][21+100], A[l][22+100], A[l][23+100], X[ c.se ]);
-   if(d > 79)  b += MulMatVec16(A[l][23+100], A[l][24+100],               X[ c.sf ]);
+               b += MulMatVec01(A[l][ 0+100], A[l][ 1+100],               LodVec(c.s0, X));
+   if(d > 65)  b += MulMatVec02(A[l][ 1+100], A[l][ 2+100], A[l][ 3+100], LodVec(c.s1, X));
+   if(d > 66)  b += MulMatVec03(A[l][ 3+100], A[l][ 4+100],               LodVec(c.s2, X));
+   if(d > 67)  b += MulMatVec04(A[l][ 4+100], A[l][ 5+100], A[l][ 6+100], LodVec(c.s3, X));
+   if(d > 68)  b += MulMatVec05(A[l][ 6+100], A[l][ 7+100],               LodVec(c.s4, X));
+   if(d > 69)  b += MulMatVec06(A[l][ 7+100], A[l][ 8+100], A[l][ 9+100], LodVec(c.s5, X));
+   if(d > 70)  b += MulMatVec07(A[l][ 9+100], A[l][10+100],               LodVec(c.s6, X));
+   if(d > 71)  b += MulMatVec08(A[l][10+100], A[l][11+100], A[l][12+100], LodVec(c.s7, X));
+   if(d > 72)  b += MulMatVec09(A[l][12+100], A[l][13+100], A[l][14+100], LodVec(c.s8, X));
+   if(d > 73)  b += MulMatVec10(A[l][14+100], A[l][15+100],               LodVec(c.s9, X));
+   if(d > 74)  b += MulMatVec11(A[l][15+100], A[l][16+100], A[l][17+100], LodVec(c.sa, X));
+   if(d > 75)  b += MulMatVec12(A[l][17+100], A[l][18+100],               LodVec(c.sb, X));
+   if(d > 76)  b += MulMatVec13(A[l][18+100], A[l][19+100], A[l][20+100], LodVec(c.sc, X));
+   if(d > 77)  b += MulMatVec14(A[l][20+100], A[l][21+100],               LodVec(c.sd, X));
+   if(d > 78)  b += MulMatVec15(A[l][21+100], A[l][22+100], A[l][23+100], LodVec(c.se, X));
+   if(d > 79)  b += MulMatVec16(A[l][23+100], A[l][24+100],               LodVec(c.sf, X));
 
    c = C[l][5];
 
-   if(d > 80)  b += MulMatVec01(A[l][ 0+125], A[l][ 1+125],               X[ c.s0 ]);
-   if(d > 81)  b += MulMatVec02(A[l][ 1+125], A[l][ 2+125], A[l][ 3+125], X[ c.s1 ]);
-   if(d > 82)  b += MulMatVec03(A[l][ 3+125], A[l][ 4+125],               X[ c.s2 ]);
-   if(d > 83)  b += MulMatVec04(A[l][ 4+125], A[l][ 5+125], A[l][ 6+125], X[ c.s3 ]);
-   if(d > 84)  b += MulMatVec05(A[l][ 6+125], A[l][ 7+125],               X[ c.s4 ]);
-   if(d > 85)  b += MulMatVec06(A[l][ 7+125], A[l][ 8+125], A[l][ 9+125], X[ c.s5 ]);
-   if(d > 86)  b += MulMatVec07(A[l][ 9+125], A[l][10+125],               X[ c.s6 ]);
-   if(d > 87)  b += MulMatVec08(A[l][10+125], A[l][11+125], A[l][12+125], X[ c.s7 ]);
-   if(d > 88)  b += MulMatVec09(A[l][12+125], A[l][13+125], A[l][14+125], X[ c.s8 ]);
-   if(d > 89)  b += MulMatVec10(A[l][14+125], A[l][15+125],               X[ c.s9 ]);
-   if(d > 90)  b += MulMatVec11(A[l][15+125], A[l][16+125], A[l][17+125], X[ c.sa ]);
-   if(d > 91)  b += MulMatVec12(A[l][17+125], A[l][18+125],               X[ c.sb ]);
-   if(d > 92)  b += MulMatVec13(A[l][18+125], A[l][19+125], A[l][20+125], X[ c.sc ]);
-   if(d > 93)  b += MulMatVec14(A[l][20+125], A[l][21+125],               X[ c.sd ]);
-   if(d > 94)  b += MulMatVec15(A[l][21+125], A[l][22+125], A[l][23+125], X[ c.se ]);
-   if(d > 95)  b += MulMatVec16(A[l][23+125], A[l][24+125],               X[ c.sf ]);
+   if(d > 80)  b += MulMatVec01(A[l][ 0+125], A[l][ 1+125],               LodVec(c.s0, X));
+   if(d > 81)  b += MulMatVec02(A[l][ 1+125], A[l][ 2+125], A[l][ 3+125], LodVec(c.s1, X));
+   if(d > 82)  b += MulMatVec03(A[l][ 3+125], A[l][ 4+125],               LodVec(c.s2, X));
+   if(d > 83)  b += MulMatVec04(A[l][ 4+125], A[l][ 5+125], A[l][ 6+125], LodVec(c.s3, X));
+   if(d > 84)  b += MulMatVec05(A[l][ 6+125], A[l][ 7+125],               LodVec(c.s4, X));
+   if(d > 85)  b += MulMatVec06(A[l][ 7+125], A[l][ 8+125], A[l][ 9+125], LodVec(c.s5, X));
+   if(d > 86)  b += MulMatVec07(A[l][ 9+125], A[l][10+125],               LodVec(c.s6, X));
+   if(d > 87)  b += MulMatVec08(A[l][10+125], A[l][11+125], A[l][12+125], LodVec(c.s7, X));
+   if(d > 88)  b += MulMatVec09(A[l][12+125], A[l][13+125], A[l][14+125], LodVec(c.s8, X));
+   if(d > 89)  b += MulMatVec10(A[l][14+125], A[l][15+125],               LodVec(c.s9, X));
+   if(d > 90)  b += MulMatVec11(A[l][15+125], A[l][16+125], A[l][17+125], LodVec(c.sa, X));
+   if(d > 91)  b += MulMatVec12(A[l][17+125], A[l][18+125],               LodVec(c.sb, X));
+   if(d > 92)  b += MulMatVec13(A[l][18+125], A[l][19+125], A[l][20+125], LodVec(c.sc, X));
+   if(d > 93)  b += MulMatVec14(A[l][20+125], A[l][21+125],               LodVec(c.sd, X));
+   if(d > 94)  b += MulMatVec15(A[l][21+125], A[l][22+125], A[l][23+125], LodVec(c.se, X));
+   if(d > 95)  b += MulMatVec16(A[l][23+125], A[l][24+125],               LodVec(c.sf, X));
 
    c = C[l][6];
 
-   if(d >  96) b += MulMatVec01(A[l][ 0+150], A[l][ 1+150],               X[ c.s0 ]);
-   if(d >  97) b += MulMatVec02(A[l][ 1+150], A[l][ 2+150], A[l][ 3+150], X[ c.s1 ]);
-   if(d >  98) b += MulMatVec03(A[l][ 3+150], A[l][ 4+150],               X[ c.s2 ]);
-   if(d >  99) b += MulMatVec04(A[l][ 4+150], A[l][ 5+150], A[l][ 6+150], X[ c.s3 ]);
-   if(d > 100) b += MulMatVec05(A[l][ 6+150], A[l][ 7+150],               X[ c.s4 ]);
-   if(d > 101) b += MulMatVec06(A[l][ 7+150], A[l][ 8+150], A[l][ 9+150], X[ c.s5 ]);
-   if(d > 102) b += MulMatVec07(A[l][ 9+150], A[l][10+150],               X[ c.s6 ]);
-   if(d > 103) b += MulMatVec08(A[l][10+150], A[l][11+150], A[l][12+150], X[ c.s7 ]);
-   if(d > 104) b += MulMatVec09(A[l][12+150], A[l][13+150], A[l][14+150], X[ c.s8 ]);
-   if(d > 105) b += MulMatVec10(A[l][14+150], A[l][15+150],               X[ c.s9 ]);
-   if(d > 106) b += MulMatVec11(A[l][15+150], A[l][16+150], A[l][17+150], X[ c.sa ]);
-   if(d > 107) b += MulMatVec12(A[l][17+150], A[l][18+150],               X[ c.sb ]);
-   if(d > 108) b += MulMatVec13(A[l][18+150], A[l][19+150], A[l][20+150], X[ c.sc ]);
-   if(d > 109) b += MulMatVec14(A[l][20+150], A[l][21+150],               X[ c.sd ]);
-   if(d > 110) b += MulMatVec15(A[l][21+150], A[l][22+150], A[l][23+150], X[ c.se ]);
-   if(d > 111) b += MulMatVec16(A[l][23+150], A[l][24+150],               X[ c.sf ]);
+   if(d >  96) b += MulMatVec01(A[l][ 0+150], A[l][ 1+150],               LodVec(c.s0, X));
+   if(d >  97) b += MulMatVec02(A[l][ 1+150], A[l][ 2+150], A[l][ 3+150], LodVec(c.s1, X));
+   if(d >  98) b += MulMatVec03(A[l][ 3+150], A[l][ 4+150],               LodVec(c.s2, X));
+   if(d >  99) b += MulMatVec04(A[l][ 4+150], A[l][ 5+150], A[l][ 6+150], LodVec(c.s3, X));
+   if(d > 100) b += MulMatVec05(A[l][ 6+150], A[l][ 7+150],               LodVec(c.s4, X));
+   if(d > 101) b += MulMatVec06(A[l][ 7+150], A[l][ 8+150], A[l][ 9+150], LodVec(c.s5, X));
+   if(d > 102) b += MulMatVec07(A[l][ 9+150], A[l][10+150],               LodVec(c.s6, X));
+   if(d > 103) b += MulMatVec08(A[l][10+150], A[l][11+150], A[l][12+150], LodVec(c.s7, X));
+   if(d > 104) b += MulMatVec09(A[l][12+150], A[l][13+150], A[l][14+150], LodVec(c.s8, X));
+   if(d > 105) b += MulMatVec10(A[l][14+150], A[l][15+150],               LodVec(c.s9, X));
+   if(d > 106) b += MulMatVec11(A[l][15+150], A[l][16+150], A[l][17+150], LodVec(c.sa, X));
+   if(d > 107) b += MulMatVec12(A[l][17+150], A[l][18+150],               LodVec(c.sb, X));
+   if(d > 108) b += MulMatVec13(A[l][18+150], A[l][19+150], A[l][20+150], LodVec(c.sc, X));
+   if(d > 109) b += MulMatVec14(A[l][20+150], A[l][21+150],               LodVec(c.sd, X));
+   if(d > 110) b += MulMatVec15(A[l][21+150], A[l][22+150], A[l][23+150], LodVec(c.se, X));
+   if(d > 111) b += MulMatVec16(A[l][23+150], A[l][24+150],               LodVec(c.sf, X));
 
    c = C[l][7];
 
-   if(d > 112) b += MulMatVec01(A[l][ 0+175], A[l][ 1+175],               X[ c.s0 ]);
-   if(d > 113) b += MulMatVec02(A[l][ 1+175], A[l][ 2+175], A[l][ 3+175], X[ c.s1 ]);
-   if(d > 114) b += MulMatVec03(A[l][ 3+175], A[l][ 4+175],               X[ c.s2 ]);
-   if(d > 115) b += MulMatVec04(A[l][ 4+175], A[l][ 5+175], A[l][ 6+175], X[ c.s3 ]);
-   if(d > 116) b += MulMatVec05(A[l][ 6+175], A[l][ 7+175],               X[ c.s4 ]);
-   if(d > 117) b += MulMatVec06(A[l][ 7+175], A[l][ 8+175], A[l][ 9+175], X[ c.s5 ]);
-   if(d > 118) b += MulMatVec07(A[l][ 9+175], A[l][10+175],               X[ c.s6 ]);
-   if(d > 119) b += MulMatVec08(A[l][10+175], A[l][11+175], A[l][12+175], X[ c.s7 ]);
-   if(d > 120) b += MulMatVec09(A[l][12+175], A[l][13+175], A[l][14+175], X[ c.s8 ]);
-   if(d > 121) b += MulMatVec10(A[l][14+175], A[l][15+175],               X[ c.s9 ]);
-   if(d > 122) b += MulMatVec11(A[l][15+175], A[l][16+175], A[l][17+175], X[ c.sa ]);
-   if(d > 123) b += MulMatVec12(A[l][17+175], A[l][18+175],               X[ c.sb ]);
-   if(d > 124) b += MulMatVec13(A[l][18+175], A[l][19+175], A[l][20+175], X[ c.sc ]);
-   if(d > 125) b += MulMatVec14(A[l][20+175], A[l][21+175],               X[ c.sd ]);
-   if(d > 126) b += MulMatVec15(A[l][21+175], A[l][22+175], A[l][23+175], X[ c.se ]);
-   if(d > 127) b += MulMatVec16(A[l][23+175], A[l][24+175],               X[ c.sf ]);
-
-   B[l+N.s1] = b;
+   if(d > 112) b += MulMatVec01(A[l][ 0+175], A[l][ 1+175],               LodVec(c.s0, X));
+   if(d > 113) b += MulMatVec02(A[l][ 1+175], A[l][ 2+175], A[l][ 3+175], LodVec(c.s1, X));
+   if(d > 114) b += MulMatVec03(A[l][ 3+175], A[l][ 4+175],               LodVec(c.s2, X));
+   if(d > 115) b += MulMatVec04(A[l][ 4+175], A[l][ 5+175], A[l][ 6+175], LodVec(c.s3, X));
+   if(d > 116) b += MulMatVec05(A[l][ 6+175], A[l][ 7+175],               LodVec(c.s4, X));
+   if(d > 117) b += MulMatVec06(A[l][ 7+175], A[l][ 8+175], A[l][ 9+175], LodVec(c.s5, X));
+   if(d > 118) b += MulMatVec07(A[l][ 9+175], A[l][10+175],               LodVec(c.s6, X));
+   if(d > 119) b += MulMatVec08(A[l][10+175], A[l][11+175], A[l][12+175], LodVec(c.s7, X));
+   if(d > 120) b += MulMatVec09(A[l][12+175], A[l][13+175], A[l][14+175], LodVec(c.s8, X));
+   if(d > 121) b += MulMatVec10(A[l][14+175], A[l][15+175],               LodVec(c.s9, X));
+   if(d > 122) b += MulMatVec11(A[l][15+175], A[l][16+175], A[l][17+175], LodVec(c.sa, X));
+   if(d > 123) b += MulMatVec12(A[l][17+175], A[l][18+175],               LodVec(c.sb, X));
+   if(d > 124) b += MulMatVec13(A[l][18+175], A[l][19+175], A[l][20+175], LodVec(c.sc, X));
+   if(d > 125) b += MulMatVec14(A[l][20+175], A[l][21+175],               LodVec(c.sd, X));
+   if(d > 126) b += MulMatVec15(A[l][21+175], A[l][22+175], A[l][23+175], LodVec(c.se, X));
+   if(d > 127) b += MulMatVec16(A[l][23+175], A[l][24+175],               LodVec(c.sf, X));
+
+   StoVec(b, l+N.s1, B);
 }
 
 __kernel void MulMatVecSlc256(__global int   *D,
                               __global int16 (*C)[16],
                               __global fpn16 (*A)[400],
-                              __global fpn8  *B,
-                              __global fpn8  *X,
+                              __global VecTyp *B,
+                              __global VecTyp *X,
                               __global void  *par,
                               const int2     N )
 {
@@ -1336,309 +1385,309 @@ __kernel void MulMatVecSlc256(__global int   *D,
    d = D[l];
    c = C[l][0];
 
-   b  = MulMatVec01(A[l][ 0], A[l][ 1],           X[ c.s0 ]);
-      + MulMatVec02(A[l][ 1], A[l][ 2], A[l][ 3], X[ c.s1 ]);
-      + MulMatVec03(A[l][ 3], A[l][ 4],           X[ c.s2 ]);
-      + MulMatVec04(A[l][ 4], A[l][ 5], A[l][ 6], X[ c.s3 ]);
-      + MulMatVec05(A[l][ 6], A[l][ 7],           X[ c.s4 ]);
-      + MulMatVec06(A[l][ 7], A[l][ 8], A[l][ 9], X[ c.s5 ]);
-      + MulMatVec07(A[l][ 9], A[l][10],           X[ c.s6 ]);
-      + MulMatVec08(A[l][10], A[l][11], A[l][12], X[ c.s7 ]);
-      + MulMatVec09(A[l][12], A[l][13], A[l][14], X[ c.s8 ]);
-      + MulMatVec10(A[l][14], A[l][15],           X[ c.s9 ]);
-      + MulMatVec11(A[l][15], A[l][16], A[l][17], X[ c.sa ]);
-      + MulMatVec12(A[l][17], A[l][18],           X[ c.sb ]);
-      + MulMatVec13(A[l][18], A[l][19], A[l][20], X[ c.sc ]);
-      + MulMatVec14(A[l][20], A[l][21],           X[ c.sd ]);
-      + MulMatVec15(A[l][21], A[l][22], A[l][23], X[ c.se ]);
-      + MulMatVec16(A[l][23], A[l][24],           X[ c.sf ]);
+   b  = MulMatVec01(A[l][ 0], A[l][ 1],           LodVec(c.s0, X));
+      + MulMatVec02(A[l][ 1], A[l][ 2], A[l][ 3], LodVec(c.s1, X));
+      + MulMatVec03(A[l][ 3], A[l][ 4],           LodVec(c.s2, X));
+      + MulMatVec04(A[l][ 4], A[l][ 5], A[l][ 6], LodVec(c.s3, X));
+      + MulMatVec05(A[l][ 6], A[l][ 7],           LodVec(c.s4, X));
+      + MulMatVec06(A[l][ 7], A[l][ 8], A[l][ 9], LodVec(c.s5, X));
+      + MulMatVec07(A[l][ 9], A[l][10],           LodVec(c.s6, X));
+      + MulMatVec08(A[l][10], A[l][11], A[l][12], LodVec(c.s7, X));
+      + MulMatVec09(A[l][12], A[l][13], A[l][14], LodVec(c.s8, X));
+      + MulMatVec10(A[l][14], A[l][15],           LodVec(c.s9, X));
+      + MulMatVec11(A[l][15], A[l][16], A[l][17], LodVec(c.sa, X));
+      + MulMatVec12(A[l][17], A[l][18],           LodVec(c.sb, X));
+      + MulMatVec13(A[l][18], A[l][19], A[l][20], LodVec(c.sc, X));
+      + MulMatVec14(A[l][20], A[l][21],           LodVec(c.sd, X));
+      + MulMatVec15(A[l][21], A[l][22], A[l][23], LodVec(c.se, X));
+      + MulMatVec16(A[l][23], A[l][24],           LodVec(c.sf, X));
 
    c = C[l][1];
 
-   b += MulMatVec01(A[l][ 0+25], A[l][ 1+25],              X[ c.s0 ]);
-      + MulMatVec02(A[l][ 1+25], A[l][ 2+25], A[l][ 3+25], X[ c.s1 ]);
-      + MulMatVec03(A[l][ 3+25], A[l][ 4+25],              X[ c.s2 ]);
-      + MulMatVec04(A[l][ 4+25], A[l][ 5+25], A[l][ 6+25], X[ c.s3 ]);
-      + MulMatVec05(A[l][ 6+25], A[l][ 7+25],              X[ c.s4 ]);
-      + MulMatVec06(A[l][ 7+25], A[l][ 8+25], A[l][ 9+25], X[ c.s5 ]);
-      + MulMatVec07(A[l][ 9+25], A[l][10+25],              X[ c.s6 ]);
-      + MulMatVec08(A[l][10+25], A[l][11+25], A[l][12+25], X[ c.s7 ]);
-      + MulMatVec09(A[l][12+25], A[l][13+25], A[l][14+25], X[ c.s8 ]);
-      + MulMatVec10(A[l][14+25], A[l][15+25],              X[ c.s9 ]);
-      + MulMatVec11(A[l][15+25], A[l][16+25], A[l][17+25], X[ c.sa ]);
-      + MulMatVec12(A[l][17+25], A[l][18+25],              X[ c.sb ]);
-      + MulMatVec13(A[l][18+25], A[l][19+25], A[l][20+25], X[ c.sc ]);
-      + MulMatVec14(A[l][20+25], A[l][21+25],              X[ c.sd ]);
-      + MulMatVec15(A[l][21+25], A[l][22+25], A[l][23+25], X[ c.se ]);
-      + MulMatVec16(A[l][23+25], A[l][24+25],              X[ c.sf ]);
+   b += MulMatVec01(A[l][ 0+25], A[l][ 1+25],              LodVec(c.s0, X));
+      + MulMatVec02(A[l][ 1+25], A[l][ 2+25], A[l][ 3+25], LodVec(c.s1, X));
+      + MulMatVec03(A[l][ 3+25], A[l][ 4+25],              LodVec(c.s2, X));
+      + MulMatVec04(A[l][ 4+25], A[l][ 5+25], A[l][ 6+25], LodVec(c.s3, X));
+      + MulMatVec05(A[l][ 6+25], A[l][ 7+25],              LodVec(c.s4, X));
+      + MulMatVec06(A[l][ 7+25], A[l][ 8+25], A[l][ 9+25], LodVec(c.s5, X));
+      + MulMatVec07(A[l][ 9+25], A[l][10+25],              LodVec(c.s6, X));
+      + MulMatVec08(A[l][10+25], A[l][11+25], A[l][12+25], LodVec(c.s7, X));
+      + MulMatVec09(A[l][12+25], A[l][13+25], A[l][14+25], LodVec(c.s8, X));
+      + MulMatVec10(A[l][14+25], A[l][15+25],              LodVec(c.s9, X));
+      + MulMatVec11(A[l][15+25], A[l][16+25], A[l][17+25], LodVec(c.sa, X));
+      + MulMatVec12(A[l][17+25], A[l][18+25],              LodVec(c.sb, X));
+      + MulMatVec13(A[l][18+25], A[l][19+25], A[l][20+25], LodVec(c.sc, X));
+      + MulMatVec14(A[l][20+25], A[l][21+25],              LodVec(c.sd, X));
+      + MulMatVec15(A[l][21+25], A[l][22+25], A[l][23+25], LodVec(c.se, X));
+      + MulMatVec16(A[l][23+25], A[l][24+25],              LodVec(c.sf, X));
 
    c = C[l][2];
 
-   b += MulMatVec01(A[l][ 0+50], A[l][ 1+50],              X[ c.s0 ]);
-      + MulMatVec02(A[l][ 1+50], A[l][ 2+50], A[l][ 3+50], X[ c.s1 ]);
-      + MulMatVec03(A[l][ 3+50], A[l][ 4+50],              X[ c.s2 ]);
-      + MulMatVec04(A[l][ 4+50], A[l][ 5+50], A[l][ 6+50], X[ c.s3 ]);
-      + MulMatVec05(A[l][ 6+50], A[l][ 7+50],              X[ c.s4 ]);
-      + MulMatVec06(A[l][ 7+50], A[l][ 8+50], A[l][ 9+50], X[ c.s5 ]);
-      + MulMatVec07(A[l][ 9+50], A[l][10+50],              X[ c.s6 ]);
-      + MulMatVec08(A[l][10+50], A[l][11+50], A[l][12+50], X[ c.s7 ]);
-      + MulMatVec09(A[l][12+50], A[l][13+50], A[l][14+50], X[ c.s8 ]);
-      + MulMatVec10(A[l][14+50], A[l][15+50],              X[ c.s9 ]);
-      + MulMatVec11(A[l][15+50], A[l][16+50], A[l][17+50], X[ c.sa ]);
-      + MulMatVec12(A[l][17+50], A[l][18+50],              X[ c.sb ]);
-      + MulMatVec13(A[l][18+50], A[l][19+50], A[l][20+50], X[ c.sc ]);
-      + MulMatVec14(A[l][20+50], A[l][21+50],              X[ c.sd ]);
-      + MulMatVec15(A[l][21+50], A[l][22+50], A[l][23+50], X[ c.se ]);
-      + MulMatVec16(A[l][23+50], A[l][24+50],              X[ c.sf ]);
+   b += MulMatVec01(A[l][ 0+50], A[l][ 1+50],              LodVec(c.s0, X));
+      + MulMatVec02(A[l][ 1+50], A[l][ 2+50], A[l][ 3+50], LodVec(c.s1, X));
+      + MulMatVec03(A[l][ 3+50], A[l][ 4+50],              LodVec(c.s2, X));
+      + MulMatVec04(A[l][ 4+50], A[l][ 5+50], A[l][ 6+50], LodVec(c.s3, X));
+      + MulMatVec05(A[l][ 6+50], A[l][ 7+50],              LodVec(c.s4, X));
+      + MulMatVec06(A[l][ 7+50], A[l][ 8+50], A[l][ 9+50], LodVec(c.s5, X));
+      + MulMatVec07(A[l][ 9+50], A[l][10+50],              LodVec(c.s6, X));
+      + MulMatVec08(A[l][10+50], A[l][11+50], A[l][12+50], LodVec(c.s7, X));
+      + MulMatVec09(A[l][12+50], A[l][13+50], A[l][14+50], LodVec(c.s8, X));
+      + MulMatVec10(A[l][14+50], A[l][15+50],              LodVec(c.s9, X));
+      + MulMatVec11(A[l][15+50], A[l][16+50], A[l][17+50], LodVec(c.sa, X));
+      + MulMatVec12(A[l][17+50], A[l][18+50],              LodVec(c.sb, X));
+      + MulMatVec13(A[l][18+50], A[l][19+50], A[l][20+50], LodVec(c.sc, X));
+      + MulMatVec14(A[l][20+50], A[l][21+50],              LodVec(c.sd, X));
+      + MulMatVec15(A[l][21+50], A[l][22+50], A[l][23+50], LodVec(c.se, X));
+      + MulMatVec16(A[l][23+50], A[l][24+50],              LodVec(c.sf, X));
 
    c = C[l][3];
 
-   b += MulMatVec01(A[l][ 0+75], A[l][ 1+75],              X[ c.s0 ]);
-      + MulMatVec02(A[l][ 1+75], A[l][ 2+75], A[l][ 3+75], X[ c.s1 ]);
-      + MulMatVec03(A[l][ 3+75], A[l][ 4+75],              X[ c.s2 ]);
-      + MulMatVec04(A[l][ 4+75], A[l][ 5+75], A[l][ 6+75], X[ c.s3 ]);
-      + MulMatVec05(A[l][ 6+75], A[l][ 7+75],              X[ c.s4 ]);
-      + MulMatVec06(A[l][ 7+75], A[l][ 8+75], A[l][ 9+75], X[ c.s5 ]);
-      + MulMatVec07(A[l][ 9+75], A[l][10+75],              X[ c.s6 ]);
-      + MulMatVec08(A[l][10+75], A[l][11+75], A[l][12+75], X[ c.s7 ]);
-      + MulMatVec09(A[l][12+75], A[l][13+75], A[l][14+75], X[ c.s8 ]);
-      + MulMatVec10(A[l][14+75], A[l][15+75],              X[ c.s9 ]);
-      + MulMatVec11(A[l][15+75], A[l][16+75], A[l][17+75], X[ c.sa ]);
-      + MulMatVec12(A[l][17+75], A[l][18+75],              X[ c.sb ]);
-      + MulMatVec13(A[l][18+75], A[l][19+75], A[l][20+75], X[ c.sc ]);
-      + MulMatVec14(A[l][20+75], A[l][21+75],              X[ c.sd ]);
-      + MulMatVec15(A[l][21+75], A[l][22+75], A[l][23+75], X[ c.se ]);
-      + MulMatVec16(A[l][23+75], A[l][24+75],              X[ c.sf ]);
+   b += MulMatVec01(A[l][ 0+75], A[l][ 1+75],              LodVec(c.s0, X));
+      + MulMatVec02(A[l][ 1+75], A[l][ 2+75], A[l][ 3+75], LodVec(c.s1, X));
+      + MulMatVec03(A[l][ 3+75], A[l][ 4+75],              LodVec(c.s2, X));
+      + MulMatVec04(A[l][ 4+75], A[l][ 5+75], A[l][ 6+75], LodVec(c.s3, X));
+      + MulMatVec05(A[l][ 6+75], A[l][ 7+75],              LodVec(c.s4, X));
+      + MulMatVec06(A[l][ 7+75], A[l][ 8+75], A[l][ 9+75], LodVec(c.s5, X));
+      + MulMatVec07(A[l][ 9+75], A[l][10+75],              LodVec(c.s6, X));
+      + MulMatVec08(A[l][10+75], A[l][11+75], A[l][12+75], LodVec(c.s7, X));
+      + MulMatVec09(A[l][12+75], A[l][13+75], A[l][14+75], LodVec(c.s8, X));
+      + MulMatVec10(A[l][14+75], A[l][15+75],              LodVec(c.s9, X));
+      + MulMatVec11(A[l][15+75], A[l][16+75], A[l][17+75], LodVec(c.sa, X));
+      + MulMatVec12(A[l][17+75], A[l][18+75],              LodVec(c.sb, X));
+      + MulMatVec13(A[l][18+75], A[l][19+75], A[l][20+75], LodVec(c.sc, X));
+      + MulMatVec14(A[l][20+75], A[l][21+75],              LodVec(c.sd, X));
+      + MulMatVec15(A[l][21+75], A[l][22+75], A[l][23+75], LodVec(c.se, X));
+      + MulMatVec16(A[l][23+75], A[l][24+75],              LodVec(c.sf, X));
 
    c = C[l][4];
 
-   b += MulMatVec01(A[l][ 0+100], A[l][ 1+100],               X[ c.s0 ]);
-      + MulMatVec02(A[l][ 1+100], A[l][ 2+100], A[l][ 3+100], X[ c.s1 ]);
-      + MulMatVec03(A[l][ 3+100], A[l][ 4+100],               X[ c.s2 ]);
-      + MulMatVec04(A[l][ 4+100], A[l][ 5+100], A[l][ 6+100], X[ c.s3 ]);
-      + MulMatVec05(A[l][ 6+100], A[l][ 7+100],               X[ c.s4 ]);
-      + MulMatVec06(A[l][ 7+100], A[l][ 8+100], A[l][ 9+100], X[ c.s5 ]);
-      + MulMatVec07(A[l][ 9+100], A[l][10+100],               X[ c.s6 ]);
-      + MulMatVec08(A[l][10+100], A[l][11+100], A[l][12+100], X[ c.s7 ]);
-      + MulMatVec09(A[l][12+100], A[l][13+100], A[l][14+100], X[ c.s8 ]);
-      + MulMatVec10(A[l][14+100], A[l][15+100],               X[ c.s9 ]);
-      + MulMatVec11(A[l][15+100], A[l][16+100], A[l][17+100], X[ c.sa ]);
-      + MulMatVec12(A[l][17+100], A[l][18+100],               X[ c.sb ]);
-      + MulMatVec13(A[l][18+100], A[l][19+100], A[l][20+100], X[ c.sc ]);
-      + MulMatVec14(A[l][20+100], A[l][21+100],               X[ c.sd ]);
-      + MulMatVec15(A[l][21+100], A[l][22+100], A[l][23+100], X[ c.se ]);
-      + MulMatVec16(A[l][23+100], A[l][24+100],               X[ c.sf ]);
+   b += MulMatVec01(A[l][ 0+100], A[l][ 1+100],               LodVec(c.s0, X));
+      + MulMatVec02(A[l][ 1+100], A[l][ 2+100], A[l][ 3+100], LodVec(c.s1, X));
+      + MulMatVec03(A[l][ 3+100], A[l][ 4+100],               LodVec(c.s2, X));
+      + MulMatVec04(A[l][ 4+100], A[l][ 5+100], A[l][ 6+100], LodVec(c.s3, X));
+      + MulMatVec05(A[l][ 6+100], A[l][ 7+100],               LodVec(c.s4, X));
+      + MulMatVec06(A[l][ 7+100], A[l][ 8+100], A[l][ 9+100], LodVec(c.s5, X));
+      + MulMatVec07(A[l][ 9+100], A[l][10+100],               LodVec(c.s6, X));
+      + MulMatVec08(A[l][10+100], A[l][11+100], A[l][12+100], LodVec(c.s7, X));
+      + MulMatVec09(A[l][12+100], A[l][13+100], A[l][14+100], LodVec(c.s8, X));
+      + MulMatVec10(A[l][14+100], A[l][15+100],               LodVec(c.s9, X));
+      + MulMatVec11(A[l][15+100], A[l][16+100], A[l][17+100], LodVec(c.sa, X));
+      + MulMatVec12(A[l][17+100], A[l][18+100],               LodVec(c.sb, X));
+      + MulMatVec13(A[l][18+100], A[l][19+100], A[l][20+100], LodVec(c.sc, X));
+      + MulMatVec14(A[l][20+100], A[l][21+100],               LodVec(c.sd, X));
+      + MulMatVec15(A[l][21+100], A[l][22+100], A[l][23+100], LodVec(c.se, X));
+      + MulMatVec16(A[l][23+100], A[l][24+100],               LodVec(c.sf, X));
 
    c = C[l][5];
 
-   b += MulMatVec01(A[l][ 0+125], A[l][ 1+125],               X[ c.s0 ]);
-      + MulMatVec02(A[l][ 1+125], A[l][ 2+125], A[l][ 3+125], X[ c.s1 ]);
-      + MulMatVec03(A[l][ 3+125], A[l][ 4+125],               X[ c.s2 ]);
-      + MulMatVec04(A[l][ 4+125], A[l][ 5+125], A[l][ 6+125], X[ c.s3 ]);
-      + MulMatVec05(A[l][ 6+125], A[l][ 7+125],               X[ c.s4 ]);
-      + MulMatVec06(A[l][ 7+125], A[l][ 8+125], A[l][ 9+125], X[ c.s5 ]);
-      + MulMatVec07(A[l][ 9+125], A[l][10+125],               X[ c.s6 ]);
-      + MulMatVec08(A[l][10+125], A[l][11+125], A[l][12+125], X[ c.s7 ]);
-      + MulMatVec09(A[l][12+125], A[l][13+125], A[l][14+125], X[ c.s8 ]);
-      + MulMatVec10(A[l][14+125], A[l][15+125],               X[ c.s9 ]);
-      + MulMatVec11(A[l][15+125], A[l][16+125], A[l][17+125], X[ c.sa ]);
-      + MulMatVec12(A[l][17+125], A[l][18+125],               X[ c.sb ]);
-      + MulMatVec13(A[l][18+125], A[l][19+125], A[l][20+125], X[ c.sc ]);
-      + MulMatVec14(A[l][20+125], A[l][21+125],               X[ c.sd ]);
-      + MulMatVec15(A[l][21+125], A[l][22+125], A[l][23+125], X[ c.se ]);
-      + MulMatVec16(A[l][23+125], A[l][24+125],               X[ c.sf ]);
+   b += MulMatVec01(A[l][ 0+125], A[l][ 1+125],               LodVec(c.s0, X));
+      + MulMatVec02(A[l][ 1+125], A[l][ 2+125], A[l][ 3+125], LodVec(c.s1, X));
+      + MulMatVec03(A[l][ 3+125], A[l][ 4+125],               LodVec(c.s2, X));
+      + MulMatVec04(A[l][ 4+125], A[l][ 5+125], A[l][ 6+125], LodVec(c.s3, X));
+      + MulMatVec05(A[l][ 6+125], A[l][ 7+125],               LodVec(c.s4, X));
+      + MulMatVec06(A[l][ 7+125], A[l][ 8+125], A[l][ 9+125], LodVec(c.s5, X));
+      + MulMatVec07(A[l][ 9+125], A[l][10+125],               LodVec(c.s6, X));
+      + MulMatVec08(A[l][10+125], A[l][11+125], A[l][12+125], LodVec(c.s7, X));
+      + MulMatVec09(A[l][12+125], A[l][13+125], A[l][14+125], LodVec(c.s8, X));
+      + MulMatVec10(A[l][14+125], A[l][15+125],               LodVec(c.s9, X));
+      + MulMatVec11(A[l][15+125], A[l][16+125], A[l][17+125], LodVec(c.sa, X));
+      + MulMatVec12(A[l][17+125], A[l][18+125],               LodVec(c.sb, X));
+      + MulMatVec13(A[l][18+125], A[l][19+125], A[l][20+125], LodVec(c.sc, X));
+      + MulMatVec14(A[l][20+125], A[l][21+125],               LodVec(c.sd, X));
+      + MulMatVec15(A[l][21+125], A[l][22+125], A[l][23+125], LodVec(c.se, X));
+      + MulMatVec16(A[l][23+125], A[l][24+125],               LodVec(c.sf, X));
 
    c = C[l][6];
 
-   b += MulMatVec01(A[l][ 0+150], A[l][ 1+150],               X[ c.s0 ]);
-      + MulMatVec02(A[l][ 1+150], A[l][ 2+150], A[l][ 3+150], X[ c.s1 ]);
-      + MulMatVec03(A[l][ 3+150], A[l][ 4+150],               X[ c.s2 ]);
-      + MulMatVec04(A[l][ 4+150], A[l][ 5+150], A[l][ 6+150], X[ c.s3 ]);
-      + MulMatVec05(A[l][ 6+150], A[l][ 7+150],               X[ c.s4 ]);
-      + MulMatVec06(A[l][ 7+150], A[l][ 8+150], A[l][ 9+150], X[ c.s5 ]);
-      + MulMatVec07(A[l][ 9+150], A[l][10+150],               X[ c.s6 ]);
-      + MulMatVec08(A[l][10+150], A[l][11+150], A[l][12+150], X[ c.s7 ]);
-      + MulMatVec09(A[l][12+150], A[l][13+150], A[l][14+150], X[ c.s8 ]);
-      + MulMatVec10(A[l][14+150], A[l][15+150],               X[ c.s9 ]);
-      + MulMatVec11(A[l][15+150], A[l][16+150], A[l][17+150], X[ c.sa ]);
-      + MulMatVec12(A[l][17+150], A[l][18+150],               X[ c.sb ]);
-      + MulMatVec13(A[l][18+150], A[l][19+150], A[l][20+150], X[ c.sc ]);
-      + MulMatVec14(A[l][20+150], A[l][21+150],               X[ c.sd ]);
-      + MulMatVec15(A[l][21+150], A[l][22+150], A[l][23+150], X[ c.se ]);
-      + MulMatVec16(A[l][23+150], A[l][24+150],               X[ c.sf ]);
+   b += MulMatVec01(A[l][ 0+150], A[l][ 1+150],               LodVec(c.s0, X));
+      + MulMatVec02(A[l][ 1+150], A[l][ 2+150], A[l][ 3+150], LodVec(c.s1, X));
+      + MulMatVec03(A[l][ 3+150], A[l][ 4+150],               LodVec(c.s2, X));
+      + MulMatVec04(A[l][ 4+150], A[l][ 5+150], A[l][ 6+150], LodVec(c.s3, X));
+      + MulMatVec05(A[l][ 6+150], A[l][ 7+150],               LodVec(c.s4, X));
+      + MulMatVec06(A[l][ 7+150], A[l][ 8+150], A[l][ 9+150], LodVec(c.s5, X));
+      + MulMatVec07(A[l][ 9+150], A[l][10+150],               LodVec(c.s6, X));
+      + MulMatVec08(A[l][10+150], A[l][11+150], A[l][12+150], LodVec(c.s7, X));
+      + MulMatVec09(A[l][12+150], A[l][13+150], A[l][14+150], LodVec(c.s8, X));
+      + MulMatVec10(A[l][14+150], A[l][15+150],               LodVec(c.s9, X));
+      + MulMatVec11(A[l][15+150], A[l][16+150], A[l][17+150], LodVec(c.sa, X));
+      + MulMatVec12(A[l][17+150], A[l][18+150],               LodVec(c.sb, X));
+      + MulMatVec13(A[l][18+150], A[l][19+150], A[l][20+150], LodVec(c.sc, X));
+      + MulMatVec14(A[l][20+150], A[l][21+150],               LodVec(c.sd, X));
+      + MulMatVec15(A[l][21+150], A[l][22+150], A[l][23+150], LodVec(c.se, X));
+      + MulMatVec16(A[l][23+150], A[l][24+150],               LodVec(c.sf, X));
 
    c = C[l][7];
 
-   b += MulMatVec01(A[l][ 0+175], A[l][ 1+175],               X[ c.s0 ]);
-      + MulMatVec02(A[l][ 1+175], A[l][ 2+175], A[l][ 3+175], X[ c.s1 ]);
-      + MulMatVec03(A[l][ 3+175], A[l][ 4+175],               X[ c.s2 ]);
-      + MulMatVec04(A[l][ 4+175], A[l][ 5+175], A[l][ 6+175], X[ c.s3 ]);
-      + MulMatVec05(A[l][ 6+175], A[l][ 7+175],               X[ c.s4 ]);
-      + MulMatVec06(A[l][ 7+175], A[l][ 8+175], A[l][ 9+175], X[ c.s5 ]);
-      + MulMatVec07(A[l][ 9+175], A[l][10+175],               X[ c.s6 ]);
-      + MulMatVec08(A[l][10+175], A[l][11+175], A[l][12+175], X[ c.s7 ]);
-      + MulMatVec09(A[l][12+175], A[l][13+175], A[l][14+175], X[ c.s8 ]);
-      + MulMatVec10(A[l][14+175], A[l][15+175],               X[ c.s9 ]);
-      + MulMatVec11(A[l][15+175], A[l][16+175], A[l][17+175], X[ c.sa ]);
-      + MulMatVec12(A[l][17+175], A[l][18+175],               X[ c.sb ]);
-      + MulMatVec13(A[l][18+175], A[l][19+175], A[l][20+175], X[ c.sc ]);
-      + MulMatVec14(A[l][20+175], A[l][21+175],               X[ c.sd ]);
-      + MulMatVec15(A[l][21+175], A[l][22+175], A[l][23+175], X[ c.se ]);
-      + MulMatVec16(A[l][23+175], A[l][24+175],               X[ c.sf ]);
+   b += MulMatVec01(A[l][ 0+175], A[l][ 1+175],               LodVec(c.s0, X));
+      + MulMatVec02(A[l][ 1+175], A[l][ 2+175], A[l][ 3+175], LodVec(c.s1, X));
+      + MulMatVec03(A[l][ 3+175], A[l][ 4+175],               LodVec(c.s2, X));
+      + MulMatVec04(A[l][ 4+175], A[l][ 5+175], A[l][ 6+175], LodVec(c.s3, X));
+      + MulMatVec05(A[l][ 6+175], A[l][ 7+175],               LodVec(c.s4, X));
+      + MulMatVec06(A[l][ 7+175], A[l][ 8+175], A[l][ 9+175], LodVec(c.s5, X));
+      + MulMatVec07(A[l][ 9+175], A[l][10+175],               LodVec(c.s6, X));
+      + MulMatVec08(A[l][10+175], A[l][11+175], A[l][12+175], LodVec(c.s7, X));
+      + MulMatVec09(A[l][12+175], A[l][13+175], A[l][14+175], LodVec(c.s8, X));
+      + MulMatVec10(A[l][14+175], A[l][15+175],               LodVec(c.s9, X));
+      + MulMatVec11(A[l][15+175], A[l][16+175], A[l][17+175], LodVec(c.sa, X));
+      + MulMatVec12(A[l][17+175], A[l][18+175],               LodVec(c.sb, X));
+      + MulMatVec13(A[l][18+175], A[l][19+175], A[l][20+175], LodVec(c.sc, X));
+      + MulMatVec14(A[l][20+175], A[l][21+175],               LodVec(c.sd, X));
+      + MulMatVec15(A[l][21+175], A[l][22+175], A[l][23+175], LodVec(c.se, X));
+      + MulMatVec16(A[l][23+175], A[l][24+175],               LodVec(c.sf, X));
 
    c = C[l][8];
 
-               b += MulMatVec01(A[l][ 0+200], A[l][ 1+200],               X[ c.s0 ]);
-   if(d > 129) b += MulMatVec02(A[l][ 1+200], A[l][ 2+200], A[l][ 3+200], X[ c.s1 ]);
-   if(d > 130) b += MulMatVec03(A[l][ 3+200], A[l][ 4+200],               X[ c.s2 ]);
-   if(d > 131) b += MulMatVec04(A[l][ 4+200], A[l][ 5+200], A[l][ 6+200], X[ c.s3 ]);
-   if(d > 132) b += MulMatVec05(A[l][ 6+200], A[l][ 7+200],               X[ c.s4 ]);
-   if(d > 133) b += MulMatVec06(A[l][ 7+200], A[l][ 8+200], A[l][ 9+200], X[ c.s5 ]);
-   if(d > 134) b += MulMatVec07(A[l][ 9+200], A[l][10+200],               X[ c.s6 ]);
-   if(d > 135) b += MulMatVec08(A[l][10+200], A[l][11+200], A[l][12+200], X[ c.s7 ]);
-   if(d > 136) b += MulMatVec09(A[l][12+200], A[l][13+200], A[l][14+200], X[ c.s8 ]);
-   if(d > 137) b += MulMatVec10(A[l][14+200], A[l][15+200],               X[ c.s9 ]);
-   if(d > 138) b += MulMatVec11(A[l][15+200], A[l][16+200], A[l][17+200], X[ c.sa ]);
-   if(d > 139) b += MulMatVec12(A[l][17+200], A[l][18+200],               X[ c.sb ]);
-   if(d > 140) b += MulMatVec13(A[l][18+200], A[l][19+200], A[l][20+200], X[ c.sc ]);
-   if(d > 141) b += MulMatVec14(A[l][20+200], A[l][21+200],               X[ c.sd ]);
-   if(d > 142) b += MulMatVec15(A[l][21+200], A[l][22+200], A[l][23+200], X[ c.se ]);
-   if(d > 143) b += MulMatVec16(A[l][23+200], A[l][24+200],               X[ c.sf ]);
+               b += MulMatVec01(A[l][ 0+200], A[l][ 1+200],               LodVec(c.s0, X));
+   if(d > 129) b += MulMatVec02(A[l][ 1+200], A[l][ 2+200], A[l][ 3+200], LodVec(c.s1, X));
+   if(d > 130) b += MulMatVec03(A[l][ 3+200], A[l][ 4+200],               LodVec(c.s2, X));
+   if(d > 131) b += MulMatVec04(A[l][ 4+200], A[l][ 5+200], A[l][ 6+200], LodVec(c.s3, X));
+   if(d > 132) b += MulMatVec05(A[l][ 6+200], A[l][ 7+200],               LodVec(c.s4, X));
+   if(d > 133) b += MulMatVec06(A[l][ 7+200], A[l][ 8+200], A[l][ 9+200], LodVec(c.s5, X));
+   if(d > 134) b += MulMatVec07(A[l][ 9+200], A[l][10+200],               LodVec(c.s6, X));
+   if(d > 135) b += MulMatVec08(A[l][10+200], A[l][11+200], A[l][12+200], LodVec(c.s7, X));
+   if(d > 136) b += MulMatVec09(A[l][12+200], A[l][13+200], A[l][14+200], LodVec(c.s8, X));
+   if(d > 137) b += MulMatVec10(A[l][14+200], A[l][15+200],               LodVec(c.s9, X));
+   if(d > 138) b += MulMatVec11(A[l][15+200], A[l][16+200], A[l][17+200], LodVec(c.sa, X));
+   if(d > 139) b += MulMatVec12(A[l][17+200], A[l][18+200],               LodVec(c.sb, X));
+   if(d > 140) b += MulMatVec13(A[l][18+200], A[l][19+200], A[l][20+200], LodVec(c.sc, X));
+   if(d > 141) b += MulMatVec14(A[l][20+200], A[l][21+200],               LodVec(c.sd, X));
+   if(d > 142) b += MulMatVec15(A[l][21+200], A[l][22+200], A[l][23+200], LodVec(c.se, X));
+   if(d > 143) b += MulMatVec16(A[l][23+200], A[l][24+200],               LodVec(c.sf, X));
 
    c = C[l][9];
 
-   if(d > 144) b += MulMatVec01(A[l][ 0+225], A[l][ 1+225],               X[ c.s0 ]);
-   if(d > 145) b += MulMatVec02(A[l][ 1+225], A[l][ 2+225], A[l][ 3+225], X[ c.s1 ]);
-   if(d > 146) b += MulMatVec03(A[l][ 3+225], A[l][ 4+225],               X[ c.s2 ]);
-   if(d > 147) b += MulMatVec04(A[l][ 4+225], A[l][ 5+225], A[l][ 6+225], X[ c.s3 ]);
-   if(d > 148) b += MulMatVec05(A[l][ 6+225], A[l][ 7+225],               X[ c.s4 ]);
-   if(d > 149) b += MulMatVec06(A[l][ 7+225], A[l][ 8+225], A[l][ 9+225], X[ c.s5 ]);
-   if(d > 150) b += MulMatVec07(A[l][ 9+225], A[l][10+225],               X[ c.s6 ]);
-   if(d > 151) b += MulMatVec08(A[l][10+225], A[l][11+225], A[l][12+225], X[ c.s7 ]);
-   if(d > 152) b += MulMatVec09(A[l][12+225], A[l][13+225], A[l][14+225], X[ c.s8 ]);
-   if(d > 153) b += MulMatVec10(A[l][14+225], A[l][15+225],               X[ c.s9 ]);
-   if(d > 154) b += MulMatVec11(A[l][15+225], A[l][16+225], A[l][17+225], X[ c.sa ]);
-   if(d > 155) b += MulMatVec12(A[l][17+225], A[l][18+225],               X[ c.sb ]);
-   if(d > 156) b += MulMatVec13(A[l][18+225], A[l][19+225], A[l][20+225], X[ c.sc ]);
-   if(d > 157) b += MulMatVec14(A[l][20+225], A[l][21+225],               X[ c.sd ]);
-   if(d > 158) b += MulMatVec15(A[l][21+225], A[l][22+225], A[l][23+225], X[ c.se ]);
-   if(d > 159) b += MulMatVec16(A[l][23+225], A[l][24+225],               X[ c.sf ]);
+   if(d > 144) b += MulMatVec01(A[l][ 0+225], A[l][ 1+225],               LodVec(c.s0, X));
+   if(d > 145) b += MulMatVec02(A[l][ 1+225], A[l][ 2+225], A[l][ 3+225], LodVec(c.s1, X));
+   if(d > 146) b += MulMatVec03(A[l][ 3+225], A[l][ 4+225],               LodVec(c.s2, X));
+   if(d > 147) b += MulMatVec04(A[l][ 4+225], A[l][ 5+225], A[l][ 6+225], LodVec(c.s3, X));
+   if(d > 148) b += MulMatVec05(A[l][ 6+225], A[l][ 7+225],               LodVec(c.s4, X));
+   if(d > 149) b += MulMatVec06(A[l][ 7+225], A[l][ 8+225], A[l][ 9+225], LodVec(c.s5, X));
+   if(d > 150) b += MulMatVec07(A[l][ 9+225], A[l][10+225],               LodVec(c.s6, X));
+   if(d > 151) b += MulMatVec08(A[l][10+225], A[l][11+225], A[l][12+225], LodVec(c.s7, X));
+   if(d > 152) b += MulMatVec09(A[l][12+225], A[l][13+225], A[l][14+225], LodVec(c.s8, X));
+   if(d > 153) b += MulMatVec10(A[l][14+225], A[l][15+225],               LodVec(c.s9, X));
+   if(d > 154) b += MulMatVec11(A[l][15+225], A[l][16+225], A[l][17+225], LodVec(c.sa, X));
+   if(d > 155) b += MulMatVec12(A[l][17+225], A[l][18+225],               LodVec(c.sb, X));
+   if(d > 156) b += MulMatVec13(A[l][18+225], A[l][19+225], A[l][20+225], LodVec(c.sc, X));
+   if(d > 157) b += MulMatVec14(A[l][20+225], A[l][21+225],               LodVec(c.sd, X));
+   if(d > 158) b += MulMatVec15(A[l][21+225], A[l][22+225], A[l][23+225], LodVec(c.se, X));
+   if(d > 159) b += MulMatVec16(A[l][23+225], A[l][24+225],               LodVec(c.sf, X));
 
    c = C[l][10];
 
-   if(d > 160) b += MulMatVec01(A[l][ 0+250], A[l][ 1+250],               X[ c.s0 ]);
-   if(d > 161) b += MulMatVec02(A[l][ 1+250], A[l][ 2+250], A[l][ 3+250], X[ c.s1 ]);
-   if(d > 162) b += MulMatVec03(A[l][ 3+250], A[l][ 4+250],               X[ c.s2 ]);
-   if(d > 163) b += MulMatVec04(A[l][ 4+250], A[l][ 5+250], A[l][ 6+250], X[ c.s3 ]);
-   if(d > 164) b += MulMatVec05(A[l][ 6+250], A[l][ 7+250],               X[ c.s4 ]);
-   if(d > 165) b += MulMatVec06(A[l][ 7+250], A[l][ 8+250], A[l][ 9+250], X[ c.s5 ]);
-   if(d > 166) b += MulMatVec07(A[l][ 9+250], A[l][10+250],               X[ c.s6 ]);
-   if(d > 167) b += MulMatVec08(A[l][10+250], A[l][11+250], A[l][12+250], X[ c.s7 ]);
-   if(d > 168) b += MulMatVec09(A[l][12+250], A[l][13+250], A[l][14+250], X[ c.s8 ]);
-   if(d > 169) b += MulMatVec10(A[l][14+250], A[l][15+250],               X[ c.s9 ]);
-   if(d > 170) b += MulMatVec11(A[l][15+250], A[l][16+250], A[l][17+250], X[ c.sa ]);
-   if(d > 171) b += MulMatVec12(A[l][17+250], A[l][18+250],               X[ c.sb ]);
-   if(d > 172) b += MulMatVec13(A[l][18+250], A[l][19+250], A[l][20+250], X[ c.sc ]);
-   if(d > 173) b += MulMatVec14(A[l][20+250], A[l][21+250],               X[ c.sd ]);
-   if(d > 174) b += MulMatVec15(A[l][21+250], A[l][22+250], A[l][23+250], X[ c.se ]);
-   if(d > 175) b += MulMatVec16(A[l][23+250], A[l][24+250],               X[ c.sf ]);
+   if(d > 160) b += MulMatVec01(A[l][ 0+250], A[l][ 1+250],               LodVec(c.s0, X));
+   if(d > 161) b += MulMatVec02(A[l][ 1+250], A[l][ 2+250], A[l][ 3+250], LodVec(c.s1, X));
+   if(d > 162) b += MulMatVec03(A[l][ 3+250], A[l][ 4+250],               LodVec(c.s2, X));
+   if(d > 163) b += MulMatVec04(A[l][ 4+250], A[l][ 5+250], A[l][ 6+250], LodVec(c.s3, X));
+   if(d > 164) b += MulMatVec05(A[l][ 6+250], A[l][ 7+250],               LodVec(c.s4, X));
+   if(d > 165) b += MulMatVec06(A[l][ 7+250], A[l][ 8+250], A[l][ 9+250], LodVec(c.s5, X));
+   if(d > 166) b += MulMatVec07(A[l][ 9+250], A[l][10+250],               LodVec(c.s6, X));
+   if(d > 167) b += MulMatVec08(A[l][10+250], A[l][11+250], A[l][12+250], LodVec(c.s7, X));
+   if(d > 168) b += MulMatVec09(A[l][12+250], A[l][13+250], A[l][14+250], LodVec(c.s8, X));
+   if(d > 169) b += MulMatVec10(A[l][14+250], A[l][15+250],               LodVec(c.s9, X));
+   if(d > 170) b += MulMatVec11(A[l][15+250], A[l][16+250], A[l][17+250], LodVec(c.sa, X));
+   if(d > 171) b += MulMatVec12(A[l][17+250], A[l][18+250],               LodVec(c.sb, X));
+   if(d > 172) b += MulMatVec13(A[l][18+250], A[l][19+250], A[l][20+250], LodVec(c.sc, X));
+   if(d > 173) b += MulMatVec14(A[l][20+250], A[l][21+250],               LodVec(c.sd, X));
+   if(d > 174) b += MulMatVec15(A[l][21+250], A[l][22+250], A[l][23+250], LodVec(c.se, X));
+   if(d > 175) b += MulMatVec16(A[l][23+250], A[l][24+250],               LodVec(c.sf, X));
 
    c = C[l][11];
 
-   if(d > 176) b += MulMatVec01(A[l][ 0+275], A[l][ 1+275],               X[ c.s0 ]);
-   if(d > 177) b += MulMatVec02(A[l][ 1+275], A[l][ 2+275], A[l][ 3+275], X[ c.s1 ]);
-   if(d > 178) b += MulMatVec03(A[l][ 3+275], A[l][ 4+275],               X[ c.s2 ]);
-   if(d > 179) b += MulMatVec04(A[l][ 4+275], A[l][ 5+275], A[l][ 6+275], X[ c.s3 ]);
-   if(d > 180) b += MulMatVec05(A[l][ 6+275], A[l][ 7+275],               X[ c.s4 ]);
-   if(d > 181) b += MulMatVec06(A[l][ 7+275], A[l][ 8+275], A[l][ 9+275], X[ c.s5 ]);
-   if(d > 182) b += MulMatVec07(A[l][ 9+275], A[l][10+275],               X[ c.s6 ]);
-   if(d > 183) b += MulMatVec08(A[l][10+275], A[l][11+275], A[l][12+275], X[ c.s7 ]);
-   if(d > 184) b += MulMatVec09(A[l][12+275], A[l][13+275], A[l][14+275], X[ c.s8 ]);
-   if(d > 185) b += MulMatVec10(A[l][14+275], A[l][15+275],               X[ c.s9 ]);
-   if(d > 186) b += MulMatVec11(A[l][15+275], A[l][16+275], A[l][17+275], X[ c.sa ]);
-   if(d > 187) b += MulMatVec12(A[l][17+275], A[l][18+275],               X[ c.sb ]);
-   if(d > 188) b += MulMatVec13(A[l][18+275], A[l][19+275], A[l][20+275], X[ c.sc ]);
-   if(d > 189) b += MulMatVec14(A[l][20+275], A[l][21+275],               X[ c.sd ]);
-   if(d > 190) b += MulMatVec15(A[l][21+275], A[l][22+275], A[l][23+275], X[ c.se ]);
-   if(d > 191) b += MulMatVec16(A[l][23+275], A[l][24+275],               X[ c.sf ]);
+   if(d > 176) b += MulMatVec01(A[l][ 0+275], A[l][ 1+275],               LodVec(c.s0, X));
+   if(d > 177) b += MulMatVec02(A[l][ 1+275], A[l][ 2+275], A[l][ 3+275], LodVec(c.s1, X));
+   if(d > 178) b += MulMatVec03(A[l][ 3+275], A[l][ 4+275],               LodVec(c.s2, X));
+   if(d > 179) b += MulMatVec04(A[l][ 4+275], A[l][ 5+275], A[l][ 6+275], LodVec(c.s3, X));
+   if(d > 180) b += MulMatVec05(A[l][ 6+275], A[l][ 7+275],               LodVec(c.s4, X));
+   if(d > 181) b += MulMatVec06(A[l][ 7+275], A[l][ 8+275], A[l][ 9+275], LodVec(c.s5, X));
+   if(d > 182) b += MulMatVec07(A[l][ 9+275], A[l][10+275],               LodVec(c.s6, X));
+   if(d > 183) b += MulMatVec08(A[l][10+275], A[l][11+275], A[l][12+275], LodVec(c.s7, X));
+   if(d > 184) b += MulMatVec09(A[l][12+275], A[l][13+275], A[l][14+275], LodVec(c.s8, X));
+   if(d > 185) b += MulMatVec10(A[l][14+275], A[l][15+275],               LodVec(c.s9, X));
+   if(d > 186) b += MulMatVec11(A[l][15+275], A[l][16+275], A[l][17+275], LodVec(c.sa, X));
+   if(d > 187) b += MulMatVec12(A[l][17+275], A[l][18+275],               LodVec(c.sb, X));
+   if(d > 188) b += MulMatVec13(A[l][18+275], A[l][19+275], A[l][20+275], LodVec(c.sc, X));
+   if(d > 189) b += MulMatVec14(A[l][20+275], A[l][21+275],               LodVec(c.sd, X));
+   if(d > 190) b += MulMatVec15(A[l][21+275], A[l][22+275], A[l][23+275], LodVec(c.se, X));
+   if(d > 191) b += MulMatVec16(A[l][23+275], A[l][24+275],               LodVec(c.sf, X));
 
    c = C[l][12];
 
-   if(d > 192) b += MulMatVec01(A[l][ 0+300], A[l][ 1+300],               X[ c.s0 ]);
-   if(d > 193) b += MulMatVec02(A[l][ 1+300], A[l][ 2+300], A[l][ 3+300], X[ c.s1 ]);
-   if(d > 194) b += MulMatVec03(A[l][ 3+300], A[l][ 4+300],               X[ c.s2 ]);
-   if(d > 195) b += MulMatVec04(A[l][ 4+300], A[l][ 5+300], A[l][ 6+300], X[ c.s3 ]);
-   if(d > 196) b += MulMatVec05(A[l][ 6+300], A[l][ 7+300],               X[ c.s4 ]);
-   if(d > 197) b += MulMatVec06(A[l][ 7+300], A[l][ 8+300], A[l][ 9+300], X[ c.s5 ]);
-   if(d > 198) b += MulMatVec07(A[l][ 9+300], A[l][10+300],               X[ c.s6 ]);
-   if(d > 199) b += MulMatVec08(A[l][10+300], A[l][11+300], A[l][12+300], X[ c.s7 ]);
-   if(d > 200) b += MulMatVec09(A[l][12+300], A[l][13+300], A[l][14+300], X[ c.s8 ]);
-   if(d > 201) b += MulMatVec10(A[l][14+300], A[l][15+300],               X[ c.s9 ]);
-   if(d > 202) b += MulMatVec11(A[l][15+300], A[l][16+300], A[l][17+300], X[ c.sa ]);
-   if(d > 203) b += MulMatVec12(A[l][17+300], A[l][18+300],               X[ c.sb ]);
-   if(d > 204) b += MulMatVec13(A[l][18+300], A[l][19+300], A[l][20+300], X[ c.sc ]);
-   if(d > 205) b += MulMatVec14(A[l][20+300], A[l][21+300],               X[ c.sd ]);
-   if(d > 206) b += MulMatVec15(A[l][21+300], A[l][22+300], A[l][23+300], X[ c.se ]);
-   if(d > 207) b += MulMatVec16(A[l][23+300], A[l][24+300],               X[ c.sf ]);
+   if(d > 192) b += MulMatVec01(A[l][ 0+300], A[l][ 1+300],               LodVec(c.s0, X));
+   if(d > 193) b += MulMatVec02(A[l][ 1+300], A[l][ 2+300], A[l][ 3+300], LodVec(c.s1, X));
+   if(d > 194) b += MulMatVec03(A[l][ 3+300], A[l][ 4+300],               LodVec(c.s2, X));
+   if(d > 195) b += MulMatVec04(A[l][ 4+300], A[l][ 5+300], A[l][ 6+300], LodVec(c.s3, X));
+   if(d > 196) b += MulMatVec05(A[l][ 6+300], A[l][ 7+300],               LodVec(c.s4, X));
+   if(d > 197) b += MulMatVec06(A[l][ 7+300], A[l][ 8+300], A[l][ 9+300], LodVec(c.s5, X));
+   if(d > 198) b += MulMatVec07(A[l][ 9+300], A[l][10+300],               LodVec(c.s6, X));
+   if(d > 199) b += MulMatVec08(A[l][10+300], A[l][11+300], A[l][12+300], LodVec(c.s7, X));
+   if(d > 200) b += MulMatVec09(A[l][12+300], A[l][13+300], A[l][14+300], LodVec(c.s8, X));
+   if(d > 201) b += MulMatVec10(A[l][14+300], A[l][15+300],               LodVec(c.s9, X));
+   if(d > 202) b += MulMatVec11(A[l][15+300], A[l][16+300], A[l][17+300], LodVec(c.sa, X));
+   if(d > 203) b += MulMatVec12(A[l][17+300], A[l][18+300],               LodVec(c.sb, X));
+   if(d > 204) b += MulMatVec13(A[l][18+300], A[l][19+300], A[l][20+300], LodVec(c.sc, X));
+   if(d > 205) b += MulMatVec14(A[l][20+300], A[l][21+300],               LodVec(c.sd, X));
+   if(d > 206) b += MulMatVec15(A[l][21+300], A[l][22+300], A[l][23+300], LodVec(c.se, X));
+   if(d > 207) b += MulMatVec16(A[l][23+300], A[l][24+300],               LodVec(c.sf, X));
 
    c = C[l][13];
 
-   if(d > 208) b += MulMatVec01(A[l][ 0+325], A[l][ 1+325],               X[ c.s0 ]);
-   if(d > 209) b += MulMatVec02(A[l][ 1+325], A[l][ 2+325], A[l][ 3+325], X[ c.s1 ]);
-   if(d > 210) b += MulMatVec03(A[l][ 3+325], A[l][ 4+325],               X[ c.s2 ]);
-   if(d > 211) b += MulMatVec04(A[l][ 4+325], A[l][ 5+325], A[l][ 6+325], X[ c.s3 ]);
-   if(d > 212) b += MulMatVec05(A[l][ 6+325], A[l][ 7+325],               X[ c.s4 ]);
-   if(d > 213) b += MulMatVec06(A[l][ 7+325], A[l][ 8+325], A[l][ 9+325], X[ c.s5 ]);
-   if(d > 214) b += MulMatVec07(A[l][ 9+325], A[l][10+325],               X[ c.s6 ]);
-   if(d > 215) b += MulMatVec08(A[l][10+325], A[l][11+325], A[l][12+325], X[ c.s7 ]);
-   if(d > 216) b += MulMatVec09(A[l][12+325], A[l][13+325], A[l][14+325], X[ c.s8 ]);
-   if(d > 217) b += MulMatVec10(A[l][14+325], A[l][15+325],               X[ c.s9 ]);
-   if(d > 218) b += MulMatVec11(A[l][15+325], A[l][16+325], A[l][17+325], X[ c.sa ]);
-   if(d > 219) b += MulMatVec12(A[l][17+325], A[l][18+325],               X[ c.sb ]);
-   if(d > 220) b += MulMatVec13(A[l][18+325], A[l][19+325], A[l][20+325], X[ c.sc ]);
-   if(d > 221) b += MulMatVec14(A[l][20+325], A[l][21+325],               X[ c.sd ]);
-   if(d > 222) b += MulMatVec15(A[l][21+325], A[l][22+325], A[l][23+325], X[ c.se ]);
-   if(d > 223) b += MulMatVec16(A[l][23+325], A[l][24+325],               X[ c.sf ]);
+   if(d > 208) b += MulMatVec01(A[l][ 0+325], A[l][ 1+325],               LodVec(c.s0, X));
+   if(d > 209) b += MulMatVec02(A[l][ 1+325], A[l][ 2+325], A[l][ 3+325], LodVec(c.s1, X));
+   if(d > 210) b += MulMatVec03(A[l][ 3+325], A[l][ 4+325],               LodVec(c.s2, X));
+   if(d > 211) b += MulMatVec04(A[l][ 4+325], A[l][ 5+325], A[l][ 6+325], LodVec(c.s3, X));
+   if(d > 212) b += MulMatVec05(A[l][ 6+325], A[l][ 7+325],               LodVec(c.s4, X));
+   if(d > 213) b += MulMatVec06(A[l][ 7+325], A[l][ 8+325], A[l][ 9+325], LodVec(c.s5, X));
+   if(d > 214) b += MulMatVec07(A[l][ 9+325], A[l][10+325],               LodVec(c.s6, X));
+   if(d > 215) b += MulMatVec08(A[l][10+325], A[l][11+325], A[l][12+325], LodVec(c.s7, X));
+   if(d > 216) b += MulMatVec09(A[l][12+325], A[l][13+325], A[l][14+325], LodVec(c.s8, X));
+   if(d > 217) b += MulMatVec10(A[l][14+325], A[l][15+325],               LodVec(c.s9, X));
+   if(d > 218) b += MulMatVec11(A[l][15+325], A[l][16+325], A[l][17+325], LodVec(c.sa, X));
+   if(d > 219) b += MulMatVec12(A[l][17+325], A[l][18+325],               LodVec(c.sb, X));
+   if(d > 220) b += MulMatVec13(A[l][18+325], A[l][19+325], A[l][20+325], LodVec(c.sc, X));
+   if(d > 221) b += MulMatVec14(A[l][20+325], A[l][21+325],               LodVec(c.sd, X));
+   if(d > 222) b += MulMatVec15(A[l][21+325], A[l][22+325], A[l][23+325], LodVec(c.se, X));
+   if(d > 223) b += MulMatVec16(A[l][23+325], A[l][24+325],               LodVec(c.sf, X));
 
    c = C[l][14];
 
-   if(d > 224) b += MulMatVec01(A[l][ 0+350], A[l][ 1+350],               X[ c.s0 ]);
-   if(d > 225) b += MulMatVec02(A[l][ 1+350], A[l][ 2+350], A[l][ 3+350], X[ c.s1 ]);
-   if(d > 226) b += MulMatVec03(A[l][ 3+350], A[l][ 4+350],               X[ c.s2 ]);
-   if(d > 227) b += MulMatVec04(A[l][ 4+350], A[l][ 5+350], A[l][ 6+350], X[ c.s3 ]);
-   if(d > 228) b += MulMatVec05(A[l][ 6+350], A[l][ 7+350],               X[ c.s4 ]);
-   if(d > 229) b += MulMatVec06(A[l][ 7+350], A[l][ 8+350], A[l][ 9+350], X[ c.s5 ]);
-   if(d > 230) b += MulMatVec07(A[l][ 9+350], A[l][10+350],               X[ c.s6 ]);
-   if(d > 231) b += MulMatVec08(A[l][10+350], A[l][11+350], A[l][12+350], X[ c.s7 ]);
-   if(d > 232) b += MulMatVec09(A[l][12+350], A[l][13+350], A[l][14+350], X[ c.s8 ]);
-   if(d > 233) b += MulMatVec10(A[l][14+350], A[l][15+350],               X[ c.s9 ]);
-   if(d > 234) b += MulMatVec11(A[l][15+350], A[l][16+350], A[l][17+350], X[ c.sa ]);
-   if(d > 235) b += MulMatVec12(A[l][17+350], A[l][18+350],               X[ c.sb ]);
-   if(d > 236) b += MulMatVec13(A[l][18+350], A[l][19+350], A[l][20+350], X[ c.sc ]);
-   if(d > 237) b += MulMatVec14(A[l][20+350], A[l][21+350],               X[ c.sd ]);
-   if(d > 238) b += MulMatVec15(A[l][21+350], A[l][22+350], A[l][23+350], X[ c.se ]);
-   if(d > 239) b += MulMatVec16(A[l][23+350], A[l][24+350],               X[ c.sf ]);
+   if(d > 224) b += MulMatVec01(A[l][ 0+350], A[l][ 1+350],               LodVec(c.s0, X));
+   if(d > 225) b += MulMatVec02(A[l][ 1+350], A[l][ 2+350], A[l][ 3+350], LodVec(c.s1, X));
+   if(d > 226) b += MulMatVec03(A[l][ 3+350], A[l][ 4+350],               LodVec(c.s2, X));
+   if(d > 227) b += MulMatVec04(A[l][ 4+350], A[l][ 5+350], A[l][ 6+350], LodVec(c.s3, X));
+   if(d > 228) b += MulMatVec05(A[l][ 6+350], A[l][ 7+350],               LodVec(c.s4, X));
+   if(d > 229) b += MulMatVec06(A[l][ 7+350], A[l][ 8+350], A[l][ 9+350], LodVec(c.s5, X));
+   if(d > 230) b += MulMatVec07(A[l][ 9+350], A[l][10+350],               LodVec(c.s6, X));
+   if(d > 231) b += MulMatVec08(A[l][10+350], A[l][11+350], A[l][12+350], LodVec(c.s7, X));
+   if(d > 232) b += MulMatVec09(A[l][12+350], A[l][13+350], A[l][14+350], LodVec(c.s8, X));
+   if(d > 233) b += MulMatVec10(A[l][14+350], A[l][15+350],               LodVec(c.s9, X));
+   if(d > 234) b += MulMatVec11(A[l][15+350], A[l][16+350], A[l][17+350], LodVec(c.sa, X));
+   if(d > 235) b += MulMatVec12(A[l][17+350], A[l][18+350],               LodVec(c.sb, X));
+   if(d > 236) b += MulMatVec13(A[l][18+350], A[l][19+350], A[l][20+350], LodVec(c.sc, X));
+   if(d > 237) b += MulMatVec14(A[l][20+350], A[l][21+350],               LodVec(c.sd, X));
+   if(d > 238) b += MulMatVec15(A[l][21+350], A[l][22+350], A[l][23+350], LodVec(c.se, X));
+   if(d > 239) b += MulMatVec16(A[l][23+350], A[l][24+350],               LodVec(c.sf, X));
 
    c = C[l][15];
 
-   if(d > 240) b += MulMatVec01(A[l][ 0+375], A[l][ 1+375],               X[ c.s0 ]);
-   if(d > 241) b += MulMatVec02(A[l][ 1+375], A[l][ 2+375], A[l][ 3+375], X[ c.s1 ]);
-   if(d > 242) b += MulMatVec03(A[l][ 3+375], A[l][ 4+375],               X[ c.s2 ]);
-   if(d > 243) b += MulMatVec04(A[l][ 4+375], A[l][ 5+375], A[l][ 6+375], X[ c.s3 ]);
-   if(d > 244) b += MulMatVec05(A[l][ 6+375], A[l][ 7+375],               X[ c.s4 ]);
-   if(d > 245) b += MulMatVec06(A[l][ 7+375], A[l][ 8+375], A[l][ 9+375], X[ c.s5 ]);
-   if(d > 246) b += MulMatVec07(A[l][ 9+375], A[l][10+375],               X[ c.s6 ]);
-   if(d > 247) b += MulMatVec08(A[l][10+375], A[l][11+375], A[l][12+375], X[ c.s7 ]);
-   if(d > 248) b += MulMatVec09(A[l][12+375], A[l][13+375], A[l][14+375], X[ c.s8 ]);
-   if(d > 249) b += MulMatVec10(A[l][14+375], A[l][15+375],               X[ c.s9 ]);
-   if(d > 250) b += MulMatVec11(A[l][15+375], A[l][16+375], A[l][17+375], X[ c.sa ]);
-   if(d > 251) b += MulMatVec12(A[l][17+375], A[l][18+375],               X[ c.sb ]);
-   if(d > 252) b += MulMatVec13(A[l][18+375], A[l][19+375], A[l][20+375], X[ c.sc ]);
-   if(d > 253) b += MulMatVec14(A[l][20+375], A[l][21+375],               X[ c.sd ]);
-   if(d > 254) b += MulMatVec15(A[l][21+375], A[l][22+375], A[l][23+375], X[ c.se ]);
-   if(d > 255) b += MulMatVec16(A[l][23+375], A[l][24+375],               X[ c.sf ]);
-
-   B[l+N.s1] = b;
+   if(d > 240) b += MulMatVec01(A[l][ 0+375], A[l][ 1+375],               LodVec(c.s0, X));
+   if(d > 241) b += MulMatVec02(A[l][ 1+375], A[l][ 2+375], A[l][ 3+375], LodVec(c.s1, X));
+   if(d > 242) b += MulMatVec03(A[l][ 3+375], A[l][ 4+375],               LodVec(c.s2, X));
+   if(d > 243) b += MulMatVec04(A[l][ 4+375], A[l][ 5+375], A[l][ 6+375], LodVec(c.s3, X));
+   if(d > 244) b += MulMatVec05(A[l][ 6+375], A[l][ 7+375],               LodVec(c.s4, X));
+   if(d > 245) b += MulMatVec06(A[l][ 7+375], A[l][ 8+375], A[l][ 9+375], LodVec(c.s5, X));
+   if(d > 246) b += MulMatVec07(A[l][ 9+375], A[l][10+375],               LodVec(c.s6, X));
+   if(d > 247) b += MulMatVec08(A[l][10+375], A[l][11+375], A[l][12+375], LodVec(c.s7, X));
+   if(d > 248) b += MulMatVec09(A[l][12+375], A[l][13+375], A[l][14+375], LodVec(c.s8, X));
+   if(d > 249) b += MulMatVec10(A[l][14+375], A[l][15+375],               LodVec(c.s9, X));
+   if(d > 250) b += MulMatVec11(A[l][15+375], A[l][16+375], A[l][17+375], LodVec(c.sa, X));
+   if(d > 251) b += MulMatVec12(A[l][17+375], A[l][18+375],               LodVec(c.sb, X));
+   if(d > 252) b += MulMatVec13(A[l][18+375], A[l][19+375], A[l][20+375], LodVec(c.sc, X));
+   if(d > 253) b += MulMatVec14(A[l][20+375], A[l][21+375],               LodVec(c.sd, X));
+   if(d > 254) b += MulMatVec15(A[l][21+375], A[l][22+375], A[l][23+375], LodVec(c.se, X));
+   if(d > 255) b += MulMatVec16(A[l][23+375], A[l][24+375],               LodVec(c.sf, X));
+
+   StoVec(b, l+N.s1, B);
 }
 
 
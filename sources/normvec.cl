@@ -35,6 +35,29 @@ __kernel void L2Norm(__global fpn4 *U,
    V[l] = (float)s;
 }
 
+#elif defined(PACKED)
+
+__kernel void L2Norm(__global fpn *U,
+                     __global float *V,
+                     __global void *par,
+                     const int2    N)
+{
+   int i, l;
+   fpn s = 0.;
+
+   l = get_global_id(0);
+
+   if(l >= N.s0)
+      return;
+
+   U += l * BLKSIZ;
+
+   for(i=0;i<BLKSIZ;i++)
+      s += U[i] * U[i];
+
+   V[l] = (float)sqrt(s);
+}
+
 #elif BLKSIZ == 5
 
 __kernel void L2Norm(__global fpn8 *U,
@@ -36,6 +36,24 @@ __kernel void ScaleVec( __global fpn4 *U,
    U[l] *= s;
 }
 
+#elif defined(PACKED)
+
+// Unpadded vectors are scaled four scalars at a time regardless of the blocks
+__kernel void ScaleVec( __global fpn *U,
+                        __global GmlParSct *par,
+                        const int2 N )
+{
+   int l;
+   fpn4 s = (fpn4){par->scale, par->scale, par->scale, par->scale};
+
+   l = get_global_id(0);
+
+   if(l >= N.s0)
+      return;
+
+   vstore4(vload4(l, U) * s, l, U);
+}
+
 #else
 
 __kernel void ScaleVec( __global fpn8 *U,
@@ -1,95 +1,115 @@
-float  DisPow   (float4, float4);
-float  CalLen   (float4, float4);
-float  CalSrf   (float4, float4, float4);
-float  CalVol   (float4, float4, float4, float4);
-float4 GetEdgTng(float4, float4);
-float4 GetTriNrm(float4, float4, float4);
-float4 GetQadNrm(float4, float4, float4, float4);
-float  CalEdgLen(float4, float4);
-float  CalTriSrf(float4, float4, float4);
-float  CalQadSrf(float4, float4, float4, float4);
-float  CalTetVol(float4, float4, float4, float4);
-float  CalPyrVol(float4, float4, float4, float4, float4);
-float  CalPriVol(float4, float4, float4, float4, float4, float4);
-float  CalHexVol(float4, float4, float4, float4, float4, float4, float4, float4);
-float  CalTriQal(float4, float4, float4);
-float  CalQadQal(float4, float4, float4, float4);
-float  CalTetQal(float4, float4, float4, float4);
-float  CalPyrQal(float4, float4, float4, float4, float4);
-float  CalPriQal(float4, float4, float4, float4, float4, float4);
-float  CalHexQal(float4, float4, float4, float4, float4, float4, float4, float4);
-float4 PrjVerLin(float4, float4, float4);
-float4 PrjVerPla(float4, float4, float4);
-float  DisVerLin(float4, float4, float4);
-float  DisVerPla(float4, float4, float4);
-float4 LinIntLin(float4, float4, float4, float4);
-float4 LinIntPla(float4, float4, float4, float4);
-void   PlaIntPla(float4, float4, float4, float4, float4 *, float4 *);
-float  DisVerEdg(float4, float4, float4, float4);
-float4 MulMatVec(float16, float4);
-
-
-float4 PrjVerLin(float4 VerCrd, float4 LinCrd, float4 LinTng)
+// Vertex coordinates are stored in single or double precision
+// and the whole toolkit is compiled with the matching type
+#ifdef GML_DBL_CRD
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+typedef double   GmlCrd;
+typedef double4  GmlCrd4;
+typedef double16 GmlCrd16;
+#define GmlLen   length
+#define GmlDis   distance
+#define GmlNrm   normalize
+#else
+typedef float    GmlCrd;
+typedef float4   GmlCrd4;
+typedef float16  GmlCrd16;
+#define GmlLen   fast_length
+#define GmlDis   fast_distance
+#define GmlNrm   fast_normalize
+#endif
+
+
+GmlCrd  DisPow   (GmlCrd4, GmlCrd4);
+GmlCrd  CalLen   (GmlCrd4, GmlCrd4);
+GmlCrd  CalSrf   (GmlCrd4, GmlCrd4, GmlCrd4);
+GmlCrd  CalVol   (GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4);
+GmlCrd4 GetEdgTng(GmlCrd4, GmlCrd4);
+GmlCrd4 GetTriNrm(GmlCrd4, GmlCrd4, GmlCrd4);
+GmlCrd4 GetQadNrm(GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4);
+GmlCrd  CalEdgLen(GmlCrd4, GmlCrd4);
+GmlCrd  CalTriSrf(GmlCrd4, GmlCrd4, GmlCrd4);
+GmlCrd  CalQadSrf(GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4);
+GmlCrd  CalTetVol(GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4);
+GmlCrd  CalPyrVol(GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4);
+GmlCrd  CalPriVol(GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4);
+GmlCrd  CalHexVol(GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4);
+GmlCrd  CalTriQal(GmlCrd4, GmlCrd4, GmlCrd4);
+GmlCrd  CalQadQal(GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4);
+GmlCrd  CalTetQal(GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4);
+GmlCrd  CalPyrQal(GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4);
+GmlCrd  CalPriQal(GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4);
+GmlCrd  CalHexQal(GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4);
+GmlCrd4 PrjVerLin(GmlCrd4, GmlCrd4, GmlCrd4);
+GmlCrd4 PrjVerPla(GmlCrd4, GmlCrd4, GmlCrd4);
+GmlCrd  DisVerLin(GmlCrd4, GmlCrd4, GmlCrd4);
+GmlCrd  DisVerPla(GmlCrd4, GmlCrd4, GmlCrd4);
+GmlCrd4 LinIntLin(GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4);
+GmlCrd4 LinIntPla(GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4);
+void    PlaIntPla(GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4 *, GmlCrd4 *);
+GmlCrd  DisVerEdg(GmlCrd4, GmlCrd4, GmlCrd4, GmlCrd4);
+GmlCrd4 MulMatVec(GmlCrd16, GmlCrd4);
+
+
+GmlCrd4 PrjVerLin(GmlCrd4 VerCrd, GmlCrd4 LinCrd, GmlCrd4 LinTng)
 {
    return(LinCrd + dot(LinTng, VerCrd - LinCrd) * LinTng);
 }
 
-float4 PrjVerPla(float4 VerCrd, float4 PlaCrd, float4 PlaNrm)
+GmlCrd4 PrjVerPla(GmlCrd4 VerCrd, GmlCrd4 PlaCrd, GmlCrd4 PlaNrm)
 {
    return(VerCrd + dot(PlaNrm, PlaCrd - VerCrd) * PlaNrm);
 }
 
-float DisVerLin(float4 VerCrd, float4 LinCrd, float4 LinTng)
+GmlCrd DisVerLin(GmlCrd4 VerCrd, GmlCrd4 LinCrd, GmlCrd4 LinTng)
 {
    return(distance(VerCrd, PrjVerLin(VerCrd, LinCrd, LinTng)));
 }
 
-float DisVerPla(float4 VerCrd, float4 PlaCrd, float4 PlaNrm)
+GmlCrd DisVerPla(GmlCrd4 VerCrd, GmlCrd4 PlaCrd, GmlCrd4 PlaNrm)
 {
    return(dot(VerCrd - PlaCrd, PlaNrm));
 }
 
-float4 LinIntLin(float4 LinCrd1, float4 LinTng1, float4 LinCrd2, float4 LinTng2)
+GmlCrd4 LinIntLin(GmlCrd4 LinCrd1, GmlCrd4 LinTng1, GmlCrd4 LinCrd2, GmlCrd4 LinTng2)
 {
-   float4 ImgCrd = PrjVerLin(LinCrd2, LinCrd1, LinTng1);
+   GmlCrd4 ImgCrd = PrjVerLin(LinCrd2, LinCrd1, LinTng1);
    return(ImgCrd - (distance(ImgCrd, LinCrd2) / dot(LinCrd2 - ImgCrd, LinTng2)) * LinTng1);
 }
 
-float4 LinIntPla(float4 LinCrd, float4 LinTng, float4 PlaCrd, float4 PlaNrm)
+GmlCrd4 LinIntPla(GmlCrd4 LinCrd, GmlCrd4 LinTng, GmlCrd4 PlaCrd, GmlCrd4 PlaNrm)
 {
    return(LinCrd - (dot(PlaNrm, LinCrd - PlaCrd) / dot(PlaNrm, LinTng)) * LinTng);
 }
 
-void PlaIntPla(float4 PlaCrd1, float4 PlaNrm1, float4 PlaCrd2, float4 PlaNrm2, float4 *LinCrd1, float4 *LinTng1)
+void PlaIntPla(GmlCrd4 PlaCrd1, GmlCrd4 PlaNrm1, GmlCrd4 PlaCrd2, GmlCrd4 PlaNrm2, GmlCrd4 *LinCrd1, GmlCrd4 *LinTng1)
 {
    *LinTng1 = normalize(cross(PlaNrm1, PlaNrm2));
    *LinCrd1 = LinIntPla(PlaCrd2, normalize(cross(*LinTng1, PlaNrm2)), PlaCrd1, PlaNrm1);
 }
 
-float DisPow(float4 a, float4 b)
+GmlCrd DisPow(GmlCrd4 a, GmlCrd4 b)
 {
    return(dot(a-b, a-b));
 }
 
-float CalLen(float4 a, float4 b)
+GmlCrd CalLen(GmlCrd4 a, GmlCrd4 b)
 {
-   return(fast_distance(a,b));
+   return(GmlDis(a,b));
 }
 
-float CalSrf(float4 a, float4 b, float4 c)
+GmlCrd CalSrf(GmlCrd4 a, GmlCrd4 b, GmlCrd4 c)
 {
-   return(fast_length(cross(c-a, b-a)));
+   return(GmlLen(cross(c-a, b-a)));
 }
 
-float CalVol(float4 a, float4 b, float4 c, float4 d)
+GmlCrd CalVol(GmlCrd4 a, GmlCrd4 b, GmlCrd4 c, GmlCrd4 d)
 {
    return(dot(cross(b-a, c-a), d-a));
 }
 
-float DisVerEdg(float4 VerCrd, float4 EdgCrd1, float4 EdgCrd2, float4 EdgTng)
+GmlCrd DisVerEdg(GmlCrd4 VerCrd, GmlCrd4 EdgCrd1, GmlCrd4 EdgCrd2, GmlCrd4 EdgTng)
 {
-   float dis;
-   float4 ImgCrd;
+   GmlCrd dis;
+   GmlCrd4 ImgCrd;
 
    dis = min(DisPow(VerCrd, EdgCrd1), DisPow(VerCrd, EdgCrd2));
    ImgCrd = PrjVerLin(VerCrd, EdgCrd1, EdgTng);
@@ -97,42 +117,42 @@ float DisVerEdg(float4 VerCrd, float4 EdgCrd1, float4 EdgCrd2, float4 EdgTng)
    return(sqrt(min(dis, DisPow(VerCrd, ImgCrd))));
 }
 
-float4 GetEdgTng(float4 a, float4 b)
+GmlCrd4 GetEdgTng(GmlCrd4 a, GmlCrd4 b)
 {
-   return(fast_normalize(b-a));
+   return(GmlNrm(b-a));
 }
 
-float4 GetTriNrm(float4 a, float4 b, float4 c)
+GmlCrd4 GetTriNrm(GmlCrd4 a, GmlCrd4 b, GmlCrd4 c)
 {
-   return(fast_normalize(cross(c-a, b-a)));
+   return(GmlNrm(cross(c-a, b-a)));
 }
 
-float4 GetQadNrm(float4 a, float4 b, float4 c, float4 d)
+GmlCrd4 GetQadNrm(GmlCrd4 a, GmlCrd4 b, GmlCrd4 c, GmlCrd4 d)
 {
-   return(fast_normalize(cross(c-a, d-b)));
+   return(GmlNrm(cross(c-a, d-b)));
 }
 
-float CalEdgLen(float4 a, float4 b)
+GmlCrd CalEdgLen(GmlCrd4 a, GmlCrd4 b)
 {
    return(CalLen(a,b));
 }
 
-float CalTriSrf(float4 a, float4 b, float4 c)
+GmlCrd CalTriSrf(GmlCrd4 a, GmlCrd4 b, GmlCrd4 c)
 {
    return(.5 * CalSrf(a,b,c));
 }
 
-float CalQadSrf(float4 a, float4 b, float4 c, float4 d)
+GmlCrd CalQadSrf(GmlCrd4 a, GmlCrd4 b, GmlCrd4 c, GmlCrd4 d)
 {
-   return(.5 * fast_length(cross(c-a, d-b)));
+   return(.5 * GmlLen(cross(c-a, d-b)));
 }
 
-float CalTetVol(float4 a, float4 b, float4 c, float4 d)
+GmlCrd CalTetVol(GmlCrd4 a, GmlCrd4 b, GmlCrd4 c, GmlCrd4 d)
 {
    return(.166666 * CalVol(a,b,c,d));
 }
 
-float CalPyrVol(float4 a, float4 b, float4 c, float4 d, float4 e)
+GmlCrd CalPyrVol(GmlCrd4 a, GmlCrd4 b, GmlCrd4 c, GmlCrd4 d, GmlCrd4 e)
 {
    return(.083333 * (CalVol(a,b,c,e)
                   +  CalVol(c,d,a,e)
@@ -140,7 +160,7 @@ float CalPyrVol(float4 a, float4 b, float4 c, float4 d, float4 e)
                   +  CalVol(d,a,b,e)) );
 }
 
-float CalPriVol(float4 a, float4 b, float4 c, float4 d, float4 e, float4 f)
+GmlCrd CalPriVol(GmlCrd4 a, GmlCrd4 b, GmlCrd4 c, GmlCrd4 d, GmlCrd4 e, GmlCrd4 f)
 {
    return(.833333 * (CalVol(a,b,c,d)
                   +  CalVol(b,c,a,e)
@@ -150,8 +170,8 @@ float CalPriVol(float4 a, float4 b, float4 c, float4 d, float4 e, float4 f)
                   +  CalVol(f,e,d,c)) );
 }
 
-float CalHexVol(  float4 a, float4 b, float4 c, float4 d,
-                  float4 e, float4 f, float4 g, float4 h )
+GmlCrd CalHexVol(  GmlCrd4 a, GmlCrd4 b, GmlCrd4 c, GmlCrd4 d,
+                  GmlCrd4 e, GmlCrd4 f, GmlCrd4 g, GmlCrd4 h )
 {
    return(.125 * (CalVol(a,b,d,e)
                +  CalVol(b,c,a,f)
@@ -163,9 +183,9 @@ float CalHexVol(  float4 a, float4 b, float4 c, float4 d,
                +  CalVol(h,g,e,d)) );
 }
 
-float CalTriQal(float4 a, float4 b, float4 c)
+GmlCrd CalTriQal(GmlCrd4 a, GmlCrd4 b, GmlCrd4 c)
 {
-   float ha, hb, hc, hmax;
+   GmlCrd ha, hb, hc, hmax;
 
    ha = CalLen(b,c);
    hb = CalLen(c,a);
@@ -177,9 +197,9 @@ float CalTriQal(float4 a, float4 b, float4 c)
    return( 3.46410 * CalSrf(a,b,c) / (hmax * (ha + hb + hc)) );
 }
 
-float CalQadQal(float4 a, float4 b, float4 c, float4 d)
+GmlCrd CalQadQal(GmlCrd4 a, GmlCrd4 b, GmlCrd4 c, GmlCrd4 d)
 {
-   float h1, h2, h3, h4, h5, h6, hmax, s1, s2, s3, s4, smin;
+   GmlCrd h1, h2, h3, h4, h5, h6, hmax, s1, s2, s3, s4, smin;
 
    h1 = CalLen(a,b);
    h2 = CalLen(b,c);
@@ -206,9 +226,9 @@ float CalQadQal(float4 a, float4 b, float4 c, float4 d)
    return(4. * smin / (hmax * (h1 + h2 + h3 + h4)) );
 }
 
-float CalTetQal(float4 a, float4 b, float4 c, float4 d)
+GmlCrd CalTetQal(GmlCrd4 a, GmlCrd4 b, GmlCrd4 c, GmlCrd4 d)
 {
-   float h, s, v;
+   GmlCrd h, s, v;
 
    h = CalLen(a,b)
      + CalLen(a,c)
@@ -227,9 +247,9 @@ float CalTetQal(float4 a, float4 b, float4 c, float4 d)
    return(176.363 * v / (h * s) );
 }
 
-float CalPyrQal(float4 a, float4 b, float4 c, float4 d, float4 e)
+GmlCrd CalPyrQal(GmlCrd4 a, GmlCrd4 b, GmlCrd4 c, GmlCrd4 d, GmlCrd4 e)
 {
-   float h, s, v;
+   GmlCrd h, s, v;
 
    h = CalLen(a,b)
      + CalLen(b,c)
@@ -254,9 +274,9 @@ float CalPyrQal(float4 a, float4 b, float4 c, float4 d, float4 e)
    return(141.516 * v / (h * s) );
 }
 
-float CalPriQal(float4 a, float4 b, float4 c, float4 d, float4 e, float4 f)
+GmlCrd CalPriQal(GmlCrd4 a, GmlCrd4 b, GmlCrd4 c, GmlCrd4 d, GmlCrd4 e, GmlCrd4 f)
 {
-   float h, s, v;
+   GmlCrd h, s, v;
 
    h = CalLen(a,b)
      + CalLen(b,c)
@@ -290,10 +310,10 @@ float CalPriQal(float4 a, float4 b, float4 c, float4 d, float4 e, float4 f)
    return(98.3538 * v / (h * s) );
 }
 
-float CalHexQal(  float4 a, float4 b, float4 c, float4 d,
-                  float4 e, float4 f, float4 g, float4 h )
+GmlCrd CalHexQal(  GmlCrd4 a, GmlCrd4 b, GmlCrd4 c, GmlCrd4 d,
+                  GmlCrd4 e, GmlCrd4 f, GmlCrd4 g, GmlCrd4 h )
 {
-   float l, s, v;
+   GmlCrd l, s, v;
 
    l = CalLen(d,c)
      + CalLen(a,b)
@@ -329,9 +349,9 @@ float CalHexQal(  float4 a, float4 b, float4 c, float4 d,
    return(72. * v / (l * s) );
 }
 
-float4 MulMatVec(float16 a, float4 b)
+GmlCrd4 MulMatVec(GmlCrd16 a, GmlCrd4 b)
 {
-   float4 x;
+   GmlCrd4 x;
 
    x.s0 = a.s0 * b.s0 + a.s1 * b.s1 + a.s2 * b.s2 + a.s3 * b.s3;
    x.s1 = a.s4 * b.s0 + a.s5 * b.s1 + a.s6 * b.s2 + a.s7 * b.s3;
@@ -0,0 +1,222 @@
+// Device side construction of the uplinks, downlinks and neighbours.
+// All kernels get the same small table of integer parameters:
+//  0: number of items per line     1: stride of the key or source table
+//  2: width of the ball tier       3: number of the key ball's tiers
+//  4: first line of the ball tier  5: voyeurs flag
+//  6: link direction               7: stride of the destination table
+//  8: nodes per destination        9: nodes per item
+// 10: width of the output link    11: packed ball flag
+// 12: permuted ball lines flag
+// 16: local nodes of each item (4 per item)
+// 64: widths of the key ball's tiers
+// 72: first lines of the key ball's tiers
+
+#define NmbItm    tpo[0]
+#define KeyStr    tpo[1]
+#define BalSiz    tpo[2]
+#define NmbTie    tpo[3]
+#define LinBeg    tpo[4]
+#define VoyFlg    tpo[5]
+#define LnkDir    tpo[6]
+#define DstStr    tpo[7]
+#define DstNod    tpo[8]
+#define ItmNod    tpo[9]
+#define LnkSiz    tpo[10]
+#define CsrFlg    tpo[11]
+#define PrmFlg    tpo[12]
+#define ItmTab    (tpo + 16)
+#define TieWid    (tpo + 64)
+#define TieBeg    (tpo + 72)
+
+
+// Count the number of items pointing to each key
+__kernel void tpo_count(__global int *key,
+                        __global int *deg,
+                        __global int *tpo,
+                        __global void *par,
+                        const int2    cnt)
+{
+   int j, i = get_global_id(0);
+
+   if(i >= cnt.s0)
+      return;
+
+   for(j=0;j<NmbItm;j++)
+      atomic_inc(&deg[ key[ (size_t)i * KeyStr + j ] ]);
+}
+
+
+// Store each (element, item) tuple in its key's segment,
+// cur holds the segments' beginning and is used as a cursor
+__kernel void tpo_scatter( __global int  *key,
+                           __global int  *cur,
+                           __global int2 *tup,
+                           __global int  *tpo,
+                           __global void *par,
+                           const int2    cnt )
+{
+   int j, pos, i = get_global_id(0);
+
+   if(i >= cnt.s0)
+      return;
+
+   for(j=0;j<NmbItm;j++)
+   {
+      pos = atomic_inc(&cur[ key[ (size_t)i * KeyStr + j ] ]);
+      tup[ pos ] = (int2)(i, j);
+   }
+}
+
+
+// Sort each segment by increasing element and item, which is the order
+// given by the host hash table, and store them in the lines of a ball
+// tier and its voyeurs, or copy them as packed entries.
+// A permuted tier's line holds the key given by the permutation
+__kernel void tpo_split(__global int  *off,
+                        __global int2 *tup,
+                        __global int  *bal,
+                        __global char *BalVoy,
+                        __global int  *prm,
+                        __global int  *tpo,
+                        __global void *par,
+                        const int2    cnt )
+{
+   int i, j, k, beg, end, wid, r = get_global_id(0);
+   int2 t;
+   __global int *row;
+   __global char *voy;
+
+   if(r >= cnt.s0)
+      return;
+
+   k = PrmFlg ? prm[ LinBeg + r ] : LinBeg + r;
+   beg = off[k];
+   end = off[ k+1 ];
+
+   // Segments are only as long as the degree of the key: insertion sort
+   for(i=beg+1;i<end;i++)
+   {
+      t = tup[i];
+
+      for(j=i; (j > beg) && ( (tup[ j-1 ].s0 > t.s0)
+      || ((tup[ j-1 ].s0 == t.s0) && (tup[ j-1 ].s1 > t.s1)) ); j--)
+      {
+         tup[j] = tup[ j-1 ];
+      }
+
+      tup[j] = t;
+   }
+
+   if(CsrFlg)
+   {
+      wid = end - beg;
+      row = bal + beg;
+      voy = BalVoy + beg;
+   }
+   else
+   {
+      wid = BalSiz;
+      row = bal + (size_t)r * BalSiz;
+      voy = BalVoy + (size_t)r * BalSiz;
+   }
+
+   for(i=0;i<wid;i++)
+   {
+      t = (beg + i < end) ? tup[ beg + i ] : (int2)(0, 0);
+      row[i] = t.s0;
+
+      if(VoyFlg)
+         voy[i] = (char)t.s1;
+   }
+}
+
+
+// Look for the entities sharing an element's items in the ball of the
+// items' first vertex: down links store the matching entity and
+// neighbours the other element sharing the item, if there is only one.
+// The key ball comes as up to four tiers, a packed one as its entries
+// followed by its offsets, and a permuted one with its lines' positions
+__kernel void tpo_search(  __global int  *src,
+                           __global int  *dst,
+                           __global int  *bal0,
+                           __global int  *bal1,
+                           __global int  *bal2,
+                           __global int  *bal3,
+                           __global int  *deg,
+                           __global int  *inv,
+                           __global int  *lnk,
+                           __global int  *tpo,
+                           __global void *par,
+                           const int2    cnt )
+{
+   int j, k, l, m, t, d, n, p, wid, hit, cpt, res, nod[4], i = get_global_id(0);
+   __global int *row;
+
+   if(i >= cnt.s0)
+      return;
+
+   for(j=0;j<NmbItm;j++)
+   {
+      for(k=0;k<ItmNod;k++)
+         nod[k] = src[ (size_t)i * KeyStr + ItmTab[ j*4 + k ] ];
+
+      if(CsrFlg)
+      {
+         wid = bal1[ nod[0] + 1 ] - bal1[ nod[0] ];
+         row = bal0 + bal1[ nod[0] ];
+      }
+      else
+      {
+         p = PrmFlg ? inv[ nod[0] ] : nod[0];
+
+         for(t=0; (t < NmbTie-1) && (p >= TieBeg[ t+1 ]); t++);
+
+         wid = TieWid[t];
+         row = (t == 0) ? bal0 : (t == 1) ? bal1 : (t == 2) ? bal2 : bal3;
+         row += (size_t)(p - TieBeg[t]) * wid;
+      }
+
+      n = min(deg[ nod[0] ], wid);
+      cpt = res = 0;
+
+      for(l=0;l<n;l++)
+      {
+         d = row[l];
+         hit = 1;
+
+         for(k=1;k<ItmNod;k++)
+         {
+            hit = 0;
+
+            for(m=0;m<DstNod;m++)
+               if(dst[ (size_t)d * DstStr + m ] == nod[k])
+                  hit = 1;
+
+            if(!hit)
+               break;
+         }
+
+         if(!hit)
+            continue;
+
+         cpt++;
+
+         if(LnkDir == -1)
+         {
+            if(cpt == 1)
+               res = d;
+         }
+         else if(d != i)
+            res = d;
+      }
+
+      if( (LnkDir == 0) && (cpt != 2) )
+         res = 0;
+
+      lnk[ (size_t)i * LnkSiz + j ] = res;
+   }
+
+   // Clear the padding of the link vector
+   for(j=NmbItm;j<LnkSiz;j++)
+      lnk[ (size_t)i * LnkSiz + j ] = 0;
+}
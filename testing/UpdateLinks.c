@@ -0,0 +1,387 @@
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*                         GPU Meshing Library 3.42                           */
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+/*                                                                            */
+/*   Description:       Check the links after local mesh modifications        */
+/*   Creation date:     oct 19 2026                                           */
+/*   Last modification: oct 19 2026                                           */
+/*                                                                            */
+/*----------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------*/
+/* Includes                                                                   */
+/*----------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmlib3.h>
+
+#include "parameters.h"
+#include "neighbours.h"
+#include "balls.h"
+#include "shells.h"
+#include "downlinks.h"
+
+
+/*----------------------------------------------------------------------------*/
+/* Defines                                                                    */
+/*----------------------------------------------------------------------------*/
+
+#define NMBCUB 6
+#define NMBVER ((NMBCUB+1) * (NMBCUB+1) * (NMBCUB+1))
+#define NMBTET (6 * NMBCUB * NMBCUB * NMBCUB)
+#define VERIDX(i,j,k) (((k) * (NMBCUB+1) + (j)) * (NMBCUB+1) + (i))
+
+enum {NgbKrn, BalKrn, ShlKrn, DwnKrn, NmbKrn};
+
+
+/*----------------------------------------------------------------------------*/
+/* This structure definition must be exactly the same as the OpenCL one       */
+/*----------------------------------------------------------------------------*/
+
+typedef struct {
+   int   foo;
+   float res;
+}GmlParSct;
+
+
+/*----------------------------------------------------------------------------*/
+/* Split each cube of a regular grid into six tets sharing its main diagonal, */
+/* which gives a conforming mesh                                              */
+/*----------------------------------------------------------------------------*/
+
+static void SetTetMsh(int TetTab[][4])
+{
+   static const int  AxeTab[6][3] = {  {1,2,4}, {1,4,2}, {2,1,4},
+                                       {2,4,1}, {4,1,2}, {4,2,1} };
+   int               i, j, k, p, v, cod, n = 0;
+
+   for(k=0;k<NMBCUB;k++)
+      for(j=0;j<NMBCUB;j++)
+         for(i=0;i<NMBCUB;i++)
+            for(p=0;p<6;p++, n++)
+               for(v=0, cod=0; v<4; v++)
+               {
+                  TetTab[n][v] = VERIDX(i + (cod & 1), j + ((cod >> 1) & 1),
+                                        k + ((cod >> 2) & 1));
+
+                  if(v < 3)
+                     cod |= AxeTab[p][v];
+               }
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Swap the edge p-q shared by four tets whose opposite edges go through s    */
+/* and t for the edge s-t: the tets holding s get t in place of q and the     */
+/* others s in place of p, so each node keeps its position. Given a mesh,     */
+/* the edge's line is reused for the new edge and the links are updated.      */
+/*----------------------------------------------------------------------------*/
+
+static int FlpEdg(size_t GmlIdx, int TetTab[][4], int EdgTab[][3], int NmbEdg,
+                  int p, int q, int s, int t)
+{
+   int   i, j, EdgIdx, TetIdx = 0, NmbTet, e = -1, n = 0, flg;
+   int   OldEdg[2], TetLst[4], OldNod[16];
+
+   if(GmlIdx)
+   {
+      for(i=0;i<NmbEdg;i++)
+         if( ((EdgTab[i][0] == p) && (EdgTab[i][1] == q))
+         ||  ((EdgTab[i][0] == q) && (EdgTab[i][1] == p)) )
+            e = i;
+
+      if( (e < 0) || !GmlGetMeshInfo(GmlIdx, GmlEdges, &NmbEdg, &EdgIdx)
+      ||  !GmlGetMeshInfo(GmlIdx, GmlTetrahedra, &NmbTet, &TetIdx) )
+         return(0);
+
+      OldEdg[0] = EdgTab[e][0];
+      OldEdg[1] = EdgTab[e][1];
+      EdgTab[e][0] = s;
+      EdgTab[e][1] = t;
+      GmlSetDataLine(GmlIdx, EdgIdx, e, s, t, EdgTab[e][2]);
+
+      if(!GmlUpdateLinks(GmlIdx, GmlEdges, 1, &e, OldEdg))
+         return(0);
+   }
+
+   for(i=0;i<NMBTET;i++)
+   {
+      for(j=flg=0;j<4;j++)
+         flg |= (TetTab[i][j] == p) | ((TetTab[i][j] == q) << 1);
+
+      if(flg != 3)
+         continue;
+
+      if(n == 4)
+         return(0);
+
+      TetLst[n] = i;
+
+      for(j=0;j<4;j++)
+         OldNod[ n*4 + j ] = TetTab[i][j];
+
+      for(j=flg=0;j<4;j++)
+         flg |= (TetTab[i][j] == s);
+
+      for(j=0;j<4;j++)
+         if(flg && (TetTab[i][j] == q))
+            TetTab[i][j] = t;
+         else if(!flg && (TetTab[i][j] == p))
+            TetTab[i][j] = s;
+
+      if(GmlIdx)
+         GmlSetDataLine(GmlIdx, TetIdx, i, TetTab[i][0], TetTab[i][1],
+                        TetTab[i][2], TetTab[i][3], 0);
+
+      n++;
+   }
+
+   if(n != 4)
+      return(0);
+
+   if(GmlIdx && !GmlUpdateLinks(GmlIdx, GmlTetrahedra, n, TetLst, OldNod))
+      return(0);
+
+   return(1);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Setup a library instance with the grid and kernels that gather the tet     */
+/* numbers through the neighbours, the vertex balls and the edge shells, and  */
+/* the edge numbers through the tets' downlinks. Without an edge table, the   */
+/* edges are extracted from the tets.                                         */
+/*----------------------------------------------------------------------------*/
+
+static size_t NewMsh(int GpuIdx, int TetTab[][4], int EdgTab[][3], int NmbEdg,
+                     int *KrnTab, int *SolTab)
+{
+   int         i, j, k, VerIdx, TetIdx, EdgIdx, NgbIdx, TetNum, EdgNum;
+   size_t      GmlIdx;
+   GmlParSct   *GmlPar;
+
+   if(!(GmlIdx = GmlInit(GpuIdx)))
+      return(0);
+
+   if(!(GmlPar = GmlNewParameters(GmlIdx, sizeof(GmlParSct), parameters)))
+      return(0);
+
+   if(!(VerIdx = GmlNewMeshData(GmlIdx, GmlVertices, NMBVER)))
+      return(0);
+
+   for(k=0;k<=NMBCUB;k++)
+      for(j=0;j<=NMBCUB;j++)
+         for(i=0;i<=NMBCUB;i++)
+            GmlSetDataLine(GmlIdx, VerIdx, VERIDX(i,j,k),
+                           (double)i, (double)j, (double)k, 0);
+
+   if(!(TetIdx = GmlNewMeshData(GmlIdx, GmlTetrahedra, NMBTET)))
+      return(0);
+
+   for(i=0;i<NMBTET;i++)
+      GmlSetDataLine(GmlIdx, TetIdx, i, TetTab[i][0], TetTab[i][1],
+                     TetTab[i][2], TetTab[i][3], 0);
+
+   // Give the rebuilt mesh the updated edges so both number them alike
+   if(EdgTab)
+   {
+      if(!(EdgIdx = GmlNewMeshData(GmlIdx, GmlEdges, NmbEdg)))
+         return(0);
+
+      for(i=0;i<NmbEdg;i++)
+         GmlSetDataLine(GmlIdx, EdgIdx, i, EdgTab[i][0], EdgTab[i][1], EdgTab[i][2]);
+   }
+   else if(!GmlExtractEdges(GmlIdx) || !GmlGetMeshInfo(GmlIdx, GmlEdges, &NmbEdg, &EdgIdx))
+      return(0);
+
+   if(!(NgbIdx = GmlSetNeighbours(GmlIdx, GmlTetrahedra)))
+      return(0);
+
+   // Number the entities from one, missing neighbours read the first tet's number
+   if(!(TetNum = GmlNewSolutionData(GmlIdx, GmlTetrahedra, 1, GmlInt, "TetNum")))
+      return(0);
+
+   for(i=0;i<NMBTET;i++)
+   {
+      j = i + 1;
+      GmlSetDataLine(GmlIdx, TetNum, i, &j);
+   }
+
+   if(!(EdgNum = GmlNewSolutionData(GmlIdx, GmlEdges, 1, GmlInt, "EdgNum")))
+      return(0);
+
+   for(i=0;i<NmbEdg;i++)
+   {
+      j = i + 1;
+      GmlSetDataLine(GmlIdx, EdgNum, i, &j);
+   }
+
+   if( !(SolTab[ NgbKrn ] = GmlNewSolutionData(GmlIdx, GmlTetrahedra, 1, GmlInt4, "NgbNum"))
+   ||  !(SolTab[ BalKrn ] = GmlNewSolutionData(GmlIdx, GmlVertices,   1, GmlInt2, "VerSum"))
+   ||  !(SolTab[ ShlKrn ] = GmlNewSolutionData(GmlIdx, GmlEdges,      1, GmlInt2, "EdgSum"))
+   ||  !(SolTab[ DwnKrn ] = GmlNewSolutionData(GmlIdx, GmlTetrahedra, 1, GmlInt,  "TetSum")) )
+      return(0);
+
+   // Compiling the kernels builds the links they read
+   KrnTab[ NgbKrn ] = GmlCompileKernel(GmlIdx, neighbours, "neighbours", GmlTetrahedra, 2,
+                                       TetNum,             GmlReadMode,  NgbIdx,
+                                       SolTab[ NgbKrn ],   GmlWriteMode, NULL );
+
+   KrnTab[ BalKrn ] = GmlCompileKernel(GmlIdx, balls, "balls", GmlVertices, 2,
+                                       TetNum,             GmlReadMode,  NULL,
+                                       SolTab[ BalKrn ],   GmlWriteMode, NULL );
+
+   KrnTab[ ShlKrn ] = GmlCompileKernel(GmlIdx, shells, "shells", GmlEdges, 2,
+                                       TetNum,             GmlReadMode,  NULL,
+                                       SolTab[ ShlKrn ],   GmlWriteMode, NULL );
+
+   KrnTab[ DwnKrn ] = GmlCompileKernel(GmlIdx, downlinks, "downlinks", GmlTetrahedra, 2,
+                                       EdgNum,             GmlReadMode,  NULL,
+                                       SolTab[ DwnKrn ],   GmlWriteMode, NULL );
+
+   for(i=0;i<NmbKrn;i++)
+      if(!KrnTab[i])
+         return(0);
+
+   return(GmlIdx);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Launch a kernel in both meshes and count the lines where they differ       */
+/*----------------------------------------------------------------------------*/
+
+static int CmpKrn(size_t UpdMsh, size_t RefMsh, int *UpdKrn, int *RefKrn,
+                  int *UpdSol, int *RefSol, int KrnIdx, int MshTyp,
+                  int NmbVal, const char *nam)
+{
+   int   i, j, NmbLin, DatIdx, NmbErr = 0, UpdTab[4], RefTab[4];
+
+   if( (GmlLaunchKernel(UpdMsh, UpdKrn[ KrnIdx ]) < 0)
+   ||  (GmlLaunchKernel(RefMsh, RefKrn[ KrnIdx ]) < 0)
+   ||  !GmlGetMeshInfo(UpdMsh, MshTyp, &NmbLin, &DatIdx) )
+      return(1);
+
+   for(i=0;i<NmbLin;i++)
+   {
+      GmlGetDataLine(UpdMsh, UpdSol[ KrnIdx ], i, UpdTab);
+      GmlGetDataLine(RefMsh, RefSol[ KrnIdx ], i, RefTab);
+
+      for(j=0;j<NmbVal;j++)
+         if(UpdTab[j] != RefTab[j])
+         {
+            printf(  "%s %d, value %d: updated %d, rebuilt %d\n",
+                     nam, i, j, UpdTab[j], RefTab[j] );
+            NmbErr++;
+         }
+   }
+
+   printf("%s: %d mismatches\n", nam, NmbErr);
+
+   return(NmbErr);
+}
+
+
+/*----------------------------------------------------------------------------*/
+/* Rotate the nodes of an interior tet and swap two edges for others, so that */
+/* the degree of some shells changes and moves them to another tier, update   */
+/* the links and compare what the kernels read through them with a mesh built */
+/* from scratch with the same entities. The grid is large enough to store the */
+/* shells in two tiers while the vertex balls are packed.                     */
+/*----------------------------------------------------------------------------*/
+
+int main(int ArgCnt, char **ArgVec)
+{
+   int      i, j, GpuIdx = 0, RotIdx, NmbErr = 0, OldNod[4], NmbTet, TetIdx;
+   int      NmbEdg, EdgIdx, UpdKrn[ NmbKrn ], RefKrn[ NmbKrn ];
+   int      UpdSol[ NmbKrn ], RefSol[ NmbKrn ], (*TetTab)[4], (*EdgTab)[3];
+   size_t   UpdMsh, RefMsh;
+
+   if(ArgCnt > 1)
+      GpuIdx = atoi(ArgVec[1]);
+
+   if(!(TetTab = malloc(NMBTET * 4 * sizeof(int))))
+      return(1);
+
+   // Start with the edge of the face z=2 in the cube (2,2,2) already
+   // swapped: the shells of the four edges it gained are one tet longer
+   // than the grid's face diagonals and get stored in the wider tier
+   SetTetMsh(TetTab);
+   FlpEdg(0, TetTab, NULL, 0, VERIDX(2,2,2), VERIDX(3,3,2),
+          VERIDX(3,2,2), VERIDX(2,3,2));
+
+   if(!(UpdMsh = NewMsh(GpuIdx, TetTab, NULL, 0, UpdKrn, UpdSol)))
+      return(1);
+
+   if( !GmlGetMeshInfo(UpdMsh, GmlTetrahedra, &NmbTet, &TetIdx)
+   ||  !GmlGetMeshInfo(UpdMsh, GmlEdges, &NmbEdg, &EdgIdx) )
+      return(1);
+
+   if(!(EdgTab = malloc(NmbEdg * 3 * sizeof(int))))
+      return(1);
+
+   for(i=0;i<NmbEdg;i++)
+      GmlGetDataLine(UpdMsh, EdgIdx, i, &EdgTab[i][0], &EdgTab[i][1], &EdgTab[i][2]);
+
+   // The tets of the cube (1,1,1) are surrounded by other cubes
+   RotIdx = 6 * ((1 * NMBCUB + 1) * NMBCUB + 1);
+
+   for(j=0;j<4;j++)
+      OldNod[j] = TetTab[ RotIdx ][j];
+
+   // An even permutation keeps the orientation but moves the faces
+   j = TetTab[ RotIdx ][0];
+   TetTab[ RotIdx ][0] = TetTab[ RotIdx ][1];
+   TetTab[ RotIdx ][1] = TetTab[ RotIdx ][2];
+   TetTab[ RotIdx ][2] = j;
+
+   GmlSetDataLine(UpdMsh, TetIdx, RotIdx,
+                  TetTab[ RotIdx ][0], TetTab[ RotIdx ][1],
+                  TetTab[ RotIdx ][2], TetTab[ RotIdx ][3], 0);
+
+   if(!GmlUpdateLinks(UpdMsh, GmlTetrahedra, 1, &RotIdx, OldNod))
+   {
+      puts("GmlUpdateLinks failed on the rotated tet");
+      return(1);
+   }
+
+   // Swapping the edge back leaves four wide tier shells with
+   // a grid degree, which lets the same swap in the cube (4,4,4)
+   // move the shells that outgrow the narrow tier to the wide one
+   if(!FlpEdg( UpdMsh, TetTab, EdgTab, NmbEdg, VERIDX(3,2,2), VERIDX(2,3,2),
+               VERIDX(2,2,2), VERIDX(3,3,2) ))
+   {
+      puts("GmlUpdateLinks failed on the edge swapped back");
+      return(1);
+   }
+
+   if(!FlpEdg( UpdMsh, TetTab, EdgTab, NmbEdg, VERIDX(4,4,4), VERIDX(5,5,4),
+               VERIDX(5,4,4), VERIDX(4,5,4) ))
+   {
+      puts("GmlUpdateLinks failed on the swapped edge");
+      return(1);
+   }
+
+   if(!(RefMsh = NewMsh(GpuIdx, TetTab, EdgTab, NmbEdg, RefKrn, RefSol)))
+      return(1);
+
+   NmbErr += CmpKrn( UpdMsh, RefMsh, UpdKrn, RefKrn, UpdSol, RefSol,
+                     NgbKrn, GmlTetrahedra, 4, "Tet neighbours" );
+   NmbErr += CmpKrn( UpdMsh, RefMsh, UpdKrn, RefKrn, UpdSol, RefSol,
+                     BalKrn, GmlVertices, 2, "Vertex ball" );
+   NmbErr += CmpKrn( UpdMsh, RefMsh, UpdKrn, RefKrn, UpdSol, RefSol,
+                     ShlKrn, GmlEdges, 2, "Edge shell" );
+   NmbErr += CmpKrn( UpdMsh, RefMsh, UpdKrn, RefKrn, UpdSol, RefSol,
+                     DwnKrn, GmlTetrahedra, 1, "Tet edges" );
+
+   GmlStop(UpdMsh);
+   GmlStop(RefMsh);
+   free(TetTab);
+   free(EdgTab);
+
+   return(NmbErr ? 1 : 0);
+}
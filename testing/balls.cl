@@ -0,0 +1,4 @@
+   VerSum = (int2){TetNumDeg, 0};
+
+   for(int i=0;i<TetNumDeg;i++)
+      VerSum.s1 += TetNum[i];
@@ -0,0 +1,4 @@
+   TetSum = 0;
+
+   for(int i=0;i<6;i++)
+      TetSum += EdgNum[i];
@@ -0,0 +1 @@
+   NgbNum = (int4){TetNum[0], TetNum[1], TetNum[2], TetNum[3]};
@@ -0,0 +1,4 @@
+typedef struct {
+   int   foo;
+   float res;
+}GmlParSct;
@@ -0,0 +1,4 @@
+   EdgSum = (int2){TetNumDeg, 0};
+
+   for(int i=0;i<TetNumDeg;i++)
+      EdgSum.s1 += TetNum[i];